@@ -1,5 +1,405 @@
 #include "crcLib.h"
 
+/* Register layout:
+ *   refin:  reflected CRC in the low `width` bits, shifted right
+ *   !refin: CRC in the high `width` bits (left aligned), shifted left
+ * so every width from 1 to 32 uses the same 32-bit code path.
+ */
+
+static uint32_t reflect(uint32_t v, uint8_t width) {
+    v = ((v >> 1) & 0x55555555u) | ((v & 0x55555555u) << 1);
+    v = ((v >> 2) & 0x33333333u) | ((v & 0x33333333u) << 2);
+    v = ((v >> 4) & 0x0F0F0F0Fu) | ((v & 0x0F0F0F0Fu) << 4);
+    v = ((v >> 8) & 0x00FF00FFu) | ((v & 0x00FF00FFu) << 8);
+    v = (v >> 16) | (v << 16);
+    return v >> (32 - width);
+}
+
+static uint32_t reg_poly(const crc_model_t* model) {
+    if (model->refin)
+        return reflect(model->poly, model->width);
+    return model->poly << (32 - model->width);
+}
+
+static void update_bit(crc_ctx_t* ctx, const uint8_t* p, uint32_t length) {
+    uint32_t reg = ctx->reg;
+    uint32_t rpoly = ctx->rpoly;
+    if (ctx->model->refin) {
+        while (length--) {
+            reg ^= *p++;
+            for (uint8_t i = 0; i < 8; i++)
+                reg = (reg & 1) ? (reg >> 1) ^ rpoly : reg >> 1;
+        }
+    } else {
+        while (length--) {
+            reg ^= (uint32_t)*p++ << 24;
+            for (uint8_t i = 0; i < 8; i++)
+                reg = (reg & 0x80000000u) ? (reg << 1) ^ rpoly : reg << 1;
+        }
+    }
+    ctx->reg = reg;
+}
+
+#ifdef CRC_TABLE_SIZE
+#if LIBCRC_CFG_ENGINE_NIBBLE
+#define TABLE_BITS 4
+#else
+#define TABLE_BITS 8
+#endif
+
+/* Feed `bits` zero bits into the register */
+static uint32_t reg_shift(uint32_t reg, uint32_t rpoly, bool refin,
+                          uint8_t bits) {
+    while (bits--) {
+        if (refin)
+            reg = (reg >> 1) ^ (rpoly & (0u - (reg & 1)));
+        else
+            reg = (reg << 1) ^ (rpoly & (0u - (reg >> 31)));
+    }
+    return reg;
+}
+
+void crc_table_init(const crc_model_t* model) {
+    // precomputed tables are always ready, so only RAM tables are written
+    crc_table_t* table = (crc_table_t*)model->table;
+    if (table == NULL || table->ready)
+        return;
+    volatile uint32_t* t = table->data;  // keep stores before `ready`
+    uint32_t rpoly = reg_poly(model);
+    bool refin = model->refin;
+    for (uint32_t i = 0; i < (1u << TABLE_BITS); i++) {
+        t[i] = reg_shift(refin ? i : i << (32 - TABLE_BITS), rpoly, refin,
+                         TABLE_BITS);
+    }
+#if LIBCRC_CFG_ENGINE_SLICE8
+    // t[k][i]: CRC of byte i followed by k zero bytes
+    for (uint32_t i = 256; i < 8 * 256; i++) {
+        uint32_t v = t[i - 256];
+        t[i] = refin ? (v >> 8) ^ t[v & 0xFF] : (v << 8) ^ t[v >> 24];
+    }
+#endif
+    // concurrent builders write identical values, so a race is harmless
+    table->ready = 1;
+}
+
+static void update_table(crc_ctx_t* ctx, const uint8_t* p, uint32_t length) {
+    const uint32_t* t = ctx->model->table->data;
+    uint32_t reg = ctx->reg;
+    if (ctx->model->refin) {
+#if LIBCRC_CFG_ENGINE_SLICE8
+        for (; length >= 8; length -= 8, p += 8) {
+            uint32_t a = reg ^ (p[0] | (uint32_t)p[1] << 8 |
+                                (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+            reg = t[7 * 256 + (a & 0xFF)] ^ t[6 * 256 + ((a >> 8) & 0xFF)] ^
+                  t[5 * 256 + ((a >> 16) & 0xFF)] ^ t[4 * 256 + (a >> 24)] ^
+                  t[3 * 256 + p[4]] ^ t[2 * 256 + p[5]] ^ t[256 + p[6]] ^
+                  t[p[7]];
+        }
+#endif
+        while (length--) {
+#if LIBCRC_CFG_ENGINE_NIBBLE
+            reg ^= *p++;
+            reg = (reg >> 4) ^ t[reg & 0x0F];
+            reg = (reg >> 4) ^ t[reg & 0x0F];
+#else
+            reg = (reg >> 8) ^ t[(reg ^ *p++) & 0xFF];
+#endif
+        }
+    } else {
+#if LIBCRC_CFG_ENGINE_SLICE8
+        for (; length >= 8; length -= 8, p += 8) {
+            uint32_t a = reg ^ ((uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 |
+                                (uint32_t)p[2] << 8 | p[3]);
+            reg = t[7 * 256 + (a >> 24)] ^ t[6 * 256 + ((a >> 16) & 0xFF)] ^
+                  t[5 * 256 + ((a >> 8) & 0xFF)] ^ t[4 * 256 + (a & 0xFF)] ^
+                  t[3 * 256 + p[4]] ^ t[2 * 256 + p[5]] ^ t[256 + p[6]] ^
+                  t[p[7]];
+        }
+#endif
+        while (length--) {
+#if LIBCRC_CFG_ENGINE_NIBBLE
+            reg ^= (uint32_t)*p++ << 24;
+            reg = (reg << 4) ^ t[reg >> 28];
+            reg = (reg << 4) ^ t[reg >> 28];
+#else
+            reg = (reg << 8) ^ t[(reg >> 24) ^ *p++];
+#endif
+        }
+    }
+    ctx->reg = reg;
+}
+#else
+void crc_table_init(const crc_model_t* model) { (void)model; }
+#endif  // CRC_TABLE_SIZE
+
+#if LIBCRC_CFG_HW_HOOK
+static crc_hw_hook_t hw_hook;
+
+/**
+ * @brief Install (or remove with NULL) the hardware CRC hook
+ */
+void crc_set_hw_hook(crc_hw_hook_t hook) { hw_hook = hook; }
+#endif
+
+static void ctx_setup(crc_ctx_t* ctx, const crc_model_t* model) {
+    ctx->model = model;
+    ctx->rpoly = model->table == NULL ? reg_poly(model) : 0;
+    crc_table_init(model);
+}
+
+/**
+ * @brief Start a CRC calculation, builds the model's table on first use
+ */
+void crc_init(crc_ctx_t* ctx, const crc_model_t* model) {
+    ctx_setup(ctx, model);
+    if (model->refin)
+        ctx->reg = reflect(model->init, model->width);
+    else
+        ctx->reg = model->init << (32 - model->width);
+}
+
+/**
+ * @brief Continue a calculation from a CRC returned by crc_final()/crc_calc()
+ * @note  crc_resume(crc_calc(a)) + crc_update(b) gives the CRC of a + b
+ */
+void crc_resume(crc_ctx_t* ctx, const crc_model_t* model, uint32_t crc) {
+    ctx_setup(ctx, model);
+    crc = (crc ^ model->xorout) & (0xFFFFFFFFu >> (32 - model->width));
+    if (model->refin != model->refout)
+        crc = reflect(crc, model->width);
+    if (!model->refin)
+        crc <<= 32 - model->width;
+    ctx->reg = crc;
+}
+
+/**
+ * @brief Feed data, may be called any number of times
+ */
+void crc_update(crc_ctx_t* ctx, const void* data, uint32_t length) {
+#if LIBCRC_CFG_HW_HOOK
+    if (hw_hook != NULL) {
+        uint8_t shift = ctx->model->refin ? 0 : 32 - ctx->model->width;
+        uint32_t crc = ctx->reg >> shift;
+        if (hw_hook(ctx->model, &crc, data, length)) {
+            ctx->reg = crc << shift;
+            return;
+        }
+    }
+#endif
+#ifdef CRC_TABLE_SIZE
+    if (ctx->model->table != NULL) {
+        update_table(ctx, (const uint8_t*)data, length);
+        return;
+    }
+#endif
+    update_bit(ctx, (const uint8_t*)data, length);
+}
+
+/**
+ * @brief Get the CRC of all data fed so far, the context stays usable
+ */
+uint32_t crc_final(const crc_ctx_t* ctx) {
+    const crc_model_t* model = ctx->model;
+    uint32_t crc = ctx->reg;
+    if (!model->refin)
+        crc >>= 32 - model->width;
+    if (model->refin != model->refout)
+        crc = reflect(crc, model->width);
+    return (crc ^ model->xorout) & (0xFFFFFFFFu >> (32 - model->width));
+}
+
+uint32_t crc_calc(const crc_model_t* model, const void* data,
+                  uint32_t length) {
+    crc_ctx_t ctx;
+    crc_init(&ctx, model);
+    crc_update(&ctx, data, length);
+    return crc_final(&ctx);
+}
+
+/**
+ * @brief Append data to a CRC, e.g. crc32 of a + b:
+ *        crc_continue(&crc32_model, crc32(a), b, len_b)
+ * @note  Starting from crc_calc(model, NULL, 0) equals crc_calc() of the data
+ */
+uint32_t crc_continue(const crc_model_t* model, uint32_t crc,
+                      const void* data, uint32_t length) {
+    crc_ctx_t ctx;
+    crc_resume(&ctx, model, crc);
+    crc_update(&ctx, data, length);
+    return crc_final(&ctx);
+}
+
+/**
+ * @brief Check the model against its check value ("123456789")
+ */
+bool crc_model_verify(const crc_model_t* model) {
+    static const char vector[] = "123456789";
+    return crc_calc(model, vector, sizeof(vector) - 1) == model->check;
+}
+
+/* Tables shared by models with the same width/poly/refin */
+CRC_TABLE_DEF(tab_4_03_ref);
+CRC_TABLE_DEF(tab_5_09);
+CRC_TABLE_DEF(tab_5_15_ref);
+CRC_TABLE_DEF(tab_5_05_ref);
+CRC_TABLE_DEF(tab_6_03_ref);
+CRC_TABLE_DEF(tab_7_09);
+CRC_TABLE_DEF(tab_8_07);
+CRC_TABLE_DEF(tab_8_07_ref);
+CRC_TABLE_DEF(tab_16_1021_ref);
+CRC_TABLE_DEF(tab_16_1021);
+CRC_TABLE_DEF(tab_16_3d65_ref);
+CRC_TABLE_DEF(tab_32_04c11db7);
+
+#if LIBCRC_CFG_CONST_TABLE
+/* Byte tables used by modbus/TinyFrame/lwpkt/easyflash, kept in flash */
+static const crc_table_t tab_8_31_ref = {
+    1,
+    {
+        0x00000000, 0x0000005E, 0x000000BC, 0x000000E2, 0x00000061, 0x0000003F,
+        0x000000DD, 0x00000083, 0x000000C2, 0x0000009C, 0x0000007E, 0x00000020,
+        0x000000A3, 0x000000FD, 0x0000001F, 0x00000041, 0x0000009D, 0x000000C3,
+        0x00000021, 0x0000007F, 0x000000FC, 0x000000A2, 0x00000040, 0x0000001E,
+        0x0000005F, 0x00000001, 0x000000E3, 0x000000BD, 0x0000003E, 0x00000060,
+        0x00000082, 0x000000DC, 0x00000023, 0x0000007D, 0x0000009F, 0x000000C1,
+        0x00000042, 0x0000001C, 0x000000FE, 0x000000A0, 0x000000E1, 0x000000BF,
+        0x0000005D, 0x00000003, 0x00000080, 0x000000DE, 0x0000003C, 0x00000062,
+        0x000000BE, 0x000000E0, 0x00000002, 0x0000005C, 0x000000DF, 0x00000081,
+        0x00000063, 0x0000003D, 0x0000007C, 0x00000022, 0x000000C0, 0x0000009E,
+        0x0000001D, 0x00000043, 0x000000A1, 0x000000FF, 0x00000046, 0x00000018,
+        0x000000FA, 0x000000A4, 0x00000027, 0x00000079, 0x0000009B, 0x000000C5,
+        0x00000084, 0x000000DA, 0x00000038, 0x00000066, 0x000000E5, 0x000000BB,
+        0x00000059, 0x00000007, 0x000000DB, 0x00000085, 0x00000067, 0x00000039,
+        0x000000BA, 0x000000E4, 0x00000006, 0x00000058, 0x00000019, 0x00000047,
+        0x000000A5, 0x000000FB, 0x00000078, 0x00000026, 0x000000C4, 0x0000009A,
+        0x00000065, 0x0000003B, 0x000000D9, 0x00000087, 0x00000004, 0x0000005A,
+        0x000000B8, 0x000000E6, 0x000000A7, 0x000000F9, 0x0000001B, 0x00000045,
+        0x000000C6, 0x00000098, 0x0000007A, 0x00000024, 0x000000F8, 0x000000A6,
+        0x00000044, 0x0000001A, 0x00000099, 0x000000C7, 0x00000025, 0x0000007B,
+        0x0000003A, 0x00000064, 0x00000086, 0x000000D8, 0x0000005B, 0x00000005,
+        0x000000E7, 0x000000B9, 0x0000008C, 0x000000D2, 0x00000030, 0x0000006E,
+        0x000000ED, 0x000000B3, 0x00000051, 0x0000000F, 0x0000004E, 0x00000010,
+        0x000000F2, 0x000000AC, 0x0000002F, 0x00000071, 0x00000093, 0x000000CD,
+        0x00000011, 0x0000004F, 0x000000AD, 0x000000F3, 0x00000070, 0x0000002E,
+        0x000000CC, 0x00000092, 0x000000D3, 0x0000008D, 0x0000006F, 0x00000031,
+        0x000000B2, 0x000000EC, 0x0000000E, 0x00000050, 0x000000AF, 0x000000F1,
+        0x00000013, 0x0000004D, 0x000000CE, 0x00000090, 0x00000072, 0x0000002C,
+        0x0000006D, 0x00000033, 0x000000D1, 0x0000008F, 0x0000000C, 0x00000052,
+        0x000000B0, 0x000000EE, 0x00000032, 0x0000006C, 0x0000008E, 0x000000D0,
+        0x00000053, 0x0000000D, 0x000000EF, 0x000000B1, 0x000000F0, 0x000000AE,
+        0x0000004C, 0x00000012, 0x00000091, 0x000000CF, 0x0000002D, 0x00000073,
+        0x000000CA, 0x00000094, 0x00000076, 0x00000028, 0x000000AB, 0x000000F5,
+        0x00000017, 0x00000049, 0x00000008, 0x00000056, 0x000000B4, 0x000000EA,
+        0x00000069, 0x00000037, 0x000000D5, 0x0000008B, 0x00000057, 0x00000009,
+        0x000000EB, 0x000000B5, 0x00000036, 0x00000068, 0x0000008A, 0x000000D4,
+        0x00000095, 0x000000CB, 0x00000029, 0x00000077, 0x000000F4, 0x000000AA,
+        0x00000048, 0x00000016, 0x000000E9, 0x000000B7, 0x00000055, 0x0000000B,
+        0x00000088, 0x000000D6, 0x00000034, 0x0000006A, 0x0000002B, 0x00000075,
+        0x00000097, 0x000000C9, 0x0000004A, 0x00000014, 0x000000F6, 0x000000A8,
+        0x00000074, 0x0000002A, 0x000000C8, 0x00000096, 0x00000015, 0x0000004B,
+        0x000000A9, 0x000000F7, 0x000000B6, 0x000000E8, 0x0000000A, 0x00000054,
+        0x000000D7, 0x00000089, 0x0000006B, 0x00000035
+    }};
+static const crc_table_t tab_16_8005_ref = {
+    1,
+    {
+        0x00000000, 0x0000C0C1, 0x0000C181, 0x00000140, 0x0000C301, 0x000003C0,
+        0x00000280, 0x0000C241, 0x0000C601, 0x000006C0, 0x00000780, 0x0000C741,
+        0x00000500, 0x0000C5C1, 0x0000C481, 0x00000440, 0x0000CC01, 0x00000CC0,
+        0x00000D80, 0x0000CD41, 0x00000F00, 0x0000CFC1, 0x0000CE81, 0x00000E40,
+        0x00000A00, 0x0000CAC1, 0x0000CB81, 0x00000B40, 0x0000C901, 0x000009C0,
+        0x00000880, 0x0000C841, 0x0000D801, 0x000018C0, 0x00001980, 0x0000D941,
+        0x00001B00, 0x0000DBC1, 0x0000DA81, 0x00001A40, 0x00001E00, 0x0000DEC1,
+        0x0000DF81, 0x00001F40, 0x0000DD01, 0x00001DC0, 0x00001C80, 0x0000DC41,
+        0x00001400, 0x0000D4C1, 0x0000D581, 0x00001540, 0x0000D701, 0x000017C0,
+        0x00001680, 0x0000D641, 0x0000D201, 0x000012C0, 0x00001380, 0x0000D341,
+        0x00001100, 0x0000D1C1, 0x0000D081, 0x00001040, 0x0000F001, 0x000030C0,
+        0x00003180, 0x0000F141, 0x00003300, 0x0000F3C1, 0x0000F281, 0x00003240,
+        0x00003600, 0x0000F6C1, 0x0000F781, 0x00003740, 0x0000F501, 0x000035C0,
+        0x00003480, 0x0000F441, 0x00003C00, 0x0000FCC1, 0x0000FD81, 0x00003D40,
+        0x0000FF01, 0x00003FC0, 0x00003E80, 0x0000FE41, 0x0000FA01, 0x00003AC0,
+        0x00003B80, 0x0000FB41, 0x00003900, 0x0000F9C1, 0x0000F881, 0x00003840,
+        0x00002800, 0x0000E8C1, 0x0000E981, 0x00002940, 0x0000EB01, 0x00002BC0,
+        0x00002A80, 0x0000EA41, 0x0000EE01, 0x00002EC0, 0x00002F80, 0x0000EF41,
+        0x00002D00, 0x0000EDC1, 0x0000EC81, 0x00002C40, 0x0000E401, 0x000024C0,
+        0x00002580, 0x0000E541, 0x00002700, 0x0000E7C1, 0x0000E681, 0x00002640,
+        0x00002200, 0x0000E2C1, 0x0000E381, 0x00002340, 0x0000E101, 0x000021C0,
+        0x00002080, 0x0000E041, 0x0000A001, 0x000060C0, 0x00006180, 0x0000A141,
+        0x00006300, 0x0000A3C1, 0x0000A281, 0x00006240, 0x00006600, 0x0000A6C1,
+        0x0000A781, 0x00006740, 0x0000A501, 0x000065C0, 0x00006480, 0x0000A441,
+        0x00006C00, 0x0000ACC1, 0x0000AD81, 0x00006D40, 0x0000AF01, 0x00006FC0,
+        0x00006E80, 0x0000AE41, 0x0000AA01, 0x00006AC0, 0x00006B80, 0x0000AB41,
+        0x00006900, 0x0000A9C1, 0x0000A881, 0x00006840, 0x00007800, 0x0000B8C1,
+        0x0000B981, 0x00007940, 0x0000BB01, 0x00007BC0, 0x00007A80, 0x0000BA41,
+        0x0000BE01, 0x00007EC0, 0x00007F80, 0x0000BF41, 0x00007D00, 0x0000BDC1,
+        0x0000BC81, 0x00007C40, 0x0000B401, 0x000074C0, 0x00007580, 0x0000B541,
+        0x00007700, 0x0000B7C1, 0x0000B681, 0x00007640, 0x00007200, 0x0000B2C1,
+        0x0000B381, 0x00007340, 0x0000B101, 0x000071C0, 0x00007080, 0x0000B041,
+        0x00005000, 0x000090C1, 0x00009181, 0x00005140, 0x00009301, 0x000053C0,
+        0x00005280, 0x00009241, 0x00009601, 0x000056C0, 0x00005780, 0x00009741,
+        0x00005500, 0x000095C1, 0x00009481, 0x00005440, 0x00009C01, 0x00005CC0,
+        0x00005D80, 0x00009D41, 0x00005F00, 0x00009FC1, 0x00009E81, 0x00005E40,
+        0x00005A00, 0x00009AC1, 0x00009B81, 0x00005B40, 0x00009901, 0x000059C0,
+        0x00005880, 0x00009841, 0x00008801, 0x000048C0, 0x00004980, 0x00008941,
+        0x00004B00, 0x00008BC1, 0x00008A81, 0x00004A40, 0x00004E00, 0x00008EC1,
+        0x00008F81, 0x00004F40, 0x00008D01, 0x00004DC0, 0x00004C80, 0x00008C41,
+        0x00004400, 0x000084C1, 0x00008581, 0x00004540, 0x00008701, 0x000047C0,
+        0x00004680, 0x00008641, 0x00008201, 0x000042C0, 0x00004380, 0x00008341,
+        0x00004100, 0x000081C1, 0x00008081, 0x00004040
+    }};
+static const crc_table_t tab_32_04c11db7_ref = {
+    1,
+    {
+        0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+        0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+        0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+        0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+        0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+        0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+        0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+        0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+        0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+        0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+        0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+        0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+        0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+        0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+        0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+        0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+        0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+        0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+        0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+        0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+        0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+        0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+        0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+        0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+        0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+        0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+        0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+        0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+        0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+        0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+        0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+        0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+        0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+        0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+        0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+        0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+        0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+        0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+        0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+        0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+        0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+        0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+        0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+    }};
+#else
+CRC_TABLE_DEF(tab_8_31_ref);
+CRC_TABLE_DEF(tab_16_8005_ref);
+CRC_TABLE_DEF(tab_32_04c11db7_ref);
+#endif
+
 /******************************************************************************
  * Name:    CRC-4/ITU           x4+x+1
  * Poly:    0x03
@@ -9,19 +409,10 @@
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc4_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x0C;  // 0x0C = (reverse 0x03)>>(8-4)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc4_itu_model =
+    CRC_MODEL(4, 0x03, 0x00, 1, 1, 0x00, 0x07, tab_4_03_ref);
+uint8_t crc4_itu(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc4_itu_model, data, length);
 }
 
 /******************************************************************************
@@ -33,19 +424,10 @@ uint8_t crc4_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc5_epc(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0x48;  // Initial value: 0x48 = 0x09<<(8-5)
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x48;  // 0x48 = 0x09<<(8-5)
-            else
-                crc <<= 1;
-        }
-    }
-    return crc >> 3;
+const crc_model_t crc5_epc_model =
+    CRC_MODEL(5, 0x09, 0x09, 0, 0, 0x00, 0x00, tab_5_09);
+uint8_t crc5_epc(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc5_epc_model, data, length);
 }
 
 /******************************************************************************
@@ -57,19 +439,10 @@ uint8_t crc5_epc(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc5_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x15;  // 0x15 = (reverse 0x15)>>(8-5)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc5_itu_model =
+    CRC_MODEL(5, 0x15, 0x00, 1, 1, 0x00, 0x07, tab_5_15_ref);
+uint8_t crc5_itu(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc5_itu_model, data, length);
 }
 
 /******************************************************************************
@@ -81,19 +454,10 @@ uint8_t crc5_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x1F
  * Note:
  *****************************************************************************/
-uint8_t crc5_usb(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0x1F;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x14;  // 0x14 = (reverse 0x05)>>(8-5)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc ^ 0x1F;
+const crc_model_t crc5_usb_model =
+    CRC_MODEL(5, 0x05, 0x1F, 1, 1, 0x1F, 0x19, tab_5_05_ref);
+uint8_t crc5_usb(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc5_usb_model, data, length);
 }
 
 /******************************************************************************
@@ -105,19 +469,10 @@ uint8_t crc5_usb(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc6_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x30;  // 0x30 = (reverse 0x03)>>(8-6)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc6_itu_model =
+    CRC_MODEL(6, 0x03, 0x00, 1, 1, 0x00, 0x06, tab_6_03_ref);
+uint8_t crc6_itu(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc6_itu_model, data, length);
 }
 
 /******************************************************************************
@@ -129,19 +484,10 @@ uint8_t crc6_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Use:     MultiMediaCard,SD,ect.
  *****************************************************************************/
-uint8_t crc7_mmc(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x12;  // 0x12 = 0x09<<(8-7)
-            else
-                crc <<= 1;
-        }
-    }
-    return crc >> 1;
+const crc_model_t crc7_mmc_model =
+    CRC_MODEL(7, 0x09, 0x00, 0, 0, 0x00, 0x75, tab_7_09);
+uint8_t crc7_mmc(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc7_mmc_model, data, length);
 }
 
 /******************************************************************************
@@ -153,19 +499,10 @@ uint8_t crc7_mmc(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc8(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x07;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc8_model =
+    CRC_MODEL(8, 0x07, 0x00, 0, 0, 0x00, 0xF4, tab_8_07);
+uint8_t crc8(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc8_model, data, length);
 }
 
 /******************************************************************************
@@ -177,19 +514,10 @@ uint8_t crc8(uint8_t* data, uint16_t length) {
  * Xorout:  0x55
  * Alias:   CRC-8/ATM
  *****************************************************************************/
-uint8_t crc8_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x07;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc ^ 0x55;
+const crc_model_t crc8_itu_model =
+    CRC_MODEL(8, 0x07, 0x00, 0, 0, 0x55, 0xA1, tab_8_07);
+uint8_t crc8_itu(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc8_itu_model, data, length);
 }
 
 /******************************************************************************
@@ -201,19 +529,10 @@ uint8_t crc8_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc8_rohc(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0xFF;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xE0;  // 0xE0 = reverse 0x07
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc8_rohc_model =
+    CRC_MODEL(8, 0x07, 0xFF, 1, 1, 0x00, 0xD0, tab_8_07_ref);
+uint8_t crc8_rohc(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc8_rohc_model, data, length);
 }
 
 /******************************************************************************
@@ -226,19 +545,10 @@ uint8_t crc8_rohc(uint8_t* data, uint16_t length) {
  * Alias:   DOW-CRC,CRC-8/IBUTTON
  * Use:     Maxim(Dallas)'s some devices,e.g. DS18B20
  *****************************************************************************/
-uint8_t crc8_maxim(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x8C;  // 0x8C = reverse 0x31
-            else
-                crc >>= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc8_maxim_model =
+    CRC_MODEL(8, 0x31, 0x00, 1, 1, 0x00, 0xA1, tab_8_31_ref);
+uint8_t crc8_maxim(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc8_maxim_model, data, length);
 }
 
 /******************************************************************************
@@ -250,19 +560,10 @@ uint8_t crc8_maxim(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Alias:   CRC-16,CRC-16/ARC,CRC-16/LHA
  *****************************************************************************/
-uint16_t crc16_ibm(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc16_ibm_model =
+    CRC_MODEL(16, 0x8005, 0x0000, 1, 1, 0x0000, 0xBB3D, tab_16_8005_ref);
+uint16_t crc16_ibm(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_ibm_model, data, length);
 }
 
 /******************************************************************************
@@ -274,19 +575,10 @@ uint16_t crc16_ibm(uint8_t* data, uint16_t length) {
  * Xorout:  0xFFFF
  * Note:
  *****************************************************************************/
-uint16_t crc16_maxim(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^0xffff
+const crc_model_t crc16_maxim_model =
+    CRC_MODEL(16, 0x8005, 0x0000, 1, 1, 0xFFFF, 0x44C2, tab_16_8005_ref);
+uint16_t crc16_maxim(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_maxim_model, data, length);
 }
 
 /******************************************************************************
@@ -298,19 +590,10 @@ uint16_t crc16_maxim(uint8_t* data, uint16_t length) {
  * Xorout:  0xFFFF
  * Note:
  *****************************************************************************/
-uint16_t crc16_usb(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^0xffff
+const crc_model_t crc16_usb_model =
+    CRC_MODEL(16, 0x8005, 0xFFFF, 1, 1, 0xFFFF, 0xB4C8, tab_16_8005_ref);
+uint16_t crc16_usb(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_usb_model, data, length);
 }
 
 /******************************************************************************
@@ -322,19 +605,10 @@ uint16_t crc16_usb(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Note:
  *****************************************************************************/
-uint16_t crc16_modbus(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc16_modbus_model =
+    CRC_MODEL(16, 0x8005, 0xFFFF, 1, 1, 0x0000, 0x4B37, tab_16_8005_ref);
+uint16_t crc16_modbus(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_modbus_model, data, length);
 }
 
 /******************************************************************************
@@ -346,19 +620,10 @@ uint16_t crc16_modbus(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Alias:   CRC-CCITT,CRC-16/CCITT-TRUE,CRC-16/KERMIT
  *****************************************************************************/
-uint16_t crc16_ccitt(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x8408;  // 0x8408 = reverse 0x1021
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc16_ccitt_model =
+    CRC_MODEL(16, 0x1021, 0x0000, 1, 1, 0x0000, 0x2189, tab_16_1021_ref);
+uint16_t crc16_ccitt(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_ccitt_model, data, length);
 }
 
 /******************************************************************************
@@ -370,19 +635,10 @@ uint16_t crc16_ccitt(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Note:
  *****************************************************************************/
-uint16_t crc16_ccitt_false(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  //Initial value
-    while (length--) {
-        crc ^= (uint16_t)(*data++) << 8;  // crc ^= (uint6_t)(*data)<<8; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x1021;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc16_ccitt_false_model =
+    CRC_MODEL(16, 0x1021, 0xFFFF, 0, 0, 0x0000, 0x29B1, tab_16_1021);
+uint16_t crc16_ccitt_false(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_ccitt_false_model, data, length);
 }
 
 /******************************************************************************
@@ -394,19 +650,10 @@ uint16_t crc16_ccitt_false(uint8_t* data, uint16_t length) {
  * Xorout:  0XFFFF
  * Note:
  *****************************************************************************/
-uint16_t crc16_x25(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x8408;  // 0x8408 = reverse 0x1021
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^Xorout
+const crc_model_t crc16_x25_model =
+    CRC_MODEL(16, 0x1021, 0xFFFF, 1, 1, 0xFFFF, 0x906E, tab_16_1021_ref);
+uint16_t crc16_x25(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_x25_model, data, length);
 }
 
 /******************************************************************************
@@ -418,20 +665,10 @@ uint16_t crc16_x25(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Alias:   CRC-16/ZMODEM,CRC-16/ACORN
  *****************************************************************************/
-uint16_t crc16_xmodem(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= (uint16_t)(*data++)
-               << 8;  // crc ^= (uint16_t)(*data)<<8; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x1021;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc16_xmodem_model =
+    CRC_MODEL(16, 0x1021, 0x0000, 0, 0, 0x0000, 0x31C3, tab_16_1021);
+uint16_t crc16_xmodem(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_xmodem_model, data, length);
 }
 
 /******************************************************************************
@@ -443,19 +680,10 @@ uint16_t crc16_xmodem(uint8_t* data, uint16_t length) {
  * Xorout:  0xFFFF
  * Use:     M-Bus,ect.
  *****************************************************************************/
-uint16_t crc16_dnp(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA6BC;  // 0xA6BC = reverse 0x3D65
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^Xorout
+const crc_model_t crc16_dnp_model =
+    CRC_MODEL(16, 0x3D65, 0x0000, 1, 1, 0xFFFF, 0xEA82, tab_16_3d65_ref);
+uint16_t crc16_dnp(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc16_dnp_model, data, length);
 }
 
 /******************************************************************************
@@ -468,20 +696,11 @@ uint16_t crc16_dnp(uint8_t* data, uint16_t length) {
  * Alias:   CRC_32/ADCCP
  * Use:     WinRAR,ect.
  *****************************************************************************/
-uint32_t crc32(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint32_t crc = 0xffffffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc =
-                    (crc >> 1) ^ 0xEDB88320;  // 0xEDB88320= reverse 0x04C11DB7
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;
+const crc_model_t crc32_model =
+    CRC_MODEL(32, 0x04C11DB7, 0xFFFFFFFF, 1, 1, 0xFFFFFFFF,
+              0xCBF43926, tab_32_04c11db7_ref);
+uint32_t crc32(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc32_model, data, length);
 }
 
 /******************************************************************************
@@ -493,18 +712,9 @@ uint32_t crc32(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000000
  * Note:
  *****************************************************************************/
-uint32_t crc32_mpeg_2(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint32_t crc = 0xffffffff;  // Initial value
-    while (length--) {
-        crc ^= (uint32_t)(*data++)
-               << 24;  // crc ^=(uint32_t)(*data)<<24; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 0x80000000)
-                crc = (crc << 1) ^ 0x04C11DB7;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc32_mpeg_2_model =
+    CRC_MODEL(32, 0x04C11DB7, 0xFFFFFFFF, 0, 0, 0x00000000,
+              0x0376E6E7, tab_32_04c11db7);
+uint32_t crc32_mpeg_2(const uint8_t* data, uint32_t length) {
+    return crc_calc(&crc32_mpeg_2_model, data, length);
 }
@@ -1,28 +1,144 @@
 #ifndef __CRCLIB_H__
 #define __CRCLIB_H__
 
-#include "stdint.h"
-
-uint8_t crc4_itu(uint8_t* data, uint16_t length);
-uint8_t crc5_epc(uint8_t* data, uint16_t length);
-uint8_t crc5_itu(uint8_t* data, uint16_t length);
-uint8_t crc5_usb(uint8_t* data, uint16_t length);
-uint8_t crc6_itu(uint8_t* data, uint16_t length);
-uint8_t crc7_mmc(uint8_t* data, uint16_t length);
-uint8_t crc8(uint8_t* data, uint16_t length);
-uint8_t crc8_itu(uint8_t* data, uint16_t length);
-uint8_t crc8_rohc(uint8_t* data, uint16_t length);
-uint8_t crc8_maxim(uint8_t* data, uint16_t length);  //DS18B20
-uint16_t crc16_ibm(uint8_t* data, uint16_t length);
-uint16_t crc16_maxim(uint8_t* data, uint16_t length);
-uint16_t crc16_usb(uint8_t* data, uint16_t length);
-uint16_t crc16_modbus(uint8_t* data, uint16_t length);
-uint16_t crc16_ccitt(uint8_t* data, uint16_t length);
-uint16_t crc16_ccitt_false(uint8_t* data, uint16_t length);
-uint16_t crc16_x25(uint8_t* data, uint16_t length);
-uint16_t crc16_xmodem(uint8_t* data, uint16_t length);
-uint16_t crc16_dnp(uint8_t* data, uint16_t length);
-uint32_t crc32(uint8_t* data, uint16_t length);
-uint32_t crc32_mpeg_2(uint8_t* data, uint16_t length);
+#include "modules.h"
+
+/* Engine selection (one of, default: byte table)
+ *   LIBCRC_CFG_ENGINE_BIT    - bit by bit, no table
+ *   LIBCRC_CFG_ENGINE_NIBBLE - 16 entry table per polynomial (64 bytes)
+ *   LIBCRC_CFG_ENGINE_TABLE  - 256 entry table per polynomial (1 KB)
+ *   LIBCRC_CFG_ENGINE_SLICE8 - 8x256 entry tables per polynomial (8 KB),
+ *                              consumes 8 bytes per iteration
+ * Tables live in RAM and are built on first use, models sharing the same
+ * width/poly/refin share one table. With LIBCRC_CFG_CONST_TABLE the byte
+ * tables of CRC-8/MAXIM, CRC-16/0x8005 and CRC-32 (used by modbus, TinyFrame,
+ * lwpkt and easyflash) are precomputed in flash instead.
+ */
+#if !LIBCRC_CFG_ENGINE_BIT && !LIBCRC_CFG_ENGINE_NIBBLE && \
+    !LIBCRC_CFG_ENGINE_SLICE8
+#undef LIBCRC_CFG_ENGINE_TABLE
+#define LIBCRC_CFG_ENGINE_TABLE 1
+#endif
+
+#if LIBCRC_CFG_ENGINE_NIBBLE
+#define CRC_TABLE_SIZE 16
+#elif LIBCRC_CFG_ENGINE_TABLE
+#define CRC_TABLE_SIZE 256
+#elif LIBCRC_CFG_ENGINE_SLICE8
+#define CRC_TABLE_SIZE (8 * 256)
+#endif
+
+#if !LIBCRC_CFG_ENGINE_TABLE
+#undef LIBCRC_CFG_CONST_TABLE
+#endif
+
+#ifdef CRC_TABLE_SIZE
+typedef struct {
+    volatile uint8_t ready;
+    uint32_t data[CRC_TABLE_SIZE];
+} crc_table_t;
+#define CRC_TABLE_DEF(name) static crc_table_t name
+#define CRC_TABLE_REF(name) (&name)
+#else
+typedef struct crc_table crc_table_t;
+#define CRC_TABLE_DEF(name) extern crc_table_t* const name##_unused
+#define CRC_TABLE_REF(name) NULL
+#endif
+
+/* Parameterized CRC model (Rocksoft model), all values are not reflected */
+typedef struct {
+    uint8_t width;             // 1~32
+    bool refin;                // reflect input bytes
+    bool refout;               // reflect output before xorout
+    uint32_t poly;             // polynomial without the top bit
+    uint32_t init;             // initial register value
+    uint32_t xorout;           // final xor value
+    uint32_t check;            // CRC of "123456789"
+    const crc_table_t* table;  // lookup table (NULL: bit by bit)
+} crc_model_t;
+
+/* Define a model, table may be shared by models with same width/poly/refin
+ * e.g.
+ *   CRC_TABLE_DEF(my_table);
+ *   const crc_model_t my_crc =
+ *       CRC_MODEL(16, 0x8005, 0xFFFF, 1, 1, 0x0000, 0x4B37, my_table);
+ */
+#define CRC_MODEL(width, poly, init, refin, refout, xorout, check, table) \
+    {(width), (refin), (refout), (poly),                                   \
+     (init),  (xorout), (check), CRC_TABLE_REF(table)}
+
+/* Streaming context */
+typedef struct {
+    const crc_model_t* model;
+    uint32_t reg;    // working register
+    uint32_t rpoly;  // poly in register layout (bit by bit only)
+} crc_ctx_t;
+
+void crc_init(crc_ctx_t* ctx, const crc_model_t* model);
+void crc_update(crc_ctx_t* ctx, const void* data, uint32_t length);
+uint32_t crc_final(const crc_ctx_t* ctx);
+uint32_t crc_calc(const crc_model_t* model, const void* data,
+                  uint32_t length);
+void crc_resume(crc_ctx_t* ctx, const crc_model_t* model, uint32_t crc);
+uint32_t crc_continue(const crc_model_t* model, uint32_t crc,
+                      const void* data, uint32_t length);
+void crc_table_init(const crc_model_t* model);
+bool crc_model_verify(const crc_model_t* model);
+
+#if LIBCRC_CFG_HW_HOOK
+/* Hardware CRC hook, called by crc_update() for every model.
+ * `crc` is the running register: the CRC before refout/xorout, right aligned
+ * (for refin models it is already bit reversed, as most CRC peripherals
+ * return it with input/output reversal enabled).
+ * Return false if the model is not supported to fall back to software.
+ */
+typedef bool (*crc_hw_hook_t)(const crc_model_t* model, uint32_t* crc,
+                              const void* data, uint32_t length);
+void crc_set_hw_hook(crc_hw_hook_t hook);
+#endif
+
+extern const crc_model_t crc4_itu_model;
+extern const crc_model_t crc5_epc_model;
+extern const crc_model_t crc5_itu_model;
+extern const crc_model_t crc5_usb_model;
+extern const crc_model_t crc6_itu_model;
+extern const crc_model_t crc7_mmc_model;
+extern const crc_model_t crc8_model;
+extern const crc_model_t crc8_itu_model;
+extern const crc_model_t crc8_rohc_model;
+extern const crc_model_t crc8_maxim_model;
+extern const crc_model_t crc16_ibm_model;
+extern const crc_model_t crc16_maxim_model;
+extern const crc_model_t crc16_usb_model;
+extern const crc_model_t crc16_modbus_model;
+extern const crc_model_t crc16_ccitt_model;
+extern const crc_model_t crc16_ccitt_false_model;
+extern const crc_model_t crc16_x25_model;
+extern const crc_model_t crc16_xmodem_model;
+extern const crc_model_t crc16_dnp_model;
+extern const crc_model_t crc32_model;
+extern const crc_model_t crc32_mpeg_2_model;
+
+uint8_t crc4_itu(const uint8_t* data, uint32_t length);
+uint8_t crc5_epc(const uint8_t* data, uint32_t length);
+uint8_t crc5_itu(const uint8_t* data, uint32_t length);
+uint8_t crc5_usb(const uint8_t* data, uint32_t length);
+uint8_t crc6_itu(const uint8_t* data, uint32_t length);
+uint8_t crc7_mmc(const uint8_t* data, uint32_t length);
+uint8_t crc8(const uint8_t* data, uint32_t length);
+uint8_t crc8_itu(const uint8_t* data, uint32_t length);
+uint8_t crc8_rohc(const uint8_t* data, uint32_t length);
+uint8_t crc8_maxim(const uint8_t* data, uint32_t length);  // DS18B20
+uint16_t crc16_ibm(const uint8_t* data, uint32_t length);
+uint16_t crc16_maxim(const uint8_t* data, uint32_t length);
+uint16_t crc16_usb(const uint8_t* data, uint32_t length);
+uint16_t crc16_modbus(const uint8_t* data, uint32_t length);
+uint16_t crc16_ccitt(const uint8_t* data, uint32_t length);
+uint16_t crc16_ccitt_false(const uint8_t* data, uint32_t length);
+uint16_t crc16_x25(const uint8_t* data, uint32_t length);
+uint16_t crc16_xmodem(const uint8_t* data, uint32_t length);
+uint16_t crc16_dnp(const uint8_t* data, uint32_t length);
+uint32_t crc32(const uint8_t* data, uint32_t length);
+uint32_t crc32_mpeg_2(const uint8_t* data, uint32_t length);
 
 #endif  // __CRCLIB_H__
@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "crcLib.h"
 #include "lwrb.h"
 
 #define LWPKT_IS_VALID(p) ((p) != NULL)
@@ -150,17 +151,9 @@ static uint8_t prv_crc_in(lwpkt_crc_t* crcobj, const void* inp,
         return 0;
     }
 
-    for (size_t i = 0; i < len; ++i, ++p_data) {
-        uint8_t inbyte = *p_data;
-        for (uint8_t j = 8U; j > 0; --j) {
-            uint8_t mix = (uint8_t)(crcobj->crc ^ inbyte) & 0x01U;
-            crcobj->crc >>= 1U;
-            if (mix > 0) {
-                crcobj->crc ^= 0x8CU;
-            }
-            inbyte >>= 0x01U;
-        }
-    }
+    /* CRC-8/MAXIM (poly 0x31 reflected), computed with the libcrc tables */
+    crcobj->crc = (uint8_t)crc_continue(&crc8_maxim_model, crcobj->crc, p_data,
+                                        (uint32_t)len);
     return crcobj->crc;
 }
 
@@ -639,8 +632,8 @@ lwpktr_t lwpkt_write(lwpkt_t* pkt,
                 addr >>= (uint8_t)7U;
             } while (addr > 0);
 #endif
+#endif /* LWPKT_CFG_ADDR_EXTENDED */
         } else {
-#endif /* !LWPKT_CFG_ADDR_EXTENDED */
             WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &pkt->addr, 1);
             WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &to, 1);
         }
@@ -0,0 +1,745 @@
+/**
+ * @file mbus.c
+ * @brief 帧驱动的Modbus RTU/ASCII/TCP引擎
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-28
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "mbus.h"
+
+#include <string.h>
+
+#include "crcLib.h"
+
+#define XFER_FREE 0
+#define XFER_QUEUED 1
+#define XFER_INFLIGHT 2
+
+#define ASCII_FRAME_MAX (MBUS_ADU_MAX * 2 + 1)  // ':' + HEX + CRLF
+#define ASCII_GAP_MS 1000                       // ASCII字符间隔上限
+
+static inline uint16_t get16(const uint8_t* p) {
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static inline void put16(uint8_t* p, uint16_t v) {
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+// 寄存器数组 -> 线上字节序
+static void regs_out(uint8_t* dst, const uint16_t* regs, uint16_t count,
+                     bool be) {
+    if (be) {
+        memcpy(dst, regs, count * 2);
+        return;
+    }
+    for (uint16_t i = 0; i < count; i++) put16(dst + 2 * i, regs[i]);
+}
+
+// 线上字节序 -> 寄存器数组
+static void regs_in(uint16_t* regs, const uint8_t* src, uint16_t count,
+                    bool be) {
+    if (be) {
+        memcpy(regs, src, count * 2);
+        return;
+    }
+    for (uint16_t i = 0; i < count; i++) regs[i] = get16(src + 2 * i);
+}
+
+// TCP没有广播, 地址0与其他地址一样需要应答
+static inline bool is_broadcast(const mbus_t* bus, uint8_t unit) {
+    return unit == MBUS_BROADCAST && bus->mode != MBUS_TCP;
+}
+
+void mbus_init(mbus_t* bus, const mbus_cfg_t* cfg) {
+    memset(bus, 0, sizeof(*bus));
+    bus->mode = cfg->mode;
+    bus->role = cfg->role;
+    bus->unit = cfg->unit;
+    bus->max_inflight = cfg->max_inflight ? cfg->max_inflight : 1;
+    if (bus->max_inflight > MBUS_CFG_QUEUE_LEN)
+        bus->max_inflight = MBUS_CFG_QUEUE_LEN;
+    bus->timeout = cfg->timeout ? cfg->timeout : MBUS_TIMEOUT_MS;
+    uint32_t baud = cfg->baud ? cfg->baud : MBUS_DEFAULT_BAUD;
+    if (bus->mode == MBUS_ASCII) {
+        bus->gap = ASCII_GAP_MS;
+    } else if (baud > 19200) {  // 协议规定高波特率下帧间隔固定为1.75ms
+        bus->gap = 2;
+    } else {  // 3.5字符(每字符11位), 向上取整并多留1ms计时误差
+        bus->gap = (38500 + baud - 1) / baud + 1;
+    }
+    bus->rx = cfg->rx;
+    bus->send = cfg->send;
+    bus->user = cfg->user;
+    bus->rx_time = m_time_ms();
+}
+
+void mbus_set_regmap(mbus_t* bus, const mbus_regblock_t* blocks, uint8_t n,
+                     mbus_write_cb_t on_write) {
+    bus->map = blocks;
+    bus->map_n = n;
+    bus->on_write = on_write;
+}
+
+void mbus_set_gateway(mbus_t* bus, mbus_t* down, mbus_gw_slot_t* slots,
+                      uint8_t n) {
+    bus->gw_down = down;
+    bus->gw_slots = slots;
+    bus->gw_n = n;
+    for (uint8_t i = 0; i < n; i++) slots[i].busy = 0;
+}
+
+/******************************* 帧封装与发送 ********************************/
+
+// 发送缓冲区中PDU的起始偏移
+static inline uint8_t* tx_pdu(mbus_t* bus) {
+#if MBUS_CFG_ENABLE_TCP
+    if (bus->mode == MBUS_TCP)
+        return bus->txbuf + MBUS_MBAP_SIZE;
+#endif
+#if MBUS_CFG_ENABLE_ASCII
+    if (bus->mode == MBUS_ASCII)  // ':' + 地址, 二进制帧原地展开为HEX
+        return bus->txbuf + 2;
+#endif
+    return bus->txbuf + 1;
+}
+
+// 为tx_pdu()中长度为len的PDU加上地址和校验(TCP为MBAP头)并发送
+static void adu_send(mbus_t* bus, uint16_t tid, uint8_t unit, uint16_t len) {
+    uint8_t* buf = bus->txbuf;
+    uint32_t n;
+#if MBUS_CFG_ENABLE_TCP
+    if (bus->mode == MBUS_TCP) {
+        put16(buf, tid);
+        put16(buf + 2, 0);  // 协议标识: Modbus
+        put16(buf + 4, len + 1);
+        buf[6] = unit;
+        n = MBUS_MBAP_SIZE + len;
+    } else
+#endif
+#if MBUS_CFG_ENABLE_ASCII
+    if (bus->mode == MBUS_ASCII) {
+        static const char hex[] = "0123456789ABCDEF";
+        uint8_t* bin = buf + 1;
+        uint8_t lrc = 0;
+        bin[0] = unit;
+        n = len + 1;
+        for (uint32_t i = 0; i < n; i++) lrc += bin[i];
+        bin[n++] = (uint8_t)(-lrc);
+        // 从尾部向前展开, 写入位置(2i+1)总不小于读取位置(i+1)
+        for (uint32_t i = n; i-- > 0;) {
+            uint8_t b = bin[i];
+            buf[2 * i + 1] = hex[b >> 4];
+            buf[2 * i + 2] = hex[b & 0x0F];
+        }
+        buf[0] = ':';
+        n = 2 * n + 1;
+        buf[n++] = '\r';
+        buf[n++] = '\n';
+    } else
+#endif
+    {
+        buf[0] = unit;
+        n = len + 1;
+        uint16_t crc = crc16_modbus(buf, n);
+        buf[n++] = crc & 0xFF;
+        buf[n++] = crc >> 8;
+    }
+    bus->stat.tx_frames++;
+    if (bus->send != NULL)
+        bus->send(bus, buf, n);
+}
+
+/******************************** 从机处理 ***********************************/
+
+static const mbus_regblock_t* find_block(mbus_t* bus, uint8_t type,
+                                         uint16_t addr, uint16_t count) {
+    for (uint8_t i = 0; i < bus->map_n; i++) {
+        const mbus_regblock_t* blk = &bus->map[i];
+        if ((blk->flags & type) && addr >= blk->start &&
+            (uint32_t)addr + count <= (uint32_t)blk->start + blk->count)
+            return blk;
+    }
+    return NULL;
+}
+
+// 处理请求PDU, 在resp中生成响应PDU, 返回响应长度
+static uint16_t slave_handle(mbus_t* bus, const uint8_t* req, uint16_t len,
+                             uint8_t* resp) {
+    uint8_t fc = req[0];
+    uint8_t ex = MBUS_EX_ILLEGAL_VALUE;
+    const mbus_regblock_t* blk;
+    uint16_t addr, count;
+
+    if (len < 5)
+        goto exception;
+    addr = get16(req + 1);
+    count = get16(req + 3);
+    switch (fc) {
+        case MBUS_FC_READ_HOLDING_REGISTERS:
+        case MBUS_FC_READ_INPUT_REGISTERS:
+            if (count == 0 || count > MBUS_READ_MAX)
+                goto exception;
+            blk = find_block(bus,
+                             fc == MBUS_FC_READ_INPUT_REGISTERS
+                                 ? MBUS_REG_INPUT
+                                 : MBUS_REG_HOLDING,
+                             addr, count);
+            if (blk == NULL) {
+                ex = MBUS_EX_ILLEGAL_ADDRESS;
+                goto exception;
+            }
+            resp[0] = fc;
+            resp[1] = count * 2;
+            regs_out(resp + 2, blk->regs + (addr - blk->start), count,
+                     blk->flags & MBUS_REG_BE);
+            return 2 + count * 2;
+        case MBUS_FC_WRITE_SINGLE_REGISTER:
+        case MBUS_FC_WRITE_MULTIPLE_REGISTERS: {
+            const uint8_t* data = req + 3;
+            if (fc == MBUS_FC_WRITE_MULTIPLE_REGISTERS) {
+                if (count == 0 || count > MBUS_WRITE_MAX || len < 6 ||
+                    req[5] != count * 2 || len < 6 + req[5])
+                    goto exception;
+                data = req + 6;
+            } else {
+                count = 1;
+            }
+            blk = find_block(bus, MBUS_REG_HOLDING, addr, count);
+            if (blk == NULL || (blk->flags & MBUS_REG_RDONLY)) {
+                ex = MBUS_EX_ILLEGAL_ADDRESS;
+                goto exception;
+            }
+            regs_in(blk->regs + (addr - blk->start), data, count,
+                    blk->flags & MBUS_REG_BE);
+            if (bus->on_write != NULL)
+                bus->on_write(bus, blk, addr, count);
+            memcpy(resp, req, 5);  // 回显地址与值/个数
+            return 5;
+        }
+        default:
+            ex = MBUS_EX_ILLEGAL_FUNCTION;
+            break;
+    }
+exception:
+    resp[0] = fc | 0x80;
+    resp[1] = ex;
+    return 2;
+}
+
+/******************************** 主机处理 ***********************************/
+
+// 先释放再回调, 回调中可以立即提交新的事务
+static void xfer_done(mbus_t* bus, mbus_xfer_t* x, int result) {
+    mbus_xfer_t done = *x;
+    if (x->state == XFER_INFLIGHT)
+        bus->inflight--;
+    x->state = XFER_FREE;
+    if (done.cb != NULL)
+        done.cb(bus, &done, result);
+}
+
+// 检查响应是否与事务相符, 返回MBUS_OK/异常码/MBUS_ERR_FRAME
+static int xfer_check(const mbus_xfer_t* x, const uint8_t* pdu, uint16_t len) {
+    if (pdu[0] & 0x80)
+        return len >= 2 ? pdu[1] : MBUS_ERR_FRAME;
+    if (x->pdu != NULL)  // 透传, 不检查响应内容
+        return MBUS_OK;
+    switch (x->func) {
+        case MBUS_FC_READ_HOLDING_REGISTERS:
+        case MBUS_FC_READ_INPUT_REGISTERS:
+            if (len >= 2 && pdu[1] == x->count * 2 && len >= 2 + pdu[1])
+                return MBUS_OK;
+            break;
+        case MBUS_FC_WRITE_SINGLE_REGISTER:
+            if (len >= 5 && get16(pdu + 1) == x->addr &&
+                get16(pdu + 3) == x->value)
+                return MBUS_OK;
+            break;
+        case MBUS_FC_WRITE_MULTIPLE_REGISTERS:
+            if (len >= 5 && get16(pdu + 1) == x->addr &&
+                get16(pdu + 3) == x->count)
+                return MBUS_OK;
+            break;
+    }
+    return MBUS_ERR_FRAME;
+}
+
+// TCP按事务标识匹配; 串口上同一从机/功能码有多个在途事务时,
+// 优先匹配响应相符的最早事务, 前面的请求丢失时不会把后面的响应错配给它
+static void master_handle(mbus_t* bus, uint16_t tid, uint8_t unit,
+                          const uint8_t* pdu, uint16_t len) {
+    mbus_xfer_t* found = NULL;
+    int result = MBUS_ERR_FRAME;
+    for (uint8_t i = 0; i < MBUS_CFG_QUEUE_LEN; i++) {
+        mbus_xfer_t* x = &bus->xfers[i];
+        if (x->state != XFER_INFLIGHT || x->unit != unit ||
+            x->func != (pdu[0] & 0x7F) ||
+            (bus->mode == MBUS_TCP && x->seq != tid))
+            continue;
+        int r = xfer_check(x, pdu, len);
+        if (found == NULL ||
+            (r != MBUS_ERR_FRAME) > (result != MBUS_ERR_FRAME) ||
+            ((r != MBUS_ERR_FRAME) == (result != MBUS_ERR_FRAME) &&
+             (int16_t)(x->seq - found->seq) < 0)) {
+            found = x;
+            result = r;
+        }
+    }
+    if (found == NULL)  // 迟到的响应或其他主机的通信
+        return;
+    if (found->pdu != NULL) {
+        if (result >= 0) {
+            memcpy(found->pdu, pdu, len);
+            found->count = len;
+        }
+    } else if (result == MBUS_OK && found->data != NULL &&
+               (found->func == MBUS_FC_READ_HOLDING_REGISTERS ||
+                found->func == MBUS_FC_READ_INPUT_REGISTERS)) {
+        regs_in(found->data, pdu + 2, found->count, false);
+    }
+    xfer_done(bus, found, result);
+}
+
+static void xfer_send(mbus_t* bus, mbus_xfer_t* x) {
+    uint8_t* pdu = tx_pdu(bus);
+    uint16_t len = 5;
+    pdu[0] = x->func;
+    put16(pdu + 1, x->addr);
+    if (x->pdu != NULL) {
+        memcpy(pdu, x->pdu, x->count);
+        len = x->count;
+    } else if (x->func == MBUS_FC_WRITE_SINGLE_REGISTER) {
+        put16(pdu + 3, x->value);
+    } else {
+        put16(pdu + 3, x->count);
+        if (x->func == MBUS_FC_WRITE_MULTIPLE_REGISTERS) {
+            pdu[5] = x->count * 2;
+            regs_out(pdu + 6, x->data, x->count, false);
+            len = 6 + x->count * 2;
+        }
+    }
+    x->state = XFER_INFLIGHT;
+    x->time = m_time_ms();
+    bus->inflight++;
+    adu_send(bus, x->seq, x->unit, len);
+    if (is_broadcast(bus, x->unit))  // 广播没有响应
+        xfer_done(bus, x, MBUS_OK);
+}
+
+// 在途事务数未满时按提交顺序发出排队的请求
+static void xfer_dispatch(mbus_t* bus) {
+    while (bus->inflight < bus->max_inflight) {
+        mbus_xfer_t* next = NULL;
+        for (uint8_t i = 0; i < MBUS_CFG_QUEUE_LEN; i++) {
+            mbus_xfer_t* x = &bus->xfers[i];
+            if (x->state == XFER_QUEUED &&
+                (next == NULL || (int16_t)(x->seq - next->seq) < 0))
+                next = x;
+        }
+        if (next == NULL)
+            return;
+        xfer_send(bus, next);
+    }
+}
+
+static void xfer_check_timeout(mbus_t* bus) {
+    m_time_t now = m_time_ms();
+    for (uint8_t i = 0; i < MBUS_CFG_QUEUE_LEN && bus->inflight; i++) {
+        mbus_xfer_t* x = &bus->xfers[i];
+        if (x->state == XFER_INFLIGHT && now - x->time >= bus->timeout) {
+            bus->stat.timeouts++;
+            xfer_done(bus, x, MBUS_ERR_TIMEOUT);
+        }
+    }
+}
+
+static mbus_xfer_t* xfer_alloc(mbus_t* bus, uint8_t unit, uint8_t fc,
+                               uint16_t addr, uint16_t count, mbus_cb_t cb,
+                               void* arg) {
+    if (bus->role != MBUS_MASTER)
+        return NULL;
+    for (uint8_t i = 0; i < MBUS_CFG_QUEUE_LEN; i++) {
+        mbus_xfer_t* x = &bus->xfers[i];
+        if (x->state == XFER_FREE) {
+            x->unit = unit;
+            x->func = fc;
+            x->addr = addr;
+            x->count = count;
+            x->value = 0;
+            x->data = NULL;
+            x->pdu = NULL;
+            x->cb = cb;
+            x->arg = arg;
+            return x;
+        }
+    }
+    return NULL;
+}
+
+// 加入发送队列, 在途事务数未满时立即发送
+static int xfer_queue(mbus_t* bus, mbus_xfer_t* x) {
+    if (x == NULL)
+        return bus->role == MBUS_MASTER ? MBUS_ERR_BUSY : MBUS_ERR_PARAM;
+    x->seq = bus->seq++;
+    x->state = XFER_QUEUED;
+    int ret = x->seq;
+    xfer_dispatch(bus);
+    return ret;
+}
+
+static int read_regs(mbus_t* bus, uint8_t fc, uint8_t unit, uint16_t addr,
+                     uint16_t count, uint16_t* dst, mbus_cb_t cb, void* arg) {
+    if (count == 0 || count > MBUS_READ_MAX || is_broadcast(bus, unit))
+        return MBUS_ERR_PARAM;
+    mbus_xfer_t* x = xfer_alloc(bus, unit, fc, addr, count, cb, arg);
+    if (x != NULL)
+        x->data = dst;
+    return xfer_queue(bus, x);
+}
+
+int mbus_read_regs(mbus_t* bus, uint8_t unit, uint16_t addr, uint16_t count,
+                   uint16_t* dst, mbus_cb_t cb, void* arg) {
+    return read_regs(bus, MBUS_FC_READ_HOLDING_REGISTERS, unit, addr, count,
+                     dst, cb, arg);
+}
+
+int mbus_read_input_regs(mbus_t* bus, uint8_t unit, uint16_t addr,
+                         uint16_t count, uint16_t* dst, mbus_cb_t cb,
+                         void* arg) {
+    return read_regs(bus, MBUS_FC_READ_INPUT_REGISTERS, unit, addr, count,
+                     dst, cb, arg);
+}
+
+int mbus_write_reg(mbus_t* bus, uint8_t unit, uint16_t addr, uint16_t value,
+                   mbus_cb_t cb, void* arg) {
+    mbus_xfer_t* x = xfer_alloc(bus, unit, MBUS_FC_WRITE_SINGLE_REGISTER, addr,
+                                1, cb, arg);
+    if (x != NULL)
+        x->value = value;
+    return xfer_queue(bus, x);
+}
+
+int mbus_write_regs(mbus_t* bus, uint8_t unit, uint16_t addr, uint16_t count,
+                    const uint16_t* src, mbus_cb_t cb, void* arg) {
+    if (count == 0 || count > MBUS_WRITE_MAX || src == NULL)
+        return MBUS_ERR_PARAM;
+    mbus_xfer_t* x = xfer_alloc(bus, unit, MBUS_FC_WRITE_MULTIPLE_REGISTERS,
+                                addr, count, cb, arg);
+    if (x != NULL)
+        x->data = (uint16_t*)src;
+    return xfer_queue(bus, x);
+}
+
+int mbus_request(mbus_t* bus, uint8_t unit, uint8_t* pdu, uint16_t len,
+                 mbus_cb_t cb, void* arg) {
+    if (pdu == NULL || len == 0 || len > MBUS_PDU_MAX)
+        return MBUS_ERR_PARAM;
+    mbus_xfer_t* x = xfer_alloc(bus, unit, pdu[0], 0, len, cb, arg);
+    if (x != NULL)
+        x->pdu = pdu;
+    return xfer_queue(bus, x);
+}
+
+uint8_t mbus_pending(mbus_t* bus) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MBUS_CFG_QUEUE_LEN; i++)
+        n += bus->xfers[i].state != XFER_FREE;
+    return n;
+}
+
+/******************************** 网关转发 ***********************************/
+
+// 下游事务完成, 将响应以原请求的事务标识/地址返回上游
+static void gw_done(mbus_t* down, const mbus_xfer_t* x, int result) {
+    mbus_gw_slot_t* s = (mbus_gw_slot_t*)x->arg;
+    mbus_t* bus = s->bus;
+    uint8_t* resp = tx_pdu(bus);
+    uint16_t n = 2;
+    s->busy = 0;
+    if (is_broadcast(bus, s->unit) || is_broadcast(down, s->unit))
+        return;
+    if (result >= 0) {  // 正常或异常响应, 原样返回
+        memcpy(resp, x->pdu, x->count);
+        n = x->count;
+    } else {
+        resp[0] = x->func | 0x80;
+        resp[1] = result == MBUS_ERR_TIMEOUT ? MBUS_EX_GATEWAY_TARGET
+                                             : MBUS_EX_GATEWAY_PATH;
+    }
+    adu_send(bus, s->tid, s->unit, n);
+}
+
+static void gw_forward(mbus_t* bus, uint16_t tid, uint8_t unit,
+                       const uint8_t* pdu, uint16_t len) {
+    for (uint8_t i = 0; i < bus->gw_n; i++) {
+        mbus_gw_slot_t* s = &bus->gw_slots[i];
+        if (s->busy)
+            continue;
+        s->bus = bus;
+        s->tid = tid;
+        s->unit = unit;
+        s->busy = 1;
+        memcpy(s->pdu, pdu, len);
+        // 广播在提交时即完成并释放转发槽
+        if (mbus_request(bus->gw_down, unit, s->pdu, len, gw_done, s) >= 0)
+            return;
+        s->busy = 0;
+        break;
+    }
+    if (is_broadcast(bus, unit))
+        return;
+    uint8_t* resp = tx_pdu(bus);
+    resp[0] = pdu[0] | 0x80;
+    resp[1] = MBUS_EX_GATEWAY_PATH;
+    adu_send(bus, tid, unit, 2);
+}
+
+/******************************** 帧接收 *************************************/
+
+// 校验通过的帧, tid为事务标识(仅TCP), unit为地址,
+// pdu/len为去除帧头和校验后的PDU
+static void pdu_input(mbus_t* bus, uint16_t tid, uint8_t unit,
+                      const uint8_t* pdu, uint16_t len) {
+    bus->stat.rx_frames++;
+    if (len == 0)
+        return;
+    if (bus->role == MBUS_MASTER) {
+        master_handle(bus, tid, unit, pdu, len);
+        return;
+    }
+    if (bus->gw_down != NULL && unit != bus->unit) {
+        gw_forward(bus, tid, unit, pdu, len);
+        return;
+    }
+    bool broadcast = is_broadcast(bus, unit);
+    // TCP服务器应答任意地址, 串口从机只处理本机地址和广播
+    if (bus->mode != MBUS_TCP && unit != bus->unit && !broadcast)
+        return;
+    uint16_t n = slave_handle(bus, pdu, len, tx_pdu(bus));
+    if (!broadcast)
+        adu_send(bus, tid, unit, n);
+}
+
+// 根据帧头推算RTU帧长度, 返回0表示帧头不完整, -1表示无法推算
+static int rtu_frame_len(mbus_role_t role, const uint8_t* h, mod_size_t n) {
+    if (n < 2)
+        return 0;
+    uint8_t fc = h[1];
+    if (role == MBUS_SLAVE) {  // 请求帧
+        if (fc >= MBUS_FC_READ_COILS && fc <= MBUS_FC_WRITE_SINGLE_REGISTER)
+            return 8;
+        if (fc == MBUS_FC_WRITE_MULTIPLE_COILS ||
+            fc == MBUS_FC_WRITE_MULTIPLE_REGISTERS)
+            return n < 7 ? 0 : 9 + h[6];
+    } else {  // 响应帧
+        if (fc & 0x80)
+            return 5;
+        if (fc >= MBUS_FC_READ_COILS && fc <= MBUS_FC_READ_INPUT_REGISTERS)
+            return n < 3 ? 0 : 5 + h[2];
+        if (fc == MBUS_FC_WRITE_SINGLE_COIL ||
+            fc == MBUS_FC_WRITE_SINGLE_REGISTER ||
+            fc == MBUS_FC_WRITE_MULTIPLE_COILS ||
+            fc == MBUS_FC_WRITE_MULTIPLE_REGISTERS)
+            return 8;
+    }
+    return -1;
+}
+
+// idle: 接收FIFO已静默超过帧间隔, 剩余数据不会再增长
+static void rtu_poll(mbus_t* bus, bool idle) {
+    lfifo_t* rx = bus->rx;
+    for (;;) {
+        mod_size_t used = LFifo_GetUsed(rx);
+        if (used == 0)
+            return;
+        mod_size_t lin;
+        uint8_t* p = LFifo_AcquireLinearRead(rx, &lin);
+        uint8_t hdr[7];
+        const uint8_t* h = p;
+        mod_size_t hn = used < sizeof(hdr) ? used : sizeof(hdr);
+        if (lin < hn) {
+            LFifo_Peek(rx, 0, hdr, hn);
+            h = hdr;
+        }
+        int len = rtu_frame_len(bus->role, h, hn);
+        if (len > MBUS_ADU_MAX) {  // 字节数字段超出帧长上限, 不是有效帧头
+            LFifo_Read(rx, NULL, 1);
+            bus->stat.rx_errors++;
+            continue;
+        }
+        if (len < 0) {  // 无法推算长度, 以帧间隔为界
+            if (!idle)
+                return;
+            len = used > MBUS_ADU_MAX ? MBUS_ADU_MAX : used;
+        } else if (len == 0 || (mod_size_t)len > used) {  // 帧未接收完
+            if (!idle)
+                return;
+            // 已静默, 为残帧或干扰, 丢弃一字节后重新同步
+            len = 1;
+        }
+        const uint8_t* f = p;
+        if ((mod_size_t)len > lin) {  // 跨越FIFO边界
+            LFifo_Peek(rx, 0, bus->rxbuf, len);
+            f = bus->rxbuf;
+        }
+        if (len < 4 || crc16_modbus(f, len) != 0) {  // 丢弃一字节, 重新同步
+            LFifo_Read(rx, NULL, 1);
+            bus->stat.rx_errors++;
+            continue;
+        }
+        pdu_input(bus, 0, f[0], f + 1, len - 3);
+        LFifo_Read(rx, NULL, len);
+    }
+}
+
+#if MBUS_CFG_ENABLE_ASCII
+static inline int hex_val(uint8_t c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// 将FIFO中[1, 1+chars)的HEX字符解码到rxbuf, 返回字节数, 出错返回-1
+static int ascii_decode(mbus_t* bus, mod_size_t chars) {
+    uint8_t tmp[32];
+    mod_size_t pos = 1;
+    int n = 0;
+    if ((chars & 1) || chars / 2 > MBUS_ADU_MAX)
+        return -1;
+    while (chars) {
+        mod_size_t len = chars < sizeof(tmp) ? chars : sizeof(tmp);
+        LFifo_Peek(bus->rx, pos, tmp, len);
+        for (mod_size_t i = 0; i < len; i += 2) {
+            int hi = hex_val(tmp[i]), lo = hex_val(tmp[i + 1]);
+            if (hi < 0 || lo < 0)
+                return -1;
+            bus->rxbuf[n++] = (hi << 4) | lo;
+        }
+        pos += len;
+        chars -= len;
+    }
+    return n;
+}
+
+static void ascii_poll(mbus_t* bus, bool idle) {
+    lfifo_t* rx = bus->rx;
+    uint8_t c;
+    for (;;) {
+        mod_size_t used = LFifo_GetUsed(rx);
+        if (used == 0)
+            return;
+        if (LFifo_PeekByte(rx, 0) != ':') {  // 丢弃起始符之前的数据
+            c = ':';
+            mod_offset_t s = LFifo_Find(rx, &c, 1, 1);
+            LFifo_Read(rx, NULL, s < 0 ? used : (mod_size_t)s);
+            bus->rx_scan = 0;
+            continue;
+        }
+        c = '\n';
+        mod_offset_t e = LFifo_Find(rx, &c, 1, bus->rx_scan + !bus->rx_scan);
+        if (e < 0) {
+            if (idle || used >= ASCII_FRAME_MAX) {  // 残帧或超长, 丢弃起始符
+                LFifo_Read(rx, NULL, 1);
+                bus->stat.rx_errors++;
+                bus->rx_scan = 0;
+                continue;
+            }
+            bus->rx_scan = used;
+            return;
+        }
+        bus->rx_scan = 0;
+        int n = -1;
+        if (e >= 2 && LFifo_PeekByte(rx, e - 1) == '\r')
+            n = ascii_decode(bus, e - 2);
+        uint8_t lrc = 0;
+        for (int i = 0; i < n; i++) lrc += bus->rxbuf[i];
+        if (n < 3 || lrc != 0) {  // 校验失败, 从下一个起始符重新同步
+            LFifo_Read(rx, NULL, 1);
+            bus->stat.rx_errors++;
+            continue;
+        }
+        LFifo_Read(rx, NULL, e + 1);
+        pdu_input(bus, 0, bus->rxbuf[0], bus->rxbuf + 1, n - 2);
+    }
+}
+#endif  // MBUS_CFG_ENABLE_ASCII
+
+#if MBUS_CFG_ENABLE_TCP
+// TCP为可靠字节流, 按MBAP头中的长度分帧, 不依赖帧间隔
+static void tcp_poll(mbus_t* bus) {
+    lfifo_t* rx = bus->rx;
+    for (;;) {
+        mod_size_t used = LFifo_GetUsed(rx);
+        if (used < MBUS_MBAP_SIZE)
+            return;
+        mod_size_t lin;
+        uint8_t* p = LFifo_AcquireLinearRead(rx, &lin);
+        uint8_t hdr[MBUS_MBAP_SIZE];
+        const uint8_t* h = p;
+        if (lin < MBUS_MBAP_SIZE) {
+            LFifo_Peek(rx, 0, hdr, MBUS_MBAP_SIZE);
+            h = hdr;
+        }
+        uint16_t len = get16(h + 4);  // 地址 + PDU
+        if (get16(h + 2) != 0 || len < 2 || len > MBUS_PDU_MAX + 1) {
+            // 协议标识/长度非法, 字节流已失步, 丢弃一字节重新同步
+            LFifo_Read(rx, NULL, 1);
+            bus->stat.rx_errors++;
+            continue;
+        }
+        mod_size_t total = MBUS_MBAP_SIZE - 1 + len;
+        if (used < total)
+            return;
+        const uint8_t* f = p;
+        if (total > lin) {
+            LFifo_Peek(rx, 0, bus->rxbuf, total);
+            f = bus->rxbuf;
+        }
+        pdu_input(bus, get16(f), f[6], f + MBUS_MBAP_SIZE, len - 1);
+        LFifo_Read(rx, NULL, total);
+    }
+}
+#endif  // MBUS_CFG_ENABLE_TCP
+
+void mbus_poll(mbus_t* bus) {
+    m_time_t now = m_time_ms();
+    mod_size_t used = LFifo_GetUsed(bus->rx);
+    bool idle = false;
+    if (used != bus->rx_used) {
+        bus->rx_used = used;
+        bus->rx_time = now;
+    } else if (used && now - bus->rx_time >= bus->gap) {
+        idle = true;
+    }
+    if (used) {
+#if MBUS_CFG_ENABLE_TCP
+        if (bus->mode == MBUS_TCP)
+            tcp_poll(bus);
+        else
+#endif
+#if MBUS_CFG_ENABLE_ASCII
+        if (bus->mode == MBUS_ASCII)
+            ascii_poll(bus, idle);
+        else
+#endif
+            rtu_poll(bus, idle);
+        used = LFifo_GetUsed(bus->rx);
+        if (used != bus->rx_used) {  // 已取出完整帧, 剩余数据重新计时
+            bus->rx_used = used;
+            bus->rx_time = now;
+        }
+    }
+    if (bus->role == MBUS_MASTER) {
+        xfer_check_timeout(bus);
+        xfer_dispatch(bus);
+    }
+}
@@ -0,0 +1,285 @@
+/**
+ * @file mbus.h
+ * @brief 帧驱动的Modbus RTU/ASCII/TCP引擎
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-28
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __MBUS_H__
+#define __MBUS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfifo.h"
+#include "modules.h"
+
+/**** 与modbus.c的区别 ****
+ * 1. 接收数据由外部写入lfifo(如uart_fifo_rx_init), 引擎按功能码推算帧长,
+ *    在FIFO的连续区域内直接校验/解析, 只有跨越FIFO边界的帧才复制一次;
+ *    无法推算长度的帧以帧间隔(RTU为3.5字符, ASCII为1s)为界
+ * 2. 主机请求以事务描述符排队, 可同时向多个从机发出max_inflight个请求,
+ *    响应按(从机地址, 功能码)匹配最早的在途事务, 读取结果直接写入用户缓冲区;
+ *    RS-485等半双工总线上从机应答会与主机发送冲突, max_inflight必须为1,
+ *    仅全双工链路(RS-232/RS-422/虚拟串口)可以流水线发送
+ * 3. 从机寄存器以块(mbus_regblock_t)映射, 一次请求只做一次查找和拷贝,
+ *    MBUS_REG_BE块按线上字节序保存, 直接memcpy
+ * 4. mbus_poll可在接收回调中调用, 也可在主循环中调用
+ * 5. RTU/ASCII/TCP(MBAP)只是帧封装不同, 共用同一套PDU处理; TCP模式下主机
+ *    以事务标识(即提交序号)匹配响应, 在途事务数不受总线限制
+ * 6. 从机可设置网关(mbus_set_gateway), 非本机地址的请求透传到下游主机实例,
+ *    如将多个TCP连接桥接到同一条串口总线
+ */
+
+#ifndef MBUS_CFG_QUEUE_LEN
+#define MBUS_CFG_QUEUE_LEN 8  // 主机事务队列长度(排队+在途)
+#endif
+#ifndef MBUS_CFG_ENABLE_ASCII
+#define MBUS_CFG_ENABLE_ASCII 1
+#endif
+#ifndef MBUS_CFG_ENABLE_TCP
+#define MBUS_CFG_ENABLE_TCP 1
+#endif
+
+#define MBUS_PDU_MAX 253     // PDU最大长度
+#define MBUS_ADU_MAX 256     // RTU帧最大长度: 地址 + PDU + CRC
+#define MBUS_READ_MAX 125    // 一次最多读取的寄存器个数
+#define MBUS_WRITE_MAX 123   // 一次最多写入的寄存器个数
+#define MBUS_BROADCAST 0     // 广播地址, 从机不应答
+#define MBUS_TIMEOUT_MS 100  // 默认主机响应超时(ms)
+#define MBUS_DEFAULT_BAUD 9600
+#define MBUS_MBAP_SIZE 7  // MBAP头: 事务标识 + 协议标识 + 长度 + 地址
+#define MBUS_TCP_ADU_MAX (MBUS_MBAP_SIZE + MBUS_PDU_MAX)
+
+/* 功能码 */
+#define MBUS_FC_READ_COILS 0x01
+#define MBUS_FC_READ_DISCRETE_INPUTS 0x02
+#define MBUS_FC_READ_HOLDING_REGISTERS 0x03
+#define MBUS_FC_READ_INPUT_REGISTERS 0x04
+#define MBUS_FC_WRITE_SINGLE_COIL 0x05
+#define MBUS_FC_WRITE_SINGLE_REGISTER 0x06
+#define MBUS_FC_WRITE_MULTIPLE_COILS 0x0F
+#define MBUS_FC_WRITE_MULTIPLE_REGISTERS 0x10
+
+/* 从机异常码, 作为主机回调的result(>0)返回 */
+#define MBUS_EX_ILLEGAL_FUNCTION 0x01
+#define MBUS_EX_ILLEGAL_ADDRESS 0x02
+#define MBUS_EX_ILLEGAL_VALUE 0x03
+#define MBUS_EX_DEVICE_FAILURE 0x04
+#define MBUS_EX_DEVICE_BUSY 0x06
+#define MBUS_EX_GATEWAY_PATH 0x0A    // 网关: 没有空闲的转发槽/下游队列已满
+#define MBUS_EX_GATEWAY_TARGET 0x0B  // 网关: 下游从机未应答
+
+/* 主机回调的result(<0)及接口返回值 */
+#define MBUS_OK 0
+#define MBUS_ERR_TIMEOUT -1  // 等待响应超时
+#define MBUS_ERR_FRAME -2    // 响应与请求不符
+#define MBUS_ERR_BUSY -3     // 事务队列已满
+#define MBUS_ERR_PARAM -4    // 参数错误
+
+/* 寄存器块属性 */
+#define MBUS_REG_HOLDING 0x01  // 保持寄存器(功能码03/06/16)
+#define MBUS_REG_INPUT 0x02    // 输入寄存器(功能码04)
+#define MBUS_REG_RDONLY 0x04   // 只读, 写请求返回非法地址
+#define MBUS_REG_BE 0x08       // 数组按大端(线上字节序)保存
+
+typedef enum { MBUS_RTU, MBUS_ASCII, MBUS_TCP } mbus_mode_t;
+typedef enum { MBUS_MASTER, MBUS_SLAVE } mbus_role_t;
+
+typedef struct mbus mbus_t;
+typedef struct mbus_xfer mbus_xfer_t;
+
+/**
+ * @brief 主机事务完成回调
+ * @param  result  MBUS_OK成功, <0为MBUS_ERR_xxx, >0为从机返回的异常码
+ */
+typedef void (*mbus_cb_t)(mbus_t* bus, const mbus_xfer_t* xfer, int result);
+
+struct mbus_xfer {   // 主机事务
+    uint8_t unit;    // 从机地址
+    uint8_t func;    // 功能码
+    uint16_t addr;   // 寄存器首地址
+    uint16_t count;  // 寄存器个数 / 透传PDU长度
+    uint16_t value;  // 写单个寄存器的值
+    uint16_t* data;  // 读: 结果缓冲区, 写多个: 待写入数据
+    uint8_t* pdu;    // 透传: 请求PDU, 完成后为响应PDU
+    mbus_cb_t cb;    // 完成回调
+    void* arg;       // 用户参数
+    m_time_t time;   // 发送时刻
+    uint16_t seq;    // 提交序号, 保证先进先出, TCP模式下即事务标识
+    uint8_t state;   // 空闲/排队/在途
+};
+
+typedef struct {     // 寄存器块
+    uint16_t start;  // 首地址
+    uint16_t count;  // 寄存器个数
+    uint16_t* regs;  // 寄存器数组
+    uint8_t flags;   // MBUS_REG_xxx
+} mbus_regblock_t;
+
+/**
+ * @brief 从机寄存器写入回调, 在写入寄存器块之后、应答之前调用
+ */
+typedef void (*mbus_write_cb_t)(mbus_t* bus, const mbus_regblock_t* blk,
+                                uint16_t addr, uint16_t count);
+
+typedef struct {   // 网关转发槽
+    mbus_t* bus;   // 接收请求的实例
+    uint16_t tid;  // 请求的事务标识(TCP)
+    uint8_t unit;  // 请求的从机地址
+    uint8_t busy;
+    uint8_t pdu[MBUS_PDU_MAX];
+} mbus_gw_slot_t;
+
+typedef struct {
+    uint32_t rx_frames;  // 接收到的有效帧数
+    uint32_t rx_errors;  // 校验失败/残帧次数
+    uint32_t tx_frames;  // 发送帧数
+    uint32_t timeouts;   // 主机等待响应超时次数
+} mbus_stat_t;
+
+typedef struct {
+    mbus_mode_t mode;      // RTU / ASCII / TCP
+    mbus_role_t role;      // 主机 / 从机
+    uint8_t unit;          // 本机地址(从机)
+    uint8_t max_inflight;  // 主机同时等待响应的事务数(0: 1, 半双工总线为1)
+    uint32_t baud;         // 波特率, 用于计算帧间隔(0: 9600)
+    m_time_t timeout;      // 主机响应超时(ms, 0: MBUS_TIMEOUT_MS)
+    lfifo_t* rx;           // 接收FIFO, 由外部写入
+    void* user;            // 用户参数
+    // 发送接口, 返回后缓冲区即被复用
+    void (*send)(mbus_t* bus, const uint8_t* data, uint32_t len);
+} mbus_cfg_t;
+
+struct mbus {
+    mbus_mode_t mode;
+    mbus_role_t role;
+    uint8_t unit;
+    uint8_t max_inflight;
+    uint8_t inflight;  // 在途事务数
+    uint16_t seq;      // 下一个事务序号
+    m_time_t timeout;  // 主机响应超时(ms)
+    m_time_t gap;      // 帧间隔(ms)
+    lfifo_t* rx;
+    void (*send)(mbus_t* bus, const uint8_t* data, uint32_t len);
+    void* user;
+    mod_size_t rx_used;          // 上次检查时接收FIFO中的数据量
+    mod_size_t rx_scan;          // ASCII: 已查找过结束符的长度
+    m_time_t rx_time;            // 接收FIFO数据量最近一次变化的时刻
+    const mbus_regblock_t* map;  // 从机寄存器映射
+    uint8_t map_n;
+    mbus_write_cb_t on_write;
+    mbus_t* gw_down;  // 网关下游主机实例
+    mbus_gw_slot_t* gw_slots;
+    uint8_t gw_n;
+    mbus_xfer_t xfers[MBUS_CFG_QUEUE_LEN];
+    mbus_stat_t stat;
+#if MBUS_CFG_ENABLE_TCP
+    uint8_t rxbuf[MBUS_TCP_ADU_MAX];  // 跨越FIFO边界的帧 / ASCII解码结果
+#else
+    uint8_t rxbuf[MBUS_ADU_MAX];
+#endif
+#if MBUS_CFG_ENABLE_ASCII
+    uint8_t txbuf[MBUS_ADU_MAX * 2 + 1];  // ':' + HEX + CRLF
+#elif MBUS_CFG_ENABLE_TCP
+    uint8_t txbuf[MBUS_TCP_ADU_MAX];
+#else
+    uint8_t txbuf[MBUS_ADU_MAX];
+#endif
+};
+
+/**
+ * @brief 初始化Modbus实例
+ * @param  bus              实例
+ * @param  cfg              配置, 初始化后不再引用
+ */
+extern void mbus_init(mbus_t* bus, const mbus_cfg_t* cfg);
+
+/**
+ * @brief 处理接收FIFO中的完整帧, 检查超时, 发出排队的请求
+ * @note 可在接收回调/空闲中断之后调用, 也可在主循环中周期调用;
+ * 不可与其他mbus接口并发调用
+ */
+extern void mbus_poll(mbus_t* bus);
+
+/**
+ * @brief 设置从机寄存器映射
+ * @param  blocks           寄存器块数组, 需在实例生命周期内有效
+ * @param  n                寄存器块个数
+ * @param  on_write         写入回调, 可为NULL
+ * @note 一次请求访问的寄存器必须位于同一个块内, 否则返回非法地址
+ */
+extern void mbus_set_regmap(mbus_t* bus, const mbus_regblock_t* blocks,
+                            uint8_t n, mbus_write_cb_t on_write);
+
+/**
+ * @brief 设置从机网关, 地址不是本机的请求透传到下游主机实例
+ * @param  down             下游主机实例, NULL则关闭网关
+ * @param  slots            转发槽数组, 决定可同时转发的请求数
+ * @param  n                转发槽个数
+ * @note 下游响应按原样(包括异常响应)返回, 超时返回MBUS_EX_GATEWAY_TARGET,
+ * 没有空闲转发槽或下游队列已满返回MBUS_EX_GATEWAY_PATH; 广播请求只转发不应答;
+ * 下游超时应小于上游主机的超时
+ */
+extern void mbus_set_gateway(mbus_t* bus, mbus_t* down, mbus_gw_slot_t* slots,
+                             uint8_t n);
+
+/**
+ * @brief 读保持寄存器(03) / 输入寄存器(04)
+ * @param  unit             从机地址
+ * @param  addr             寄存器首地址
+ * @param  count            寄存器个数(1~MBUS_READ_MAX)
+ * @param  dst              结果缓冲区, 需保持有效直到回调
+ * @param  cb               完成回调, 可为NULL
+ * @param  arg              用户参数, 通过xfer->arg传回
+ * @retval int              事务序号(>=0), 失败返回MBUS_ERR_xxx
+ */
+extern int mbus_read_regs(mbus_t* bus, uint8_t unit, uint16_t addr,
+                          uint16_t count, uint16_t* dst, mbus_cb_t cb,
+                          void* arg);
+extern int mbus_read_input_regs(mbus_t* bus, uint8_t unit, uint16_t addr,
+                                uint16_t count, uint16_t* dst, mbus_cb_t cb,
+                                void* arg);
+
+/**
+ * @brief 写单个寄存器(06)
+ * @retval int              事务序号(>=0), 失败返回MBUS_ERR_xxx
+ */
+extern int mbus_write_reg(mbus_t* bus, uint8_t unit, uint16_t addr,
+                          uint16_t value, mbus_cb_t cb, void* arg);
+
+/**
+ * @brief 写多个寄存器(16)
+ * @param  src              待写入数据(1~MBUS_WRITE_MAX个), 需保持有效直到回调
+ * @retval int              事务序号(>=0), 失败返回MBUS_ERR_xxx
+ */
+extern int mbus_write_regs(mbus_t* bus, uint8_t unit, uint16_t addr,
+                           uint16_t count, const uint16_t* src, mbus_cb_t cb,
+                           void* arg);
+
+/**
+ * @brief 透传任意功能码的请求PDU
+ * @param  pdu              请求PDU, 缓冲区大小需为MBUS_PDU_MAX,
+ *                          需保持有效直到回调, 响应PDU(包括异常响应)写回其中
+ * @param  len              请求PDU长度
+ * @retval int              事务序号(>=0), 失败返回MBUS_ERR_xxx
+ * @note 回调中xfer->pdu/xfer->count为响应PDU及其长度;
+ * 无法按功能码推算长度的RTU响应以帧间隔为界
+ */
+extern int mbus_request(mbus_t* bus, uint8_t unit, uint8_t* pdu, uint16_t len,
+                        mbus_cb_t cb, void* arg);
+
+/**
+ * @brief 获取未完成(排队+在途)的主机事务数
+ */
+extern uint8_t mbus_pending(mbus_t* bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __MBUS_H__
@@ -2,6 +2,8 @@
 
 #include <string.h>
 
+#include "crcLib.h"
+
 #define LOG_MODULE "modbus"
 #include "log.h"
 
@@ -95,61 +97,39 @@ void ModBus_setTimeout(ModBus_parameter* ModBus_para, u32 receiveTimeout,
 // and place it to end.
 // return total length
 static size_t GenCRC16(uint8_t* buff, size_t len) {
-    uint16_t crc = 0xFFFF;
-    uint16_t pos = 0;
-    uint8_t i = 0;
-    uint8_t lo = 0;
-    uint8_t hi = 0;
-
-    for (pos = 0; pos < len; pos++) {
-        crc ^= buff[pos];
-
-        for (i = 8; i != 0; i--) {
-            if ((crc & 0x0001) != 0) {
-                crc >>= 1;
-                crc ^= 0xA001;
-            } else
-                crc >>= 1;
-        }
-    }
-    lo = crc & 0xFF;
-    hi = (crc >> 8) & 0xFF;
-
-    buff[len++] = lo;
-    buff[len++] = hi;
+    uint16_t crc = crc16_modbus(buff, len);
+    buff[len++] = crc & 0xFF;
+    buff[len++] = (crc >> 8) & 0xFF;
     return len;
 }
 
-// RTU模式时, 计算CRC校验码, 给定初值
-// Calculate CRC fro incoming buffer
-// Return 1 - if CRC is correct, overwise return 0
-static uint8_t CheckCRC16(uint8_t* buff, size_t len) {
-    uint16_t crc = 0xFFFF;
-    uint16_t pos = 0;
-    uint8_t i = 0;
-    uint8_t lo = 0;
-    uint8_t hi = 0;
-
-    for (pos = 0; pos < len - 2; pos++) {
-        crc ^= buff[pos];
-
-        for (i = 8; i != 0; i--) {
-            if ((crc & 0x0001) != 0) {
-                crc >>= 1;
-                crc ^= 0xA001;
-            } else
-                crc >>= 1;
-        }
-    }
-    lo = crc & 0xFF;
-    hi = (crc >> 8) & 0xFF;
-    if ((buff[len - 2] == lo) && (buff[len - 1] == hi)) {
-        return 1;
+#define CRC16_FULL_OK 0x01    // 整帧校验通过
+#define CRC16_PREFIX_OK 0x02  // 前缀帧校验通过
+
+// RTU模式时, 校验数据帧(含尾部校验码), 整帧的CRC结果为0即校验通过
+// 给定prefix(0 < prefix < len)时同时校验长度为prefix的前缀帧,
+// 两者共用一次CRC计算
+// Return CRC16_FULL_OK / CRC16_PREFIX_OK bits
+static uint8_t CheckCRC16(const uint8_t* buff, size_t len, size_t prefix) {
+    crc_ctx_t ctx;
+    uint8_t ret = 0;
+
+    crc_init(&ctx, &crc16_modbus_model);
+    if (prefix > 0 && prefix < len) {
+        crc_update(&ctx, buff, prefix);
+        if (prefix >= 2 && crc_final(&ctx) == 0)
+            ret |= CRC16_PREFIX_OK;
+        crc_update(&ctx, buff + prefix, len - prefix);
+    } else {
+        crc_update(&ctx, buff, len);
     }
+    if (len >= 2 && crc_final(&ctx) == 0)
+        ret |= CRC16_FULL_OK;
 #ifdef _UNIT_TEST
-    printf("CRC Check ERROR\n");
+    if (!ret)
+        printf("CRC Check ERROR\n");
 #endif  // _UNIT_TEST
-    return 0;
+    return ret;
 }
 
 // ASCII模式时, 产生LRC校验码并添加到数据尾部
@@ -452,8 +432,8 @@ static uint8_t ModBus_detectFrame(ModBus_parameter* ModBus_para,
                 return 0;
             }
             if (!(isTimeout  // 接收超时
-                  || frameSize > 0 && ModBus_para->m_receiveFrameBufferLen >=
-                                          frameSize  // 数据包足够
+                  || (frameSize > 0 && ModBus_para->m_receiveFrameBufferLen >=
+                                           frameSize)  // 数据包足够
                   || ModBus_para->m_receiveFrameBufferLen >=
                          MODBUS_BUFFER_SIZE))  // 缓冲区满
             {
@@ -467,33 +447,30 @@ static uint8_t ModBus_detectFrame(ModBus_parameter* ModBus_para,
                 ModBus_para->m_receiveFrameBufferLen = 0;
                 return 0;
             }
-            if (!CheckCRC16(
-                    ModBus_para->m_receiveFrameBuffer,
-                    ModBus_para->m_receiveFrameBufferLen))  // 如果校验不通过
+            uint8_t crcResult =
+                CheckCRC16(ModBus_para->m_receiveFrameBuffer,
+                           ModBus_para->m_receiveFrameBufferLen, frameSize);
+            if (!(crcResult & CRC16_FULL_OK))  // 如果校验不通过
             {
-                if (frameSize > 0 &&
-                    frameSize <
-                        ModBus_para
-                            ->m_receiveFrameBufferLen)  // 如果数据长度比m_responseFrameLen长,
+                // 如果数据长度比m_responseFrameLen长,
                 // 则尝试以m_responseFrameLen长度接收
+                if (!(crcResult & CRC16_PREFIX_OK))  // 如果校验不通过,
+                // 不为超时或缓冲区满则返回继续接收
                 {
-                    if (!CheckCRC16(ModBus_para->m_receiveFrameBuffer,
-                                    frameSize))  // 如果校验不通过,
-                    // 不为超时或缓冲区满则返回继续接收
-                    {
+                    if (frameSize > 0 &&
+                        frameSize < ModBus_para->m_receiveFrameBufferLen) {
                         if (isTimeout || ModBus_para->m_receiveFrameBufferLen >=
                                              MODBUS_BUFFER_SIZE)
                             ModBus_para->m_receiveFrameBufferLen = 0;
-                        return 0;
+                    } else {
+                        ModBus_para->m_receiveFrameBufferLen = 0;
                     }
-
-                    *restSize = ModBus_para->m_receiveFrameBufferLen -
-                                frameSize;  // 待保留的数据长度
-                    ModBus_para->m_receiveFrameBufferLen = frameSize;
-                } else {
-                    ModBus_para->m_receiveFrameBufferLen = 0;
                     return 0;
                 }
+
+                *restSize = ModBus_para->m_receiveFrameBufferLen -
+                            frameSize;  // 待保留的数据长度
+                ModBus_para->m_receiveFrameBufferLen = frameSize;
             }
             ModBus_para->m_receiveFrameBufferLen--;  // 去除校验码
             ModBus_para->m_hasDetectedBufferStart = 0;
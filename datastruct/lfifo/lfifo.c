@@ -13,32 +13,304 @@
 
 #define _INLINE __attribute__((always_inline)) inline
 
+#if LFIFO_CFG_POW2
+#define LFIFO_IDX(fifo, i) ((mod_size_t)(i) & (fifo)->mask)
+#else
+#define LFIFO_IDX(fifo, i) ((mod_size_t)(i) % (fifo)->size)
+#endif
+
+#if LFIFO_CFG_MP  // 指针低24位为位置, 高8位为预留/提交计数
+#define LFIFO_POS_MASK ((mod_size_t)0x00FFFFFF)
+#define LFIFO_CNT_ONE ((mod_size_t)0x01000000)
+#define LFIFO_MAX_SIZE ((mod_size_t)1 << 23)
+#define LFIFO_POS(v) ((mod_size_t)(v) & LFIFO_POS_MASK)
+#else
+#define LFIFO_POS(v) ((mod_size_t)(v))
+#endif
+
+static void lfifo_reset(lfifo_t* fifo) {
+    MOD_ATOMIC_INIT(fifo->wr, 0);
+    MOD_ATOMIC_INIT(fifo->rd, 0);
+#if LFIFO_CFG_POW2
+    fifo->rd_cache = 0;
+    fifo->wr_cache = 0;
+#endif
+#if LFIFO_CFG_MP
+    MOD_ATOMIC_INIT(fifo->wr_head, 0);
+    MOD_ATOMIC_INIT(fifo->rd_head, 0);
+#endif
+}
+
+#if LFIFO_CFG_POW2
+int LFifo_Init(lfifo_t* fifo, mod_size_t size) {
+    mod_size_t cap = 1;
+#if LFIFO_CFG_MP
+    if (size > LFIFO_MAX_SIZE) {
+        return -1;
+    }
+#endif
+    while (cap < size) {
+        cap <<= 1;
+    }
+    fifo->buf = m_alloc(cap);
+    if (fifo->buf == NULL) {
+        return -1;
+    }
+    fifo->size = cap;
+    fifo->mask = cap - 1;
+    lfifo_reset(fifo);
+    return 0;
+}
+#else
 int LFifo_Init(lfifo_t* fifo, mod_size_t size) {
     fifo->buf = m_alloc(size + 1);
     if (fifo->buf == NULL) {
         return -1;
     }
     fifo->size = size + 1;
-    MOD_ATOMIC_INIT(fifo->wr, 0);
-    MOD_ATOMIC_INIT(fifo->rd, 0);
+    lfifo_reset(fifo);
     return 0;
 }
+#endif
 
 void LFifo_Destory(lfifo_t* fifo) {
     m_free(fifo->buf);
     fifo->buf = NULL;
     fifo->size = 0;
-    MOD_ATOMIC_INIT(fifo->wr, 0);
-    MOD_ATOMIC_INIT(fifo->rd, 0);
+#if LFIFO_CFG_POW2
+    fifo->mask = 0;
+#endif
+    lfifo_reset(fifo);
 }
 
 void LFifo_AssignBuf(lfifo_t* fifo, uint8_t* buffer, mod_size_t size) {
     fifo->buf = buffer;
+#if LFIFO_CFG_POW2
+#if LFIFO_CFG_MP
+    if (size > LFIFO_MAX_SIZE) {
+        size = LFIFO_MAX_SIZE;
+    }
+#endif
+    while (size & (size - 1)) {  // 取不超过size的最大2的幂
+        size &= size - 1;
+    }
+    fifo->mask = size ? size - 1 : 0;
+#endif
     fifo->size = size;
-    MOD_ATOMIC_INIT(fifo->wr, 0);
-    MOD_ATOMIC_INIT(fifo->rd, 0);
+    lfifo_reset(fifo);
 }
 
+#if LFIFO_CFG_POW2
+
+_INLINE mod_size_t LFifo_GetSize(lfifo_t* fifo) {
+    return fifo->size;
+}
+
+_INLINE mod_size_t LFifo_GetUsed(lfifo_t* fifo) {
+    // 先读rd再读wr, 保证差值非负
+    mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
+    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_ACQUIRE);
+    mod_size_t used = LFIFO_POS(wr_t - rd_t);
+    return used > fifo->size ? fifo->size : used;
+}
+
+_INLINE mod_size_t LFifo_GetFree(lfifo_t* fifo) {
+    return fifo->size - LFifo_GetUsed(fifo);
+}
+
+_INLINE bool LFifo_IsEmpty(lfifo_t* fifo) {
+    return LFIFO_POS(fifo->wr - fifo->rd) == 0;
+}
+
+_INLINE bool LFifo_IsFull(lfifo_t* fifo) {
+    return LFifo_GetUsed(fifo) == fifo->size;
+}
+
+void LFifo_ClearFill(lfifo_t* fifo, const uint8_t fill_data) {
+    memset(fifo->buf, fill_data, fifo->size);
+    lfifo_reset(fifo);
+}
+
+void LFifo_Clear(lfifo_t* fifo) {
+    lfifo_reset(fifo);
+}
+
+#if LFIFO_CFG_MP
+
+static void lfifo_copy_in(lfifo_t* fifo, mod_size_t pos, const uint8_t* data,
+                          mod_size_t len) {
+    mod_size_t idx = pos & fifo->mask;
+    mod_size_t tocpy = fifo->size - idx;
+    if (tocpy > len)
+        tocpy = len;
+    memcpy(&fifo->buf[idx], data, tocpy);
+    if (len > tocpy)
+        memcpy(fifo->buf, data + tocpy, len - tocpy);
+}
+
+static void lfifo_copy_out(lfifo_t* fifo, mod_size_t pos, uint8_t* data,
+                           mod_size_t len) {
+    mod_size_t idx = pos & fifo->mask;
+    mod_size_t tocpy = fifo->size - idx;
+    if (tocpy > len)
+        tocpy = len;
+    memcpy(data, &fifo->buf[idx], tocpy);
+    if (len > tocpy)
+        memcpy(data + tocpy, fifo->buf, len - tocpy);
+}
+
+/**
+ * @brief 推进预留指针head, 可用空间为limit+room-head
+ * @note 生产者: head=wr_head, limit=rd, room=size
+ *       消费者: head=rd_head, limit=wr, room=0
+ */
+static mod_size_t lfifo_reserve(lfifo_t* fifo, mod_atomic_size_t* head,
+                                mod_atomic_size_t* limit, mod_size_t room,
+                                mod_size_t len, bool exact, mod_size_t* pos) {
+    mod_atomic_value_t h = MOD_ATOMIC_LOAD(*head, MOD_ATOMIC_ORDER_RELAXED);
+    mod_size_t lim, avail, n, nh;
+    while (1) {
+        lim = MOD_ATOMIC_LOAD(*limit, MOD_ATOMIC_ORDER_ACQUIRE);
+        avail = LFIFO_POS(lim + room - (mod_size_t)h);
+        if (avail > fifo->size) {  // h已过期
+            h = MOD_ATOMIC_LOAD(*head, MOD_ATOMIC_ORDER_RELAXED);
+            continue;
+        }
+        n = len;
+        if (n > avail)
+            n = exact ? 0 : avail;
+        if (n == 0)
+            return 0;
+        nh = LFIFO_POS((mod_size_t)h + n) |
+             (((mod_size_t)h & ~LFIFO_POS_MASK) + LFIFO_CNT_ONE);
+        if (MOD_ATOMIC_CAS(*head, h, nh, MOD_ATOMIC_ORDER_ACQUIRE))
+            break;
+    }
+    *pos = LFIFO_POS(h);
+    return n;
+}
+
+/**
+ * @brief 提交一次预留, 递增tail计数; 若与head计数相同,
+ *        说明所有预留均已提交, 将tail发布到head
+ */
+static void lfifo_commit(mod_atomic_size_t* head, mod_atomic_size_t* tail) {
+    mod_atomic_value_t t = MOD_ATOMIC_LOAD(*tail, MOD_ATOMIC_ORDER_RELAXED);
+    mod_size_t h, nt;
+    do {
+        h = MOD_ATOMIC_LOAD(*head, MOD_ATOMIC_ORDER_ACQUIRE);
+        nt = ((mod_size_t)t & ~LFIFO_POS_MASK) + LFIFO_CNT_ONE;
+        if (nt == (h & ~LFIFO_POS_MASK))
+            nt = h;
+        else
+            nt |= LFIFO_POS(t);
+    } while (!MOD_ATOMIC_CAS(*tail, t, nt, MOD_ATOMIC_ORDER_RELEASE));
+}
+
+mod_size_t LFifo_ReserveWrite(lfifo_t* fifo, mod_size_t len, mod_size_t* pos) {
+    return lfifo_reserve(fifo, &fifo->wr_head, &fifo->rd, fifo->size, len,
+                         true, pos);
+}
+
+void LFifo_CopyToReserved(lfifo_t* fifo, mod_size_t pos, const uint8_t* data,
+                          mod_size_t len) {
+    lfifo_copy_in(fifo, pos, data, len);
+}
+
+void LFifo_CommitWrite(lfifo_t* fifo) {
+    lfifo_commit(&fifo->wr_head, &fifo->wr);
+}
+
+mod_size_t LFifo_ReserveRead(lfifo_t* fifo, mod_size_t len, mod_size_t* pos) {
+    return lfifo_reserve(fifo, &fifo->rd_head, &fifo->wr, 0, len, false, pos);
+}
+
+void LFifo_CopyFromReserved(lfifo_t* fifo, mod_size_t pos, uint8_t* data,
+                            mod_size_t len) {
+    lfifo_copy_out(fifo, pos, data, len);
+}
+
+void LFifo_CommitRead(lfifo_t* fifo) {
+    lfifo_commit(&fifo->rd_head, &fifo->rd);
+}
+
+mod_size_t LFifo_Write(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
+    mod_size_t pos;
+    len = lfifo_reserve(fifo, &fifo->wr_head, &fifo->rd, fifo->size, len,
+                        false, &pos);
+    if (!len)
+        return 0;
+    if (data != NULL)
+        lfifo_copy_in(fifo, pos, data, len);
+    lfifo_commit(&fifo->wr_head, &fifo->wr);
+    return len;
+}
+
+mod_size_t LFifo_Read(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
+    mod_size_t pos;
+    len = lfifo_reserve(fifo, &fifo->rd_head, &fifo->wr, 0, len, false, &pos);
+    if (!len)
+        return 0;
+    if (data != NULL)  // NULL: discard data
+        lfifo_copy_out(fifo, pos, data, len);
+    lfifo_commit(&fifo->rd_head, &fifo->rd);
+    return len;
+}
+
+#else  // !LFIFO_CFG_MP
+
+mod_size_t LFifo_Write(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
+    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_RELAXED);
+    mod_size_t free_size = fifo->size - (wr_t - fifo->rd_cache);
+    if (len > free_size) {  // 缓存的读指针不够用时才重新读取
+        fifo->rd_cache = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
+        free_size = fifo->size - (wr_t - fifo->rd_cache);
+        if (len > free_size)
+            len = free_size;
+    }
+    if (!len)
+        return 0;
+    if (data != NULL) {
+        mod_size_t idx = wr_t & fifo->mask;
+        mod_size_t tocpy = fifo->size - idx;
+        if (tocpy > len)
+            tocpy = len;
+        memcpy(&fifo->buf[idx], data, tocpy);
+        if (len > tocpy)
+            memcpy(fifo->buf, data + tocpy, len - tocpy);
+    }
+    MOD_ATOMIC_STORE(fifo->wr, wr_t + len, MOD_ATOMIC_ORDER_RELEASE);
+    return len;
+}
+
+mod_size_t LFifo_Read(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
+    mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_RELAXED);
+    mod_size_t used_size = fifo->wr_cache - rd_t;
+    if (len > used_size) {  // 缓存的写指针不够用时才重新读取
+        fifo->wr_cache = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_ACQUIRE);
+        used_size = fifo->wr_cache - rd_t;
+        if (len > used_size)
+            len = used_size;
+    }
+    if (!len)
+        return 0;
+    if (data != NULL) {  // NULL: discard data
+        mod_size_t idx = rd_t & fifo->mask;
+        mod_size_t tocpy = fifo->size - idx;
+        if (tocpy > len)
+            tocpy = len;
+        memcpy(data, &fifo->buf[idx], tocpy);
+        if (len > tocpy)
+            memcpy(data + tocpy, fifo->buf, len - tocpy);
+    }
+    MOD_ATOMIC_STORE(fifo->rd, rd_t + len, MOD_ATOMIC_ORDER_RELEASE);
+    return len;
+}
+
+#endif  // LFIFO_CFG_MP
+
+#else  // !LFIFO_CFG_POW2
+
 _INLINE mod_size_t LFifo_GetSize(lfifo_t* fifo) {
     if (fifo->size == 0)
         return 0;
@@ -71,13 +343,11 @@ _INLINE bool LFifo_IsFull(lfifo_t* fifo) {
 
 void LFifo_ClearFill(lfifo_t* fifo, const uint8_t fill_data) {
     memset(fifo->buf, fill_data, fifo->size);
-    fifo->wr = 0;
-    fifo->rd = 0;
+    lfifo_reset(fifo);
 }
 
 void LFifo_Clear(lfifo_t* fifo) {
-    fifo->wr = 0;
-    fifo->rd = 0;
+    lfifo_reset(fifo);
 }
 
 mod_size_t LFifo_Write(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
@@ -134,6 +404,8 @@ mod_size_t LFifo_Read(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
     return len;
 }
 
+#endif  // LFIFO_CFG_POW2
+
 mod_size_t LFifo_Peek(lfifo_t* fifo, mod_size_t offset, uint8_t* data,
                       mod_size_t len) {
     mod_size_t used_size = LFifo_GetUsed(fifo);
@@ -141,7 +413,7 @@ mod_size_t LFifo_Peek(lfifo_t* fifo, mod_size_t offset, uint8_t* data,
         return 0;
     if (len + offset > used_size)
         len = used_size - offset;
-    mod_size_t rd_t = (fifo->rd + offset) % fifo->size;
+    mod_size_t rd_t = LFIFO_IDX(fifo, fifo->rd + offset);
     mod_size_t tocpy = len;
     if (len > fifo->size - rd_t)
         tocpy = fifo->size - rd_t;
@@ -153,6 +425,47 @@ mod_size_t LFifo_Peek(lfifo_t* fifo, mod_size_t offset, uint8_t* data,
     return len;
 }
 
+#if LFIFO_CFG_MP
+
+_INLINE int LFifo_WriteByte(lfifo_t* fifo, uint8_t data) {
+    return LFifo_Write(fifo, &data, 1) == 1 ? 0 : -1;
+}
+
+_INLINE int LFifo_ReadByte(lfifo_t* fifo) {
+    uint8_t data;
+    if (LFifo_Read(fifo, &data, 1) != 1)
+        return -1;
+    return data;
+}
+
+#elif LFIFO_CFG_POW2
+
+_INLINE int LFifo_WriteByte(lfifo_t* fifo, uint8_t data) {
+    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_RELAXED);
+    if (wr_t - fifo->rd_cache >= fifo->size) {
+        fifo->rd_cache = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
+        if (wr_t - fifo->rd_cache >= fifo->size)
+            return -1;
+    }
+    fifo->buf[wr_t & fifo->mask] = data;
+    MOD_ATOMIC_STORE(fifo->wr, wr_t + 1, MOD_ATOMIC_ORDER_RELEASE);
+    return 0;
+}
+
+_INLINE int LFifo_ReadByte(lfifo_t* fifo) {
+    mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_RELAXED);
+    if (rd_t == fifo->wr_cache) {
+        fifo->wr_cache = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_ACQUIRE);
+        if (rd_t == fifo->wr_cache)
+            return -1;
+    }
+    uint8_t data = fifo->buf[rd_t & fifo->mask];
+    MOD_ATOMIC_STORE(fifo->rd, rd_t + 1, MOD_ATOMIC_ORDER_RELEASE);
+    return data;
+}
+
+#else  // !LFIFO_CFG_POW2
+
 _INLINE int LFifo_WriteByte(lfifo_t* fifo, uint8_t data) {
     if (fifo->wr == (fifo->rd + fifo->size - 1) % fifo->size)
         return -1;
@@ -173,13 +486,27 @@ _INLINE int LFifo_ReadByte(lfifo_t* fifo) {
     return data;
 }
 
+#endif  // LFIFO_CFG_POW2
+
 _INLINE int LFifo_PeekByte(lfifo_t* fifo, mod_size_t offset) {
     if (offset >= LFifo_GetUsed(fifo)) {
         return -1;
     }
-    return fifo->buf[(fifo->rd + offset) % fifo->size];
+    return fifo->buf[LFIFO_IDX(fifo, fifo->rd + offset)];
 }
 
+#if LFIFO_CFG_POW2
+
+uint8_t* LFifo_GetWritePtr(lfifo_t* fifo, mod_offset_t offset) {
+    return &fifo->buf[LFIFO_IDX(fifo, fifo->wr + (mod_size_t)offset)];
+}
+
+uint8_t* LFifo_GetReadPtr(lfifo_t* fifo, mod_offset_t offset) {
+    return &fifo->buf[LFIFO_IDX(fifo, fifo->rd + (mod_size_t)offset)];
+}
+
+#else  // !LFIFO_CFG_POW2
+
 uint8_t* LFifo_GetWritePtr(lfifo_t* fifo, mod_offset_t offset) {
     mod_offset_t temp = (mod_offset_t)fifo->wr + offset;
     while (temp < 0) {
@@ -196,6 +523,8 @@ uint8_t* LFifo_GetReadPtr(lfifo_t* fifo, mod_offset_t offset) {
     return &fifo->buf[temp % fifo->size];
 }
 
+#endif  // LFIFO_CFG_POW2
+
 mod_offset_t LFifo_Find(lfifo_t* fifo, uint8_t* data, mod_size_t len,
                         mod_size_t r_offset) {
     mod_size_t used, rd;
@@ -211,7 +540,7 @@ mod_offset_t LFifo_Find(lfifo_t* fifo, uint8_t* data, mod_size_t len,
     for (mod_size_t skip_x = r_offset; skip_x <= used - len; ++skip_x) {
         found = 1;
         /* Prepare the starting point for reading */
-        rd = (fifo->rd + skip_x) % fifo->size;
+        rd = LFIFO_IDX(fifo, fifo->rd + skip_x);
         /* Search in the buffer */
         for (mod_size_t i = 0; i < len; ++i) {
             if (fifo->buf[rd] != data[i]) {
@@ -227,6 +556,58 @@ mod_offset_t LFifo_Find(lfifo_t* fifo, uint8_t* data, mod_size_t len,
     return -1;
 }
 
+#if LFIFO_CFG_POW2
+
+uint8_t* LFifo_AcquireLinearWrite(lfifo_t* fifo, mod_size_t* len) {
+    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_RELAXED);
+    fifo->rd_cache = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
+    mod_size_t free_size = fifo->size - LFIFO_POS(wr_t - fifo->rd_cache);
+    mod_size_t idx = wr_t & fifo->mask;
+    if (free_size == 0) {
+        *len = 0;
+        return NULL;
+    }
+    *len = fifo->size - idx;
+    if (*len > free_size)
+        *len = free_size;
+    return &fifo->buf[idx];
+}
+
+void LFifo_ReleaseLinearWrite(lfifo_t* fifo, mod_size_t len) {
+#if LFIFO_CFG_MP
+    LFifo_Write(fifo, NULL, len);
+#else
+    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_RELAXED);
+    MOD_ATOMIC_STORE(fifo->wr, wr_t + len, MOD_ATOMIC_ORDER_RELEASE);
+#endif
+}
+
+uint8_t* LFifo_AcquireLinearRead(lfifo_t* fifo, mod_size_t* len) {
+    mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_RELAXED);
+    fifo->wr_cache = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_ACQUIRE);
+    mod_size_t used = LFIFO_POS(fifo->wr_cache - rd_t);
+    mod_size_t idx = rd_t & fifo->mask;
+    if (used == 0) {
+        *len = 0;
+        return NULL;
+    }
+    *len = fifo->size - idx;
+    if (*len > used)
+        *len = used;
+    return &fifo->buf[idx];
+}
+
+void LFifo_ReleaseLinearRead(lfifo_t* fifo, mod_size_t len) {
+#if LFIFO_CFG_MP
+    LFifo_Read(fifo, NULL, len);
+#else
+    mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_RELAXED);
+    MOD_ATOMIC_STORE(fifo->rd, rd_t + len, MOD_ATOMIC_ORDER_RELEASE);
+#endif
+}
+
+#else  // !LFIFO_CFG_POW2
+
 uint8_t* LFifo_AcquireLinearWrite(lfifo_t* fifo, mod_size_t* len) {
     if (LFifo_GetFree(fifo) == 0) {
         *len = 0;
@@ -236,6 +617,8 @@ uint8_t* LFifo_AcquireLinearWrite(lfifo_t* fifo, mod_size_t* len) {
     mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_RELAXED);
     if (wr_t >= rd_t) {
         *len = fifo->size - wr_t;
+        if (rd_t == 0)  // 写到末尾会与rd重合, 需保留一个字节
+            *len -= 1;
     } else {
         *len = rd_t - wr_t - 1;
     }
@@ -275,3 +658,5 @@ void LFifo_ReleaseLinearRead(lfifo_t* fifo, mod_size_t len) {
     rd_t %= fifo->size;
     MOD_ATOMIC_STORE(fifo->rd, rd_t, MOD_ATOMIC_ORDER_RELEASE);
 }
+
+#endif  // LFIFO_CFG_POW2
@@ -20,19 +20,56 @@ extern "C" {
 // typedef uint32_t mod_size_t;
 // typedef int32_t mod_offset_t;
 
+#ifndef LFIFO_CFG_POW2
+#define LFIFO_CFG_POW2 0
+#endif
+#ifndef LFIFO_CFG_MP
+#define LFIFO_CFG_MP 0
+#endif
+#if LFIFO_CFG_MP && !LFIFO_CFG_POW2
+#error "LFIFO_CFG_MP requires LFIFO_CFG_POW2"
+#endif
+
 typedef struct {           // FIFO对象
     mod_atomic_size_t wr;  // 写指针
     mod_atomic_size_t rd;  // 读指针
     mod_size_t size;       // 缓冲区大小
     uint8_t* buf;          // 缓冲区指针
+#if LFIFO_CFG_POW2
+    mod_size_t mask;      // 索引掩码(size-1)
+    mod_size_t rd_cache;  // 生产者缓存的读指针
+    mod_size_t wr_cache;  // 消费者缓存的写指针
+#endif
+#if LFIFO_CFG_MP
+    mod_atomic_size_t wr_head;  // 生产者预留指针
+    mod_atomic_size_t rd_head;  // 消费者预留指针
+#endif
 } lfifo_t;
 
+/*
+ * LFIFO_CFG_POW2模式:
+ * 缓冲区大小为2的幂, 读写指针自由递增并通过掩码取下标, 缓冲区可全部使用;
+ * 生产者/消费者各自缓存对方的指针, 仅在缓存值不够用时才重新读取,
+ * 减少热路径上对共享变量的访问.
+ *
+ * LFIFO_CFG_MP模式(多生产者/多消费者):
+ * 生产者先通过CAS推进wr_head预留互不重叠的区域, 拷贝数据后提交;
+ * 每次预留/提交同时递增指针高8位的计数, 最后一个完成提交的生产者
+ * 将wr发布到wr_head, 消费者侧同理. 提交不需要等待其他生产者,
+ * 因此中断中写入不会因被抢占的线程而死锁.
+ * 该模式下读写指针低24位为位置, 缓冲区最大为2^23字节;
+ * LFifo_Write/Read/WriteByte/ReadByte均为多生产者/多消费者安全,
+ * Peek/Find/GetReadPtr/GetWritePtr/Linear系列接口仍需单生产者/单消费者.
+ */
+
 /**
  * @brief 初始化FIFO, 使用动态缓冲区
  * @param  fifo             FIFO对象
  * @param  size             请求的FIFO大小
  * @retval 0                成功
  * @note  实际申请的空间为size+1
+ * @note  LFIFO_CFG_POW2模式下size向上取整为2的幂, 且不额外申请空间
+ * @note  LFIFO_CFG_MP模式下size不能超过2^23
  */
 extern int LFifo_Init(lfifo_t* fifo, mod_size_t size);
 
@@ -49,6 +86,7 @@ extern void LFifo_Destory(lfifo_t* fifo);
  * @param  buffer           静态缓冲区指针
  * @param  size             静态缓冲区大小
  * @note  实际可用空间为size-1
+ * @note  LFIFO_CFG_POW2模式下仅使用不超过size的最大2的幂长度, 且可全部使用
  */
 extern void LFifo_AssignBuf(lfifo_t* fifo, uint8_t* buffer, mod_size_t size);
 
@@ -56,7 +94,7 @@ extern void LFifo_AssignBuf(lfifo_t* fifo, uint8_t* buffer, mod_size_t size);
  * @brief 获取FIFO的大小
  * @param  fifo             FIFO对象
  * @retval mod_size_t         FIFO的大小
- * @note  返回的实际可用大小为缓冲区大小-1
+ * @note  返回的实际可用大小为缓冲区大小-1(LFIFO_CFG_POW2模式下为缓冲区大小)
  */
 extern mod_size_t LFifo_GetSize(lfifo_t* fifo);
 
@@ -216,6 +254,64 @@ extern uint8_t* LFifo_AcquireLinearRead(lfifo_t* fifo, mod_size_t* len);
  */
 extern void LFifo_ReleaseLinearRead(lfifo_t* fifo, mod_size_t len);
 
+#if LFIFO_CFG_MP
+
+/**
+ * @brief 预留写入空间(多生产者安全)
+ * @param  fifo             FIFO对象
+ * @param  len              期望预留的长度
+ * @param  pos              返回预留区域的起始位置
+ * @retval mod_size_t       预留成功返回len, 空间不足返回0
+ * @note 预留必须全部满足, 不会部分预留; 成功后必须调用LFifo_CommitWrite
+ */
+extern mod_size_t LFifo_ReserveWrite(lfifo_t* fifo, mod_size_t len,
+                                     mod_size_t* pos);
+
+/**
+ * @brief 向预留区域拷贝数据
+ * @param  fifo             FIFO对象
+ * @param  pos              写入位置(预留起始位置+偏移)
+ * @param  data             数据缓冲区指针
+ * @param  len              数据长度
+ */
+extern void LFifo_CopyToReserved(lfifo_t* fifo, mod_size_t pos,
+                                 const uint8_t* data, mod_size_t len);
+
+/**
+ * @brief 提交一次写入预留
+ * @param  fifo             FIFO对象
+ * @note 所有在途的预留均提交后数据才对消费者可见
+ */
+extern void LFifo_CommitWrite(lfifo_t* fifo);
+
+/**
+ * @brief 预留读取空间(多消费者安全)
+ * @param  fifo             FIFO对象
+ * @param  len              期望读取的长度
+ * @param  pos              返回预留区域的起始位置
+ * @retval mod_size_t       实际预留的长度, 为0时无需提交
+ */
+extern mod_size_t LFifo_ReserveRead(lfifo_t* fifo, mod_size_t len,
+                                    mod_size_t* pos);
+
+/**
+ * @brief 从预留区域拷贝数据
+ * @param  fifo             FIFO对象
+ * @param  pos              读取位置(预留起始位置+偏移)
+ * @param  data             存放数据的缓冲区指针
+ * @param  len              数据长度
+ */
+extern void LFifo_CopyFromReserved(lfifo_t* fifo, mod_size_t pos,
+                                   uint8_t* data, mod_size_t len);
+
+/**
+ * @brief 提交一次读取预留, 释放对应空间
+ * @param  fifo             FIFO对象
+ */
+extern void LFifo_CommitRead(lfifo_t* fifo);
+
+#endif  // LFIFO_CFG_MP
+
 #ifdef __cplusplus
 }
 #endif
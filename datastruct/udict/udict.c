@@ -10,6 +10,7 @@
 
 #include "udict.h"
 
+#if !UDICT_CFG_FLAT
 #include <string.h>
 
 #include "uthash.h"
@@ -317,3 +318,5 @@ void udict_print(UDICT dict, const char* name) {
     }
     PRINTLN("}");
 }
+
+#endif  // !UDICT_CFG_FLAT
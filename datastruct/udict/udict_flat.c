@@ -0,0 +1,493 @@
+/**
+ * @file udict_flat.c
+ * @brief 数据类型通用的动态字典实现(开放寻址后端)
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-18
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "udict.h"
+
+#if UDICT_CFG_FLAT
+#include <string.h>
+
+#define LOG_MODULE "udict"
+#include "log.h"
+
+#ifndef UDICT_CFG_ARENA_SIZE
+#define UDICT_CFG_ARENA_SIZE 512
+#endif
+
+#define MIN_CAP 8
+#define ALIGN sizeof(void*)
+#define ALIGN_UP(x) (((x) + ALIGN - 1) & ~(ALIGN - 1))
+#define BIG_ITEM (UDICT_CFG_ARENA_SIZE / 4)  // 超过该大小的项目单独分配
+
+#if UDICT_CFG_ARENA_SIZE > UINT16_MAX
+#error "UDICT_CFG_ARENA_SIZE must not exceed 65535"
+#endif
+
+typedef struct {      // 哈希表槽(Robin Hood开放寻址)
+    uint32_t hash;    // 键哈希, 0表示空槽
+    const char* key;  // 键(位于数据区, 项目头之后)
+} udict_slot_t;
+
+// 数据区项目: [值][项目头][键], 项目起点按指针大小对齐
+typedef struct {
+    mod_size_t is_ptr : 1;
+    mod_size_t size : sizeof(mod_size_t) * 8 - 1;  // 值区大小
+    uint32_t chunk;  // 项目起点相对所在块的偏移, 0表示单独分配
+} udict_item_t;
+
+typedef struct udict_chunk {   // 数据区块, 项目在块内顺序分配
+    struct udict_chunk* next;  // 下一块
+    uint16_t used;             // 已分配的字节数(含块头)
+    uint16_t live;             // 仍在使用的项目数
+} udict_chunk_t;
+
+#define CHUNK_HDR ALIGN_UP(sizeof(udict_chunk_t))
+#define ITEM(key) ((udict_item_t*)(key) - 1)
+#define ITEM_VALUE(item) ((uint8_t*)(item) - ALIGN_UP((item)->size))
+
+struct udict {
+    udict_slot_t* slots;
+    mod_size_t cap;  // 槽数(2的幂), 0表示尚未分配
+    mod_size_t dyn : 1;
+    mod_size_t size : sizeof(mod_size_t) * 8 - 1;
+    udict_chunk_t* chunks;   // 数据区块链表, 首块为当前分配块
+    MOD_MUTEX_HANDLE mutex;  // 互斥锁
+};
+
+typedef struct udict udict_t;
+
+#define _udict_malloc m_alloc
+#define _udict_free m_free
+#define _udict_realloc m_realloc
+
+#define UDICT_LOCK()                                 \
+    {                                                \
+        if (!dict->mutex)                            \
+            dict->mutex = MOD_MUTEX_CREATE("udict"); \
+        MOD_MUTEX_ACQUIRE(dict->mutex);              \
+    }
+#define UDICT_UNLOCK() \
+    { MOD_MUTEX_RELEASE(dict->mutex); }
+#define UDICT_UNLOCK_RET(x) \
+    {                       \
+        UDICT_UNLOCK();     \
+        return x;           \
+    }
+
+/**
+ * @brief FNV-1a哈希, 同时求出键长
+ */
+static inline uint32_t hash_key(const char* key, size_t* len) {
+    uint32_t h = 2166136261u;
+    const char* p = key;
+    while (*p) {
+        h = (h ^ (uint8_t)*p++) * 16777619u;
+    }
+    *len = p - key;
+    return h ? h : 1;
+}
+
+static inline mod_size_t slot_dist(UDICT dict, mod_size_t idx,
+                                   uint32_t hash) {
+    return (idx - hash) & (dict->cap - 1);
+}
+
+/**
+ * @brief 获取字典对外的值: 指针值返回指针本身, 否则返回值区地址
+ */
+static inline void* item_get(udict_item_t* item) {
+    uint8_t* value = ITEM_VALUE(item);
+    return item->is_ptr ? *(void**)value : value;
+}
+
+/**
+ * @brief 分配并填充项目, 小项目从数据区块顺序分配, 大项目单独分配
+ * @retval 项目头, 失败返回NULL
+ */
+static udict_item_t* item_new(UDICT dict, const char* key, size_t len,
+                              size_t value_size) {
+    size_t size = ALIGN_UP(value_size) + sizeof(udict_item_t) + len + 1;
+    uint8_t* start;
+    uint32_t offset = 0;
+    if (size > BIG_ITEM) {
+        start = (uint8_t*)_udict_malloc(size);
+        if (!start)
+            return NULL;
+    } else {
+        udict_chunk_t* chunk = dict->chunks;
+        if (!chunk || chunk->used + size > UDICT_CFG_ARENA_SIZE) {
+            chunk = (udict_chunk_t*)_udict_malloc(UDICT_CFG_ARENA_SIZE);
+            if (!chunk)
+                return NULL;
+            chunk->used = CHUNK_HDR;
+            chunk->live = 0;
+            chunk->next = dict->chunks;
+            dict->chunks = chunk;
+        }
+        offset = chunk->used;
+        start = (uint8_t*)chunk + offset;
+        chunk->used += ALIGN_UP(size);
+        chunk->live++;
+    }
+    udict_item_t* item = (udict_item_t*)(start + ALIGN_UP(value_size));
+    item->is_ptr = false;
+    item->size = ALIGN_UP(value_size);
+    item->chunk = offset;
+    memcpy(item + 1, key, len + 1);
+    return item;
+}
+
+static void item_free(UDICT dict, udict_item_t* item) {
+    uint8_t* start = ITEM_VALUE(item);
+    if (!item->chunk) {
+        _udict_free(start);
+        return;
+    }
+    udict_chunk_t* chunk = (udict_chunk_t*)(start - item->chunk);
+    if (--chunk->live)
+        return;
+    if (chunk == dict->chunks) {  // 当前块直接重置
+        chunk->used = CHUNK_HDR;
+        return;
+    }
+    udict_chunk_t** pp = &dict->chunks;
+    while (*pp != chunk) {
+        pp = &(*pp)->next;
+    }
+    *pp = chunk->next;
+    _udict_free(chunk);
+}
+
+static void table_insert(UDICT dict, udict_slot_t ins) {
+    mod_size_t mask = dict->cap - 1;
+    mod_size_t idx = ins.hash & mask;
+    mod_size_t dist = 0;
+    while (1) {
+        udict_slot_t* slot = &dict->slots[idx];
+        if (!slot->hash) {
+            *slot = ins;
+            return;
+        }
+        mod_size_t d = slot_dist(dict, idx, slot->hash);
+        if (d < dist) {  // 劫富济贫: 让离理想位置更远的项目留下
+            udict_slot_t tmp = *slot;
+            *slot = ins;
+            ins = tmp;
+            dist = d;
+        }
+        idx = (idx + 1) & mask;
+        dist++;
+    }
+}
+
+static bool table_resize(UDICT dict, mod_size_t cap) {
+    udict_slot_t* slots =
+        (udict_slot_t*)_udict_malloc(sizeof(udict_slot_t) * cap);
+    if (!slots)
+        return false;
+    memset(slots, 0, sizeof(udict_slot_t) * cap);
+    udict_slot_t* old = dict->slots;
+    mod_size_t old_cap = dict->cap;
+    dict->slots = slots;
+    dict->cap = cap;
+    for (mod_size_t i = 0; i < old_cap; i++) {
+        if (old[i].hash)
+            table_insert(dict, old[i]);
+    }
+    if (old)
+        _udict_free(old);
+    return true;
+}
+
+static udict_slot_t* find_slot(UDICT dict, const char* key, uint32_t hash) {
+    if (!dict->size)
+        return NULL;
+    mod_size_t mask = dict->cap - 1;
+    mod_size_t idx = hash & mask;
+    mod_size_t dist = 0;
+    while (1) {
+        udict_slot_t* slot = &dict->slots[idx];
+        if (!slot->hash || slot_dist(dict, idx, slot->hash) < dist)
+            return NULL;
+        if (slot->hash == hash && strcmp(slot->key, key) == 0)
+            return slot;
+        idx = (idx + 1) & mask;
+        dist++;
+    }
+}
+
+static udict_slot_t* find_node(UDICT dict, const char* key) {
+    if (!dict || !key || !dict->size) {
+        return NULL;
+    }
+    size_t len;
+    return find_slot(dict, key, hash_key(key, &len));
+}
+
+static void del_slot(UDICT dict, udict_slot_t* slot) {
+    item_free(dict, ITEM(slot->key));
+    // 后移删除: 把后续偏离理想位置的项目前移一格, 无需墓碑
+    mod_size_t mask = dict->cap - 1;
+    mod_size_t idx = slot - dict->slots;
+    mod_size_t next = (idx + 1) & mask;
+    while (dict->slots[next].hash &&
+           slot_dist(dict, next, dict->slots[next].hash) > 0) {
+        dict->slots[idx] = dict->slots[next];
+        idx = next;
+        next = (next + 1) & mask;
+    }
+    dict->slots[idx].hash = 0;
+    dict->size--;
+}
+
+/**
+ * @brief 设置键的值, 不存在时添加
+ * @param  value        值数据, 可为NULL(仅分配)
+ * @retval 值区地址, 失败返回NULL
+ */
+static void* set_node(UDICT dict, const char* key, size_t value_size,
+                      const void* value, bool is_ptr) {
+    if (!dict || !key)
+        return NULL;
+    size_t len;
+    uint32_t hash = hash_key(key, &len);
+    udict_slot_t* slot = find_slot(dict, key, hash);
+    udict_item_t* item;
+    if (slot) {
+        item = ITEM(slot->key);
+        if (value_size > item->size) {  // 值区不足, 换到新项目并保留原内容
+            udict_item_t* new_item = item_new(dict, key, len, value_size);
+            if (!new_item)
+                return NULL;
+            memcpy(ITEM_VALUE(new_item), ITEM_VALUE(item), item->size);
+            item_free(dict, item);
+            item = new_item;
+            slot->key = (const char*)(item + 1);
+        }
+    } else {
+        if (((mod_size_t)dict->size + 1) * 4 > dict->cap * 3 &&
+            !table_resize(dict, dict->cap ? dict->cap * 2 : MIN_CAP) &&
+            dict->size == dict->cap)  // 扩容失败时仍可填满现有的表
+            return NULL;
+        item = item_new(dict, key, len, value_size);
+        if (!item)
+            return NULL;
+        udict_slot_t ins = {.hash = hash, .key = (const char*)(item + 1)};
+        table_insert(dict, ins);
+        dict->size++;
+    }
+    item->is_ptr = is_ptr;
+    if (value)
+        memcpy(ITEM_VALUE(item), value, value_size);
+    return ITEM_VALUE(item);
+}
+
+bool udict_init(UDICT dict) {
+    dict->slots = NULL;
+    dict->cap = 0;
+    dict->size = 0;
+    dict->dyn = false;
+    dict->chunks = NULL;
+    dict->mutex = MOD_MUTEX_CREATE("udict");
+    return true;
+}
+
+UDICT udict_new(void) {
+    UDICT dict = (UDICT)_udict_malloc(sizeof(udict_t));
+    if (!dict) {
+        return NULL;
+    }
+    if (!udict_init(dict)) {
+        _udict_free(dict);
+        return NULL;
+    }
+    dict->dyn = true;
+    return dict;
+}
+
+void udict_clear(UDICT dict) {
+    if (!dict) {
+        return;
+    }
+    UDICT_LOCK();
+    for (mod_size_t i = 0; i < dict->cap && dict->size; i++) {
+        if (dict->slots[i].hash) {
+            udict_item_t* item = ITEM(dict->slots[i].key);
+            if (!item->chunk)  // 单独分配的项目, 其余随数据区块释放
+                _udict_free(ITEM_VALUE(item));
+            dict->size--;
+        }
+    }
+    while (dict->chunks) {
+        udict_chunk_t* next = dict->chunks->next;
+        _udict_free(dict->chunks);
+        dict->chunks = next;
+    }
+    if (dict->slots)
+        _udict_free(dict->slots);
+    dict->slots = NULL;
+    dict->cap = 0;
+    dict->size = 0;
+    UDICT_UNLOCK();
+}
+
+void udict_free(UDICT dict) {
+    if (!dict) {
+        return;
+    }
+    udict_clear(dict);
+    if (dict->mutex)
+        MOD_MUTEX_DELETE(dict->mutex);
+    if (dict->dyn)
+        _udict_free(dict);
+}
+
+mod_size_t udict_len(UDICT dict) {
+    return dict->size;
+}
+
+bool udict_has(UDICT dict, const char* key) {
+    UDICT_LOCK();
+    bool ret = find_node(dict, key) != NULL;
+    UDICT_UNLOCK_RET(ret);
+}
+
+void* udict_get(UDICT dict, const char* key) {
+    void* ret = NULL;
+    UDICT_LOCK();
+    udict_slot_t* slot = find_node(dict, key);
+    if (slot) {
+        ret = item_get(ITEM(slot->key));
+    }
+    UDICT_UNLOCK_RET(ret);
+}
+
+const char* udict_get_reverse(UDICT dict, void* value) {
+    if (!dict || !value || !dict->size) {
+        return NULL;
+    }
+    UDICT_LOCK();
+    for (mod_size_t i = 0; i < dict->cap; i++) {
+        if (dict->slots[i].hash &&
+            item_get(ITEM(dict->slots[i].key)) == value) {
+            UDICT_UNLOCK_RET(dict->slots[i].key);
+        }
+    }
+    UDICT_UNLOCK_RET(NULL);
+}
+
+bool udict_set(UDICT dict, const char* key, void* value) {
+    UDICT_LOCK();
+    bool ret = set_node(dict, key, sizeof(void*), &value, true) != NULL;
+    UDICT_UNLOCK_RET(ret);
+}
+
+bool udict_set_copy(UDICT dict, const char* key, void* value, size_t size) {
+    UDICT_LOCK();
+    bool ret = set_node(dict, key, size, value, false) != NULL;
+    UDICT_UNLOCK_RET(ret);
+}
+
+void* udict_set_alloc(UDICT dict, const char* key, size_t size) {
+    UDICT_LOCK();
+    void* ret = set_node(dict, key, size, NULL, false);
+    UDICT_UNLOCK_RET(ret);
+}
+
+bool udict_del(UDICT dict, const char* key) {
+    UDICT_LOCK();
+    udict_slot_t* slot = find_node(dict, key);
+    if (!slot)
+        UDICT_UNLOCK_RET(false);
+    del_slot(dict, slot);
+    UDICT_UNLOCK_RET(true);
+}
+
+void* udict_pop(UDICT dict, const char* key) {
+    void* ret = NULL;
+    UDICT_LOCK();
+    udict_slot_t* slot = find_node(dict, key);
+    if (!slot)
+        UDICT_UNLOCK_RET(NULL);
+    udict_item_t* item = ITEM(slot->key);
+    if (item->is_ptr) {
+        ret = item_get(item);
+    } else {
+        ret = _udict_malloc(item->size);
+        if (!ret)
+            UDICT_UNLOCK_RET(NULL);
+        memcpy(ret, ITEM_VALUE(item), item->size);
+    }
+    del_slot(dict, slot);
+    UDICT_UNLOCK_RET(ret);
+}
+
+UDICT udict_copy(UDICT dict) {
+    if (!dict) {
+        return NULL;
+    }
+    UDICT new_dict = udict_new();
+    if (!new_dict) {
+        return NULL;
+    }
+    UDICT_LOCK();
+    if (dict->cap)  // 预先分配到相同容量, 避免逐步扩容
+        table_resize(new_dict, dict->cap);
+    for (mod_size_t i = 0; i < dict->cap; i++) {
+        if (!dict->slots[i].hash)
+            continue;
+        const char* key = dict->slots[i].key;
+        udict_item_t* item = ITEM(key);
+        if (item->is_ptr) {
+            udict_set(new_dict, key, item_get(item));
+        } else {
+            udict_set_copy(new_dict, key, ITEM_VALUE(item), item->size);
+        }
+    }
+    UDICT_UNLOCK();
+    return new_dict;
+}
+
+bool udict_iter(UDICT dict, const char** key, void** value) {
+    if (!dict || !dict->size) {
+        return false;
+    }
+    mod_size_t i = 0;
+    if (*key != NULL) {
+        udict_slot_t* slot = find_node(dict, *key);
+        if (!slot) {
+            return false;
+        }
+        i = slot - dict->slots + 1;
+    }
+    for (; i < dict->cap; i++) {
+        if (dict->slots[i].hash) {
+            *key = dict->slots[i].key;
+            *value = item_get(ITEM(dict->slots[i].key));
+            return true;
+        }
+    }
+    return false;
+}
+
+void udict_print(UDICT dict, const char* name) {
+    if (!dict || !dict->size) {
+        return;
+    }
+    PRINTLN("dict(%s) = {", name);
+    for (mod_size_t i = 0; i < dict->cap; i++) {
+        if (dict->slots[i].hash) {
+            PRINTLN("  %s: %p,", dict->slots[i].key,
+                    item_get(ITEM(dict->slots[i].key)));
+        }
+    }
+    PRINTLN("}");
+}
+
+#endif  // UDICT_CFG_FLAT
@@ -56,6 +56,11 @@
 #define ULIST_BSIZE(num) ((num) * list->isize)
 #define ULIST_PTR(offset) (((uint8_t*)list->data) + ULIST_BSIZE(offset))
 
+#define ULIST_SORT_INSERTION_NUM 16  // 内省排序中改用插入排序的元素个数
+#ifndef ULIST_SORT_RADIX_NUM
+#define ULIST_SORT_RADIX_NUM 64  // 使用基数排序的最少元素个数
+#endif
+
 /**
  * @brief 将Python风格的负索引转换为C风格的正索引
  * @note  如果索引越界, 返回-1
@@ -91,62 +96,75 @@ static inline mod_offset_t convert_pylike_offset(ULIST list,
     return index;
 }
 
+/**
+ * @brief 计算扩容/缩减的步长
+ * @note  不超过ULIST_MAX_EXTEND_SIZE时按2的幂次翻倍, 之后按固定步长,
+ * 启用ULIST_OPT_GEOMETRIC_GROWTH时按当前个数的比例增长
+ */
+static mod_size_t calc_step(ULIST list, mod_size_t num) {
+    if (num <= ULIST_MAX_EXTEND_SIZE)
+        return num;
+    if (list->opt & ULIST_OPT_GEOMETRIC_GROWTH)
+        return num / ULIST_GEOMETRIC_GROWTH_DIV;
+    return ULIST_MAX_EXTEND_SIZE;
+}
+
 /**
  * @brief 计算满足num个元素的所需容量
- * @note  当前实现为2的幂次, 降低内存操作次数
  */
-static mod_size_t calc_req_size(mod_size_t req_num) {
+static mod_size_t calc_req_size(ULIST list, mod_size_t req_num) {
+    if (list->opt & ULIST_OPT_NO_ALLOC_EXTEND)
+        return req_num;
     if (req_num > ULIST_MAX_EXTEND_SIZE)
-        return req_num + ULIST_MAX_EXTEND_SIZE;
+        return req_num + calc_step(list, req_num);
     mod_size_t min_req_size = 2;
     while (min_req_size < req_num)
         min_req_size *= 2;
     return min_req_size;
 }
 
+/**
+ * @brief 将列表容量调整为cap(cap>0)
+ * @note  如果申请失败, 返回false, 原数据不变
+ */
+static bool ulist_set_cap(ULIST list, mod_size_t cap) {
+    void* new_data;
+    if (list->data == NULL) {
+        list->cap = 0;
+        new_data = _ulist_malloc(ULIST_BSIZE(cap));
+    } else {
+        new_data = _ulist_realloc(list->data, ULIST_BSIZE(cap));
+    }
+    if (new_data == NULL) {
+        LIST_LOG("alloc failed");
+        return false;
+    }
+    list->data = new_data;
+    if ((list->opt & ULIST_OPT_CLEAR_DIRTY_REGION) && cap > list->cap) {
+        _ulist_memset(ULIST_PTR(list->cap), ULIST_DIRTY_REGION_FILL_DATA,
+                      ULIST_BSIZE(cap - list->cap));
+    }
+    list->cap = cap;
+    return true;
+}
+
 /**
  * @brief 扩容列表, 使其容量至少为req_num
  * @note  如果扩容失败, 返回false
  */
 static bool ulist_expend(ULIST list, mod_size_t req_num) {
-    if (list->data == NULL || list->cap == 0) {  // list is empty
-        if (!(list->opt & ULIST_OPT_NO_ALLOC_EXTEND)) {
-            req_num = calc_req_size(req_num);
-        }
-        list->data = _ulist_malloc(ULIST_BSIZE(req_num));
-        if (list->data == NULL) {
-            LIST_LOG("malloc failed");
-            return false;
-        }
-        if (list->opt & ULIST_OPT_CLEAR_DIRTY_REGION) {
-            _ulist_memset(list->data, ULIST_DIRTY_REGION_FILL_DATA,
-                          ULIST_BSIZE(req_num));
-        }
-        list->cap = req_num;
-    } else if (req_num > list->cap) {  // list is full
-        if (!(list->opt & ULIST_OPT_NO_ALLOC_EXTEND)) {
-            req_num = calc_req_size(req_num);
-        }
-        void* new_data = _ulist_realloc(list->data, ULIST_BSIZE(req_num));
-        if (new_data == NULL) {
-            LIST_LOG("realloc failed");
-            return false;
-        }
-        list->data = new_data;
-        if (list->opt & ULIST_OPT_CLEAR_DIRTY_REGION) {
-            _ulist_memset(ULIST_PTR(list->cap), ULIST_DIRTY_REGION_FILL_DATA,
-                          ULIST_BSIZE(req_num - list->cap));
-        }
-        list->cap = req_num;
-    }
-    return true;
+    if (list->data != NULL && req_num <= list->cap)
+        return true;
+    return ulist_set_cap(list, calc_req_size(list, req_num));
 }
 
 /**
  * @brief 缩减列表, 使其容量至少为req_num
+ * @param  force      是否忽略ULIST_OPT_NO_SHRINK与缩减迟滞
  * @note  如果req_num为0, 则释放列表
+ * @note  空余超过两个步长时才缩减, 避免在边界处反复扩容/缩减
  */
-static void ulist_shrink(ULIST list, mod_size_t req_num) {
+static void ulist_shrink(ULIST list, mod_size_t req_num, bool force) {
     if (req_num == 0) {  // free all
         if (list->opt & ULIST_OPT_NO_AUTO_FREE) {
             goto check_dirty_region;
@@ -157,19 +175,16 @@ static void ulist_shrink(ULIST list, mod_size_t req_num) {
         list->cap = 0;
         return;
     }
-    if (list->opt & ULIST_OPT_NO_SHRINK) {
-        goto check_dirty_region;
-    }
-    if (!(list->opt & ULIST_OPT_NO_ALLOC_EXTEND)) {
-        req_num = calc_req_size(req_num);
-    }
-    if (req_num < list->cap) {  // shrink
-        void* new_data = _ulist_realloc(list->data, ULIST_BSIZE(req_num));
-        if (new_data != NULL) {
-            list->data = new_data;
-            list->cap = req_num;
-        }
+    if (!force) {
+        if (list->opt & ULIST_OPT_NO_SHRINK)
+            goto check_dirty_region;
+        if (!(list->opt & ULIST_OPT_NO_ALLOC_EXTEND) &&
+            list->cap - req_num <= 2 * calc_step(list, req_num))
+            goto check_dirty_region;
     }
+    mod_size_t cap = calc_req_size(list, req_num);
+    if (cap < list->cap)
+        ulist_set_cap(list, cap);
 check_dirty_region:
     if ((list->opt & ULIST_OPT_CLEAR_DIRTY_REGION) && list->cap > req_num) {
         _ulist_memset(ULIST_PTR(req_num), ULIST_DIRTY_REGION_FILL_DATA,
@@ -236,7 +251,7 @@ void* ulist_append_multi(ULIST list, mod_size_t num) {
 
     ULIST_LOCK();
     if (!ulist_expend(list, list->num + num))
-        return NULL;
+        ULIST_UNLOCK_RET(NULL);
     uint8_t* ptr = ULIST_PTR(list->num);
     list->num += num;
     ULIST_UNLOCK_RET((void*)ptr);
@@ -350,7 +365,7 @@ bool ulist_delete_multi(ULIST list, mod_offset_t index, mod_size_t num) {
         _ulist_memmove(dst, src, move_size);
         list->num -= num;
     }
-    ulist_shrink(list, list->num);
+    ulist_shrink(list, list->num, false);
     ULIST_UNLOCK_RET(true);
 }
 
@@ -367,6 +382,48 @@ bool ulist_delete_slice(ULIST list, mod_offset_t start, mod_offset_t end) {
     ULIST_UNLOCK_RET(ulist_delete_multi(list, start, end - start));
 }
 
+// 按字读取元素数据, 不要求地址对齐
+static inline uint16_t load_u16(const void* p) {
+    uint16_t v;
+    _ulist_memcpy(&v, p, 2);
+    return v;
+}
+
+static inline uint32_t load_u32(const void* p) {
+    uint32_t v;
+    _ulist_memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint64_t load_u64(const void* p) {
+    uint64_t v;
+    _ulist_memcpy(&v, p, 8);
+    return v;
+}
+
+/**
+ * @brief 比较元素与键的数据是否相同
+ * @note  1/2/4/8字节元素按整数比较, 其余先比较首个字以尽早排除
+ */
+static inline bool item_equal(const void* item, const void* key,
+                              mod_size_t isize) {
+    switch (isize) {
+        case 1:
+            return *(const uint8_t*)item == *(const uint8_t*)key;
+        case 2:
+            return load_u16(item) == load_u16(key);
+        case 4:
+            return load_u32(item) == load_u32(key);
+        case 8:
+            return load_u64(item) == load_u64(key);
+        default:
+            break;
+    }
+    if (isize > 4 && load_u32(item) != load_u32(key))
+        return false;
+    return _ulist_memcmp(item, key, isize) == 0;
+}
+
 bool ulist_remove(ULIST list, const void* ptr) {
     ULIST_LOCK();
     mod_offset_t i = ulist_index(list, ptr);
@@ -375,6 +432,40 @@ bool ulist_remove(ULIST list, const void* ptr) {
     ULIST_UNLOCK_RET(ulist_delete(list, i));
 }
 
+mod_size_t ulist_delete_matched(ULIST list, const void* key,
+                                bool (*match)(const void* item,
+                                              const void* key)) {
+    ULIST_LOCK();
+    mod_size_t w = 0;    // 保留元素的写入位置
+    mod_size_t run = 0;  // 当前连续保留段的起始位置
+    for (mod_size_t r = 0; r < list->num; r++) {
+        uint8_t* item = ULIST_PTR(r);
+        if (match ? !match(item, key) : !item_equal(item, key, list->isize))
+            continue;
+        if (list->elfree != NULL)
+            list->elfree(item);
+        if (r > run) {  // 整段前移
+            if (w != run)
+                _ulist_memmove(ULIST_PTR(w), ULIST_PTR(run),
+                               ULIST_BSIZE(r - run));
+            w += r - run;
+        }
+        run = r + 1;
+    }
+    if (run == 0)  // 没有匹配的元素
+        ULIST_UNLOCK_RET(0);
+    if (list->num > run) {
+        if (w != run)
+            _ulist_memmove(ULIST_PTR(w), ULIST_PTR(run),
+                           ULIST_BSIZE(list->num - run));
+        w += list->num - run;
+    }
+    mod_size_t deleted = list->num - w;
+    list->num = w;
+    ulist_shrink(list, list->num, false);
+    ULIST_UNLOCK_RET(deleted);
+}
+
 void* ulist_slice_to_newmem(ULIST list, mod_offset_t start, mod_offset_t end) {
     ULIST_LOCK();
     start = convert_pylike_offset(list, start);
@@ -480,20 +571,34 @@ bool ulist_get_item(ULIST list, mod_offset_t index, void* target) {
     ULIST_UNLOCK_RET(true);
 }
 
+/**
+ * @brief 交换两个元素的数据, 按字进行
+ */
+static inline void swap_items(uint8_t* a, uint8_t* b, mod_size_t size) {
+    uint32_t wa, wb;
+    while (size >= 4) {
+        _ulist_memcpy(&wa, a, 4);
+        _ulist_memcpy(&wb, b, 4);
+        _ulist_memcpy(a, &wb, 4);
+        _ulist_memcpy(b, &wa, 4);
+        a += 4;
+        b += 4;
+        size -= 4;
+    }
+    while (size--) {
+        uint8_t tmp = *a;
+        *a++ = *b;
+        *b++ = tmp;
+    }
+}
+
 bool ulist_swap(ULIST list, mod_offset_t index1, mod_offset_t index2) {
     ULIST_LOCK();
     mod_offset_t i1 = convert_pylike_offset(list, index1);
     mod_offset_t i2 = convert_pylike_offset(list, index2);
     if (i1 == -1 || i2 == -1)
         ULIST_UNLOCK_RET(false);
-    uint8_t* ptr1 = ULIST_PTR(i1);
-    uint8_t* ptr2 = ULIST_PTR(i2);
-    uint8_t tmp;
-    for (mod_size_t i = 0; i < list->isize; i++) {
-        tmp = ptr1[i];
-        ptr1[i] = ptr2[i];
-        ptr2[i] = tmp;
-    }
+    swap_items(ULIST_PTR(i1), ULIST_PTR(i2), list->isize);
     ULIST_UNLOCK_RET(true);
 }
 
@@ -508,21 +613,265 @@ bool ulist_sort(ULIST list, int (*cmp)(const void*, const void*),
     ULIST_UNLOCK_RET(true);
 }
 
+typedef struct {       // 排序参数
+    mod_size_t isize;   // 元素大小
+    mod_size_t offset;  // 键在元素内的偏移
+    ulist_key_t type;   // 键类型
+} sort_ctx_t;
+
+/**
+ * @brief 读取排序键, 并转换为可按无符号整数比较的形式
+ * @note  有符号整数翻转符号位; 浮点数为负时按位取反, 否则翻转符号位
+ */
+static inline uint64_t sort_key(const sort_ctx_t* ctx, const uint8_t* item) {
+    const uint8_t* p = item + ctx->offset;
+    uint32_t u32;
+    uint64_t u64;
+    switch (ctx->type) {
+        case ULIST_KEY_U8:
+            return *p;
+        case ULIST_KEY_I8:
+            return *p ^ 0x80u;
+        case ULIST_KEY_U16:
+            return load_u16(p);
+        case ULIST_KEY_I16:
+            return load_u16(p) ^ 0x8000u;
+        case ULIST_KEY_U32:
+            return load_u32(p);
+        case ULIST_KEY_I32:
+            return load_u32(p) ^ 0x80000000u;
+        case ULIST_KEY_F32:
+            u32 = load_u32(p);
+            return (u32 & 0x80000000u) ? ~u32 : u32 ^ 0x80000000u;
+        case ULIST_KEY_U64:
+            return load_u64(p);
+        case ULIST_KEY_I64:
+            return load_u64(p) ^ 0x8000000000000000ull;
+        case ULIST_KEY_F64:
+            u64 = load_u64(p);
+            return (u64 & 0x8000000000000000ull) ? ~u64
+                                                 : u64 ^ 0x8000000000000000ull;
+        default:
+            return 0;
+    }
+}
+
+static inline uint8_t sort_key_bytes(ulist_key_t type) {
+    switch (type) {
+        case ULIST_KEY_U8:
+        case ULIST_KEY_I8:
+            return 1;
+        case ULIST_KEY_U16:
+        case ULIST_KEY_I16:
+            return 2;
+        case ULIST_KEY_U32:
+        case ULIST_KEY_I32:
+        case ULIST_KEY_F32:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+/**
+ * @brief 堆排序的下沉操作
+ */
+static void sort_sift_down(const sort_ctx_t* ctx, uint8_t* base,
+                           mod_size_t root, mod_size_t num) {
+    mod_size_t isize = ctx->isize;
+    while (1) {
+        mod_size_t child = root * 2 + 1;
+        if (child >= num)
+            return;
+        uint8_t* cp = base + child * isize;
+        if (child + 1 < num && sort_key(ctx, cp + isize) > sort_key(ctx, cp)) {
+            child++;
+            cp += isize;
+        }
+        uint8_t* rp = base + root * isize;
+        if (sort_key(ctx, rp) >= sort_key(ctx, cp))
+            return;
+        swap_items(rp, cp, isize);
+        root = child;
+    }
+}
+
+/**
+ * @brief 原地内省排序: 三数取中的快速排序, 递归过深时改用堆排序,
+ * 小区间使用插入排序
+ * @param  depth      剩余递归深度
+ */
+static void sort_introsort(const sort_ctx_t* ctx, uint8_t* base,
+                           mod_size_t num, uint8_t depth) {
+    mod_size_t isize = ctx->isize;
+    while (num > ULIST_SORT_INSERTION_NUM) {
+        if (depth-- == 0) {
+            for (mod_size_t i = num / 2; i > 0; i--) {
+                sort_sift_down(ctx, base, i - 1, num);
+            }
+            for (mod_size_t i = num - 1; i > 0; i--) {
+                swap_items(base, base + i * isize, isize);
+                sort_sift_down(ctx, base, 0, i);
+            }
+            return;
+        }
+        uint64_t a = sort_key(ctx, base);
+        uint64_t b = sort_key(ctx, base + (num / 2) * isize);
+        uint64_t c = sort_key(ctx, base + (num - 1) * isize);
+        uint64_t pivot = (a < b) ? ((b < c) ? b : (a < c) ? c : a)
+                                 : ((a < c) ? a : (b < c) ? c : b);
+        // Hoare分区, 结束后[0, j]不大于pivot, (j, num)不小于pivot
+        mod_size_t i = 0, j = num - 1;
+        while (1) {
+            while (sort_key(ctx, base + i * isize) < pivot) i++;
+            while (sort_key(ctx, base + j * isize) > pivot) j--;
+            if (i >= j)
+                break;
+            swap_items(base + i * isize, base + j * isize, isize);
+            i++;
+            j--;
+        }
+        // 递归处理较短的一侧, 循环处理较长的一侧, 限制栈深度
+        mod_size_t left = j + 1, right = num - left;
+        if (left < right) {
+            sort_introsort(ctx, base, left, depth);
+            base += left * isize;
+            num = right;
+        } else {
+            sort_introsort(ctx, base + left * isize, right, depth);
+            num = left;
+        }
+    }
+    for (mod_size_t i = 1; i < num; i++) {
+        uint64_t k = sort_key(ctx, base + i * isize);
+        for (uint8_t* p = base + i * isize; p > base; p -= isize) {
+            if (sort_key(ctx, p - isize) <= k)
+                break;
+            swap_items(p - isize, p, isize);
+        }
+    }
+}
+
+/**
+ * @brief LSD基数排序, 每趟按键的一个字节分配, 该字节全部相同的趟被跳过
+ * @param  tmp        与区间等大的临时缓冲区
+ * @param  count      256个计数
+ */
+static void sort_radix(const sort_ctx_t* ctx, uint8_t* base, mod_size_t num,
+                       uint8_t* tmp, mod_size_t* count) {
+    mod_size_t isize = ctx->isize;
+    uint8_t* src = base;
+    uint8_t* dst = tmp;
+    uint8_t bits = sort_key_bytes(ctx->type) * 8;
+    for (uint8_t shift = 0; shift < bits; shift += 8) {
+        _ulist_memset(count, 0, 256 * sizeof(mod_size_t));
+        for (mod_size_t i = 0; i < num; i++) {
+            count[(sort_key(ctx, src + i * isize) >> shift) & 0xFF]++;
+        }
+        if (count[(sort_key(ctx, src) >> shift) & 0xFF] == num)
+            continue;
+        mod_size_t sum = 0;
+        for (uint16_t d = 0; d < 256; d++) {
+            mod_size_t c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (mod_size_t i = 0; i < num; i++) {
+            uint8_t* p = src + i * isize;
+            uint8_t d = (sort_key(ctx, p) >> shift) & 0xFF;
+            _ulist_memcpy(dst + count[d]++ * isize, p, isize);
+        }
+        uint8_t* t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != base)
+        _ulist_memcpy(base, src, num * isize);
+}
+
+bool ulist_sort_by_key(ULIST list, ulist_key_t key_type, mod_size_t key_offset,
+                       mod_offset_t start, mod_offset_t end) {
+    if (key_offset + sort_key_bytes(key_type) > list->isize)
+        return false;
+
+    ULIST_LOCK();
+    mod_offset_t i = convert_pylike_offset(list, start);
+    mod_offset_t j = convert_pylike_offset(list, end);
+    if (i == -1 || j == -1)
+        ULIST_UNLOCK_RET(false);
+    if (j - i < 2)
+        ULIST_UNLOCK_RET(true);
+    sort_ctx_t ctx = {list->isize, key_offset, key_type};
+    mod_size_t num = j - i;
+    if (num >= ULIST_SORT_RADIX_NUM) {
+        mod_size_t count_size = 256 * sizeof(mod_size_t);
+        uint8_t* tmp = _ulist_malloc(count_size + ULIST_BSIZE(num));
+        if (tmp != NULL) {
+            sort_radix(&ctx, ULIST_PTR(i), num, tmp + count_size,
+                       (mod_size_t*)tmp);
+            _ulist_free(tmp);
+            ULIST_UNLOCK_RET(true);
+        }
+    }
+    uint8_t depth = 0;  // 2*log2(num)
+    for (mod_size_t n = num; n > 1; n >>= 1) depth += 2;
+    sort_introsort(&ctx, ULIST_PTR(i), num, depth);
+    ULIST_UNLOCK_RET(true);
+}
+
 mod_offset_t ulist_index(ULIST list, const void* ptr) {
     ULIST_LOCK();
     mod_offset_t i = (uint8_t*)ptr - (uint8_t*)list->data;
     if (i < 0 || i % list->isize != 0)
-        ULIST_UNLOCK_RET(false);
+        ULIST_UNLOCK_RET(-1);
     i /= list->isize;
     if (i >= list->num)
-        ULIST_UNLOCK_RET(false);
+        ULIST_UNLOCK_RET(-1);
     ULIST_UNLOCK_RET(i);
 }
 
+/**
+ * @brief 按整数类型T逐个比较, 每次检查4个元素以减少分支
+ */
+#define ULIST_FIND_WORD(T, load)                                     \
+    {                                                                \
+        T k = load(ptr);                                             \
+        const uint8_t* d = (const uint8_t*)list->data;               \
+        mod_offset_t i = 0;                                          \
+        for (; i + 4 <= list->num; i += 4, d += 4 * sizeof(T)) {     \
+            if ((load(d) == k) | (load(d + sizeof(T)) == k) |        \
+                (load(d + 2 * sizeof(T)) == k) |                     \
+                (load(d + 3 * sizeof(T)) == k))                      \
+                break;                                               \
+        }                                                            \
+        for (; i < list->num; i++, d += sizeof(T)) {                 \
+            if (load(d) == k)                                        \
+                ULIST_UNLOCK_RET(i);                                 \
+        }                                                            \
+        ULIST_UNLOCK_RET(-1);                                        \
+    }
+
 mod_offset_t ulist_find(ULIST list, const void* ptr) {
     ULIST_LOCK();
+    if (list->num == 0)
+        ULIST_UNLOCK_RET(-1);
+    switch (list->isize) {
+        case 1: {
+            const uint8_t* p =
+                memchr(list->data, *(const uint8_t*)ptr, list->num);
+            ULIST_UNLOCK_RET(p ? p - (const uint8_t*)list->data : -1);
+        }
+        case 2:
+            ULIST_FIND_WORD(uint16_t, load_u16);
+        case 4:
+            ULIST_FIND_WORD(uint32_t, load_u32);
+        case 8:
+            ULIST_FIND_WORD(uint64_t, load_u64);
+        default:
+            break;
+    }
     for (mod_offset_t i = 0; i < list->num; i++) {
-        if (_ulist_memcmp(ULIST_PTR(i), ptr, list->isize) == 0) {
+        if (item_equal(ULIST_PTR(i), ptr, list->isize)) {
             ULIST_UNLOCK_RET(i);
         }
     }
@@ -546,12 +895,30 @@ void ulist_mem_shrink(ULIST list, uint8_t force_auto_free) {
     if (force_auto_free) {
         list->opt &= ~ULIST_OPT_NO_AUTO_FREE;
     }
-    list->opt &= ~ULIST_OPT_NO_SHRINK;
-    ulist_shrink(list, list->num);
+    ulist_shrink(list, list->num, true);
     list->opt = opt;
     ULIST_UNLOCK();
 }
 
+bool ulist_reserve(ULIST list, mod_size_t num) {
+    ULIST_LOCK();
+    if (num == 0 || (list->data != NULL && num <= list->cap))
+        ULIST_UNLOCK_RET(true);
+    ULIST_UNLOCK_RET(ulist_set_cap(list, num));
+}
+
+void ulist_shrink_to_fit(ULIST list) {
+    ULIST_LOCK();
+    if (list->num == 0) {
+        _ulist_free(list->data);
+        list->data = NULL;
+        list->cap = 0;
+    } else if (list->cap > list->num) {
+        ulist_set_cap(list, list->num);
+    }
+    ULIST_UNLOCK();
+}
+
 void ulist_clear(ULIST list) {
     ULIST_LOCK();
     if (list->elfree != NULL && list->num > 0) {
@@ -559,7 +926,7 @@ void ulist_clear(ULIST list) {
             list->elfree(ULIST_PTR(i));
         }
     }
-    ulist_shrink(list, 0);
+    ulist_shrink(list, 0, false);
     list->num = 0;
     ULIST_UNLOCK();
 }
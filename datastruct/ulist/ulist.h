@@ -43,9 +43,23 @@ typedef struct {
 
 typedef ulist_iter_t* ULIST_ITER;
 
+typedef enum {      // 排序键类型(ulist_sort_by_key)
+    ULIST_KEY_U8,   // uint8_t
+    ULIST_KEY_I8,   // int8_t
+    ULIST_KEY_U16,  // uint16_t
+    ULIST_KEY_I16,  // int16_t
+    ULIST_KEY_U32,  // uint32_t
+    ULIST_KEY_I32,  // int32_t
+    ULIST_KEY_U64,  // uint64_t
+    ULIST_KEY_I64,  // int64_t
+    ULIST_KEY_F32,  // float
+    ULIST_KEY_F64,  // double
+} ulist_key_t;
+
 #define ULIST_DIRTY_REGION_FILL_DATA 0x00  // 区域填充值
 #define ULIST_DISABLE_ALL_LOG 0            // 禁用所有日志
 #define ULIST_MAX_EXTEND_SIZE 128          // 最大扩展大小(元素个数)
+#define ULIST_GEOMETRIC_GROWTH_DIV 2       // 按比例增长时的步长(个数/DIV)
 
 #define ULIST_OPT_CLEAR_DIRTY_REGION 0x01  // 用memset填充申请/释放的内存区域
 #define ULIST_OPT_NO_ALLOC_EXTEND 0x02  // 严格按照需要的大小分配内存
@@ -54,6 +68,7 @@ typedef ulist_iter_t* ULIST_ITER;
 #define ULIST_OPT_IGNORE_SLICE_ERROR 0x10  // 忽略切片越界错误
 #define ULIST_OPT_NO_ERROR_LOG 0x20        // 出错时不打印日志
 #define ULIST_OPT_NO_MUTEX 0x40            // 不使用互斥锁
+#define ULIST_OPT_GEOMETRIC_GROWTH 0x80  // 超过最大扩展大小后按比例增长
 
 /**
  * @brief 初始化一个已创建的列表
@@ -295,9 +310,21 @@ extern mod_offset_t ulist_index(ULIST list, const void* ptr);
  * @return            返回元素位置(>=0)
  * @note 返回-1说明数据不在列表中
  * @note 数据需具有和列表元素相同的结构
+ * @note 元素大小为1/2/4/8字节时按整数逐个比较, 其余先比较首个字再比较完整内容
  */
 extern mod_offset_t ulist_find(ULIST list, const void* ptr);
 
+/**
+ * @brief 删除列表中所有匹配的元素, 只移动一次数据
+ * @param  list       列表结构体
+ * @param  key        键指针
+ * @param  match      匹配函数(返回true时删除), 为NULL时删除与key数据相同的元素
+ * @return            删除的元素个数
+ */
+extern mod_size_t ulist_delete_matched(ULIST list, const void* key,
+                                       bool (*match)(const void* item,
+                                                     const void* key));
+
 /**
  * @brief 查找与对应键匹配的元素
  * @param  list       列表结构体
@@ -332,6 +359,21 @@ extern bool ulist_swap(ULIST list, mod_offset_t index1, mod_offset_t index2);
 extern bool ulist_sort(ULIST list, int (*cmp)(const void*, const void*),
                        mod_offset_t start, mod_offset_t end);
 
+/**
+ * @brief 按元素内的数值键排序(升序), 无需比较函数
+ * @param  list       列表结构体
+ * @param  key_type   键类型
+ * @param  key_offset 键在元素内的偏移(使用offsetof计算)
+ * @param  start      排序起始位置(`Python-like`)
+ * @param  end        排序结束位置(`Python-like`, 不包括)
+ * @retval            是否排序成功
+ * @note 元素较多时使用基数排序(稳定, 临时申请与排序范围等大的缓冲区),
+ * 元素较少或申请失败时使用原地内省排序(不稳定)
+ */
+extern bool ulist_sort_by_key(ULIST list, ulist_key_t key_type,
+                              mod_size_t key_offset, mod_offset_t start,
+                              mod_offset_t end);
+
 /**
  * @brief 创建列表迭代器
  * @param  list      列表结构体
@@ -413,6 +455,21 @@ extern void ulist_free(ULIST list);
  */
 extern void ulist_mem_shrink(ULIST list, uint8_t force_auto_free);
 
+/**
+ * @brief 预留容量, 使列表至少能容纳num个元素而无需再次扩容
+ * @param  list       列表结构体
+ * @param  num        需要的容量(元素个数)
+ * @retval            是否成功
+ * @note 自动缩减仍然生效, 需要长期保留容量时配合`ULIST_OPT_NO_SHRINK`使用
+ */
+extern bool ulist_reserve(ULIST list, mod_size_t num);
+
+/**
+ * @brief 将容量缩减为当前元素个数, 个数为0时释放内存
+ * @param  list       列表结构体
+ */
+extern void ulist_shrink_to_fit(ULIST list);
+
 /**
  * @brief 获取列表长度
  * @param  list       列表结构体
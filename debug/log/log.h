@@ -141,8 +141,61 @@ extern void log_hook(const char* fmt, ...);
     __LOG_TS(color, pre, lvl, "", add, suf, fmt, ##args)
 #endif  // LOG_CFG_ENABLE_FUNC_LINE
 
+#if LOG_CFG_ENABLE && LOG_CFG_ENABLE_DEFERRED
+typedef struct {         // 延迟日志描述符, 其地址即为格式ID
+    const char* fmt;     // 附加信息格式 "\x1f" 消息格式
+    const char* level;   // 日志等级
+    const char* color;   // 颜色代码
+    const char* module;  // 模块名(可为NULL)
+    const char* func;    // 函数名(可为NULL)
+    uint32_t line;       // 行号
+} log_desc_t;
+
+/**
+ * @brief 记录一条延迟日志(由日志宏调用)
+ * @param  desc             日志描述符
+ * @note 只保存描述符地址、时间戳与原始参数, 格式化由上位机完成
+ */
+extern void log_deferred(const log_desc_t* desc, ...);
+
+/**
+ * @brief 输出缓冲区中的延迟日志
+ * @param  write            输出函数, 为NULL时以"LOGD:"开头的十六进制行
+ *                          通过LOG_CFG_PRINTF输出
+ * @param  max_records      最多输出的记录数, 0为不限制
+ * @retval                  输出的记录数
+ * @note 在空闲任务或后台任务中周期调用, 同一时间只能有一个调用者
+ */
+extern uint32_t log_deferred_drain(void (*write)(const void* data,
+                                                 uint32_t len),
+                                   uint32_t max_records);
+
+#if defined(LOG_MODULE) && LOG_CFG_ENABLE_MODULE_NAME
+#define __LOG_DESC_MOD LOG_MODULE
+#else
+#define __LOG_DESC_MOD NULL
+#endif
+#if LOG_CFG_ENABLE_FUNC_LINE
+#define __LOG_DESC_FUNC __func__
+#else
+#define __LOG_DESC_FUNC NULL
+#endif
+
+#define __LOG_DEFERRED(lvl, color, add, fmt, args...)          \
+    do {                                                       \
+        static const log_desc_t SAFE_NAME(log_desc) = {        \
+            add "\x1f" fmt, lvl, T_FMT(color), __LOG_DESC_MOD, \
+            __LOG_DESC_FUNC, __LINE__};                        \
+        log_deferred(&SAFE_NAME(log_desc), ##args);            \
+    } while (0)
+
+// 延迟模式下前缀/后缀(如REFRESH的光标控制)被忽略
+#define __LOG(pre, lvl, color, add, suf, fmt, args...) \
+    __LOG_DEFERRED(lvl, color, add, fmt, ##args)
+#else
 #define __LOG(pre, lvl, color, add, suf, fmt, args...) \
     __LOG_FL(color, pre, lvl, add, suf, fmt, ##args)
+#endif  // LOG_CFG_ENABLE_DEFERRED
 
 #if LOG_CFG_ENABLE
 #define __LOG_LIMIT(_STR, _CLR, limit_ms, fmt, args...)          \
@@ -318,9 +371,10 @@ extern void log_hook(const char* fmt, ...);
     __LOG(LOG_CFG_PREFIX, level, color, "", LOG_CFG_SUFFIX LOG_CFG_NEWLINE, \
           fmt, ##args)
 
-#define __ASSERT_PRINT(text, args...)                         \
-    __LOG(LOG_CFG_PREFIX, LOG_CFG_A_STR, LOG_CFG_A_COLOR, "", \
-          LOG_CFG_SUFFIX LOG_CFG_NEWLINE, text, ##args)
+// 断言总是立即输出, 失败后可能进入死循环, 来不及等待延迟日志输出
+#define __ASSERT_PRINT(text, args...)                            \
+    __LOG_FL(LOG_CFG_A_COLOR, LOG_CFG_PREFIX, LOG_CFG_A_STR, "", \
+             LOG_CFG_SUFFIX LOG_CFG_NEWLINE, text, ##args)
 
 #if LOG_CFG_ENABLE_FUNC_LINE
 #define __ASSERT_COMMON(expr) __ASSERT_PRINT("'" #expr "' failed")
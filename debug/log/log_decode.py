@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+解码延迟日志(LOG_CFG_ENABLE_DEFERRED)输出的二进制流, 还原为文本日志
+
+输出流中只有描述符地址、时间戳与原始参数, 格式字符串、日志等级、模块名等按描述符地址从固件ELF文件中读取
+输入可以是 log_deferred_drain() 输出的二进制流, 也可以是包含"LOGD:"十六进制行的串口日志(其余行原样输出)
+
+用法: python log_decode.py <input> --elf firmware.elf [--color] [-o output.txt]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+REC_SYNC = 0xA5
+FLAG_TRUNC = 0x01
+FLAG_LOST = 0x02
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+SPEC = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+    r"(?P<len>hh|h|ll|l|j|z|t|L)?(?P<conv>[diouxXcfFeEgGaAspn%])"
+)
+
+
+class Elf:
+    """读取ELF中已分配段的内容, 按虚拟地址访问"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            sys.exit("%s is not an ELF file" % path)
+        self.ptr_size = {1: 4, 2: 8}[self.data[4]]
+        self.end = {1: "<", 2: ">"}[self.data[5]]
+        ptr = "I" if self.ptr_size == 4 else "Q"
+        if self.ptr_size == 4:
+            shoff, = struct.unpack_from(self.end + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(self.end + "HH", self.data, 0x2E)
+        else:
+            shoff, = struct.unpack_from(self.end + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(self.end + "HH", self.data, 0x3A)
+        sh = struct.Struct(self.end + "II" + ptr * 4)
+        self.sections = []
+        for i in range(shnum):
+            _, typ, flags, addr, off, size = sh.unpack_from(self.data, shoff + i * shentsize)
+            if flags & SHF_ALLOC and typ != SHT_NOBITS and size:
+                self.sections.append((addr, addr + size, off))
+        # 目标平台的整数大小: 32位为ILP32, 64位按LP64
+        self.sizes = {None: 4, "hh": 4, "h": 4, "l": self.ptr_size, "ll": 8,
+                      "j": 8, "z": self.ptr_size, "t": self.ptr_size}
+        self.ptr = self.end + ptr
+        self.ptr5 = self.end + ptr * 5
+        self.cache = {}
+
+    def read(self, addr, size):
+        for start, end, off in self.sections:
+            if start <= addr and addr + size <= end:
+                return self.data[off + addr - start : off + addr - start + size]
+        return None
+
+    def cstr(self, addr):
+        if not addr:
+            return None
+        for start, end, off in self.sections:
+            if start <= addr < end:
+                pos = off + addr - start
+                stop = self.data.index(b"\0", pos, off + end - start)
+                return self.data[pos:stop].decode("utf-8", "replace")
+        return None
+
+    def desc(self, addr):
+        """读取log_desc_t: 5个指针 + 行号"""
+        if addr in self.cache:
+            return self.cache[addr]
+        raw = self.read(addr, self.ptr_size * 5 + 4)
+        d = None
+        if raw:
+            ptrs = struct.unpack_from(self.ptr5, raw)
+            line, = struct.unpack_from(self.end + "I", raw, self.ptr_size * 5)
+            fmt = self.cstr(ptrs[0])
+            if fmt is not None and "\x1f" in fmt:
+                add, msg = fmt.split("\x1f", 1)
+                d = dict(add=add, fmt=msg, level=self.cstr(ptrs[1]) or "",
+                         color=self.cstr(ptrs[2]) or "", module=self.cstr(ptrs[3]),
+                         func=self.cstr(ptrs[4]), line=line)
+        self.cache[addr] = d
+        return d
+
+
+class Args:
+    """按目标平台的字节序依次取出原始参数"""
+
+    def __init__(self, elf, data):
+        self.elf = elf
+        self.data = data
+        self.pos = 0
+
+    def int(self, size, signed):
+        if self.pos + size > len(self.data):
+            raise IndexError
+        raw = self.data[self.pos : self.pos + size]
+        self.pos += size
+        return int.from_bytes(raw, "little" if self.elf.end == "<" else "big", signed=signed)
+
+    def double(self):
+        if self.pos + 8 > len(self.data):
+            raise IndexError
+        v, = struct.unpack_from(self.elf.end + "d", self.data, self.pos)
+        self.pos += 8
+        return v
+
+    def str(self):
+        n = self.data[self.pos]
+        if self.pos + 1 + n > len(self.data):
+            raise IndexError
+        s = self.data[self.pos + 1 : self.pos + 1 + n].decode("utf-8", "replace")
+        self.pos += 1 + n
+        return s
+
+
+def cformat(fmt, args, elf):
+    """按C格式字符串格式化, 参数不足时(记录被截断)保留剩余格式原文"""
+    out = []
+    pos = 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[pos : m.start()])
+        pos = m.end()
+        conv = m.group("conv")
+        if conv == "%":
+            out.append("%")
+            continue
+        try:
+            flags, width, prec = m.group("flags"), m.group("width"), m.group("prec")
+            if width == "*":
+                width = str(args.int(4, True))
+            if prec == "*":
+                prec = str(args.int(4, True))
+            spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+            length = m.group("len")
+            if conv in "diouxXc":
+                size = elf.sizes[length] if length != "L" else 8
+                v = args.int(size, conv in "di")
+                if length == "h":
+                    v = v & 0xFFFF
+                    v = v - 0x10000 if conv in "di" and v & 0x8000 else v
+                elif length == "hh":
+                    v = v & 0xFF
+                    v = v - 0x100 if conv in "di" and v & 0x80 else v
+                if "#" in flags and conv in "oxX" and (conv == "o" or not v):
+                    # C的%#o只保证首位为0, %#x对0不加前缀, 与Python不同
+                    if conv == "o":
+                        digits = len("%o" % v) + (1 if v else 0)
+                        prec = str(max(int(prec or 0), digits))
+                    spec = "%" + flags.replace("#", "") + (width or "")
+                    spec += "." + prec if prec is not None else ""
+                out.append((spec + ("d" if conv in "iu" else conv)) % v)
+            elif conv in "fFeEgG":
+                out.append((spec + conv) % args.double())
+            elif conv in "aA":
+                # Python固定输出13位小数, C省略末尾的0
+                v = re.sub(r"\.?0*p", "p", args.double().hex(), count=1)
+                out.append(v.upper() if conv == "A" else v)
+            elif conv == "p":
+                out.append("0x%x" % args.int(elf.ptr_size, False))
+            elif conv == "s":
+                out.append((spec + "s") % args.str())
+        except IndexError:
+            out.append(fmt[m.start() :])
+            return "".join(out)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+class Decoder:
+    def __init__(self, elf, color):
+        self.elf = elf
+        self.color = color
+        self.last_ts = None
+        self.wraps = 0
+
+    def timestamp(self, ts):
+        if self.last_ts is not None and ts < self.last_ts:  # 32位微秒时间戳回绕
+            self.wraps += 1
+        self.last_ts = ts
+        return (ts + (self.wraps << 32)) / 1e6
+
+    def record(self, flags, payload):
+        elf = self.elf
+        if flags & FLAG_LOST:
+            n, = struct.unpack_from(elf.end + "I", payload)
+            return "<%d records lost, buffer full>" % n
+        addr, = struct.unpack_from(elf.ptr, payload)
+        ts, = struct.unpack_from(elf.end + "I", payload, elf.ptr_size)
+        d = elf.desc(addr)
+        if d is None:
+            return "<unknown log id 0x%x>" % addr
+        parts = []
+        level = "[%s]" % d["level"]
+        parts.append(d["color"] + level + "\033[0m" if self.color and d["color"] else level)
+        parts.append("[%.3fs]" % self.timestamp(ts))
+        if d["module"]:
+            parts.append("[%s]" % d["module"])
+        if d["func"]:
+            parts.append("[%s:%d]" % (d["func"], d["line"]))
+        args = Args(elf, payload[elf.ptr_size + 4 :])
+        if d["add"]:
+            parts.append(cformat(d["add"], args, elf))
+        text = " ".join(parts) + " " + cformat(d["fmt"], args, elf)
+        if flags & FLAG_TRUNC:
+            text += " <truncated>"
+        return text
+
+    def stream(self, data):
+        """解析二进制流, 同步字节不匹配时逐字节重新同步"""
+        pos = 0
+        while pos + 3 <= len(data):
+            if data[pos] != REC_SYNC:
+                pos += 1
+                continue
+            n, flags = data[pos + 1], data[pos + 2]
+            if pos + 3 + n > len(data):
+                break
+            yield self.record(flags, data[pos + 3 : pos + 3 + n])
+            pos += 3 + n
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", help="二进制流或串口日志, '-'为标准输入")
+    parser.add_argument("--elf", required=True, help="固件ELF文件(需与运行的固件一致)")
+    parser.add_argument("--color", action="store_true", help="输出日志等级颜色")
+    parser.add_argument("-o", "--output", help="输出文件, 默认为标准输出")
+    args = parser.parse_args()
+
+    dec = Decoder(Elf(args.elf), args.color)
+    raw = sys.stdin.buffer.read() if args.input == "-" else open(args.input, "rb").read()
+    out = open(args.output, "w", encoding="utf-8") if args.output else sys.stdout
+    text = raw.decode("utf-8", "ignore")
+    if "LOGD:" in text:  # 文本日志, 逐行解码并保留其他输出
+        for line in text.splitlines():
+            m = re.search(r"LOGD:([0-9A-Fa-f]+)", line)
+            if not m:
+                out.write(line + "\n")
+                continue
+            for rec in dec.stream(bytes.fromhex(m.group(1))):
+                out.write(line[: m.start()] + rec + "\n")
+    else:
+        for rec in dec.stream(raw):
+            out.write(rec + "\n")
+
+
+if __name__ == "__main__":
+    main()
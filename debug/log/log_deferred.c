@@ -0,0 +1,304 @@
+/**
+ * @file log_deferred.c
+ * @brief 延迟日志: 日志宏只记录描述符地址与原始参数, 由空闲任务输出二进制流,
+ * 上位机根据ELF中的描述符还原文本(log_decode.py)
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-20
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "log.h"
+
+#if LOG_CFG_ENABLE && LOG_CFG_ENABLE_DEFERRED
+
+#include <stdarg.h>
+#include <string.h>
+
+#ifndef LOG_CFG_DEFERRED_BUFFER_SIZE
+#define LOG_CFG_DEFERRED_BUFFER_SIZE 2048
+#endif
+#ifndef LOG_CFG_DEFERRED_STR_MAX
+#define LOG_CFG_DEFERRED_STR_MAX 32
+#endif
+
+#if (LOG_CFG_DEFERRED_BUFFER_SIZE & (LOG_CFG_DEFERRED_BUFFER_SIZE - 1)) != 0
+#error "LOG_CFG_DEFERRED_BUFFER_SIZE must be a power of 2"
+#endif
+#define RING_MASK (LOG_CFG_DEFERRED_BUFFER_SIZE - 1)
+#define REC_MAX 128      // 单条记录的最大负载(字节), 在调用者栈上组装
+#define REC_SYNC 0xA5    // 输出流中每条记录的起始字节
+#define REC_READY 0xA5   // 记录头最高字节, 表示记录已写完
+#define FLAG_TRUNC 0x01  // 参数过多, 后续参数被丢弃
+#define FLAG_LOST 0x02   // 丢失计数记录, 负载为uint32_t个数
+#define HDR_SIZE 4       // 环形缓冲区中的记录头: 长度/标志/就绪标记
+#define ALIGN4(x) (((x) + 3u) & ~3u)
+
+#if MOD_CFG_ENABLE_ATOMIC
+#define HDR_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define HDR_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#else
+#define HDR_LOAD(p) (*(volatile uint32_t*)(p))
+#define HDR_STORE(p, v) (*(volatile uint32_t*)(p) = (v))
+#endif
+
+#if MOD_CFG_ENABLE_ATOMIC
+#define RING_LOCK() ((void)0)
+#define RING_UNLOCK() ((void)0)
+#else
+// 无原子操作时CAS与计数为普通读写, 中断嵌套写入可能抢到同一段空间,
+// 因此抢占空间及修改丢失计数期间关中断(可嵌套)
+#define RING_LOCK()                      \
+    uint32_t _primask = __get_PRIMASK(); \
+    __disable_irq()
+#define RING_UNLOCK() __set_PRIMASK(_primask)
+#endif
+
+// 环形缓冲区: 生产者通过CAS抢占空间, 写完负载后再写入记录头,
+// 消费者遇到未就绪的记录头即停止, 因此允许中断嵌套写入;
+// 消费者在释放空间前将其清零, 保证未写完的记录头读到的总是0
+static uint32_t ring[LOG_CFG_DEFERRED_BUFFER_SIZE / 4];
+static mod_atomic_size_t ring_head;  // 已抢占的字节数
+static mod_atomic_size_t ring_tail;  // 已输出的字节数
+static mod_atomic_size_t ring_lost;  // 缓冲区满而丢弃的记录数
+
+static void ring_write(uint32_t pos, const uint8_t* data, uint32_t len) {
+    uint8_t* buf = (uint8_t*)ring;
+    uint32_t off = pos & RING_MASK;
+    uint32_t first = LOG_CFG_DEFERRED_BUFFER_SIZE - off;
+    if (first > len)
+        first = len;
+    memcpy(buf + off, data, first);
+    memcpy(buf, data + first, len - first);
+}
+
+static void ring_zero(uint32_t pos, uint32_t len) {
+    uint8_t* buf = (uint8_t*)ring;
+    uint32_t off = pos & RING_MASK;
+    uint32_t first = LOG_CFG_DEFERRED_BUFFER_SIZE - off;
+    if (first > len)
+        first = len;
+    memset(buf + off, 0, first);
+    memset(buf, 0, len - first);
+}
+
+static void ring_read(uint32_t pos, uint8_t* data, uint32_t len) {
+    const uint8_t* buf = (const uint8_t*)ring;
+    uint32_t off = pos & RING_MASK;
+    uint32_t first = LOG_CFG_DEFERRED_BUFFER_SIZE - off;
+    if (first > len)
+        first = len;
+    memcpy(data, buf + off, first);
+    memcpy(data + first, buf, len - first);
+}
+
+/**
+ * @brief 按格式字符串从可变参数中取出原始参数
+ * @note 整数按实际类型大小保存, 浮点数保存为double, 字符串复制内容
+ * (最多LOG_CFG_DEFERRED_STR_MAX字节, 首字节为长度)
+ */
+static uint8_t pack_args(uint8_t* out, uint8_t cap, const char* fmt,
+                         va_list* ap, uint8_t* flags) {
+    uint8_t len = 0;
+#define PUT(type, promoted)                   \
+    do {                                      \
+        type v = (type)va_arg(*ap, promoted); \
+        if (len + sizeof(v) > cap) {          \
+            *flags |= FLAG_TRUNC;             \
+            return len;                       \
+        }                                     \
+        memcpy(out + len, &v, sizeof(v));     \
+        len += sizeof(v);                     \
+    } while (0)
+    while (*fmt) {
+        if (*fmt++ != '%')
+            continue;
+        if (*fmt == '%') {
+            fmt++;
+            continue;
+        }
+        while (*fmt && strchr("-+ #0", *fmt)) fmt++;
+        if (*fmt == '*') {
+            fmt++;
+            PUT(int, int);
+        }
+        while (*fmt >= '0' && *fmt <= '9') fmt++;
+        if (*fmt == '.') {
+            fmt++;
+            if (*fmt == '*') {
+                fmt++;
+                PUT(int, int);
+            }
+            while (*fmt >= '0' && *fmt <= '9') fmt++;
+        }
+        uint8_t size = sizeof(int);  // 整数参数大小
+        bool ldbl = false;           // long double参数
+        if (*fmt == 'h') {
+            fmt += (fmt[1] == 'h') ? 2 : 1;
+        } else if (*fmt == 'l') {
+            if (fmt[1] == 'l') {
+                size = sizeof(long long);
+                fmt += 2;
+            } else {
+                size = sizeof(long);
+                fmt++;
+            }
+        } else if (*fmt == 'j' || *fmt == 'z' || *fmt == 't') {
+            size = (*fmt == 'j') ? sizeof(intmax_t) : sizeof(size_t);
+            fmt++;
+        } else if (*fmt == 'L') {
+            ldbl = true;
+            fmt++;
+        }
+        char conv = *fmt;
+        if (!conv)
+            break;
+        fmt++;
+        switch (conv) {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'c':
+                if (size > sizeof(int))
+                    PUT(long long, long long);
+                else
+                    PUT(int, int);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (ldbl)
+                    PUT(double, long double);
+                else
+                    PUT(double, double);
+                break;
+            case 'p':
+                PUT(const void*, const void*);
+                break;
+            case 's': {
+                const char* str = va_arg(*ap, const char*);
+                if (str == NULL)
+                    str = "(null)";
+                const char* end = memchr(str, '\0', LOG_CFG_DEFERRED_STR_MAX);
+                uint8_t n = end ? end - str : LOG_CFG_DEFERRED_STR_MAX;
+                if (len + 1 + n > cap) {
+                    *flags |= FLAG_TRUNC;
+                    return len;
+                }
+                out[len++] = n;
+                memcpy(out + len, str, n);
+                len += n;
+                break;
+            }
+            case 'n':
+                (void)va_arg(*ap, void*);
+                break;
+            default:  // 未知的转换符, 无法确定参数类型
+                *flags |= FLAG_TRUNC;
+                return len;
+        }
+    }
+#undef PUT
+    return len;
+}
+
+static void ring_push(const uint8_t* payload, uint8_t len, uint8_t flags) {
+    uint32_t need = ALIGN4(HDR_SIZE + len);
+    mod_atomic_value_t head, tail;
+    RING_LOCK();
+    do {
+        head = MOD_ATOMIC_LOAD(ring_head, MOD_ATOMIC_ORDER_RELAXED);
+        tail = MOD_ATOMIC_LOAD(ring_tail, MOD_ATOMIC_ORDER_ACQUIRE);
+        if ((uint32_t)(head - tail) + need > LOG_CFG_DEFERRED_BUFFER_SIZE) {
+            (void)MOD_ATOMIC_FETCH_ADD(ring_lost, 1, MOD_ATOMIC_ORDER_RELAXED);
+            RING_UNLOCK();
+            return;
+        }
+    } while (!MOD_ATOMIC_CAS(ring_head, head, head + need,
+                             MOD_ATOMIC_ORDER_RELAXED));
+    RING_UNLOCK();
+    ring_write(head + HDR_SIZE, payload, len);
+    HDR_STORE(&ring[(head & RING_MASK) / 4],
+              len | ((uint32_t)flags << 8) | ((uint32_t)REC_READY << 24));
+}
+
+void log_deferred(const log_desc_t* desc, ...) {
+    uint8_t rec[REC_MAX];
+    uint8_t flags = 0;
+    uint32_t ts = (uint32_t)m_time_us();
+    memcpy(rec, &desc, sizeof(desc));
+    memcpy(rec + sizeof(desc), &ts, sizeof(ts));
+    uint8_t len = sizeof(desc) + sizeof(ts);
+    va_list ap;
+    va_start(ap, desc);
+    len += pack_args(rec + len, REC_MAX - len, desc->fmt, &ap, &flags);
+    va_end(ap);
+    ring_push(rec, len, flags);
+}
+
+static void write_hex(const void* data, uint32_t len) {
+    static const char hex[] = "0123456789ABCDEF";
+    static char line[2 * (3 + REC_MAX) + 1];  // 仅在输出任务中使用
+    const uint8_t* p = (const uint8_t*)data;
+    for (uint32_t i = 0; i < len; i++) {
+        line[2 * i] = hex[p[i] >> 4];
+        line[2 * i + 1] = hex[p[i] & 0x0F];
+    }
+    line[2 * len] = '\0';
+    LOG_CFG_PRINTF("LOGD:%s" LOG_CFG_NEWLINE, line);
+}
+
+uint32_t log_deferred_drain(void (*write)(const void* data, uint32_t len),
+                            uint32_t max_records) {
+    uint8_t rec[3 + REC_MAX];  // 同步字节/长度/标志 + 负载
+    uint32_t count = 0;
+    if (write == NULL)
+        write = write_hex;
+    rec[0] = REC_SYNC;
+    mod_atomic_value_t tail =
+        MOD_ATOMIC_LOAD(ring_tail, MOD_ATOMIC_ORDER_RELAXED);
+    while (!max_records || count < max_records) {
+        if (tail == MOD_ATOMIC_LOAD(ring_head, MOD_ATOMIC_ORDER_ACQUIRE))
+            break;
+        uint32_t* hdr = &ring[(tail & RING_MASK) / 4];
+        uint32_t h = HDR_LOAD(hdr);
+        if ((h >> 24) != REC_READY)  // 生产者尚未写完
+            break;
+        uint8_t len = h & 0xFF;
+        rec[1] = len;
+        rec[2] = (h >> 8) & 0xFF;
+        ring_read(tail + HDR_SIZE, rec + 3, len);
+        // 清零整条记录: 之后的记录头可能落在本条负载的位置上,
+        // 残留的负载字节不能被误认为就绪标记
+        ring_zero(tail, ALIGN4(HDR_SIZE + len));
+        tail += ALIGN4(HDR_SIZE + len);
+        MOD_ATOMIC_STORE(ring_tail, tail, MOD_ATOMIC_ORDER_RELEASE);
+        write(rec, 3 + len);
+        count++;
+    }
+    // 缓冲区已清空时再报告丢失数, 使其位于丢失发生前的记录之后
+    mod_atomic_value_t lost =
+        MOD_ATOMIC_LOAD(ring_lost, MOD_ATOMIC_ORDER_RELAXED);
+    if (lost && tail == MOD_ATOMIC_LOAD(ring_head, MOD_ATOMIC_ORDER_ACQUIRE)) {
+        RING_LOCK();
+        (void)MOD_ATOMIC_FETCH_ADD(ring_lost, -lost, MOD_ATOMIC_ORDER_RELAXED);
+        RING_UNLOCK();
+        uint32_t n = lost;
+        rec[1] = sizeof(n);
+        rec[2] = FLAG_LOST;
+        memcpy(rec + 3, &n, sizeof(n));
+        write(rec, 3 + sizeof(n));
+    }
+    return count;
+}
+
+#endif  // LOG_CFG_ENABLE_DEFERRED
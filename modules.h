@@ -172,15 +172,15 @@ extern void mod_custom_delay_s(m_time_t s);
 #include "stdlib.h"
 // You should configure CubeMX instead of using this!
 #define init_module_heap(ptr, size) (YOU_SHOULD_CONFIG_CUBEMX_INSTEAD)
-#define m_alloc(size) malloc(size)
-#define m_free(ptr) free(ptr)
-#define m_realloc(ptr, size) realloc(ptr, size)
+#define _m_heap_alloc(size) malloc(size)
+#define _m_heap_free(ptr) free(ptr)
+#define _m_heap_realloc(ptr, size) realloc(ptr, size)
 #elif MOD_CFG_HEAP_MATHOD_HEAP4  // heap4
 #include "heap4.h"
 #define init_module_heap(ptr, size) prvHeapInit(ptr, size)
-#define m_alloc(size) pvPortMalloc(size)
-#define m_free(ptr) vPortFree(ptr)
-#define m_realloc(ptr, size) pvPortRealloc((ptr), size)
+#define _m_heap_alloc(size) pvPortMalloc(size)
+#define _m_heap_free(ptr) vPortFree(ptr)
+#define _m_heap_realloc(ptr, size) pvPortRealloc((ptr), size)
 #elif MOD_CFG_HEAP_MATHOD_LWMEM  // lwmem
 #include "lwmem.h"
 #define init_module_heap(ptr, size)                                  \
@@ -188,30 +188,36 @@ extern void mod_custom_delay_s(m_time_t s);
         static lwmem_region_t _regions[] = {{ptr, size}, {NULL, 0}}; \
         lwmem_assignmem(_regions)                                    \
     } while (0)
-#define m_alloc(size) lwmem_malloc(size)
-#define m_free(ptr) lwmem_free(ptr)
-#define m_realloc(ptr, size) lwmem_realloc(ptr, size)
+#define _m_heap_alloc(size) lwmem_malloc(size)
+#define _m_heap_free(ptr) lwmem_free(ptr)
+#define _m_heap_realloc(ptr, size) lwmem_realloc(ptr, size)
+#elif MOD_CFG_HEAP_MATHOD_TLSF  // tlsf
+#include "tlsf.h"
+#define init_module_heap(ptr, size) tlsf_heap_init(ptr, size)
+#define _m_heap_alloc(size) tlsf_malloc(size)
+#define _m_heap_free(ptr) tlsf_free(ptr)
+#define _m_heap_realloc(ptr, size) tlsf_realloc(ptr, size)
 #elif MOD_CFG_HEAP_MATHOD_KLITE  // klite
 #include "klite.h"
 // You should init klite instead of using this!
 #define init_module_heap(ptr, size) (YOU_SHOULD_CONFIG_KLITE_INSTEAD)
-#define m_alloc(size) kl_heap_alloc(size)
-#define m_free(ptr) kl_heap_free((ptr))
-#define m_realloc(ptr, size) kl_heap_realloc((ptr), size)
+#define _m_heap_alloc(size) kl_heap_alloc(size)
+#define _m_heap_free(ptr) kl_heap_free((ptr))
+#define _m_heap_realloc(ptr, size) kl_heap_realloc((ptr), size)
 #elif MOD_CFG_HEAP_MATHOD_FREERTOS  // freertos
 #include "FreeRTOS.h"
 // You should init freertos instead of using this!
 #define init_module_heap(ptr, size) (YOU_SHOULD_CONFIG_FREERTOS_INSTEAD)
-#define m_alloc(size) vPortMalloc(size)
-#define m_free(ptr) vPortFree(ptr)
-#define m_realloc(ptr, size) pvPortRealloc((ptr), size)
+#define _m_heap_alloc(size) vPortMalloc(size)
+#define _m_heap_free(ptr) vPortFree(ptr)
+#define _m_heap_realloc(ptr, size) pvPortRealloc((ptr), size)
 #elif MOD_CFG_HEAP_MATHOD_RTT  // rtthread
 #include "rtthread.h"
 // You should init rtthread instead of using this!
 #define init_module_heap(ptr, size) (YOU_SHOULD_CONFIG_RTTHREAD_INSTEAD)
-#define m_alloc(size) rt_malloc(size)
-#define m_free(ptr) rt_free(ptr)
-#define m_realloc(ptr, size) rt_realloc(ptr, size)
+#define _m_heap_alloc(size) rt_malloc(size)
+#define _m_heap_free(ptr) rt_free(ptr)
+#define _m_heap_realloc(ptr, size) rt_realloc(ptr, size)
 #elif MOD_CFG_HEAP_MATHOD_CUSTOM  // custom
 #if MOD_CFG_CUSTOM_HEAP_IMPORT
 #include MOD_CFG_CUSTOM_HEAP_HEADER
@@ -221,13 +227,35 @@ extern void* mod_custom_heap_alloc(size_t size);
 extern void mod_custom_heap_free(void* ptr);
 extern void* mod_custom_heap_realloc(void* ptr, size_t size);
 #define init_module_heap(ptr, size) mod_custom_heap_init(ptr, size)
-#define m_alloc(size) mod_custom_heap_alloc(size)
-#define m_free(ptr) mod_custom_heap_free(ptr)
-#define m_realloc(ptr, size) mod_custom_heap_realloc(ptr, size)
+#define _m_heap_alloc(size) mod_custom_heap_alloc(size)
+#define _m_heap_free(ptr) mod_custom_heap_free(ptr)
+#define _m_heap_realloc(ptr, size) mod_custom_heap_realloc(ptr, size)
 #else
 #error "MODCFG__HEAP_MATHOD invalid"
 #endif
 
+#if MOD_CFG_HEAP_SLAB  // 小块内存由分级分配前端处理, 其余转交上面的后端
+#include "mslab.h"
+#define _m_alloc(size) mslab_alloc(size)
+#define _m_free(ptr) mslab_free(ptr)
+#define _m_realloc(ptr, size) mslab_realloc(ptr, size)
+#else
+#define _m_alloc(size) _m_heap_alloc(size)
+#define _m_free(ptr) _m_heap_free(ptr)
+#define _m_realloc(ptr, size) _m_heap_realloc(ptr, size)
+#endif
+
+#if MOD_CFG_HEAP_TRACE  // 分配追踪包裹在最外层, 记录调用位置
+#include "mtrace.h"
+#define m_alloc(size) mtrace_alloc(size)
+#define m_free(ptr) mtrace_free(ptr)
+#define m_realloc(ptr, size) mtrace_realloc(ptr, size)
+#else
+#define m_alloc(size) _m_alloc(size)
+#define m_free(ptr) _m_free(ptr)
+#define m_realloc(ptr, size) _m_realloc(ptr, size)
+#endif
+
 #if MOD_CFG_USE_OS_NONE  // none
 #define MOD_MUTEX_HANDLE __attribute__((unused)) uint8_t
 #define MOD_MUTEX_CREATE(name) (1)
@@ -306,21 +334,34 @@ typedef int32_t mod_offset_t;
 #include <stdatomic.h>
 typedef atomic_uint_fast32_t mod_atomic_size_t;
 typedef atomic_int_fast32_t mod_atomic_offset_t;
+typedef uint_fast32_t mod_atomic_value_t;  // 原子变量的普通值类型
 #define MOD_ATOMIC_INIT(var, val) atomic_init(&(var), (val))
 #define MOD_ATOMIC_LOAD(var, type) atomic_load_explicit(&(var), (type))
 #define MOD_ATOMIC_STORE(var, val, type) \
     atomic_store_explicit(&(var), (val), (type))
+#define MOD_ATOMIC_CAS(var, expected, desired, type)                     \
+    atomic_compare_exchange_weak_explicit(&(var), &(expected), (desired), \
+                                          (type), __ATOMIC_RELAXED)
+#define MOD_ATOMIC_FETCH_ADD(var, val, type) \
+    atomic_fetch_add_explicit(&(var), (val), (type))
 #define MOD_ATOMIC_ORDER_ACQUIRE __ATOMIC_ACQUIRE
 #define MOD_ATOMIC_ORDER_RELEASE __ATOMIC_RELEASE
+#define MOD_ATOMIC_ORDER_ACQ_REL __ATOMIC_ACQ_REL
 #define MOD_ATOMIC_ORDER_RELAXED __ATOMIC_RELAXED
 #else
 typedef uint32_t mod_atomic_size_t;
 typedef int32_t mod_atomic_offset_t;
+typedef uint32_t mod_atomic_value_t;
 #define MOD_ATOMIC_INIT(var, val) (var) = (val)
 #define MOD_ATOMIC_LOAD(var, type) (var)
 #define MOD_ATOMIC_STORE(var, val, type) (var) = (val)
+// 非原子实现, 仅在生产者不会互相抢占时安全(如单一中断优先级)
+#define MOD_ATOMIC_CAS(var, expected, desired, type) \
+    ((var) == (expected) ? ((var) = (desired), 1) : ((expected) = (var), 0))
+#define MOD_ATOMIC_FETCH_ADD(var, val, type) (((var) += (val)) - (val))
 #define MOD_ATOMIC_ORDER_ACQUIRE 0
 #define MOD_ATOMIC_ORDER_RELEASE 0
+#define MOD_ATOMIC_ORDER_ACQ_REL 0
 #define MOD_ATOMIC_ORDER_RELAXED 0
 #endif
 
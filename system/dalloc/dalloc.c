@@ -55,6 +55,12 @@ void heap_init(dl_heap_t* heap_struct_ptr, void* mem_ptr,
     heap_struct_ptr->total_size = mem_size;
     heap_struct_ptr->alloc_info.allocations_num = 0;
     heap_struct_ptr->alloc_info.max_memory_amount = 0;
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+    heap_struct_ptr->pending_size = 0;
+    heap_struct_ptr->defrag_done = 0;
+    heap_struct_ptr->defrag_next = 0;
+    heap_struct_ptr->defrag_offset = 0;
+#endif
     for (uint32_t i = 0; i < MAX_NUM_OF_ALLOCATIONS; i++) {
         heap_struct_ptr->alloc_info.ptr_info_arr[i].ptr = NULL;
         heap_struct_ptr->alloc_info.ptr_info_arr[i].alloc_info = 0;
@@ -86,6 +92,18 @@ void dalloc(dl_heap_t* heap_struct_ptr, uint32_t size, void** ptr) {
     }
 #endif
 
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+    /* Not enough room left, finish the pending compaction first */
+    if (heap_struct_ptr->pending_size &&
+        ((new_offset > heap_struct_ptr->total_size) ||
+         (heap_struct_ptr->alloc_info.allocations_num >=
+          MAX_NUM_OF_ALLOCATIONS))) {
+        uint32_t old_offset = heap_struct_ptr->offset;
+        dalloc_defrag_step(heap_struct_ptr, UINT32_MAX);
+        new_offset -= old_offset - heap_struct_ptr->offset;
+    }
+#endif
+
     /* Check if there is enough memory for new allocation, and if number of
    * allocations is exceeded */
     if ((new_offset <= heap_struct_ptr->total_size) &&
@@ -137,6 +155,10 @@ void dalloc(dl_heap_t* heap_struct_ptr, uint32_t size, void** ptr) {
 bool validate_ptr(dl_heap_t* heap_struct_ptr, void** ptr,
                   validate_ptr_condition_t condition, uint32_t* ptr_index) {
     for (uint32_t i = 0; i < heap_struct_ptr->alloc_info.allocations_num; i++) {
+        /* Freed entries waiting for defragmentation have no pointer */
+        if (FREEFLAG_GET(heap_struct_ptr->alloc_info.ptr_info_arr[i])) {
+            continue;
+        }
         if (condition == USING_PTR_ADDRESS) {
             if (heap_struct_ptr->alloc_info.ptr_info_arr[i].ptr ==
                 (uint8_t**)ptr) {
@@ -272,9 +294,99 @@ void dfree(dl_heap_t* heap_struct_ptr, void** ptr,
         *(*(heap_struct_ptr->alloc_info.ptr_info_arr[ptr_index].ptr) + i) = 0;
     }
 #endif
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+    /* A hole below the compact part, the next step resumes from here */
+    if (ptr_index < heap_struct_ptr->defrag_done) {
+        heap_struct_ptr->defrag_done = ptr_index;
+        heap_struct_ptr->defrag_next = ptr_index;
+        heap_struct_ptr->defrag_offset = (uint32_t)(
+            *(heap_struct_ptr->alloc_info.ptr_info_arr[ptr_index].ptr) -
+            heap_struct_ptr->mem);
+    }
+    /* The block stays in place until dalloc_defrag_step reaches it, detach
+     * the pointer now so that the variable can be reused right away */
+    *(heap_struct_ptr->alloc_info.ptr_info_arr[ptr_index].ptr) = NULL;
+    heap_struct_ptr->alloc_info.ptr_info_arr[ptr_index].ptr = NULL;
+    heap_struct_ptr->pending_size += alloc_size;
+#else
     defrag_memory(heap_struct_ptr);
+#endif
 }
 
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+bool dalloc_defrag_step(dl_heap_t* heap_struct_ptr, uint32_t max_bytes) {
+    if (heap_struct_ptr == NULL || heap_struct_ptr->pending_size == 0) {
+        return false;
+    }
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    uint8_t* cursor = heap_struct_ptr->mem + heap_struct_ptr->defrag_offset;
+    uint32_t done = heap_struct_ptr->defrag_done;
+    uint32_t next = heap_struct_ptr->defrag_next;
+    uint32_t moved = 0;
+
+    /* Blocks are laid out in the order of ptr_info_arr. Entries below done
+     * are live and end at cursor, entries from done to next are consumed
+     * (marked free) and the rest is not visited yet. A live block found
+     * above the cursor is behind a hole and is moved down */
+    while (next < info->allocations_num) {
+        if (FREEFLAG_GET(info->ptr_info_arr[next])) {
+            next++;
+            continue;
+        }
+        uint32_t alloc_size = ALLOCSIZE_GET(info->ptr_info_arr[next]);
+#if USE_ALIGNMENT
+        while (alloc_size % ALLOCATION_ALIGNMENT_BYTES != 0) {
+            alloc_size += 1;
+        }
+#endif
+        uint8_t* src = *(info->ptr_info_arr[next].ptr);
+        if (src != cursor) {
+            if (moved && (moved + alloc_size > max_bytes)) {
+                /* Out of budget, continue next step */
+                heap_struct_ptr->defrag_done = done;
+                heap_struct_ptr->defrag_next = next;
+                heap_struct_ptr->defrag_offset =
+                    (uint32_t)(cursor - heap_struct_ptr->mem);
+                return true;
+            }
+            size_t gap = (size_t)(src - cursor);
+            memmove(cursor, src, alloc_size);
+
+            /* Pointer variables stored inside the moved block moved too */
+            for (uint32_t k = 0; k < info->allocations_num; k++) {
+                uint8_t* var = (uint8_t*)info->ptr_info_arr[k].ptr;
+                if ((var >= src) && (var < src + alloc_size)) {
+                    info->ptr_info_arr[k].ptr = (uint8_t**)(var - gap);
+                }
+            }
+            *(info->ptr_info_arr[next].ptr) = cursor;
+            moved += alloc_size;
+        }
+        if (next != done) {
+            info->ptr_info_arr[done] = info->ptr_info_arr[next];
+            info->ptr_info_arr[next].ptr = NULL;
+            FREEFLAG_SET(info->ptr_info_arr[next]);
+        }
+        cursor += alloc_size;
+        done++;
+        next++;
+    }
+
+    /* All holes are closed, release the tail */
+    uint32_t new_offset = (uint32_t)(cursor - heap_struct_ptr->mem);
+#if FILL_FREED_MEMORY_BY_NULLS
+    memset(cursor, 0, heap_struct_ptr->offset - new_offset);
+#endif
+    info->allocations_num = done;
+    heap_struct_ptr->offset = new_offset;
+    heap_struct_ptr->pending_size = 0;
+    heap_struct_ptr->defrag_done = done;
+    heap_struct_ptr->defrag_next = done;
+    heap_struct_ptr->defrag_offset = new_offset;
+    return false;
+}
+#endif
+
 void replace_pointers(dl_heap_t* heap_struct_ptr, void** ptr_to_replace,
                       void** ptr_new) {
     uint32_t ptr_ind = 0;
@@ -343,6 +455,9 @@ void dump_heap(dl_heap_t* heap_struct_ptr) {
 void dump_dalloc_ptr_info(dl_heap_t* heap_struct_ptr) {
     PRINTLN("************ Ptr Info ************PRINTLN$1");
     for (uint32_t i = 0; i < heap_struct_ptr->alloc_info.allocations_num; i++) {
+        if (FREEFLAG_GET(heap_struct_ptr->alloc_info.ptr_info_arr[i])) {
+            continue;
+        }
         PRINTLN(
             "Ptr address: 0x%08X, ptr first val: 0x%02X, alloc size: "
             "%luPRINTLN$1",
@@ -357,6 +472,9 @@ void dump_dalloc_ptr_info(dl_heap_t* heap_struct_ptr) {
 float get_heap_usage(dl_heap_t* heap_struct_ptr) {
     uint32_t alloc_size = 0;
     for (uint32_t i = 0; i < heap_struct_ptr->alloc_info.allocations_num; i++) {
+        if (FREEFLAG_GET(heap_struct_ptr->alloc_info.ptr_info_arr[i])) {
+            continue;
+        }
         alloc_size +=
             ALLOCSIZE_GET(heap_struct_ptr->alloc_info.ptr_info_arr[i]);
     }
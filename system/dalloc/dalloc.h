@@ -40,6 +40,16 @@ extern "C" {
 
 #define ALLOC_INFO_U16 1
 
+/* Compact the heap in bounded steps (dalloc_defrag_step) instead of
+ * synchronously inside dfree */
+#ifndef DALLOC_CFG_INCREMENTAL_DEFRAG
+#define DALLOC_CFG_INCREMENTAL_DEFRAG 0
+#endif
+
+#if DALLOC_CFG_INCREMENTAL_DEFRAG && !defined(DALLOC_CFG_DEFRAG_STEP_BYTES)
+#define DALLOC_CFG_DEFRAG_STEP_BYTES 256UL
+#endif
+
 #if USE_SINGLE_HEAP_MEMORY
 #define SINGLE_HEAP_SIZE (1UL * 1024UL)
 #endif
@@ -81,6 +91,12 @@ typedef struct {
         total_size; /* Total size of memory that can be used for allocation
                         memory */
     alloc_info_t alloc_info;
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+    uint32_t pending_size;  /* Size of freed memory not compacted yet */
+    uint32_t defrag_done;   /* Entries below are live and compact */
+    uint32_t defrag_next;   /* First entry not visited in this pass */
+    uint32_t defrag_offset; /* End of the compact part of the heap */
+#endif
 } dl_heap_t;
 
 #pragma pack()
@@ -145,6 +161,15 @@ extern uint8_t single_heap[];
  */
 #define get_def_heap_usage() get_heap_usage(&default_heap)
 
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+/**
+ * @brief Run one defragmentation step on the default heap
+ * @return true if there is still work left
+ */
+#define def_dalloc_defrag_step() \
+    dalloc_defrag_step(&default_heap, DALLOC_CFG_DEFRAG_STEP_BYTES)
+#endif
+
 #define _dalloc(ptr, size) def_dalloc(size, (void**)&(ptr))
 // #define _dfree(ptr) def_dfree((void **)&(ptr))
 #define _dfree(ptr) def_dfree_value((void*)(ptr))
@@ -198,6 +223,23 @@ bool validate_ptr(dl_heap_t* heap_struct_ptr, void** ptr,
 void dfree(dl_heap_t* heap_struct_ptr, void** ptr,
            validate_ptr_condition_t condition);
 
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+/**
+ * @brief Run one bounded step of incremental defragmentation
+ * @param  heap_struct_ptr - pointer to heap structure
+ * @param  max_bytes - maximum number of bytes to move in this step
+ * @return true if there is still work left, false if the heap is compact
+ * @note Blocks are moved whole, a block larger than max_bytes is moved alone
+ * @note A step resumes where the previous one stopped (dfree below that point
+ *       rewinds it). It visits each entry once and, for every block it moves,
+ *       scans all entries for pointer variables stored inside that block, so
+ *       a step costs O(visited entries + moved blocks * allocations_num) plus
+ *       the bytes moved
+ * @note Call it periodically, e.g. from the scheduler idle hook
+ */
+bool dalloc_defrag_step(dl_heap_t* heap_struct_ptr, uint32_t max_bytes);
+#endif
+
 /**
  * @brief Print information about a heap
  * @param  heap_struct_ptr - pointer to heap structure
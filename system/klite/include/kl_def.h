@@ -32,8 +32,13 @@ typedef enum {
     KL_ENFOUND,   // 未找到
 } kl_err_t;
 
+#if KLITE_CFG_64BIT_SIZE
+typedef uint64_t kl_size_t;
+typedef int64_t kl_ssize_t;
+#else
 typedef uint32_t kl_size_t;
 typedef int32_t kl_ssize_t;
+#endif
 
 #define KL_THREAD_FLAGS_READY (1U << 0)
 #define KL_THREAD_FLAGS_SLEEP (1U << 1)
@@ -220,13 +225,22 @@ typedef struct kl_mqueue* kl_mqueue_t;
 #endif
 
 #if KLITE_CFG_IPC_TIMER
+#ifndef KLITE_CFG_TIMER_WHEEL_BITS
+#define KLITE_CFG_TIMER_WHEEL_BITS 6
+#endif
+#define KL_TIMER_WHEEL_LEVELS 4  // 时间轮层数
+#define KL_TIMER_WHEEL_SIZE (1U << KLITE_CFG_TIMER_WHEEL_BITS)  // 每层槽数
+#define KL_TIMER_WHEEL_WORDS ((KL_TIMER_WHEEL_SIZE + 31) / 32)  // 位图字数
+
 struct kl_timer_task {
-    struct kl_timer_task* next;
+    struct kl_timer_task* next;  // 定时器任务注册链表
     struct kl_timer* timer;
+    struct kl_timer_task* wnext;    // 时间轮槽链表
+    struct kl_timer_task** wpprev;  // 指向前驱的next指针, NULL表示未启动
     void (*handler)(void*);
     void* arg;
     kl_tick_t reload;
-    kl_tick_t timeout;
+    kl_tick_t expire;  // 绝对到期时刻
     bool loop;
 };
 typedef struct kl_timer_task* kl_timer_task_t;
@@ -236,6 +250,9 @@ struct kl_timer {
     struct kl_mutex mutex;
     struct kl_cond cond;
     kl_thread_t thread;
+    kl_tick_t now;  // 时间轮已推进到的时刻
+    uint32_t bitmap[KL_TIMER_WHEEL_LEVELS][KL_TIMER_WHEEL_WORDS];
+    struct kl_timer_task* wheel[KL_TIMER_WHEEL_LEVELS][KL_TIMER_WHEEL_SIZE];
 };
 typedef struct kl_timer* kl_timer_t;
 #endif
@@ -122,6 +122,11 @@ void kl_sched_tcb_resume(kl_thread_t tcb);
 // @param timeout: 睡眠时间
 void kl_sched_tcb_sleep(kl_thread_t tcb, kl_tick_t timeout);
 
+// 获取线程剩余超时时间(睡眠中的线程实时计算)
+// @param tcb: 线程控制块
+// @return: 剩余超时时间
+kl_tick_t kl_sched_tcb_timeout(kl_thread_t tcb);
+
 // 将线程加入等待队列
 // @param tcb: 线程控制块
 // @param list: 等待队列
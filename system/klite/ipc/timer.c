@@ -6,44 +6,168 @@
 
 #include "kl_slist.h"
 
-static kl_tick_t kl_timer_process(kl_timer_t timer, kl_tick_t inc) {
-    kl_timer_task_t task;
-    kl_tick_t timeout = KL_WAIT_FOREVER;
-    kl_mutex_lock(&timer->mutex, KL_WAIT_FOREVER);
-    for (task = timer->head; task != NULL; task = task->next) {
-        if (task->reload == 0) {
+/*
+ * 分层时间轮: KL_TIMER_WHEEL_LEVELS层, 每层KL_TIMER_WHEEL_SIZE个槽.
+ * 第l层每槽覆盖2^(l*BITS)个tick, 任务按剩余时间挂入对应层的槽中,
+ * 时间轮推进到高层槽的起始时刻时将其中任务重新分配(级联)到低层.
+ * 启动/停止为O(1), 推进时借助占用位图直接跳到下一个非空槽,
+ * 开销只与实际到期和级联的任务数有关.
+ */
+
+#define WHEEL_BITS KLITE_CFG_TIMER_WHEEL_BITS
+#define WHEEL_SIZE KL_TIMER_WHEEL_SIZE
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS KL_TIMER_WHEEL_LEVELS
+#define LEVEL_SHIFT(level) ((level) * WHEEL_BITS)
+#define WHEEL_RANGE ((kl_tick_t)1 << (WHEEL_LEVELS * WHEEL_BITS))
+
+static void wheel_link(kl_timer_t timer, kl_timer_task_t task) {
+    kl_tick_t delta = task->expire - timer->now;
+    kl_tick_t when = task->expire;
+    uint32_t level, slot;
+    /* 超出时间轮范围, 挂到最远处, 级联时再重新计算 */
+    if (delta >= WHEEL_RANGE) {
+        delta = WHEEL_RANGE - 1;
+        when = timer->now + delta;
+    }
+    for (level = 0; level < WHEEL_LEVELS - 1; level++) {
+        if (delta < ((kl_tick_t)1 << LEVEL_SHIFT(level + 1))) {
+            break;
+        }
+    }
+    slot = (uint32_t)(when >> LEVEL_SHIFT(level)) & WHEEL_MASK;
+    task->wnext = timer->wheel[level][slot];
+    if (task->wnext != NULL) {
+        task->wnext->wpprev = &task->wnext;
+    }
+    task->wpprev = &timer->wheel[level][slot];
+    timer->wheel[level][slot] = task;
+    timer->bitmap[level][slot >> 5] |= 1U << (slot & 31);
+}
+
+static void wheel_unlink(kl_timer_t timer, kl_timer_task_t task) {
+    uint32_t index, slot;
+    if (task->wpprev == NULL) {
+        return;
+    }
+    *task->wpprev = task->wnext;
+    if (task->wnext != NULL) {
+        task->wnext->wpprev = task->wpprev;
+    } else if (*task->wpprev == NULL &&
+               task->wpprev >= &timer->wheel[0][0] &&
+               task->wpprev <= &timer->wheel[WHEEL_LEVELS - 1][WHEEL_MASK]) {
+        /* 槽已清空, 清除占用位 */
+        index = (uint32_t)(task->wpprev - &timer->wheel[0][0]);
+        slot = index & WHEEL_MASK; /* 每层不足32槽时index的低5位含层号 */
+        timer->bitmap[index / WHEEL_SIZE][slot >> 5] &= ~(1U << (slot & 31));
+    }
+    task->wnext = NULL;
+    task->wpprev = NULL;
+}
+
+/* 从start开始环形查找第一个非空槽, 返回偏移量, 全空返回-1 */
+static int32_t wheel_scan(const uint32_t* map, uint32_t start) {
+    uint32_t i = 0;
+    uint32_t idx, word, skip;
+    while (i < WHEEL_SIZE) {
+        idx = (start + i) & WHEEL_MASK;
+        word = map[idx >> 5] >> (idx & 31);
+        if (word == 0) {
+            skip = 32 - (idx & 31);
+            if (skip > WHEEL_SIZE - idx) {
+                skip = WHEEL_SIZE - idx;
+            }
+            i += skip;
             continue;
         }
-        if (task->timeout > inc) {
-            task->timeout -= inc;
-        } else {
-            task->handler(task->arg);
-            if (task->loop) {
-                task->timeout = task->reload - (inc - task->timeout);
-            } else {
-                task->timeout = 0;
-                task->reload = 0;
+        while (!(word & 1)) {
+            word >>= 1;
+            i++;
+        }
+        return (int32_t)i;
+    }
+    return -1;
+}
+
+/* 距下一个需要处理(到期或级联)的时刻的tick数, 无任务返回KL_WAIT_FOREVER */
+static kl_tick_t wheel_next(kl_timer_t timer) {
+    kl_tick_t next = KL_WAIT_FOREVER;
+    kl_tick_t block, delta;
+    uint32_t level;
+    int32_t k;
+    for (level = 0; level < WHEEL_LEVELS; level++) {
+        block = timer->now >> LEVEL_SHIFT(level);
+        k = wheel_scan(timer->bitmap[level],
+                       (uint32_t)(block + 1) & WHEEL_MASK);
+        if (k < 0) {
+            continue;
+        }
+        delta = ((block + 1 + k) << LEVEL_SHIFT(level)) - timer->now;
+        if (delta < next) {
+            next = delta;
+        }
+    }
+    return next;
+}
+
+/* 处理当前时刻: 先级联高层槽, 再执行第0层到期任务 */
+static void wheel_expire(kl_timer_t timer) {
+    kl_timer_task_t task;
+    uint32_t level, slot;
+    for (level = 1; level < WHEEL_LEVELS; level++) {
+        if (timer->now & (((kl_tick_t)1 << LEVEL_SHIFT(level)) - 1)) {
+            break;
+        }
+        slot = (uint32_t)(timer->now >> LEVEL_SHIFT(level)) & WHEEL_MASK;
+        while ((task = timer->wheel[level][slot]) != NULL) {
+            wheel_unlink(timer, task);
+            wheel_link(timer, task);
+        }
+    }
+    slot = (uint32_t)timer->now & WHEEL_MASK;
+    while ((task = timer->wheel[0][slot]) != NULL) {
+        wheel_unlink(timer, task);
+        if (task->loop) { /* 先重新挂入, 处理函数中可直接停止或重启自身 */
+            task->expire += task->reload;
+            /* 落后过多, 重新对齐 */
+            if (task->expire - timer->now - 1 >= task->reload) {
+                task->expire = timer->now + task->reload;
             }
+            wheel_link(timer, task);
+        } else {
+            task->reload = 0;
         }
-        if (task->timeout < timeout) {
-            timeout = task->timeout;
+        task->handler(task->arg);
+    }
+}
+
+static void kl_timer_process(kl_timer_t timer, kl_tick_t tick) {
+    kl_tick_t delta;
+    while (1) {
+        delta = wheel_next(timer);
+        if (delta == KL_WAIT_FOREVER || delta > tick - timer->now) {
+            timer->now = tick;
+            return;
         }
+        timer->now += delta;
+        wheel_expire(timer);
     }
-    kl_mutex_unlock(&timer->mutex);
-    return timeout;
 }
 
 static void kl_timer_service(void* arg) {
-    kl_tick_t last;
-    kl_tick_t inc;
     kl_tick_t timeout;
+    kl_tick_t inc;
     kl_timer_t timer = (kl_timer_t)arg;
-    last = kl_kernel_tick();
     while (1) {
-        inc = kl_kernel_tick() - last;
-        last += inc;
-        timeout = kl_timer_process(timer, inc);
-        inc = kl_kernel_tick() - last;
+        kl_mutex_lock(&timer->mutex, KL_WAIT_FOREVER);
+        kl_timer_process(timer, kl_kernel_tick());
+        timeout = wheel_next(timer);
+        kl_mutex_unlock(&timer->mutex);
+        if (timeout == KL_WAIT_FOREVER) {
+            kl_cond_wait_complete(&timer->cond, KL_WAIT_FOREVER);
+            continue;
+        }
+        inc = kl_kernel_tick() - timer->now;
         if (timeout > inc) {
             kl_cond_wait_complete(&timer->cond, timeout - inc);
         }
@@ -57,6 +181,7 @@ kl_timer_t kl_timer_create(kl_size_t stack_size, uint32_t priority) {
         return NULL;
     }
     memset(timer, 0, sizeof(struct kl_timer));
+    timer->now = kl_kernel_tick();
     timer->thread =
         kl_thread_create(kl_timer_service, timer, stack_size, priority);
     if (timer->thread == NULL) {
@@ -91,7 +216,7 @@ kl_timer_task_t kl_timer_attach_task(kl_timer_t timer, void (*handler)(void*),
         task->handler = handler;
         task->arg = arg;
         task->reload = 0;
-        task->timeout = 0;
+        task->expire = 0;
         kl_mutex_lock(&timer->mutex, KL_WAIT_FOREVER);
         kl_slist_append(timer, task);
         kl_mutex_unlock(&timer->mutex);
@@ -103,6 +228,7 @@ kl_timer_task_t kl_timer_attach_task(kl_timer_t timer, void (*handler)(void*),
 
 void kl_timer_detach_task(kl_timer_task_t task) {
     kl_mutex_lock(&task->timer->mutex, KL_WAIT_FOREVER);
+    wheel_unlink(task->timer, task);
     kl_slist_remove(task->timer, task);
     kl_mutex_unlock(&task->timer->mutex);
     kl_heap_free(task);
@@ -110,15 +236,18 @@ void kl_timer_detach_task(kl_timer_task_t task) {
 
 void kl_timer_start_task(kl_timer_task_t task, kl_tick_t timeout, bool loop) {
     kl_mutex_lock(&task->timer->mutex, KL_WAIT_FOREVER);
+    wheel_unlink(task->timer, task);
     task->reload = (timeout > 0) ? timeout : 1; /* timeout can't be 0 */
-    task->timeout = task->reload;
+    task->expire = kl_kernel_tick() + task->reload;
     task->loop = loop;
+    wheel_link(task->timer, task);
     kl_mutex_unlock(&task->timer->mutex);
     kl_cond_signal(&task->timer->cond);
 }
 
 void kl_timer_stop_task(kl_timer_task_t task) {
     kl_mutex_lock(&task->timer->mutex, KL_WAIT_FOREVER);
+    wheel_unlink(task->timer, task);
     task->reload = 0;
     kl_mutex_unlock(&task->timer->mutex);
     kl_cond_signal(&task->timer->cond);
@@ -4,9 +4,10 @@
 kl_thread_t kl_sched_tcb_now;
 kl_thread_t kl_sched_tcb_next;
 static struct kl_thread_list m_list_ready[KLITE_CFG_MAX_PRIO + 1];
+// 睡眠队列按唤醒时刻升序排列, 队列中线程的timeout字段为绝对唤醒时刻,
+// 移出队列时换算回剩余时间. 时钟处理只需检查队首, 与睡眠线程数量无关
 static struct kl_thread_list m_list_sleep;
-static kl_tick_t m_idle_elapse;
-static kl_tick_t m_idle_timeout;
+static kl_tick_t m_sleep_tick;
 #if KLITE_CFG_MLFQ
 static kl_tick_t m_mlfq_reset_tick;
 #endif
@@ -19,6 +20,11 @@ static uint8_t m_susp_pending_flags;
 #define SUSPEND_PREEMPT_PENDING 0x02
 #define SUSPEND_PREEMPT_ROUND_ROBIN 0x04
 
+// 时刻a是否早于时刻b(允许计数回绕)
+#define TICK_BEFORE(a, b) ((kl_tick_t)((a) - (b)) > (KL_WAIT_FOREVER >> 1))
+// 单次睡眠的最长时间, 超过计数范围一半时回绕比较失效
+#define SLEEP_MAX_TICK (KL_WAIT_FOREVER >> 1)
+
 static inline void waitlist_insert(struct kl_thread_list* list,
                                    struct kl_thread_node* node) {
 #if KLITE_CFG_WAIT_LIST_ORDER_BY_PRIO
@@ -51,6 +57,20 @@ static inline void remove_list_wait(kl_thread_t tcb) {
     KL_CLR_FLAG(tcb->flags, KL_THREAD_FLAGS_WAIT);
 }
 
+static inline void sleeplist_insert(kl_thread_t tcb, kl_tick_t timeout) {
+    struct kl_thread_node* find;
+    if (timeout > SLEEP_MAX_TICK) {
+        timeout = SLEEP_MAX_TICK;
+    }
+    tcb->timeout = m_sleep_tick + timeout; /* absolute wake tick */
+    for (find = m_list_sleep.tail; find != NULL; find = find->prev) {
+        if (!TICK_BEFORE(tcb->timeout, find->tcb->timeout)) {
+            break; /* same wake tick keeps FIFO order */
+        }
+    }
+    kl_blist_insert_after(&m_list_sleep, find, &tcb->node_sched);
+}
+
 static inline void remove_list_sched(kl_thread_t tcb) {
     kl_blist_remove(tcb->list_sched, &tcb->node_sched);
     if (tcb->list_sched != &m_list_sleep) /* in ready list ? */
@@ -61,6 +81,12 @@ static inline void remove_list_sched(kl_thread_t tcb) {
         }
         KL_CLR_FLAG(tcb->flags, KL_THREAD_FLAGS_READY);
     } else {
+        /* back to remain time, at least 1 means not timed out */
+        if (TICK_BEFORE(m_sleep_tick, tcb->timeout)) {
+            tcb->timeout -= m_sleep_tick;
+        } else {
+            tcb->timeout = 1;
+        }
         KL_CLR_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP);
     }
     tcb->list_sched = NULL;
@@ -113,11 +139,8 @@ void kl_sched_tcb_suspend(kl_thread_t tcb) {
     }
     if (tcb->list_sched) { /* remove sched */
         list = tcb->list_sched;
-        remove_list_sched(tcb);
+        remove_list_sched(tcb); /* sleep time is kept as remain time */
         tcb->list_sched = list;
-        if (tcb->list_sched == &m_list_sleep && tcb->timeout > m_idle_elapse) {
-            tcb->timeout -= m_idle_elapse; /* remain sleep time */
-        }
     }
     KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_SUSPEND);
 }
@@ -130,11 +153,7 @@ void kl_sched_tcb_resume(kl_thread_t tcb) {
             KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_WAIT);
         }
         if (tcb->list_sched == &m_list_sleep) { /* set sleep */
-            tcb->timeout += m_idle_elapse;
-            kl_blist_append(tcb->list_sched, &tcb->node_sched);
-            if (tcb->timeout < m_idle_timeout) {
-                m_idle_timeout = tcb->timeout;
-            }
+            sleeplist_insert(tcb, tcb->timeout);
             KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP);
         } else if (tcb->list_sched) { /* set ready */
             tcb->list_sched = NULL;
@@ -179,15 +198,21 @@ void kl_sched_tcb_sleep(kl_thread_t tcb, kl_tick_t timeout) {
     if (tcb->list_sched) {
         remove_list_sched(tcb);
     }
-    tcb->timeout = timeout + m_idle_elapse;
     tcb->list_sched = &m_list_sleep;
-    kl_blist_append(tcb->list_sched, &tcb->node_sched);
-    if (tcb->timeout < m_idle_timeout) {
-        m_idle_timeout = tcb->timeout;
-    }
+    sleeplist_insert(tcb, timeout);
     KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP);
 }
 
+kl_tick_t kl_sched_tcb_timeout(kl_thread_t tcb) {
+    if (KL_GET_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP)) {
+        if (TICK_BEFORE(m_sleep_tick, tcb->timeout)) {
+            return tcb->timeout - m_sleep_tick;
+        }
+        return 0;
+    }
+    return tcb->timeout;
+}
+
 void kl_sched_tcb_wait(kl_thread_t tcb, struct kl_thread_list* list) {
     if (tcb->list_wait) {
         remove_list_wait(tcb);
@@ -334,26 +359,18 @@ void kl_sched_preempt(const bool round_robin) {
 
 static inline void kl_sched_timeout(void) {
     kl_thread_t tcb;
-    struct kl_thread_node* node;
-    struct kl_thread_node* next;
-    m_idle_timeout = KL_WAIT_FOREVER;
-    for (node = m_list_sleep.head; node != NULL; node = next) {
-        next = node->next;
-        tcb = node->tcb;
-        if (tcb->timeout > m_idle_elapse) {
-            tcb->timeout -= m_idle_elapse;
-            if (tcb->timeout < m_idle_timeout) {
-                m_idle_timeout = tcb->timeout;
-            }
-        } else {
-            tcb->timeout = 0;
-            kl_sched_tcb_wake_up(tcb);
+    while (m_list_sleep.head != NULL) {
+        tcb = m_list_sleep.head->tcb;
+        if (TICK_BEFORE(m_sleep_tick, tcb->timeout)) {
+            break; /* sorted, the rest are not expired */
         }
+        kl_sched_tcb_wake_up(tcb);
+        tcb->timeout = 0; /* timed out */
     }
 }
 
 void kl_sched_timing(void) {
-    m_idle_elapse++;
+    m_sleep_tick++;
     kl_sched_tcb_now->time++;
 #if KLITE_CFG_STACKOF_DETECT_ON_TICK_INC
     kl_sched_stack_overflow_check();
@@ -404,24 +421,22 @@ void kl_sched_timing(void) {
     }
 #endif
     //
-    if (m_idle_elapse >= m_idle_timeout) {
-        kl_sched_timeout();
-        m_idle_elapse = 0;
-    }
+    kl_sched_timeout();
 }
 
 void kl_sched_idle(void) {
     if (m_prio_bitmap) {
         kl_sched_tcb_ready(kl_sched_tcb_now, false);
         kl_sched_switch();
+    } else if (m_list_sleep.head != NULL) {
+        kl_port_sys_idle(m_list_sleep.head->tcb->timeout - m_sleep_tick);
     } else {
-        kl_port_sys_idle(m_idle_timeout);
+        kl_port_sys_idle(KL_WAIT_FOREVER);
     }
 }
 
 void kl_sched_init(void) {
-    m_idle_elapse = 0;
-    m_idle_timeout = KL_WAIT_FOREVER;
+    m_sleep_tick = 0;
     m_prio_highest = 0;
     m_prio_bitmap = 0;
     m_susp_nesting = 0;
@@ -274,11 +274,15 @@ void kl_thread_set_errno(kl_thread_t thread, kl_err_t errno) {
 }
 
 kl_tick_t kl_thread_timeout(kl_thread_t thread) {
+    kl_tick_t timeout;
     if (THREAD_INFO_INVALID(thread)) {
         KL_SET_ERRNO(KL_EINVAL);
         return KL_INVALID;
     }
-    return thread->timeout;
+    kl_port_enter_critical();
+    timeout = kl_sched_tcb_timeout(thread);
+    kl_port_leave_critical();
+    return timeout;
 }
 
 kl_thread_t kl_thread_find(uint32_t id) {
@@ -0,0 +1,277 @@
+/**
+ * @file mslab.c
+ * @brief 小块内存分级(slab)分配前端, 位于m_alloc所选的堆后端之前
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-12
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "mslab.h"
+
+#include <string.h>
+
+#ifndef MSLAB_CFG_POOL_SIZE
+#define MSLAB_CFG_POOL_SIZE 8192
+#endif
+#ifndef MSLAB_CFG_PAGE_SIZE
+#define MSLAB_CFG_PAGE_SIZE 512
+#endif
+#ifndef MSLAB_CFG_MAX_SIZE
+#define MSLAB_CFG_MAX_SIZE 256
+#endif
+
+#define PAGE_NUM (MSLAB_CFG_POOL_SIZE / MSLAB_CFG_PAGE_SIZE)
+#define PAGE_NONE UINT16_MAX
+#define ALIGN 8
+
+#if PAGE_NUM < 1 || PAGE_NUM >= PAGE_NONE
+#error "MSLAB_CFG_POOL_SIZE / MSLAB_CFG_PAGE_SIZE out of range"
+#endif
+#if MSLAB_CFG_MAX_SIZE > MSLAB_CFG_PAGE_SIZE
+#error "MSLAB_CFG_MAX_SIZE must not exceed MSLAB_CFG_PAGE_SIZE"
+#endif
+
+// 尺寸级别, 相邻级别的内部碎片不超过1/3
+static const uint16_t class_sizes[] = {8,  16, 24,  32,  48,
+                                       64, 96, 128, 192, 256};
+
+#define CLASS_NUM_MAX (sizeof(class_sizes) / sizeof(class_sizes[0]))
+
+typedef struct {      // 页描述
+    void* free;       // 页内空闲块链表(块首存放下一块指针)
+    uint16_t used;    // 使用中的块数
+    uint16_t carved;  // 已切分的块数, 其后为尚未使用的区域
+    uint16_t prev;    // 所在链表的前驱页
+    uint16_t next;    // 所在链表的后继页
+    uint8_t cls;      // 所属级别
+} mslab_page_t;
+
+typedef struct {         // 尺寸级别
+    uint16_t size;       // 块大小
+    uint16_t per_page;   // 每页块数
+    uint16_t partial;    // 尚有空闲块的页链表
+    uint16_t pages;      // 占用页数
+    uint32_t used;       // 使用中的块数
+    uint32_t peak;       // 使用中块数峰值
+    uint32_t allocs;     // 累计分配次数
+    uint32_t fallbacks;  // 页耗尽转交后端的次数
+} mslab_class_t;
+
+static mod_atomic_size_t inited;  // 全部状态就绪后才置位
+static uint8_t* pool = NULL;     // 页区起点(按ALIGN对齐)
+static uint16_t pool_pages = 0;  // 可用页数
+static uint16_t free_head = PAGE_NONE;
+static uint16_t free_num = 0;
+static uint8_t class_num = 0;
+static mslab_page_t pages[PAGE_NUM];
+static mslab_class_t classes[CLASS_NUM_MAX];
+static uint8_t size_to_class[(MSLAB_CFG_MAX_SIZE + ALIGN - 1) / ALIGN + 1];
+static MOD_MUTEX_HANDLE mutex;
+
+#define MSLAB_LOCK() MOD_MUTEX_ACQUIRE(mutex)
+#define MSLAB_UNLOCK() MOD_MUTEX_RELEASE(mutex)
+
+#define PAGE_PTR(idx) (pool + (size_t)(idx) * MSLAB_CFG_PAGE_SIZE)
+#define IN_POOL(ptr)            \
+    ((uint8_t*)(ptr) >= pool && \
+     (uint8_t*)(ptr) < pool + (size_t)pool_pages * MSLAB_CFG_PAGE_SIZE)
+
+static inline void list_push(uint16_t* head, uint16_t idx) {
+    pages[idx].prev = PAGE_NONE;
+    pages[idx].next = *head;
+    if (*head != PAGE_NONE)
+        pages[*head].prev = idx;
+    *head = idx;
+}
+
+static inline void list_remove(uint16_t* head, uint16_t idx) {
+    mslab_page_t* page = &pages[idx];
+    if (page->prev != PAGE_NONE)
+        pages[page->prev].next = page->next;
+    else
+        *head = page->next;
+    if (page->next != PAGE_NONE)
+        pages[page->next].prev = page->prev;
+}
+
+static void mslab_init(void) {
+    // 互斥锁须先于inited就绪, 其他线程看到inited后会直接加锁
+    mutex = MOD_MUTEX_CREATE("mslab");
+    for (uint8_t i = 0; i < CLASS_NUM_MAX; i++) {
+        if (class_sizes[i] > MSLAB_CFG_MAX_SIZE)
+            break;
+        classes[i].size = class_sizes[i];
+        classes[i].per_page = MSLAB_CFG_PAGE_SIZE / class_sizes[i];
+        classes[i].partial = PAGE_NONE;
+        class_num++;
+    }
+    uint8_t cls = 0;
+    for (size_t i = 0; i < sizeof(size_to_class); i++) {
+        while (cls < class_num && classes[cls].size < i * ALIGN)
+            cls++;
+        size_to_class[i] = cls;  // 超出最大级别时为class_num, 转交后端
+    }
+    uint8_t* pool_raw = _m_heap_alloc(MSLAB_CFG_POOL_SIZE + ALIGN - 1);
+    if (pool_raw != NULL) {  // 无法分配内存池时, 全部请求转交后端
+        pool = (uint8_t*)(((uintptr_t)pool_raw + ALIGN - 1) &
+                          ~(uintptr_t)(ALIGN - 1));
+        pool_pages = PAGE_NUM;
+        for (uint16_t i = PAGE_NUM; i > 0; i--) {
+            list_push(&free_head, i - 1);
+        }
+        free_num = PAGE_NUM;
+    }
+    MOD_ATOMIC_STORE(inited, 1, MOD_ATOMIC_ORDER_RELEASE);
+}
+
+static inline void check_init(void) {
+    if (!MOD_ATOMIC_LOAD(inited, MOD_ATOMIC_ORDER_ACQUIRE))
+        mslab_init();
+}
+
+/**
+ * @brief 获取一个空闲页, 内存池耗尽时回收其他级别保留的空页
+ */
+static uint16_t page_get(void) {
+    uint16_t idx = free_head;
+    if (idx != PAGE_NONE) {
+        list_remove(&free_head, idx);
+        free_num--;
+        return idx;
+    }
+    for (uint8_t i = 0; i < class_num; i++) {
+        idx = classes[i].partial;
+        if (idx != PAGE_NONE && pages[idx].used == 0) {
+            list_remove(&classes[i].partial, idx);
+            classes[i].pages--;
+            return idx;
+        }
+    }
+    return PAGE_NONE;
+}
+
+static inline uint8_t get_class(size_t size) {
+    return size_to_class[(size + ALIGN - 1) / ALIGN];
+}
+
+void* mslab_alloc(size_t size) {
+    check_init();
+    if (size == 0 || size > MSLAB_CFG_MAX_SIZE || !pool_pages)
+        return _m_heap_alloc(size);
+    uint8_t cls = get_class(size);
+    if (cls >= class_num)
+        return _m_heap_alloc(size);
+    mslab_class_t* c = &classes[cls];
+    MSLAB_LOCK();
+    uint16_t idx = c->partial;
+    if (idx == PAGE_NONE) {
+        idx = page_get();
+        if (idx == PAGE_NONE) {
+            c->fallbacks++;
+            MSLAB_UNLOCK();
+            return _m_heap_alloc(size);
+        }
+        pages[idx].free = NULL;
+        pages[idx].used = 0;
+        pages[idx].carved = 0;
+        pages[idx].cls = cls;
+        list_push(&c->partial, idx);
+        c->pages++;
+    }
+    mslab_page_t* page = &pages[idx];
+    void* ptr = page->free;
+    if (ptr != NULL) {
+        page->free = *(void**)ptr;
+    } else {  // 按需切分, 新页无需预先构建空闲链表
+        ptr = PAGE_PTR(idx) + (size_t)page->carved * c->size;
+        page->carved++;
+    }
+    if (++page->used == c->per_page)  // 页已满, 移出部分空闲链表
+        list_remove(&c->partial, idx);
+    c->allocs++;
+    if (++c->used > c->peak)
+        c->peak = c->used;
+    MSLAB_UNLOCK();
+    return ptr;
+}
+
+void mslab_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    if (!IN_POOL(ptr)) {
+        _m_heap_free(ptr);
+        return;
+    }
+    uint16_t idx = ((uint8_t*)ptr - pool) / MSLAB_CFG_PAGE_SIZE;
+    mslab_page_t* page = &pages[idx];
+    mslab_class_t* c = &classes[page->cls];
+    MSLAB_LOCK();
+    if (page->used == c->per_page)  // 满页重新变为部分空闲
+        list_push(&c->partial, idx);
+    *(void**)ptr = page->free;
+    page->free = ptr;
+    page->used--;
+    c->used--;
+    // 空页归还内存池, 但保留级别的最后一页以免反复申请释放同一页
+    if (page->used == 0 && (c->partial != idx || page->next != PAGE_NONE)) {
+        list_remove(&c->partial, idx);
+        c->pages--;
+        list_push(&free_head, idx);
+        free_num++;
+    }
+    MSLAB_UNLOCK();
+}
+
+void* mslab_realloc(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return mslab_alloc(size);
+    if (!IN_POOL(ptr))  // 后端分配的块大小未知, 直接交由后端处理
+        return _m_heap_realloc(ptr, size);
+    if (size == 0) {
+        mslab_free(ptr);
+        return NULL;
+    }
+    uint8_t cls = pages[((uint8_t*)ptr - pool) / MSLAB_CFG_PAGE_SIZE].cls;
+    size_t old_size = classes[cls].size;
+    if (size <= old_size && (cls == 0 || size > classes[cls - 1].size))
+        return ptr;  // 仍在同一级别
+    void* new_ptr = mslab_alloc(size);
+    if (new_ptr == NULL)
+        return size <= old_size ? ptr : NULL;
+    memcpy(new_ptr, ptr, size < old_size ? size : old_size);
+    mslab_free(ptr);
+    return new_ptr;
+}
+
+uint8_t mslab_get_class_num(void) {
+    check_init();
+    return class_num;
+}
+
+uint8_t mslab_get_class_stat(uint8_t cls, mslab_class_stat_t* stat) {
+    check_init();
+    if (cls >= class_num || stat == NULL)
+        return 0;
+    MSLAB_LOCK();
+    stat->size = classes[cls].size;
+    stat->pages = classes[cls].pages;
+    stat->used = classes[cls].used;
+    stat->peak = classes[cls].peak;
+    stat->allocs = classes[cls].allocs;
+    stat->fallbacks = classes[cls].fallbacks;
+    MSLAB_UNLOCK();
+    return 1;
+}
+
+void mslab_get_pool_stat(mslab_pool_stat_t* stat) {
+    check_init();
+    if (stat == NULL)
+        return;
+    stat->pool = pool;
+    stat->total_pages = pool_pages;
+    stat->free_pages = free_num;
+    stat->page_size = MSLAB_CFG_PAGE_SIZE;
+    stat->max_size = MSLAB_CFG_MAX_SIZE;
+}
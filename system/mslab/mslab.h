@@ -0,0 +1,84 @@
+/**
+ * @file mslab.h
+ * @brief 小块内存分级(slab)分配前端, 位于m_alloc所选的堆后端之前
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-12
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __MSLAB_H
+#define __MSLAB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "modules.h"
+
+typedef struct {         // 单个尺寸级别的统计
+    uint16_t size;       // 块大小(字节)
+    uint16_t pages;      // 当前占用页数
+    uint32_t used;       // 使用中的块数
+    uint32_t peak;       // 使用中块数峰值
+    uint32_t allocs;     // 累计分配次数
+    uint32_t fallbacks;  // 页耗尽转交后端的次数
+} mslab_class_stat_t;
+
+typedef struct {           // 内存池统计
+    void* pool;            // 页区起始地址
+    uint16_t total_pages;  // 总页数, 0表示内存池尚未(或无法)分配
+    uint16_t free_pages;   // 空闲页数
+    uint16_t page_size;    // 页大小(字节)
+    uint16_t max_size;     // 由前端处理的最大请求大小(字节)
+} mslab_pool_stat_t;
+
+/**
+ * @brief 分配内存, 不超过MSLAB_CFG_MAX_SIZE的请求由对应级别的空闲链表提供
+ * @param  size             请求大小
+ * @retval void*            内存指针, 失败返回NULL
+ * @note 首次调用时从后端一次性申请MSLAB_CFG_POOL_SIZE字节作为内存池
+ * @note 首次调用完成初始化, 不可在多个线程中并发进行(如在启动调度前先调用一次)
+ */
+extern void* mslab_alloc(size_t size);
+
+/**
+ * @brief 释放内存, 自动区分内存池与后端分配的指针
+ * @param  ptr              内存指针(可为NULL)
+ */
+extern void mslab_free(void* ptr);
+
+/**
+ * @brief 重新分配内存
+ * @param  ptr              原内存指针(可为NULL)
+ * @param  size             新大小
+ * @retval void*            新内存指针, 失败返回NULL(原内存保持不变)
+ * @note 同级别内的调整直接返回原指针
+ */
+extern void* mslab_realloc(void* ptr, size_t size);
+
+/**
+ * @brief 获取尺寸级别数量
+ */
+extern uint8_t mslab_get_class_num(void);
+
+/**
+ * @brief 获取指定尺寸级别的统计
+ * @param  cls              级别序号(0 ~ mslab_get_class_num()-1)
+ * @param  stat             统计数据输出
+ * @retval uint8_t          是否成功
+ */
+extern uint8_t mslab_get_class_stat(uint8_t cls, mslab_class_stat_t* stat);
+
+/**
+ * @brief 获取内存池统计
+ * @param  stat             统计数据输出
+ */
+extern void mslab_get_pool_stat(mslab_pool_stat_t* stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __MSLAB_H
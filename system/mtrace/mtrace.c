@@ -0,0 +1,184 @@
+/**
+ * @file mtrace.c
+ * @brief 堆分配追踪, 记录m_alloc/m_free/m_realloc的调用位置、大小与时间戳
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "mtrace.h"
+
+#include "log.h"
+
+#ifndef MTRACE_CFG_SIZE
+#define MTRACE_CFG_SIZE 1024
+#endif
+
+#if (MTRACE_CFG_SIZE & (MTRACE_CFG_SIZE - 1)) != 0
+#error "MTRACE_CFG_SIZE must be a power of 2"
+#endif
+#define TRACE_MASK (MTRACE_CFG_SIZE - 1)
+#define TRACE_VERSION 1
+#define SIZE_MASK 0x0fffffffUL
+
+#define REGION_END 0   // 区域表结束
+#define REGION_HEAP 1  // 堆区域
+#define REGION_POOL 2  // 前端内存池(整体视为已占用)
+
+// 调用者返回地址即m_alloc等宏的展开位置, 本文件的函数不能被内联到调用者中
+// (开启LTO时编译器可能跨文件内联, 需显式禁止)
+#if defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM)
+#define CALLER() __builtin_return_address(0)
+#define NOINLINE __attribute__((noinline))
+#else
+#define CALLER() NULL
+#define NOINLINE
+#endif
+
+typedef struct {         // 导出文件头
+    char magic[4];       // "MTRC"
+    uint8_t version;     // 格式版本
+    uint8_t ptr_size;    // 指针大小(字节)
+    uint16_t rec_size;   // 单条记录大小(字节)
+    uint32_t rec_num;    // 记录数
+    uint32_t lost;       // 被覆盖的记录数
+    uint64_t freq;       // 时间戳频率(Hz)
+} mtrace_header_t;
+
+// 追踪环形缓冲区: 写满后覆盖最旧的记录, 记录位置由原子自增抢占
+static mtrace_rec_t trace_ring[MTRACE_CFG_SIZE];
+static mod_atomic_size_t trace_head;  // 已写入的记录总数
+static __IO uint8_t trace_enabled = 1;
+static const void* region_start = NULL;
+static size_t region_size = 0;
+
+static inline void rec_fill(mod_atomic_value_t pos, uint8_t type,
+                            const void* site, void* ptr, size_t size) {
+    mtrace_rec_t* rec = &trace_ring[pos & TRACE_MASK];
+    rec->tick = (uint32_t)m_tick();
+    rec->info = ((uint32_t)type << 28) |
+                (size > SIZE_MASK ? SIZE_MASK : (uint32_t)size);
+    rec->site = site;
+    rec->ptr = ptr;
+}
+
+NOINLINE void* mtrace_alloc(size_t size) {
+    void* ptr = _m_alloc(size);
+    if (trace_enabled) {
+        mod_atomic_value_t pos =
+            MOD_ATOMIC_FETCH_ADD(trace_head, 1, MOD_ATOMIC_ORDER_RELAXED);
+        rec_fill(pos, MTRACE_ALLOC, CALLER(), ptr, size);
+    }
+    return ptr;
+}
+
+NOINLINE void mtrace_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    if (trace_enabled) {  // 先记录再释放, 以免同一地址的新分配记录排在前面
+        mod_atomic_value_t pos =
+            MOD_ATOMIC_FETCH_ADD(trace_head, 1, MOD_ATOMIC_ORDER_RELAXED);
+        rec_fill(pos, MTRACE_FREE, CALLER(), ptr, 0);
+    }
+    _m_free(ptr);
+}
+
+NOINLINE void* mtrace_realloc(void* ptr, size_t size) {
+    if (!trace_enabled)
+        return _m_realloc(ptr, size);
+    const void* site = CALLER();
+    // 一次预留两条记录, 保证原指针与结果相邻
+    mod_atomic_value_t pos =
+        MOD_ATOMIC_FETCH_ADD(trace_head, 2, MOD_ATOMIC_ORDER_RELAXED);
+    rec_fill(pos, MTRACE_REALLOC_OLD, site, ptr, 0);
+    void* new_ptr = _m_realloc(ptr, size);
+    rec_fill(pos + 1, MTRACE_REALLOC, site, new_ptr, size);
+    return new_ptr;
+}
+
+void mtrace_set_region(const void* start, size_t size) {
+    region_start = start;
+    region_size = size;
+}
+
+void mtrace_set_enabled(uint8_t enable) {
+    if (enable == 0xff)
+        trace_enabled = !trace_enabled;
+    else
+        trace_enabled = enable;
+}
+
+void mtrace_clear(void) {
+    MOD_ATOMIC_STORE(trace_head, 0, MOD_ATOMIC_ORDER_RELAXED);
+}
+
+static void region_write(mtrace_write_t write, uint8_t kind, const void* start,
+                         uint32_t size) {
+    write(&kind, 1);
+    write(&start, sizeof(start));
+    write(&size, sizeof(size));
+}
+
+uint32_t mtrace_dump(mtrace_write_t write) {
+    uint8_t enabled = trace_enabled;
+    trace_enabled = 0;
+    mod_atomic_value_t head =
+        MOD_ATOMIC_LOAD(trace_head, MOD_ATOMIC_ORDER_ACQUIRE);
+    uint32_t num = head > MTRACE_CFG_SIZE ? MTRACE_CFG_SIZE : head;
+    mtrace_header_t hdr = {
+        .magic = {'M', 'T', 'R', 'C'},
+        .version = TRACE_VERSION,
+        .ptr_size = sizeof(void*),
+        .rec_size = sizeof(mtrace_rec_t),
+        .rec_num = num,
+        .lost = head - num,
+        .freq = m_tick_clk,
+    };
+    write(&hdr, sizeof(hdr));
+    for (mod_atomic_value_t i = head - num; i != head; i++) {
+        write(&trace_ring[i & TRACE_MASK], sizeof(mtrace_rec_t));
+    }
+    if (region_size)
+        region_write(write, REGION_HEAP, region_start, region_size);
+#if MOD_CFG_HEAP_SLAB
+    mslab_pool_stat_t pool;
+    mslab_get_pool_stat(&pool);
+    if (pool.total_pages)
+        region_write(write, REGION_POOL, pool.pool,
+                     (uint32_t)pool.total_pages * pool.page_size);
+#endif
+    region_write(write, REGION_END, NULL, 0);
+    trace_enabled = enabled;
+    return num;
+}
+
+static uint8_t hex_line[32];
+static uint8_t hex_len = 0;
+
+static void hex_flush(void) {
+    if (!hex_len)
+        return;
+    PRINT("MTRACE:");
+    for (uint8_t i = 0; i < hex_len; i++) {
+        PRINT("%02X", hex_line[i]);
+    }
+    PRINTLN("");
+    hex_len = 0;
+}
+
+static void hex_write(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    while (len--) {
+        hex_line[hex_len++] = *p++;
+        if (hex_len == sizeof(hex_line))
+            hex_flush();
+    }
+}
+
+uint32_t mtrace_dump_hex(void) {
+    uint32_t num = mtrace_dump(hex_write);
+    hex_flush();
+    return num;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file mtrace.h
+ * @brief 堆分配追踪, 记录m_alloc/m_free/m_realloc的调用位置、大小与时间戳
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __MTRACE_H
+#define __MTRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "modules.h"
+
+typedef enum {               // 追踪记录类型
+    MTRACE_ALLOC = 1,        // 分配(ptr为NULL表示失败)
+    MTRACE_FREE = 2,         // 释放
+    MTRACE_REALLOC_OLD = 3,  // 重新分配的原指针, 紧接着一条MTRACE_REALLOC
+    MTRACE_REALLOC = 4,      // 重新分配的结果(ptr为NULL表示失败, 原内存仍有效)
+} mtrace_type_t;
+
+typedef struct {        // 追踪记录
+    uint32_t tick;      // 时间戳(m_tick()的低32位)
+    uint32_t info;      // 低28位: 请求大小, 高4位: 类型(mtrace_type_t)
+    const void* site;   // 调用位置(调用者返回地址)
+    void* ptr;          // 内存指针
+} mtrace_rec_t;
+
+typedef void (*mtrace_write_t)(const void* data, size_t len);
+
+/**
+ * @brief 追踪并分配内存, 由m_alloc调用
+ */
+extern void* mtrace_alloc(size_t size);
+
+/**
+ * @brief 追踪并释放内存, 由m_free调用
+ */
+extern void mtrace_free(void* ptr);
+
+/**
+ * @brief 追踪并重新分配内存, 由m_realloc调用
+ */
+extern void* mtrace_realloc(void* ptr, size_t size);
+
+/**
+ * @brief 设置堆区域, 供主机工具计算最大空闲块
+ * @param  start            堆起始地址
+ * @param  size             堆大小(字节)
+ * @note 未设置时主机工具以记录中出现的最小/最大地址估计
+ */
+extern void mtrace_set_region(const void* start, size_t size);
+
+/**
+ * @brief 设置追踪记录使能
+ * @param  enable           0:暂停 1:开始 0xff:切换
+ */
+extern void mtrace_set_enabled(uint8_t enable);
+
+/**
+ * @brief 清空追踪缓冲区
+ */
+extern void mtrace_clear(void);
+
+/**
+ * @brief 导出追踪数据(二进制), 由mtrace_report.py回放分析
+ * @param  write            数据输出函数
+ * @retval uint32_t         导出的记录数
+ * @note 格式: 文件头 + 记录(旧->新) + 区域表(以类型0结束)
+ * @note 导出期间暂停记录
+ */
+extern uint32_t mtrace_dump(mtrace_write_t write);
+
+/**
+ * @brief 以"MTRACE:"开头的十六进制行通过PRINTLN导出追踪数据
+ * @retval uint32_t         导出的记录数
+ */
+extern uint32_t mtrace_dump_hex(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __MTRACE_H
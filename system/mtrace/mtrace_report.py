@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+回放堆分配追踪数据(mtrace_dump), 统计各调用位置的存活字节数与峰值,
+并输出堆使用量与最大空闲块随时间变化的曲线(CSV)
+
+输入可以是二进制导出文件, 也可以是包含 mtrace_dump_hex() 输出(MTRACE:开头的十六进制行)的串口日志
+
+最大空闲块由存活块的地址推算: 堆区域内相邻存活块之间的空隙视为空闲块,
+每个块额外计入 --overhead 字节块头并按 --align 向上取整, 结果是对实际堆后端的近似
+
+用法: python mtrace_report.py <input> [--elf firmware.elf] [--csv timeline.csv]
+"""
+
+import argparse
+import bisect
+import csv
+import re
+import struct
+import subprocess
+import sys
+
+# 与 mtrace.h 中的 mtrace_type_t 保持一致
+ALLOC = 1
+FREE = 2
+REALLOC_OLD = 3
+REALLOC = 4
+
+REGION_END = 0
+REGION_HEAP = 1
+REGION_POOL = 2
+
+HEADER = struct.Struct("<4sBBHIIQ")
+SIZE_MASK = 0x0FFFFFFF
+
+
+def load(path):
+    """读取输入文件, 日志文件中的 MTRACE: 行拼接为二进制数据"""
+    with open(path, "rb") as f:
+        raw = f.read()
+    if raw[:4] == b"MTRC":
+        return raw
+    text = re.sub(r"\x1b\[[0-9;]*m", "", raw.decode("utf-8", "ignore"))
+    data = bytearray()
+    for line in text.splitlines():
+        m = re.search(r"MTRACE:([0-9A-Fa-f]+)", line)
+        if m:
+            data += bytes.fromhex(m.group(1))
+    start = data.find(b"MTRC")
+    if start < 0:
+        sys.exit("no trace data found in %s" % path)
+    return bytes(data[start:])
+
+
+def parse(data):
+    """解析文件头、记录与区域表"""
+    magic, version, ptr_size, rec_size, rec_num, lost, freq = HEADER.unpack_from(data)
+    if magic != b"MTRC" or version != 1:
+        sys.exit("unsupported trace format")
+    ptr_fmt = {4: "I", 8: "Q"}[ptr_size]
+    rec = struct.Struct("<II" + ptr_fmt * 2)
+    off = HEADER.size
+    records = []
+    for _ in range(rec_num):
+        tick, info, site, ptr = rec.unpack_from(data, off)
+        records.append((tick, info >> 28, info & SIZE_MASK, site, ptr))
+        off += rec_size
+    region = struct.Struct("<B" + ptr_fmt + "I")
+    regions = []
+    while off + region.size <= len(data):
+        kind, start, size = region.unpack_from(data, off)
+        off += region.size
+        if kind == REGION_END:
+            break
+        regions.append((kind, start, size))
+    return records, regions, lost, freq, ptr_size
+
+
+def symbolize(sites, elf, addr2line):
+    """通过addr2line将调用位置转换为 函数名@文件:行号"""
+    names = {site: "0x%08X" % site for site in sites}
+    if not elf or not sites:
+        return names
+    order = sorted(s for s in sites if s)
+    # 返回地址指向调用指令之后, 减1落在调用指令上(同时清除Thumb位)
+    args = [addr2line, "-f", "-C", "-s", "-e", elf]
+    args += ["0x%X" % ((s & ~1) - 1) for s in order]
+    try:
+        out = subprocess.run(args, capture_output=True, text=True, check=True)
+    except (OSError, subprocess.CalledProcessError) as e:
+        print("addr2line failed: %s" % e, file=sys.stderr)
+        return names
+    lines = out.stdout.splitlines()
+    for i, site in enumerate(order):
+        func, loc = lines[2 * i], lines[2 * i + 1]
+        if func != "??":
+            names[site] = "%s@%s" % (func, loc.split(" ")[0])
+    return names
+
+
+class Site:
+    def __init__(self):
+        self.allocs = 0
+        self.frees = 0
+        self.fails = 0
+        self.live = 0
+        self.blocks = 0
+        self.peak = 0
+
+
+class Heap:
+    """按地址维护存活块, 计算堆区域内的最大空隙"""
+
+    def __init__(self, start, end, pools, overhead, align):
+        self.start = start
+        self.end = end
+        self.overhead = overhead
+        self.align = align
+        self.starts = []
+        self.ends = {}
+        for pool_start, pool_size in pools:  # 前端内存池整体视为已占用
+            self.add(pool_start, pool_size, raw=True)
+
+    def add(self, ptr, size, raw=False):
+        if raw:
+            lo, hi = ptr, ptr + size
+        else:
+            lo = ptr - self.overhead
+            hi = ptr + (size + self.align - 1) // self.align * self.align
+        if lo < self.start or hi > self.end:  # 不在堆区域内(如后端与内存池外)
+            return
+        bisect.insort(self.starts, lo)
+        self.ends[lo] = hi
+
+    def remove(self, ptr):
+        lo = ptr - self.overhead
+        if lo not in self.ends:
+            return
+        del self.ends[lo]
+        del self.starts[bisect.bisect_left(self.starts, lo)]
+
+    def largest_free(self):
+        largest = 0
+        pos = self.start
+        for lo in self.starts:
+            largest = max(largest, lo - pos)
+            pos = max(pos, self.ends[lo])
+        return max(largest, self.end - pos)
+
+
+def replay(records, regions, freq, args):
+    heap_regions = [(s, s + n) for k, s, n in regions if k == REGION_HEAP]
+    pools = [(s, n) for k, s, n in regions if k == REGION_POOL]
+    ptrs = [r[4] for r in records if r[4] and r[1] in (ALLOC, REALLOC)]
+    if args.region:
+        start, size = (int(x, 0) for x in args.region.split(":"))
+        heap_regions = [(start, start + size)]
+    if heap_regions:
+        start, end = heap_regions[0]
+    elif ptrs:  # 未设置堆区域, 以出现过的地址范围估计
+        start = min(ptrs) - args.overhead
+        end = max(r[4] + r[2] for r in records if r[4] and r[1] in (ALLOC, REALLOC))
+    else:
+        start = end = 0
+    heap = Heap(start, end, pools, args.overhead, args.align)
+
+    sites = {}
+    live = {}  # ptr -> (size, site)
+    used = peak = 0
+    peak_time = 0.0
+    unknown_frees = 0
+    timeline = []
+    base = records[0][0] if records else 0
+    wraps = 0
+    last = base
+    old = None  # 等待结果的realloc原指针
+    for i, (tick, typ, size, site, ptr) in enumerate(records):
+        if tick < last:  # 32位时间戳回绕
+            wraps += 1
+        last = tick
+        t = ((tick + (wraps << 32)) - base) * 1e6 / freq
+
+        if typ == REALLOC_OLD:
+            old = ptr
+            continue
+        s = sites.setdefault(site, Site())
+        # realloc成功(或新大小为0)时原块被释放
+        if typ == FREE or (typ == REALLOC and old and (ptr or not size)):
+            victim = ptr if typ == FREE else old
+            if victim in live:
+                vsize, vsite = live.pop(victim)
+                vs = sites[vsite]
+                vs.live -= vsize
+                vs.blocks -= 1
+                vs.frees += 1
+                used -= vsize
+                heap.remove(victim)
+            else:  # 分配记录已被覆盖, 或在追踪开始前分配
+                unknown_frees += 1
+        if typ in (ALLOC, REALLOC):
+            if ptr:
+                live[ptr] = (size, site)
+                s.allocs += 1
+                s.live += size
+                s.blocks += 1
+                s.peak = max(s.peak, s.live)
+                used += size
+                heap.add(ptr, size)
+            elif size:
+                s.fails += 1
+            old = None
+        if used > peak:
+            peak, peak_time = used, t
+        if i % args.step == 0 or i == len(records) - 1:
+            timeline.append((t, used, heap.largest_free(), len(live)))
+    return sites, used, peak, peak_time, unknown_frees, timeline, end - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", help="二进制导出文件或串口日志")
+    parser.add_argument("--elf", help="固件ELF文件, 用于解析调用位置")
+    parser.add_argument("--addr2line", default="arm-none-eabi-addr2line")
+    parser.add_argument("--csv", help="输出时间线CSV(时间/使用量/最大空闲块/存活块数)")
+    parser.add_argument("--region", help="堆区域 start:size, 覆盖导出数据中的设置")
+    parser.add_argument("--overhead", type=int, default=8, help="每块的块头开销(字节)")
+    parser.add_argument("--align", type=int, default=8, help="块大小对齐(字节)")
+    parser.add_argument("--step", type=int, default=1, help="时间线每N条记录采样一次")
+    parser.add_argument("--top", type=int, default=20, help="显示的调用位置数量")
+    args = parser.parse_args()
+
+    records, regions, lost, freq, ptr_size = parse(load(args.input))
+    sites, used, peak, peak_time, unknown, timeline, span = replay(
+        records, regions, freq, args
+    )
+    names = symbolize(list(sites), args.elf, args.addr2line)
+
+    print("records: %d (lost %d), duration: %.3f ms" % (
+        len(records), lost, timeline[-1][0] / 1000 if timeline else 0))
+    print("heap span: %d bytes" % span)
+    print("live: %d bytes, peak: %d bytes @ %.3f ms" % (used, peak, peak_time / 1000))
+    if timeline:
+        lf = min(timeline, key=lambda x: x[2])
+        print("largest free: final %d, min %d bytes @ %.3f ms" % (
+            timeline[-1][2], lf[2], lf[0] / 1000))
+    if unknown:
+        print("frees of untracked blocks: %d" % unknown)
+    print()
+    fmt = "%-40s %8s %8s %6s %10s %8s %10s"
+    print(fmt % ("site", "allocs", "frees", "fails", "live", "blocks", "peak"))
+    top = sorted(sites.items(), key=lambda x: -x[1].peak)[: args.top]
+    for site, s in top:
+        print(fmt % (names[site][:40], s.allocs, s.frees, s.fails, s.live,
+                     s.blocks, s.peak))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            w = csv.writer(f)
+            w.writerow(["time_us", "used", "largest_free", "live_blocks"])
+            for t, u, lf, n in timeline:
+                w.writerow(["%.1f" % t, u, lf, n])
+
+
+if __name__ == "__main__":
+    main()
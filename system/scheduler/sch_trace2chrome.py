@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+将调度器追踪数据(sch_trace_dump)转换为Chrome追踪格式(JSON),
+可在 chrome://tracing 或 https://ui.perfetto.dev 中查看
+
+输入可以是二进制导出文件, 也可以是包含 "trace -d" 命令输出(TRACE:开头的十六进制行)的串口日志
+
+用法: python sch_trace2chrome.py <input> [-o output.json]
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+# 与 scheduler_trace.h 中的 sch_trace_type_t 保持一致
+TASK_BEGIN = 1
+TASK_END = 2
+EVENT_TRIGGER = 3
+EVENT_BEGIN = 4
+EVENT_END = 5
+CORTN_BEGIN = 6
+CORTN_END = 7
+RUNLATER_BEGIN = 8
+RUNLATER_END = 9
+SOFTINT_TRIGGER = 10
+SOFTINT_BEGIN = 11
+SOFTINT_END = 12
+IDLE_BEGIN = 13
+IDLE_END = 14
+
+# 轨道: (tid, 名称)
+TRACKS = {
+    "task": (1, "Task"),
+    "event": (2, "Event"),
+    "cortn": (3, "Coroutine"),
+    "runlater": (4, "RunLater"),
+    "softint": (5, "SoftInt"),
+    "idle": (6, "Idle"),
+    "trigger": (7, "Trigger"),
+}
+
+# 类型 -> (轨道, 是否开始)
+SLICES = {
+    TASK_BEGIN: ("task", True),
+    TASK_END: ("task", False),
+    EVENT_BEGIN: ("event", True),
+    EVENT_END: ("event", False),
+    CORTN_BEGIN: ("cortn", True),
+    CORTN_END: ("cortn", False),
+    RUNLATER_BEGIN: ("runlater", True),
+    RUNLATER_END: ("runlater", False),
+    SOFTINT_BEGIN: ("softint", True),
+    SOFTINT_END: ("softint", False),
+    IDLE_BEGIN: ("idle", True),
+    IDLE_END: ("idle", False),
+}
+
+NAME_KIND = {1: "task", 2: "event", 3: "cortn"}
+
+HEADER = struct.Struct("<4sBBHIIQ")
+PID = 1
+
+
+def load(path):
+    """读取输入文件, 日志文件中的 TRACE: 行拼接为二进制数据"""
+    with open(path, "rb") as f:
+        raw = f.read()
+    if raw[:4] == b"SCHT":
+        return raw
+    text = re.sub(r"\x1b\[[0-9;]*m", "", raw.decode("utf-8", "ignore"))
+    data = bytearray()
+    for line in text.splitlines():
+        m = re.search(r"TRACE:([0-9A-Fa-f]+)", line)
+        if m:
+            data += bytes.fromhex(m.group(1))
+    start = data.find(b"SCHT")
+    if start < 0:
+        sys.exit("no trace data found in %s" % path)
+    return bytes(data[start:])
+
+
+def parse(data):
+    """解析文件头/记录/对象名表"""
+    magic, ver, ptr_size, rec_size, rec_num, lost, freq = HEADER.unpack_from(data)
+    if magic != b"SCHT" or ver != 1:
+        sys.exit("unsupported trace format")
+    ptr_fmt = {4: "I", 8: "Q"}[ptr_size]
+    rec = struct.Struct("<Q" + ptr_fmt + "I")  # tick, obj, info(无尾部填充)
+    off = HEADER.size
+    if len(data) < off + rec_num * rec_size:
+        sys.exit("trace data truncated")
+    records = []
+    for i in range(rec_num):
+        tick, obj, info = rec.unpack_from(data, off + i * rec_size)
+        records.append((tick, obj, info & 0xFF, info >> 8))
+    off += rec_num * rec_size
+    names = {}
+    while off + ptr_size + 2 <= len(data):
+        (obj,) = struct.unpack_from("<" + ptr_fmt, data, off)
+        kind, length = data[off + ptr_size], data[off + ptr_size + 1]
+        off += ptr_size + 2
+        if kind == 0:
+            break
+        names[(NAME_KIND.get(kind), obj)] = data[off : off + length].decode(
+            "utf-8", "replace"
+        )
+        off += length
+    return freq, lost, records, names
+
+
+def convert(freq, lost, records, names):
+    """生成Chrome追踪事件列表"""
+    if not records:
+        return []
+    t0 = records[0][0]
+
+    def ts(tick):
+        return (tick - t0) * 1e6 / freq
+
+    def obj_name(track, obj):
+        if track == "softint":
+            return "softint %d" % (obj >> 8)
+        if track == "idle":
+            return "idle"
+        return names.get((track, obj), "0x%x" % obj)
+
+    out = [
+        {"ph": "M", "pid": PID, "name": "process_name", "args": {"name": "Scheduler"}}
+    ]
+    for tid, tname in TRACKS.values():
+        out.append(
+            {"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+             "args": {"name": tname}}
+        )
+        out.append(
+            {"ph": "M", "pid": PID, "tid": tid, "name": "thread_sort_index",
+             "args": {"sort_index": tid}}
+        )
+    open_slices = {}  # 轨道 -> (开始tick, 对象, 参数)
+    pending = {}  # 事件对象 -> [(触发tick, flow id)], 按触发顺序执行
+    flow_id = 0
+    for tick, obj, typ, arg in records:
+        if typ == EVENT_TRIGGER or typ == SOFTINT_TRIGGER:
+            track = "event" if typ == EVENT_TRIGGER else "softint"
+            key = obj if typ == EVENT_TRIGGER else arg >> 8
+            name = (
+                obj_name("event", obj)
+                if typ == EVENT_TRIGGER
+                else "softint %d:%d" % (arg >> 8, arg & 0xFF)
+            )
+            tid = TRACKS["trigger"][0]
+            out.append({"ph": "X", "pid": PID, "tid": tid, "ts": ts(tick),
+                        "dur": 0, "name": name, "cat": "trigger"})
+            flow_id += 1
+            out.append({"ph": "s", "pid": PID, "tid": tid, "ts": ts(tick),
+                        "id": flow_id, "name": "trigger", "cat": "flow"})
+            pending.setdefault((track, key), []).append((tick, flow_id))
+            continue
+        if typ not in SLICES:
+            continue
+        track, begin = SLICES[typ]
+        if begin:
+            open_slices[track] = (tick, obj, arg)
+            continue
+        if track not in open_slices:
+            continue  # 开始记录已被覆盖
+        btick, bobj, barg = open_slices.pop(track)
+        tid = TRACKS[track][0]
+        args = {}
+        if track == "task":
+            args["latency_us"] = barg
+        elif track == "runlater":
+            args["overrun_us"] = barg
+        elif track == "softint":
+            args["sub_mask"] = "0x%02x" % (barg & 0xFF)
+        elif track == "idle":
+            args["request_us"] = barg
+            args["actual_us"] = round((tick - btick) * 1e6 / freq, 3)
+        key = bobj if track == "event" else barg >> 8
+        queue = pending.get((track, key))
+        if track in ("event", "softint") and queue:
+            if track == "event":
+                trig, fid = queue.pop(0)
+                fids = [fid]
+            else:  # 同一主通道的多次触发合并为一次处理
+                trig, fids = queue[0][0], [f for _, f in queue]
+                queue.clear()
+            args["wait_us"] = round((btick - trig) * 1e6 / freq, 3)
+            for fid in fids:
+                out.append({"ph": "f", "bp": "e", "pid": PID, "tid": tid,
+                            "ts": ts(btick), "id": fid, "name": "trigger",
+                            "cat": "flow"})
+        out.append({"ph": "X", "pid": PID, "tid": tid, "ts": ts(btick),
+                    "dur": ts(tick) - ts(btick), "name": obj_name(track, bobj),
+                    "cat": track, "args": args})
+    end = ts(records[-1][0])
+    for track, (btick, bobj, barg) in open_slices.items():  # 导出时尚未结束
+        out.append({"ph": "X", "pid": PID, "tid": TRACKS[track][0],
+                    "ts": ts(btick), "dur": end - ts(btick),
+                    "name": obj_name(track, bobj), "cat": track,
+                    "args": {"unfinished": True}})
+    if lost:
+        out.append({"ph": "i", "s": "g", "pid": PID, "tid": 0, "ts": 0,
+                    "name": "%d records lost (ring overwritten)" % lost})
+    out.sort(key=lambda e: e.get("ts", -1))
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert scheduler trace dump to Chrome trace JSON"
+    )
+    parser.add_argument("input", help="binary dump or log with TRACE: lines")
+    parser.add_argument("-o", "--output", default="trace.json")
+    args = parser.parse_args()
+    freq, lost, records, names = parse(load(args.input))
+    events = convert(freq, lost, records, names)
+    with open(args.output, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, f)
+    print(
+        "%d records (%d lost), %d names -> %s"
+        % (len(records), lost, len(names), args.output)
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -1,42 +1,93 @@
 #include "scheduler_internal.h"
 
+static __IO uint8_t wakeup_pending = 0;  // 本轮调度后有新的触发, 不应休眠
+
+#if SCH_CFG_IDLE_STAT
+static uint64_t stat_start_us = 0;  // 统计开始时间(us)
+static uint64_t stat_idle_us = 0;   // 空闲时长(us)
+static uint32_t stat_wakeups = 0;   // 唤醒次数
+#endif
+
 #if MOD_CFG_WFI_WHEN_SYSTEM_IDLE && !MOD_CFG_OS_AVAILABLE
+extern void SysTick_Handler(void);
+
+/**
+ * @brief 延长SysTick周期后休眠
+ * @note 时基在SysTick中断中按周期累加(perf_counter累加LOAD+1, HAL累加1ms),
+ *       休眠期间经过的计数在唤醒后按原周期补调SysTick_Handler计入,
+ *       不足一个周期的部分留待下次休眠时累计
+ */
 static void SysTick_Sleep(uint32_t us) {
+    static uint32_t residue = 0;  // 尚未计入时基的计数(不足一个周期)
+    uint64_t ticks = us_to_tick(us);
+    if (ticks > SysTick_LOAD_RELOAD_Msk)
+        ticks = SysTick_LOAD_RELOAD_Msk;  // 24位计数器, 超出部分下轮继续休眠
+    CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+    __disable_irq();  // 关中断后检查, 避免检查后触发的唤醒被错过
+    if (wakeup_pending || !ticks || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)) {
+        __enable_irq();  // 挂起的SysTick中断按原周期处理后再休眠
+        return;
+    }
+    uint32_t load = SysTick->LOAD;  // 原本的重装载值(一个时基周期)
     SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
-    uint32_t load = SysTick->LOAD;   // 保存原本的重装载值
-    SysTick->LOAD = us_to_tick(us);  // 在指定时间后中断
-    uint32_t val = SysTick->VAL;
+    uint32_t elapsed = load - SysTick->VAL;  // 当前周期已经过的计数
+    SysTick->LOAD = ticks - 1;               // 在指定时间后中断
     SysTick->VAL = 0;
     SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
-    CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
-    __wfi();  // 关闭CPU等待中断
+    __wfi();  // 关闭CPU等待中断(关中断时挂起的中断仍可唤醒)
     SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
-    SysTick->LOAD = load;  // 恢复重装载值
-    SysTick->VAL = val;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        // 休眠到期, 清除挂起的中断以免按恢复后的LOAD只计一个周期
+        SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+        elapsed += ticks;
+    } else {  // 被其他中断提前唤醒
+        elapsed += ticks - 1 - SysTick->VAL;
+    }
+    SysTick->LOAD = load;  // 恢复重装载值, 从完整的周期重新开始计数
+    SysTick->VAL = 0;
     SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    for (elapsed += residue; elapsed > load; elapsed -= load + 1)
+        SysTick_Handler();  // 补偿休眠期间跨过的周期
+    residue = elapsed;
+    __enable_irq();
 }
 #endif
 
 __weak void scheduler_idle_handler(uint64_t idleTimeUs) {
+#if !SCH_CFG_TICKLESS
     if (idleTimeUs > 1000)
         idleTimeUs = 1000;  // 最多休眠1ms以保证事件的及时响应
+#endif
 #if MOD_CFG_OS_AVAILABLE
     m_delay_us(idleTimeUs);
 #else  // 关闭CPU
 #if MOD_CFG_WFI_WHEN_SYSTEM_IDLE
     SysTick_Sleep(idleTimeUs);
+#else
+    (void)idleTimeUs;
 #endif
 #endif
 }
 
+__weak void scheduler_wakeup_handler(void) {}
+
+void scheduler_wakeup(void) {
+    wakeup_pending = 1;
+    scheduler_wakeup_handler();
+}
+
 uint64_t _INLINE scheduler_run(const uint8_t block) {
 // #define CHECK(rslp, name) LOG_DEBUG_LIMIT(1000, #name " rslp=%d", rslp)
 #define CHECK(rslp, name) ((void)0)
     uint64_t mslp, rslp;
     do {
         mslp = UINT64_MAX;
+        wakeup_pending = 0;
 #if SCH_CFG_ENABLE_SOFTINT
-        soft_int_runner();
+        rslp = soft_int_runner();
+        CHECK(rslp, softint);
+        if (rslp < mslp)
+            mslp = rslp;
 #endif
 #if SCH_CFG_ENABLE_TASK
         rslp = task_runner();
@@ -57,21 +108,142 @@ uint64_t _INLINE scheduler_run(const uint8_t block) {
             mslp = rslp;
 #endif
 #if SCH_CFG_ENABLE_EVENT
-        event_runner();
+        rslp = event_runner();
+        CHECK(rslp, event);
+        if (rslp < mslp)
+            mslp = rslp;
 #endif
+#if SCH_CFG_TICKLESS
+        if (mslp > SCH_CFG_TICKLESS_MAX_SLEEP_US)
+            mslp = SCH_CFG_TICKLESS_MAX_SLEEP_US;  // 没有任务或等待时间过长
+#else
         if (mslp == UINT64_MAX)
             mslp = 1000;  // 没有任何任务
+#endif
 #if SCH_CFG_DEBUG_REPORT
         if (debug_info_runner(mslp))
             continue;
 #endif
+        if (wakeup_pending)
+            mslp = 0;  // 调度期间有新的触发, 立即开始下一轮
         if (block && mslp) {
+            SCH_TRACE(IDLE_BEGIN, NULL, SCH_TRACE_ARG(mslp));
+#if SCH_CFG_IDLE_STAT
+            uint64_t idle_start = get_sys_us();
             scheduler_idle_handler(mslp);
+            stat_idle_us += get_sys_us() - idle_start;
+            stat_wakeups++;
+#else
+            scheduler_idle_handler(mslp);
+#endif
+            SCH_TRACE(IDLE_END, NULL, 0);
         }
     } while (block);
     return mslp;
 }
 
+#if SCH_CFG_IDLE_STAT
+void scheduler_get_idle_stat(sch_idle_stat_t* stat, uint8_t reset) {
+    uint64_t now = get_sys_us();
+    stat->period_us = now - stat_start_us;
+    stat->idle_us = stat_idle_us;
+    stat->wakeups = stat_wakeups;
+    if (stat->period_us) {
+        stat->wakeup_rate = (float)stat_wakeups * 1000000 / stat->period_us;
+        stat->idle_ratio = (float)stat_idle_us / stat->period_us;
+    } else {
+        stat->wakeup_rate = 0;
+        stat->idle_ratio = 0;
+    }
+    if (reset) {
+        stat_start_us = now;
+        stat_idle_us = 0;
+        stat_wakeups = 0;
+    }
+}
+#endif  // SCH_CFG_IDLE_STAT
+
+_STATIC_INLINE uint32_t name_hash(const char* key) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < ID_NAME_MAX_LEN && key[i]; i++) {
+        hash ^= (uint8_t)key[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+_STATIC_INLINE uint8_t name_equal(const char* str1, const char* str2) {
+#if SCH_CFG_STATIC_NAME
+    return strncmp(str1, str2, ID_NAME_MAX_LEN) == 0;
+#else
+    return fast_strcmp(str1, str2);
+#endif
+}
+
+static uint8_t index_resize(sch_index_t* index, uint16_t size) {
+    sch_index_node_t** buckets = m_alloc(size * sizeof(sch_index_node_t*));
+    if (buckets == NULL)
+        return 0;
+    memset(buckets, 0, size * sizeof(sch_index_node_t*));
+    for (uint16_t i = 0; i < index->size; i++) {  // 重新散列
+        sch_index_node_t* node = index->buckets[i];
+        while (node != NULL) {
+            sch_index_node_t* next = node->next;
+            node->next = buckets[node->hash & (size - 1)];
+            buckets[node->hash & (size - 1)] = node;
+            node = next;
+        }
+    }
+    if (index->buckets != NULL)
+        m_free(index->buckets);
+    index->buckets = buckets;
+    index->size = size;
+    return 1;
+}
+
+uint8_t sch_index_add(sch_index_t* index, sch_index_node_t* node,
+                      const char* key) {
+    if (index->num >= index->size && index->size < 0x8000) {  // 负载因子<=1
+        if (!index_resize(index, index->size ? index->size << 1 : 8) &&
+            !index->size)
+            return 0;
+    }
+    node->key = key;
+    node->hash = name_hash(key);
+    node->next = index->buckets[node->hash & (index->size - 1)];
+    index->buckets[node->hash & (index->size - 1)] = node;
+    index->num++;
+    return 1;
+}
+
+void sch_index_remove(sch_index_t* index, sch_index_node_t* node) {
+    if (!index->size)
+        return;
+    sch_index_node_t** pp = &index->buckets[node->hash & (index->size - 1)];
+    while (*pp != NULL) {
+        if (*pp == node) {
+            *pp = node->next;
+            node->next = NULL;
+            index->num--;
+            return;
+        }
+        pp = &(*pp)->next;
+    }
+}
+
+sch_index_node_t* sch_index_find(const sch_index_t* index, const char* key) {
+    if (!index->num || key == NULL)
+        return NULL;
+    uint32_t hash = name_hash(key);
+    sch_index_node_t* node = index->buckets[hash & (index->size - 1)];
+    while (node != NULL) {
+        if (node->hash == hash && name_equal(node->key, key))
+            return node;
+        node = node->next;
+    }
+    return NULL;
+}
+
 #if SCH_CFG_DEBUG_REPORT
 _INLINE uint8_t debug_info_runner(uint64_t sleep_us) {
     static uint8_t first_print = 1;
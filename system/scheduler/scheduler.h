@@ -18,11 +18,14 @@ extern "C" {
 #include "scheduler_runlater.h"
 #include "scheduler_softint.h"
 #include "scheduler_task.h"
+#include "scheduler_trace.h"
 
 /**
  * @brief 调度器主函数
  * @param  block            是否阻塞, 若不阻塞则应将此函数放在SuperLoop中
  * @retval uint64_t         返回时间: 距离下一次调度的时间(us)
+ * @note 开启SCH_CFG_TICKLESS时, 返回时间为各模块中最近的到期时间(不超过
+ *       SCH_CFG_TICKLESS_MAX_SLEEP_US), 否则最长为1ms
  * @note block=0时. SuperLoop应保证在返回时间前交还CPU以最小化调度延迟
  * @note block=1时. 查看scheduler_Idle_Callback函数说明
  **/
@@ -36,6 +39,37 @@ extern uint64_t scheduler_run(const uint8_t block);
  */
 extern void scheduler_idle_handler(uint64_t idleTimeUs);
 
+/**
+ * @brief 唤醒调度器, 使其跳过(或尽快结束)本次空闲休眠
+ * @note 触发事件/软中断/发送协程消息时自动调用, 可在中断中调用
+ */
+extern void scheduler_wakeup(void);
+
+/**
+ * @brief 调度器唤醒回调函数, 由用户实现(可选), 在scheduler_wakeup中调用
+ * @note  若scheduler_idle_handler使用了OS延时等无法被中断打断的休眠方式,
+ *        应在此函数中结束休眠(如释放信号量), 否则新的触发需等待休眠结束才能处理
+ * @note  可能在中断中被调用
+ */
+extern void scheduler_wakeup_handler(void);
+
+#if SCH_CFG_IDLE_STAT
+typedef struct {        // 调度器空闲统计
+    uint64_t period_us;  // 统计时长(us)
+    uint64_t idle_us;    // 空闲(休眠)时长(us)
+    uint32_t wakeups;    // 唤醒次数(空闲回调返回次数)
+    float wakeup_rate;   // 每秒唤醒次数
+    float idle_ratio;    // 空闲时间占比(0~1)
+} sch_idle_stat_t;
+
+/**
+ * @brief 获取调度器空闲统计(仅block=1时统计)
+ * @param  stat             统计结果
+ * @param  reset            是否在读取后重置统计
+ */
+extern void scheduler_get_idle_stat(sch_idle_stat_t* stat, uint8_t reset);
+#endif  // SCH_CFG_IDLE_STAT
+
 #if SCH_CFG_ENABLE_TERMINAL
 #include "embedded_cli.h"
 /**
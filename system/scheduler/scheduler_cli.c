@@ -61,5 +61,18 @@ void sch_add_command_to_cli(EmbeddedCli* cli) {
 
     embeddedCliAddBinding(cli, softint_cmd);
 #endif  // SCH_CFG_ENABLE_SOFTINT
+
+#if SCH_CFG_TRACE
+    static CliCommandBinding trace_cmd = {
+        .name = "trace",
+        .usage = "trace [-s start | -p pause | -c clear | -d dump]",
+        .help = "Scheduler trace control command",
+        .context = NULL,
+        .autoTokenizeArgs = 1,
+        .func = trace_cmd_func,
+    };
+
+    embeddedCliAddBinding(cli, trace_cmd);
+#endif  // SCH_CFG_TRACE
 }
 #endif  // SCH_CFG_ENABLE_TERMINAL
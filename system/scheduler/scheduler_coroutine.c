@@ -3,33 +3,68 @@
 #if SCH_CFG_ENABLE_COROUTINE
 #include "scheduler_internal.h"
 
-typedef struct {          // 协程任务结构
-    ID_NAME_VAR(name);    // 协程名
+typedef struct __sch_cortn {  // 协程任务结构
+    sch_index_node_t node;    // 名称索引节点
+    ID_NAME_VAR(name);        // 协程名
     cortn_func_t task;    // 任务函数指针
     void* args;           // 协程主函数参数
     __cortn_handle_t hd;  // 协程句柄
+    struct __sch_cortn* rq_prev;  // 就绪队列前驱
+    struct __sch_cortn* rq_next;  // 就绪队列后继
+    mod_size_t heap_idx;          // 在睡眠堆中的位置
+    uint8_t queue;                // 所在队列(CR_QUEUE_*)
+    uint8_t chan_wait;            // 已登记在通道等待列表中
 #if SCH_CFG_DEBUG_REPORT
     uint64_t max_cost;    // 协程最大执行时间(Tick)
     uint64_t total_cost;  // 协程总执行时间(Tick)
     float last_usage;     // 协程上次执行占用率
-    size_t stack_size;    // 协程动态栈大小
-    size_t last_stack;    // 协程上一个获取的栈大小
 #endif
 } scheduler_cortn_t;
 
+#define CR_QUEUE_NONE 0   // 未入队(运行中/等待消息)
+#define CR_QUEUE_READY 1  // 就绪队列
+#define CR_QUEUE_SLEEP 2  // 睡眠堆
+#define CR_QUEUE_MUTEX 3  // 互斥锁等待队列
+
 typedef struct {        // 协程互斥锁结构
     ID_NAME_VAR(name);  // 锁名
     uint8_t locked;     // 锁状态
-    ulist_t waitlist;   // 等待的协程列表
+    ulist_t waitlist;   // 等待的协程列表(scheduler_cortn_t*), 先到先得
 } sch_cortneduler_mutex_t;
 
+typedef struct __sch_chan {  // 协程通道结构
+    size_t isize;            // 元素大小
+    mod_size_t cap;          // 容量(元素个数)
+    mod_size_t head;         // 队首位置
+    mod_size_t count;        // 元素个数
+    ulist_t recv_waiters;    // 等待接收的协程(scheduler_cortn_t*)
+    ulist_t send_waiters;    // 等待发送的协程(scheduler_cortn_t*)
+    uint8_t buf[];           // 环形缓冲区
+} scheduler_chan_t;
+
+typedef struct {                // 睡眠堆元素
+    uint64_t until;             // 唤醒时间, 与协程的sleepUntil相同
+    struct __sch_cortn* cortn;  // 协程
+} sleep_node_t;
+
+// 全部协程(scheduler_cortn_t*), 协程本体单独分配以保证句柄稳定
 static ulist_t cortnlist = {.data = NULL,
                             .cap = 0,
                             .num = 0,
                             .elfree = NULL,
-                            .isize = sizeof(scheduler_cortn_t),
+                            .isize = sizeof(scheduler_cortn_t*),
                             .opt = ULIST_OPT_CLEAR_DIRTY_REGION};
 
+static sch_index_t cortnindex = {.buckets = NULL, .size = 0, .num = 0};
+
+// 全部通道(scheduler_chan_t*), 用于停止协程时清理等待登记
+static ulist_t chanlist = {.data = NULL,
+                           .cap = 0,
+                           .num = 0,
+                           .elfree = NULL,
+                           .isize = sizeof(scheduler_chan_t*),
+                           .opt = ULIST_OPT_CLEAR_DIRTY_REGION};
+
 static ulist_t mutexlist = {
     .data = NULL,
     .cap = 0,
@@ -38,136 +73,350 @@ static ulist_t mutexlist = {
     .isize = sizeof(sch_cortneduler_mutex_t),
     .opt = ULIST_OPT_CLEAR_DIRTY_REGION | ULIST_OPT_NO_ALLOC_EXTEND};
 
+// 就绪队列: 待运行的协程(含yield后继续运行的协程), 先进先出
+static scheduler_cortn_t* ready_head = NULL;
+static scheduler_cortn_t* ready_tail = NULL;
+// 本轮调度的最后一个协程, 运行中新就绪的协程留到下一轮
+static scheduler_cortn_t* pass_last = NULL;
+
+// 睡眠堆: 延时中的协程, 按唤醒时间排序的小顶堆
+static ulist_t sleep_heap = {
+    .data = NULL,
+    .cap = 0,
+    .num = 0,
+    .elfree = NULL,
+    .isize = sizeof(sleep_node_t),
+    .opt = ULIST_OPT_NO_SHRINK | ULIST_OPT_NO_AUTO_FREE};
+
 static __cortn_handle_t* cortn_handle_now = NULL;
 
+#define HEAP_ARR() ((sleep_node_t*)sleep_heap.data)
+#define HEAP_TOP() (HEAP_ARR()[0])
+#define CORTN_OF(handle) \
+    ((scheduler_cortn_t*)((uint8_t*)(handle) - offsetof(scheduler_cortn_t, hd)))
+
+static void ready_push(scheduler_cortn_t* cortn) {
+    cortn->queue = CR_QUEUE_READY;
+    cortn->rq_next = NULL;
+    cortn->rq_prev = ready_tail;
+    if (ready_tail != NULL)
+        ready_tail->rq_next = cortn;
+    else
+        ready_head = cortn;
+    ready_tail = cortn;
+}
+
+static void ready_remove(scheduler_cortn_t* cortn) {
+    if (cortn == pass_last)  // 本轮剩余的协程向前收缩
+        pass_last = cortn->rq_prev;
+    if (cortn->rq_prev != NULL)
+        cortn->rq_prev->rq_next = cortn->rq_next;
+    else
+        ready_head = cortn->rq_next;
+    if (cortn->rq_next != NULL)
+        cortn->rq_next->rq_prev = cortn->rq_prev;
+    else
+        ready_tail = cortn->rq_prev;
+    cortn->queue = CR_QUEUE_NONE;
+}
+
+_STATIC_INLINE void heap_place(mod_size_t idx, sleep_node_t node) {
+    HEAP_ARR()[idx] = node;
+    node.cortn->heap_idx = idx;
+}
+
+static void heap_sift_up(mod_size_t idx) {
+    sleep_node_t node = HEAP_ARR()[idx];
+    while (idx) {
+        mod_size_t parent = (idx - 1) >> 1;
+        if (HEAP_ARR()[parent].until <= node.until)
+            break;
+        heap_place(idx, HEAP_ARR()[parent]);
+        idx = parent;
+    }
+    heap_place(idx, node);
+}
+
+/**
+ * @brief 空位下沉到叶子: 每层把较小的子节点上移, 返回最终空位
+ * @note  不与被填入的元素比较, 分支可预测; 填入末尾元素后再上浮即可
+ */
+static mod_size_t heap_hole_down(mod_size_t idx) {
+    sleep_node_t* arr = HEAP_ARR();
+    mod_size_t child;
+    while ((child = (idx << 1) + 1) < sleep_heap.num) {
+        child += child + 1 < sleep_heap.num &&
+                 arr[child + 1].until < arr[child].until;
+        heap_place(idx, arr[child]);
+        idx = child;
+    }
+    return idx;
+}
+
+static uint8_t sleep_push(scheduler_cortn_t* cortn) {
+    if (ulist_append(&sleep_heap) == NULL)
+        return 0;
+    cortn->queue = CR_QUEUE_SLEEP;
+    sleep_node_t node = {.until = cortn->hd.sleepUntil, .cortn = cortn};
+    heap_place(sleep_heap.num - 1, node);
+    heap_sift_up(sleep_heap.num - 1);
+    return 1;
+}
+
+static void sleep_remove(scheduler_cortn_t* cortn) {
+    mod_size_t idx = cortn->heap_idx;
+    sleep_node_t last = HEAP_ARR()[sleep_heap.num - 1];
+    ulist_delete(&sleep_heap, -1);
+    cortn->queue = CR_QUEUE_NONE;
+    if (idx < sleep_heap.num) {  // 空位下沉后以末尾元素填补
+        idx = heap_hole_down(idx);
+        heap_place(idx, last);
+        heap_sift_up(idx);
+    }
+}
+
+static void mutex_wait_remove(scheduler_cortn_t* cortn);
+static void chan_wait_remove_all(scheduler_cortn_t* cortn);
+
+/**
+ * @brief 将协程从所在的队列中移除
+ */
+static void dequeue_cortn(scheduler_cortn_t* cortn) {
+    switch (cortn->queue) {
+        case CR_QUEUE_READY:
+            ready_remove(cortn);
+            break;
+        case CR_QUEUE_SLEEP:
+            sleep_remove(cortn);
+            break;
+        case CR_QUEUE_MUTEX:
+            mutex_wait_remove(cortn);
+            break;
+        default:
+            break;
+    }
+}
+
+#define ARENA_ALIGN(size) (((size) + 7) & ~(size_t)7)
+#define CHUNK_BUF(chunk) ((uint8_t*)((chunk) + 1))
+
+/**
+ * @brief 释放指定内存块及其后的所有块
+ */
+static void arena_free_chunks(__cortn_arena_t* arena, __cortn_chunk_t* chunk) {
+    if (chunk->prev != NULL)
+        chunk->prev->next = NULL;
+    while (chunk != NULL) {
+        __cortn_chunk_t* next = chunk->next;
+        arena->cap -= chunk->size;
+        m_free(chunk);
+        chunk = next;
+    }
+}
+
+/**
+ * @brief 从帧内存区栈顶分配, 当前块空间不足时切换到下一块(复用或新分配)
+ * @param  arena            帧内存区
+ * @param  size             分配大小
+ * @retval void*            分配的内存, 失败返回NULL
+ */
+static void* arena_alloc(__cortn_arena_t* arena, size_t size) {
+    __cortn_chunk_t* chunk = arena->chunk;
+    size = ARENA_ALIGN(size);
+    if (arena->top + size > chunk->size) {
+        __cortn_chunk_t* next = chunk->next;
+        if (next != NULL && next->size < size) {  // 保留的块不够大, 重新分配
+            arena_free_chunks(arena, next);
+            next = NULL;
+        }
+        if (next == NULL) {
+            size_t csize = size > SCH_CFG_CORTN_ARENA_SIZE
+                               ? size
+                               : ARENA_ALIGN(SCH_CFG_CORTN_ARENA_SIZE);
+            next = m_alloc(sizeof(__cortn_chunk_t) + csize);
+            if (next == NULL)
+                return NULL;
+            next->prev = chunk;
+            next->next = NULL;
+            next->size = csize;
+            chunk->next = next;
+            arena->cap += csize;
+        }
+        next->base = chunk->base + arena->top;
+        arena->chunk = chunk = next;
+        arena->top = 0;
+    }
+    void* ptr = CHUNK_BUF(chunk) + arena->top;
+    arena->top += size;
+    if (chunk->base + arena->top > arena->peak)
+        arena->peak = chunk->base + arena->top;
+    return ptr;
+}
+
+/**
+ * @brief 将帧内存区栈顶回退到指定位置(该位置之后分配的内存全部释放)
+ */
+static void arena_pop(__cortn_arena_t* arena, void* ptr) {
+    while ((uintptr_t)ptr < (uintptr_t)CHUNK_BUF(arena->chunk) ||
+           (uintptr_t)ptr >=
+               (uintptr_t)CHUNK_BUF(arena->chunk) + arena->chunk->size) {
+        arena->chunk = arena->chunk->prev;
+    }
+    arena->top = (uint8_t*)ptr - CHUNK_BUF(arena->chunk);
+}
+
 _INLINE uint64_t cortn_runner(void) {
     if (!cortnlist.num)
         return UINT64_MAX;
-    uint64_t sleep_us = UINT64_MAX;
     uint64_t now = get_sys_us();
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (cortn->hd.state == _CR_STATE_STOPPED) {
-            sch_cortn_stop(cortn->name);
-            return 0;  // 指针已被释放
-        } else if (cortn->hd.state == _CR_STATE_READY) {
-            cortn->hd.state = _CR_STATE_RUNNING;  // 就绪态转运行态
-            cortn->hd.sleepUntil = 0;
-        } else if (cortn->hd.state == _CR_STATE_AWAITING) {
-            continue;  // 跳过等待态协程
-        }
+    while (sleep_heap.num && HEAP_TOP().until <= now) {
+        scheduler_cortn_t* cortn = HEAP_TOP().cortn;  // 到期协程转入就绪队列
+        sleep_remove(cortn);
+        ready_push(cortn);
+    }
+    pass_last = ready_tail;
+    while (pass_last != NULL) {
+        scheduler_cortn_t* cortn = ready_head;
+        ready_remove(cortn);
         cortn_handle_now = &cortn->hd;
-        // 检查睡眠态协程或者运行态协程
-        if (cortn_handle_now->state == _CR_STATE_RUNNING ||
-            (cortn_handle_now->state == _CR_STATE_SLEEPING &&
-             now >= cortn_handle_now->sleepUntil)) {
-            cortn_handle_now->runDepth = 0;
-            cortn_handle_now->sleepUntil = 0;
+        cortn_handle_now->state = _CR_STATE_RUNNING;
+        cortn_handle_now->runDepth = 0;
+        cortn_handle_now->data = cortn_handle_now->root;
+        cortn_handle_now->sleepUntil = 0;
+        SCH_TRACE(CORTN_BEGIN, cortn, 0);
 #if SCH_CFG_DEBUG_REPORT
-            uint64_t _sch_debug_task_tick = get_sys_tick();
-            cortn->task(cortn_handle_now, cortn->args);
-            _sch_debug_task_tick = get_sys_tick() - _sch_debug_task_tick;
-            if (cortn->max_cost < _sch_debug_task_tick)
-                cortn->max_cost = _sch_debug_task_tick;
-            cortn->total_cost += _sch_debug_task_tick;
+        uint64_t _sch_debug_task_tick = get_sys_tick();
+        cortn->task(cortn_handle_now, cortn->args);
+        _sch_debug_task_tick = get_sys_tick() - _sch_debug_task_tick;
+        if (cortn->max_cost < _sch_debug_task_tick)
+            cortn->max_cost = _sch_debug_task_tick;
+        cortn->total_cost += _sch_debug_task_tick;
 #else
-            cortn->task(cortn_handle_now, cortn->args);
+        cortn->task(cortn_handle_now, cortn->args);
 #endif
-            if (cortn_handle_now->data[0].ptr == NULL) {
-                cortn_handle_now->state = _CR_STATE_STOPPED;
-                cortn_handle_now = NULL;
-                sleep_us = 0;
-                continue;  // 协程已结束
-            }
+        SCH_TRACE(CORTN_END, cortn, 0);
+        cortn_handle_now = NULL;
+        if (cortn->hd.root->ptr == 0) {  // 协程已结束
+            cortn->hd.state = _CR_STATE_STOPPED;
+            sch_cortn_stop_h(cortn);
+            continue;
         }
-        // 计算等待时间
-        if (cortn_handle_now->sleepUntil < now) {
-            sleep_us = 0;  // 直接yield的协程，不休眠
-        } else if (cortn_handle_now->sleepUntil - now < sleep_us) {
-            sleep_us = cortn_handle_now->sleepUntil - now;
+        switch (cortn->hd.state) {
+            case _CR_STATE_SLEEPING:
+                if (sleep_push(cortn))
+                    break;
+                LOG_ERROR("cortn %s enqueue failed", cortn->name);
+                ready_push(cortn);  // 退化为轮询
+                break;
+            case _CR_STATE_AWAITING:  // 等待消息, 由sch_cortn_send_msg唤醒
+            case _CR_STATE_LOCKING:   // 等待互斥锁, 由锁释放者唤醒
+            case _CR_STATE_CHANNEL:   // 无限期等待通道, 由通道操作唤醒
+                break;
+            default:  // 直接yield, 下一轮继续运行
+                ready_push(cortn);
+                break;
         }
-        cortn_handle_now = NULL;
-    }
-    return sleep_us;
-}
-
-uint8_t sch_cortn_run(const char* name, cortn_func_t func, void* args) {
-    scheduler_cortn_t cortn = {
-        .task = func,
-        .args = args,
-        .hd =
-            {
-                .state = _CR_STATE_READY,
-                .runDepth = 0,
-                .actDepth = 0,
-                .sleepUntil = 0,
-                .msg = NULL,
-                .name = name,
-            },
-    };
-    ID_NAME_SET(cortn.name, name);
-    if (!ulist_init(&cortn.hd.dataList, sizeof(__cortn_data_t), 1,
-                    ULIST_OPT_CLEAR_DIRTY_REGION | ULIST_OPT_NO_ALLOC_EXTEND |
-                        ULIST_OPT_NO_SHRINK,
-                    NULL)) {
-        return 0;
-    }
-    cortn.hd.data = (__cortn_data_t*)cortn.hd.dataList.data;
-    cortn.hd.data[0].local = NULL;
-    cortn.hd.data[0].ptr = NULL;
-    uint16_t __chd_idx;
-    if (cortn_handle_now != NULL) {  // 列表添加可能会导致旧指针失效
-        __chd_idx =
-            cortn_handle_now - &(((scheduler_cortn_t*)cortnlist.data)->hd);
     }
-    if (!ulist_append_copy(&cortnlist, &cortn)) {
-        ulist_free(&cortn.hd.dataList);
+    if (ready_head != NULL)
         return 0;
-    }
-    if (cortn_handle_now != NULL) {
-        cortn_handle_now =
-            &ulist_get_ptr(&cortnlist, scheduler_cortn_t, __chd_idx)->hd;
-    }
-    return 1;
+    if (!sleep_heap.num)
+        return UINT64_MAX;
+    now = get_sys_us();
+    return HEAP_TOP().until > now ? HEAP_TOP().until - now : 0;
 }
 
 static scheduler_cortn_t* find_cortn(const char* name) {
-    if (cortnlist.num == 0)
+    sch_index_node_t* node = sch_index_find(&cortnindex, name);
+    if (node == NULL)
         return NULL;
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (fast_strcmp(cortn->name, name)) {
-            return cortn;
-        }
-    }
-    return NULL;
+    return SCH_INDEX_ENTRY(node, scheduler_cortn_t, node);
 }
 
-static scheduler_cortn_t* find_cortn_by_handle(__cortn_handle_t* handle) {
-    if (cortnlist.num == 0)
+sch_cortn_handle_t sch_cortn_run_ex_h(const char* name, cortn_func_t func,
+                                      void* args, size_t arena_size) {
+    if (name == NULL || func == NULL || find_cortn(name) != NULL)
+        return NULL;
+    if (arena_size < sizeof(__cortn_data_t))
+        arena_size = arena_size ? sizeof(__cortn_data_t)
+                                : SCH_CFG_CORTN_ARENA_SIZE;
+    arena_size = ARENA_ALIGN(arena_size);
+    // 首个帧内存块与协程本体一同分配
+    size_t offset = ARENA_ALIGN(sizeof(scheduler_cortn_t));
+    scheduler_cortn_t* cortn =
+        m_alloc(offset + sizeof(__cortn_chunk_t) + arena_size);
+    if (cortn == NULL)
+        return NULL;
+    memset(cortn, 0, sizeof(scheduler_cortn_t));
+    cortn->task = func;
+    cortn->args = args;
+    cortn->hd.state = _CR_STATE_READY;
+    ID_NAME_SET(cortn->name, name);
+    cortn->hd.name = cortn->name;
+    __cortn_chunk_t* chunk = (__cortn_chunk_t*)((uint8_t*)cortn + offset);
+    chunk->prev = NULL;
+    chunk->next = NULL;
+    chunk->size = arena_size;
+    chunk->base = 0;
+    cortn->hd.arena.chunk = chunk;
+    cortn->hd.arena.cap = arena_size;
+    cortn->hd.root = arena_alloc(&cortn->hd.arena, sizeof(__cortn_data_t));
+    memset(cortn->hd.root, 0, sizeof(__cortn_data_t));
+    cortn->hd.data = cortn->hd.root;
+    cortn->queue = CR_QUEUE_NONE;
+    if (!sch_index_add(&cortnindex, &cortn->node, cortn->name)) {
+        m_free(cortn);
+        return NULL;
+    }
+    if (!ulist_append_copy(&cortnlist, &cortn)) {
+        sch_index_remove(&cortnindex, &cortn->node);
+        m_free(cortn);
         return NULL;
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (&cortn->hd == handle) {
-            return cortn;
-        }
     }
-    return NULL;
+    ready_push(cortn);
+    return cortn;
 }
 
-uint8_t sch_cortn_stop(const char* name) {
-    scheduler_cortn_t* cortn = find_cortn(name);
+sch_cortn_handle_t sch_cortn_run_h(const char* name, cortn_func_t func,
+                                   void* args) {
+    return sch_cortn_run_ex_h(name, func, args, SCH_CFG_CORTN_ARENA_SIZE);
+}
+
+uint8_t sch_cortn_run(const char* name, cortn_func_t func, void* args) {
+    return sch_cortn_run_h(name, func, args) != NULL;
+}
+
+sch_cortn_handle_t sch_cortn_get_handle(const char* name) {
+    return find_cortn(name);
+}
+
+uint8_t sch_cortn_stop_h(sch_cortn_handle_t cortn) {
     if (cortn == NULL)
         return 0;
     // 不允许在协程中删除自身
     if (cortn_handle_now == &cortn->hd)
         return 0;
-    ulist_foreach(&cortn->hd.dataList, __cortn_data_t, data) {
-        if (data->local != NULL)
-            m_free(data->local);
+    dequeue_cortn(cortn);
+    if (cortn->chan_wait)
+        chan_wait_remove_all(cortn);
+    __cortn_chunk_t* first = (__cortn_chunk_t*)((uint8_t*)cortn +
+                                                ARENA_ALIGN(sizeof(*cortn)));
+    if (first->next != NULL)  // 首块随协程本体释放
+        arena_free_chunks(&cortn->hd.arena, first->next);
+    sch_index_remove(&cortnindex, &cortn->node);
+    ulist_foreach(&cortnlist, scheduler_cortn_t*, pcortn) {
+        if (*pcortn == cortn) {
+            ulist_remove(&cortnlist, pcortn);
+            break;
+        }
     }
-    ulist_free(&cortn->hd.dataList);
-    ulist_remove(&cortnlist, cortn);
+    m_free(cortn);
     return 1;
 }
 
+uint8_t sch_cortn_stop(const char* name) {
+    return sch_cortn_stop_h(find_cortn(name));
+}
+
 uint16_t sch_cortn_get_num(void) {
     return cortnlist.num;
 }
@@ -176,8 +425,23 @@ uint8_t sch_cortn_get_running(const char* name) {
     return find_cortn(name) != NULL;
 }
 
-uint8_t sch_cortn_get_waiting_msg(const char* name) {
-    scheduler_cortn_t* cortn = find_cortn(name);
+uint8_t sch_cortn_get_arena_stat_h(sch_cortn_handle_t cortn,
+                                   sch_cortn_arena_stat_t* stat) {
+    if (cortn == NULL || stat == NULL)
+        return 0;
+    stat->used = cortn->hd.arena.chunk->base + cortn->hd.arena.top;
+    stat->peak = cortn->hd.arena.peak;
+    stat->cap = cortn->hd.arena.cap;
+    stat->depth = cortn->hd.actDepth;
+    return 1;
+}
+
+uint8_t sch_cortn_get_arena_stat(const char* name,
+                                 sch_cortn_arena_stat_t* stat) {
+    return sch_cortn_get_arena_stat_h(find_cortn(name), stat);
+}
+
+uint8_t sch_cortn_get_waiting_msg_h(sch_cortn_handle_t cortn) {
     if (cortn == NULL)
         return 0;
     if (cortn->hd.state == _CR_STATE_STOPPED)
@@ -185,18 +449,33 @@ uint8_t sch_cortn_get_waiting_msg(const char* name) {
     return cortn->hd.state == _CR_STATE_AWAITING;
 }
 
-uint8_t sch_cortn_send_msg(const char* name, void* msg) {
-    scheduler_cortn_t* cortn = find_cortn(name);
+uint8_t sch_cortn_get_waiting_msg(const char* name) {
+    return sch_cortn_get_waiting_msg_h(find_cortn(name));
+}
+
+uint8_t sch_cortn_send_msg_h(sch_cortn_handle_t cortn, void* msg) {
     if (cortn == NULL)
         return 0;
     if (cortn->hd.state == _CR_STATE_STOPPED)
         return 0;
     if (msg != NULL)
         cortn->hd.msg = msg;
+    if (cortn->hd.state == _CR_STATE_LOCKING ||
+        cortn->hd.state == _CR_STATE_CHANNEL)
+        return 1;  // 等锁/等通道中的协程只能由对应的操作唤醒
     cortn->hd.state = _CR_STATE_READY;
+    if (cortn_handle_now != &cortn->hd && cortn->queue != CR_QUEUE_READY) {
+        dequeue_cortn(cortn);  // 提前结束睡眠
+        ready_push(cortn);
+    }
+    scheduler_wakeup();
     return 1;
 }
 
+uint8_t sch_cortn_send_msg(const char* name, void* msg) {
+    return sch_cortn_send_msg_h(find_cortn(name), msg);
+}
+
 /**
  * @brief (内部函数)获取当前协程名
  * @return 协程名
@@ -215,23 +494,15 @@ _INLINE const char* __cortn_internal_get_name(void) {
 _INLINE void* __cortn_internal_init_local(size_t size) {
     if (size == 0)
         return (void*)0x01;
-    if (cortn_handle_now->data[cortn_handle_now->runDepth].local == NULL) {
-        // 初始化局部变量存储区
-        cortn_handle_now->data[cortn_handle_now->runDepth].local =
-            m_alloc(size);
-        if (cortn_handle_now->data[cortn_handle_now->runDepth].local == NULL)
+    __cortn_data_t* frame = cortn_handle_now->data;
+    if (frame->local == NULL) {
+        // 初始化局部变量存储区, 紧跟在本层帧之后分配
+        frame->local = arena_alloc(&cortn_handle_now->arena, size);
+        if (frame->local == NULL)
             return NULL;
-        memset(cortn_handle_now->data[cortn_handle_now->runDepth].local, 0,
-               size);
-#if SCH_CFG_DEBUG_REPORT
-        scheduler_cortn_t* cortn = find_cortn_by_handle(cortn_handle_now);
-        if (cortn != NULL) {
-            cortn->stack_size += size;
-            cortn->last_stack = size;
-        }
-#endif
+        memset(frame->local, 0, size);
     }
-    return cortn_handle_now->data[cortn_handle_now->runDepth].local;
+    return frame->local;
 }
 
 /**
@@ -239,19 +510,21 @@ _INLINE void* __cortn_internal_init_local(size_t size) {
  * @return 是否允许进行调用
  */
 _INLINE uint8_t __cortn_internal_await_enter(void) {
-    cortn_handle_now->runDepth++;
-    if (cortn_handle_now->runDepth > cortn_handle_now->actDepth) {
+    __cortn_data_t* frame = cortn_handle_now->data->next;
+    if (frame == NULL) {
         // 嵌套层级+1
-        if (!ulist_append(&cortn_handle_now->dataList)) {
-            cortn_handle_now->runDepth--;
+        frame = arena_alloc(&cortn_handle_now->arena, sizeof(__cortn_data_t));
+        if (frame == NULL)
             return 0;
-        }
-        // 更新指针，初始化
-        cortn_handle_now->data = cortn_handle_now->dataList.data;
-        cortn_handle_now->data[cortn_handle_now->runDepth].local = NULL;
-        cortn_handle_now->data[cortn_handle_now->runDepth].ptr = NULL;
+        frame->ptr = 0;
+        frame->local = NULL;
+        frame->prev = cortn_handle_now->data;
+        frame->next = NULL;
+        cortn_handle_now->data->next = frame;
         cortn_handle_now->actDepth++;
     }
+    cortn_handle_now->data = frame;
+    cortn_handle_now->runDepth++;
     return 1;
 }
 
@@ -260,26 +533,16 @@ _INLINE uint8_t __cortn_internal_await_enter(void) {
  * @return 嵌套协程已结束
  */
 _INLINE uint8_t __cortn_internal_await_return(void) {
+    __cortn_data_t* frame = cortn_handle_now->data;
+    cortn_handle_now->data = frame->prev;
     cortn_handle_now->runDepth--;
-    if (cortn_handle_now->data[cortn_handle_now->runDepth + 1].ptr != NULL) {
+    if (frame->ptr != 0) {
         // 嵌套协程未结束
         return 0;
     }
-    if (cortn_handle_now->data[cortn_handle_now->runDepth + 1].local != NULL) {
-        // 释放局部变量存储区
-        m_free(cortn_handle_now->data[cortn_handle_now->runDepth + 1].local);
-        cortn_handle_now->data[cortn_handle_now->runDepth + 1].local = NULL;
-#if SCH_CFG_DEBUG_REPORT
-        scheduler_cortn_t* cortn = find_cortn_by_handle(cortn_handle_now);
-        if (cortn != NULL) {
-            cortn->stack_size -= cortn->last_stack;
-            cortn->last_stack = 0;
-        }
-#endif
-    }
-    // 嵌套层级-1
-    ulist_delete(&cortn_handle_now->dataList, -1);
-    cortn_handle_now->data = cortn_handle_now->dataList.data;
+    // 嵌套层级-1, 回收该层帧及其局部变量
+    frame->prev->next = NULL;
+    arena_pop(&cortn_handle_now->arena, frame);
     cortn_handle_now->actDepth--;
     return 1;
 }
@@ -320,24 +583,38 @@ _STATIC_INLINE sch_cortneduler_mutex_t* get_mutex(const char* name) {
         return NULL;
     ID_NAME_SET(ret->name, name);
     ret->locked = 0;
-    ulist_init(&ret->waitlist, sizeof(char*), 0, NULL, NULL);
+    ulist_init(&ret->waitlist, sizeof(scheduler_cortn_t*), 0, 0, NULL);
     return ret;
 }
 
+static void mutex_wait_remove(scheduler_cortn_t* cortn) {
+    ulist_foreach(&mutexlist, sch_cortneduler_mutex_t, mutex) {
+        ulist_foreach(&mutex->waitlist, scheduler_cortn_t*, pcortn) {
+            if (*pcortn == cortn) {
+                ulist_remove(&mutex->waitlist, pcortn);
+                cortn->queue = CR_QUEUE_NONE;
+                return;
+            }
+        }
+    }
+}
+
 /**
  * @brief (内部函数)协程互斥锁获取
  * @param  name 锁名
- * @return 1: 获取成功跳过等待, 0: 需要等待
+ * @return 1: 获取成功跳过等待, 0: 需要等待(释放者移交锁后唤醒)
  */
 _INLINE uint8_t __cortn_internal_acq_mutex(const char* name) {
     sch_cortneduler_mutex_t* mutex = get_mutex(name);
     if (mutex == NULL)
         return 0;
     if (mutex->locked) {  // 锁已被占用, 添加到等待队列
-        const char** ptr = ulist_append(&mutex->waitlist);
+        scheduler_cortn_t** ptr = ulist_append(&mutex->waitlist);
         if (ptr == NULL)
             return 0;
-        *ptr = cortn_handle_now->name;
+        *ptr = CORTN_OF(cortn_handle_now);
+        (*ptr)->queue = CR_QUEUE_MUTEX;
+        cortn_handle_now->state = _CR_STATE_LOCKING;
         return 0;
     } else {  // 锁未被占用, 直接占用
         mutex->locked = 1;
@@ -350,22 +627,252 @@ _INLINE uint8_t __cortn_internal_acq_mutex(const char* name) {
  * @param  name 锁名
  */
 _INLINE void __cortn_internal_rel_mutex(const char* name) {
-    scheduler_cortn_t* cortn = NULL;
     sch_cortneduler_mutex_t* mutex = get_mutex(name);
     if (mutex == NULL)
         return;
-    do {
-        if (mutex->waitlist.num) {  // 等待队列不为空, 唤醒第一个协程
-            const char** ptr = ulist_get(&mutex->waitlist, 0);
-            cortn = find_cortn(*ptr);
-            if (cortn != NULL)
-                cortn->hd.state = _CR_STATE_READY;
-            ulist_delete(&mutex->waitlist, 0);
-        } else {  // 等待队列为空, 释放锁
-            mutex->locked = 0;
-            cortn = (scheduler_cortn_t*)0x01;
+    if (mutex->waitlist.num) {  // 等待队列不为空, 将锁移交给第一个协程
+        scheduler_cortn_t* cortn =
+            *(scheduler_cortn_t**)ulist_get(&mutex->waitlist, 0);
+        ulist_delete(&mutex->waitlist, 0);
+        cortn->hd.state = _CR_STATE_READY;
+        ready_push(cortn);
+    } else {  // 等待队列为空, 释放锁
+        mutex->locked = 0;
+    }
+}
+
+sch_chan_t sch_chan_create(size_t isize, mod_size_t capacity) {
+    if (isize == 0 || capacity == 0)
+        return NULL;
+    scheduler_chan_t* chan =
+        m_alloc(sizeof(scheduler_chan_t) + isize * capacity);
+    if (chan == NULL)
+        return NULL;
+    chan->isize = isize;
+    chan->cap = capacity;
+    chan->head = 0;
+    chan->count = 0;
+    ulist_init(&chan->recv_waiters, sizeof(scheduler_cortn_t*), 0,
+               ULIST_OPT_NO_SHRINK | ULIST_OPT_NO_AUTO_FREE, NULL);
+    ulist_init(&chan->send_waiters, sizeof(scheduler_cortn_t*), 0,
+               ULIST_OPT_NO_SHRINK | ULIST_OPT_NO_AUTO_FREE, NULL);
+    if (!ulist_append_copy(&chanlist, &chan)) {
+        m_free(chan);
+        return NULL;
+    }
+    return chan;
+}
+
+uint8_t sch_chan_delete(sch_chan_t chan) {
+    if (chan == NULL || chan->recv_waiters.num || chan->send_waiters.num)
+        return 0;
+    ulist_foreach(&chanlist, scheduler_chan_t*, pchan) {
+        if (*pchan == chan) {
+            ulist_remove(&chanlist, pchan);
+            break;
+        }
+    }
+    ulist_free(&chan->recv_waiters);
+    ulist_free(&chan->send_waiters);
+    m_free(chan);
+    return 1;
+}
+
+/**
+ * @brief 按等待顺序唤醒一个仍在等待的协程, 由其自行重试
+ * @note 已被其他通道唤醒(多路等待)的协程直接移出列表并跳过
+ */
+static void chan_wake_one(ulist_t* waiters) {
+    while (waiters->num) {
+        scheduler_cortn_t* cortn =
+            *ulist_get_ptr(waiters, scheduler_cortn_t*, 0);
+        ulist_delete(waiters, 0);
+        if (cortn->hd.state != _CR_STATE_CHANNEL &&
+            cortn->hd.state != _CR_STATE_SLEEPING)
+            continue;
+        cortn->hd.state = _CR_STATE_READY;
+        dequeue_cortn(cortn);  // 提前结束超时等待
+        ready_push(cortn);
+        scheduler_wakeup();
+        return;
+    }
+}
+
+/**
+ * @brief 通道仍可收/发时继续唤醒下一个等待者
+ * @note 被唤醒的协程可能未取走数据(被停止/多路等待), 唤醒需向后传递
+ */
+static void chan_kick(scheduler_chan_t* chan) {
+    if (chan->count && chan->recv_waiters.num)
+        chan_wake_one(&chan->recv_waiters);
+    if (chan->count < chan->cap && chan->send_waiters.num)
+        chan_wake_one(&chan->send_waiters);
+}
+
+uint8_t sch_chan_try_send(sch_chan_t chan, const void* data) {
+    if (chan == NULL || chan->count == chan->cap)
+        return 0;
+    mod_size_t tail = chan->head + chan->count;
+    if (tail >= chan->cap)
+        tail -= chan->cap;
+    memcpy(chan->buf + (size_t)tail * chan->isize, data, chan->isize);
+    chan->count++;
+    chan_kick(chan);
+    return 1;
+}
+
+uint8_t sch_chan_try_recv(sch_chan_t chan, void* data) {
+    if (chan == NULL || chan->count == 0)
+        return 0;
+    if (data != NULL)
+        memcpy(data, chan->buf + (size_t)chan->head * chan->isize,
+               chan->isize);
+    if (++chan->head == chan->cap)
+        chan->head = 0;
+    chan->count--;
+    chan_kick(chan);
+    return 1;
+}
+
+mod_size_t sch_chan_get_count(sch_chan_t chan) {
+    return chan == NULL ? 0 : chan->count;
+}
+
+static void chan_waiter_remove(ulist_t* waiters, scheduler_cortn_t* cortn) {
+    ulist_foreach(waiters, scheduler_cortn_t*, pcortn) {
+        if (*pcortn == cortn) {
+            ulist_remove(waiters, pcortn);
+            return;
+        }
+    }
+}
+
+static void chan_wait_remove_all(scheduler_cortn_t* cortn) {
+    ulist_foreach(&chanlist, scheduler_chan_t*, pchan) {
+        chan_waiter_remove(&(*pchan)->recv_waiters, cortn);
+        chan_waiter_remove(&(*pchan)->send_waiters, cortn);
+        chan_kick(*pchan);  // 转交可能已分配给本协程的唤醒
+    }
+    cortn->chan_wait = 0;
+}
+
+/**
+ * @brief 登记到通道等待列表并挂起当前协程
+ * @param  chans            通道列表
+ * @param  num              通道数量
+ * @param  send             等待发送(1)或接收(0)
+ * @param  deadline         超时时间(us), 0为永久等待
+ * @retval uint8_t          是否成功登记
+ */
+static uint8_t chan_wait_begin(sch_chan_t const* chans, uint8_t num,
+                               uint8_t send, uint64_t deadline) {
+    scheduler_cortn_t* cortn = CORTN_OF(cortn_handle_now);
+    for (uint8_t i = 0; i < num; i++) {
+        if (chans[i] == NULL)
+            continue;
+        ulist_t* waiters = send ? &chans[i]->send_waiters
+                                : &chans[i]->recv_waiters;
+        if (!ulist_append_copy(waiters, &cortn)) {
+            chan_wait_remove_all(cortn);
+            return 0;
+        }
+    }
+    cortn->chan_wait = 1;
+    if (deadline) {  // 超时由睡眠堆唤醒
+        cortn_handle_now->sleepUntil = deadline;
+        cortn_handle_now->state = _CR_STATE_SLEEPING;
+    } else {
+        cortn_handle_now->state = _CR_STATE_CHANNEL;
+    }
+    return 1;
+}
+
+/**
+ * @brief 被唤醒(或超时)后注销剩余的等待登记
+ */
+static void chan_wait_end(sch_chan_t const* chans, uint8_t num, uint8_t send) {
+    scheduler_cortn_t* cortn = CORTN_OF(cortn_handle_now);
+    if (!cortn->chan_wait)
+        return;
+    for (uint8_t i = 0; i < num; i++) {
+        if (chans[i] == NULL)
+            continue;
+        chan_waiter_remove(send ? &chans[i]->send_waiters
+                                : &chans[i]->recv_waiters,
+                           cortn);
+    }
+    cortn->chan_wait = 0;
+}
+
+_STATIC_INLINE uint64_t chan_deadline(uint32_t timeout_ms) {
+    if (timeout_ms == SCH_CHAN_FOREVER)
+        return 0;
+    return get_sys_us() + (uint64_t)timeout_ms * 1000;
+}
+
+/**
+ * @brief (内部函数)协程通道发送/接收
+ * @param  chan             通道
+ * @param  send             1:发送 0:接收
+ * @param  data             数据指针
+ * @param  timeout_ms       超时时间(ms), SCH_CHAN_FOREVER为永久等待
+ * @param  ok               结果输出, 1:成功 0:超时
+ */
+void __cortn_internal_chan_xfer(__async__, sch_chan_t chan, uint8_t send,
+                                void* data, uint32_t timeout_ms, uint8_t* ok) {
+    CR_INIT_LOCAL_BEGIN
+    uint64_t deadline;  // 超时时间(us), 0为永久等待
+    CR_INIT_LOCAL_END
+
+    CR_LOCAL(deadline) = chan_deadline(timeout_ms);
+    while (1) {
+        if (send ? sch_chan_try_send(chan, data)
+                 : sch_chan_try_recv(chan, data)) {
+            *ok = 1;
+            return;
         }
-    } while (cortn == NULL);
+        if (chan == NULL || timeout_ms == 0 ||
+            (CR_LOCAL(deadline) && get_sys_us() >= CR_LOCAL(deadline)) ||
+            !chan_wait_begin(&chan, 1, send, CR_LOCAL(deadline))) {
+            *ok = 0;
+            return;
+        }
+        CR_YIELD();
+        chan_wait_end(&chan, 1, send);
+    }
+}
+
+/**
+ * @brief (内部函数)协程通道多路等待接收
+ * @param  chans            通道列表
+ * @param  num              通道数量
+ * @param  timeout_ms       超时时间(ms), SCH_CHAN_FOREVER为永久等待
+ * @param  index            结果输出, 有数据的通道序号, 超时为-1
+ */
+void __cortn_internal_chan_select(__async__, sch_chan_t const* chans,
+                                  uint8_t num, uint32_t timeout_ms,
+                                  int16_t* index) {
+    CR_INIT_LOCAL_BEGIN
+    uint64_t deadline;  // 超时时间(us), 0为永久等待
+    CR_INIT_LOCAL_END
+
+    CR_LOCAL(deadline) = chan_deadline(timeout_ms);
+    while (1) {
+        for (uint8_t i = 0; i < num; i++) {
+            if (chans[i] != NULL && chans[i]->count) {
+                *index = i;
+                return;
+            }
+        }
+        if (timeout_ms == 0 ||
+            (CR_LOCAL(deadline) && get_sys_us() >= CR_LOCAL(deadline)) ||
+            !chan_wait_begin(chans, num, 0, CR_LOCAL(deadline))) {
+            *index = -1;
+            return;
+        }
+        CR_YIELD();
+        chan_wait_end(chans, num, 0);
+    }
 }
 
 static const char* get_cortn_state_str(uint8_t state) {
@@ -380,6 +887,10 @@ static const char* get_cortn_state_str(uint8_t state) {
             return "await";
         case _CR_STATE_SLEEPING:
             return "sleep";
+        case _CR_STATE_LOCKING:
+            return "mutex";
+        case _CR_STATE_CHANNEL:
+            return "chan";
         default:
             return "unknown";
     }
@@ -399,11 +910,12 @@ void sch_cortn_add_debug(TT tt, uint64_t period, uint64_t* other) {
         TT_ITEM_GRID_LINE line =
             TT_Grid_AddLine(grid, TT_Str(TT_ALIGN_CENTER, f1, f2, " | "));
         const char* head3[] = {"No",    "State", "Depth", "Tmax",
-                               "Usage", "Stack", "Name"};
+                               "Usage", "Arena", "Name"};
         for (int i = 0; i < sizeof(head3) / sizeof(char*); i++)
             TT_GridLine_AddItem(line, TT_Str(al, f1, f2, head3[i]));
         int i = 0;
-        ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
+        ulist_foreach(&cortnlist, scheduler_cortn_t*, pcortn) {
+            scheduler_cortn_t* cortn = *pcortn;
             if (i >= SCH_CFG_DEBUG_MAXLINE) {
                 TT_AddString(
                     tt,
@@ -430,8 +942,11 @@ void sch_cortn_add_debug(TT tt, uint64_t period, uint64_t* other) {
             TT_GridLine_AddItem(line, TT_FmtStr(al, f1, f2, "%.3f", usage));
             f1 = TT_FMT1_GREEN;
             f2 = TT_FMT2_NONE;
-            TT_GridLine_AddItem(line,
-                                TT_FmtStr(al, f1, f2, "%d", cortn->stack_size));
+            TT_GridLine_AddItem(
+                line, TT_FmtStr(al, f1, f2, "%d/%d",
+                                (int)(cortn->hd.arena.chunk->base +
+                                      cortn->hd.arena.top),
+                                (int)cortn->hd.arena.peak));
             TT_GridLine_AddItem(line, TT_FmtStr(al, f1, f2, "%s", cortn->name));
 
             cortn->last_usage = usage;
@@ -448,13 +963,22 @@ void sch_cortn_add_debug(TT tt, uint64_t period, uint64_t* other) {
 }
 
 void sch_cortn_finish_debug(uint8_t first_print, uint64_t offset) {
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
+    ulist_foreach(&cortnlist, scheduler_cortn_t*, pcortn) {
+        scheduler_cortn_t* cortn = *pcortn;
         cortn->max_cost = 0;
         cortn->total_cost = 0;
     }
 }
 #endif  // SCH_CFG_DEBUG_REPORT
 
+#if SCH_CFG_TRACE
+void sch_cortn_trace_names(sch_trace_write_t write) {
+    ulist_foreach(&cortnlist, scheduler_cortn_t*, pcortn) {
+        sch_trace_name(write, 3, *pcortn, (*pcortn)->name);
+    }
+}
+#endif  // SCH_CFG_TRACE
+
 #if SCH_CFG_ENABLE_TERMINAL
 void cortn_cmd_func(EmbeddedCli* cli, char* args, void* context) {
     size_t argc = embeddedCliGetTokenCount(args);
@@ -467,15 +991,21 @@ void cortn_cmd_func(EmbeddedCli* cli, char* args, void* context) {
             T_FMT(T_BOLD, T_GREEN) "Coroutines list:" T_FMT(T_RESET, T_GREEN));
         uint16_t max_len = 0;
         uint16_t temp;
-        ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-            temp = strlen(cortn->name);
+        ulist_foreach(&cortnlist, scheduler_cortn_t*, pcortn) {
+            temp = strlen((*pcortn)->name);
             if (temp > max_len)
                 max_len = temp;
         }
-        ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-            PRINTLN("  %-*s | entry:%p depth:%d state:%s", max_len, cortn->name,
-                    cortn->task, cortn->hd.actDepth,
-                    get_cortn_state_str(cortn->hd.state));
+        ulist_foreach(&cortnlist, scheduler_cortn_t*, pcortn) {
+            scheduler_cortn_t* cortn = *pcortn;
+            sch_cortn_arena_stat_t stat;
+            sch_cortn_get_arena_stat_h(cortn, &stat);
+            PRINTLN(
+                "  %-*s | entry:%p depth:%d state:%s arena:%d/%d/%d(used/peak/"
+                "cap)",
+                max_len, cortn->name, cortn->task, stat.depth,
+                get_cortn_state_str(cortn->hd.state), (int)stat.used,
+                (int)stat.peak, (int)stat.cap);
         }
         PRINTLN(T_FMT(T_BOLD, T_GREEN) "Total %d coroutines" T_RST,
                 cortnlist.num);
@@ -486,13 +1016,7 @@ void cortn_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         return;
     }
     const char* name = embeddedCliGetToken(args, 2);
-    scheduler_cortn_t* p = NULL;
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (fast_strcmp(cortn->name, name)) {
-            p = cortn;
-            break;
-        }
-    }
+    scheduler_cortn_t* p = find_cortn(name);
     if (p == NULL) {
         PRINTLN(T_FMT(T_BOLD, T_RED) "Coroutine: %s not found" T_RST, name);
         return;
@@ -8,6 +8,17 @@ extern "C" {
 #include "scheduler_coroutine_internal.h"
 
 typedef void (*cortn_func_t)(__async__, void* args);  // 协程函数指针类型
+typedef struct __sch_cortn* sch_cortn_handle_t;        // 协程句柄类型
+typedef struct __sch_chan* sch_chan_t;                 // 协程通道类型
+
+#define SCH_CHAN_FOREVER UINT32_MAX  // 通道操作永久等待
+
+typedef struct {    // 协程帧内存区统计
+    size_t used;    // 当前使用量(字节)
+    size_t peak;    // 使用量峰值(字节), 可作为sch_cortn_run_ex_h的arena_size
+    size_t cap;     // 已分配的总容量(字节)
+    uint8_t depth;  // 当前嵌套深度
+} sch_cortn_arena_stat_t;
 
 /**
  * @brief 初始化协程
@@ -88,7 +99,8 @@ typedef void (*cortn_func_t)(__async__, void* args);  // 协程函数指针类
 /**
  * @brief 等待消息并将消息指针赋值给指定变量
  */
-#define CR_RECV_MSG(to_ptr) __CR(__Internal_AwaitMsg, (void**)&(to_ptr))
+#define CR_RECV_MSG(to_ptr) \
+    __CR_AWAIT(__cortn_internal_await_msg, (void**)&(to_ptr))
 
 /**
  * @brief 发送消息给指定协程, 立即返回
@@ -105,6 +117,47 @@ typedef void (*cortn_func_t)(__async__, void* args);  // 协程函数指针类
  */
 #define CR_RELEASE_MUTEX(mutex_name) __cortn_internal_rel_mutex(mutex_name)
 
+/**
+ * @brief 向通道发送数据, 通道已满时阻塞
+ * @param  chan             通道(sch_chan_t)
+ * @param  data_ptr         待发送数据指针(拷贝isize字节)
+ * @param  timeout_ms       超时时间(ms), 0为仅尝试一次, SCH_CHAN_FOREVER为永久
+ * @param  ok               结果(uint8_t变量), 1:成功 0:超时
+ * @note 参数在恢复时会被重新求值, 应使用CR_LOCAL变量
+ */
+#define CR_CHAN_SEND(chan, data_ptr, timeout_ms, ok)                     \
+    __CR_AWAIT(__cortn_internal_chan_xfer, (chan), 1, (void*)(data_ptr), \
+               (timeout_ms), &(ok))
+
+/**
+ * @brief 从通道接收数据, 通道为空时阻塞
+ * @param  chan             通道(sch_chan_t)
+ * @param  data_ptr         接收缓冲区指针(拷贝isize字节)
+ * @param  timeout_ms       超时时间(ms), 0为仅尝试一次, SCH_CHAN_FOREVER为永久
+ * @param  ok               结果(uint8_t变量), 1:成功 0:超时
+ * @note 参数在恢复时会被重新求值, 应使用CR_LOCAL变量
+ */
+#define CR_CHAN_RECV(chan, data_ptr, timeout_ms, ok)                     \
+    __CR_AWAIT(__cortn_internal_chan_xfer, (chan), 0, (void*)(data_ptr), \
+               (timeout_ms), &(ok))
+
+/**
+ * @brief 等待多个通道中任一通道有数据
+ * @param  chans            通道数组(sch_chan_t[])
+ * @param  num              通道数量
+ * @param  timeout_ms       超时时间(ms), 0为仅尝试一次, SCH_CHAN_FOREVER为永久
+ * @param  index            结果(int16_t变量), 有数据的通道序号, 超时为-1
+ * @note 不取出数据, 返回后应立即用sch_chan_try_recv读取chans[index]
+ */
+#define CR_CHAN_SELECT(chans, num, timeout_ms, index)                      \
+    __CR_AWAIT(__cortn_internal_chan_select, (chans), (num), (timeout_ms), \
+               &(index))
+
+/**
+ * @brief 创建指定元素类型的通道
+ */
+#define CR_CHAN_CREATE(type, capacity) sch_chan_create(sizeof(type), capacity)
+
 /**
  * @brief 运行一个协程
  * @param  name             协程名
@@ -148,6 +201,89 @@ extern uint8_t sch_cortn_get_waiting_msg(const char* name);
  */
 extern uint8_t sch_cortn_send_msg(const char* name, void* msg);
 
+/**
+ * @brief 获取指定协程的帧内存区统计
+ * @param  name             协程名
+ * @param  stat             统计数据输出
+ * @retval uint8_t          是否成功
+ * @note 嵌套调用帧与CR_LOCAL局部变量均从协程独占的帧内存区栈式分配,
+ *       peak为运行至今的最大使用量
+ */
+extern uint8_t sch_cortn_get_arena_stat(const char* name,
+                                        sch_cortn_arena_stat_t* stat);
+
+/**
+ * @brief 创建协程通道(有界环形缓冲区)
+ * @param  isize            元素大小
+ * @param  capacity         容量(元素个数)
+ * @retval sch_chan_t       通道, 失败返回NULL
+ * @note 通道不属于任何协程, 可在协程外(任务/事件等)中非阻塞地收发
+ */
+extern sch_chan_t sch_chan_create(size_t isize, mod_size_t capacity);
+
+/**
+ * @brief 删除协程通道
+ * @param  chan             通道
+ * @retval uint8_t          是否成功, 仍有协程在等待时失败
+ */
+extern uint8_t sch_chan_delete(sch_chan_t chan);
+
+/**
+ * @brief 非阻塞发送, 成功时唤醒等待接收的协程
+ * @param  chan             通道
+ * @param  data             待发送数据指针
+ * @retval uint8_t          是否成功, 通道已满时失败
+ */
+extern uint8_t sch_chan_try_send(sch_chan_t chan, const void* data);
+
+/**
+ * @brief 非阻塞接收, 成功时唤醒等待发送的协程
+ * @param  chan             通道
+ * @param  data             接收缓冲区指针, NULL则丢弃数据
+ * @retval uint8_t          是否成功, 通道为空时失败
+ */
+extern uint8_t sch_chan_try_recv(sch_chan_t chan, void* data);
+
+/**
+ * @brief 获取通道中的元素个数
+ */
+extern mod_size_t sch_chan_get_count(sch_chan_t chan);
+
+/*********************句柄接口**********************/
+// 句柄接口跳过名称查找, 适合高频调用场景
+// 协程结束(或被停止)后句柄立即失效, 仅在确定协程仍在运行时使用
+
+/**
+ * @brief 运行一个协程并返回句柄
+ * @param  参数同sch_cortn_run
+ * @retval sch_cortn_handle_t 协程句柄, 失败(或协程名重复)返回NULL
+ */
+extern sch_cortn_handle_t sch_cortn_run_h(const char* name, cortn_func_t func,
+                                          void* args);
+
+/**
+ * @brief 运行一个协程并指定帧内存区首块大小
+ * @param  arena_size       首块大小(字节), 0为SCH_CFG_CORTN_ARENA_SIZE
+ * @retval sch_cortn_handle_t 协程句柄, 失败(或协程名重复)返回NULL
+ * @note 首块与协程本体一同分配; 嵌套超出后按块扩展, 扩展的块保留至协程结束
+ */
+extern sch_cortn_handle_t sch_cortn_run_ex_h(const char* name,
+                                             cortn_func_t func, void* args,
+                                             size_t arena_size);
+
+/**
+ * @brief 按协程名获取协程句柄
+ * @param  name             协程名
+ * @retval sch_cortn_handle_t 协程句柄, 未找到返回NULL
+ */
+extern sch_cortn_handle_t sch_cortn_get_handle(const char* name);
+
+extern uint8_t sch_cortn_stop_h(sch_cortn_handle_t cortn);
+extern uint8_t sch_cortn_get_waiting_msg_h(sch_cortn_handle_t cortn);
+extern uint8_t sch_cortn_send_msg_h(sch_cortn_handle_t cortn, void* msg);
+extern uint8_t sch_cortn_get_arena_stat_h(sch_cortn_handle_t cortn,
+                                          sch_cortn_arena_stat_t* stat);
+
 #endif  // SCH_CFG_ENABLE_COROUTINE
 #ifdef __cplusplus
 }
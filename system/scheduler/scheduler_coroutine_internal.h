@@ -6,21 +6,40 @@
 #define _CR_STATE_AWAITING 2  // 等待态
 #define _CR_STATE_SLEEPING 3  // 睡眠态
 #define _CR_STATE_STOPPED 4   // 停止态
-
-typedef struct {  // 协程句柄结构
-    long ptr;     // 协程跳入地址
-    void* local;  // 协程局部变量储存区
+#define _CR_STATE_LOCKING 5   // 等锁态
+#define _CR_STATE_CHANNEL 6   // 等通道态
+
+typedef struct __cortn_data {   // 协程帧结构(每层嵌套一个)
+    long ptr;                   // 协程跳入地址
+    void* local;                // 协程局部变量储存区
+    struct __cortn_data* prev;  // 上一层(调用者)帧
+    struct __cortn_data* next;  // 下一层(被等待者)帧
 } __cortn_data_t;
 
-typedef struct {           // 协程句柄结构
-    uint8_t state;         // 协程状态
-    ulist_t dataList;      // 协程数据列表(__cortn_data_t)
-    __cortn_data_t* data;  // 协程数据指针(指向当前深度)
-    uint8_t runDepth;      // 协程当前运行深度
-    uint8_t actDepth;      // 协程实际执行深度
-    uint64_t sleepUntil;   // 等待态结束时间(us), 0表示暂停
-    void* msg;             // 协程消息指针
-    const char* name;      // 协程名
+typedef struct __cortn_chunk {   // 协程帧内存块, 其后紧跟数据区
+    struct __cortn_chunk* prev;  // 上一块
+    struct __cortn_chunk* next;  // 下一块(回退后保留以供复用)
+    size_t size;                 // 数据区大小
+    size_t base;                 // 本块起始处的累计使用量
+} __cortn_chunk_t;
+
+typedef struct {             // 协程帧内存区(栈式分配)
+    __cortn_chunk_t* chunk;  // 当前内存块
+    size_t top;              // 当前块已用大小
+    size_t peak;             // 使用量峰值
+    size_t cap;              // 已分配的数据区总大小
+} __cortn_arena_t;
+
+typedef struct {            // 协程句柄结构
+    uint8_t state;          // 协程状态
+    __cortn_arena_t arena;  // 帧内存区
+    __cortn_data_t* root;   // 最外层帧
+    __cortn_data_t* data;   // 当前深度的帧
+    uint8_t runDepth;       // 协程当前运行深度
+    uint8_t actDepth;       // 协程实际执行深度
+    uint64_t sleepUntil;    // 等待态结束时间(us), 0表示暂停
+    void* msg;              // 协程消息指针
+    const char* name;       // 协程名
 } __cortn_handle_t;
 
 // 试图报个用户友好的错误
@@ -44,13 +63,21 @@ extern uint8_t __cortn_internal_acq_mutex(const char* name);
 extern void __cortn_internal_rel_mutex(const char* name);
 extern uint8_t __cortn_internal_await_bar(const char* name);
 extern void __cortn_internal_await_msg(__async__, void** msgPtr);
-
-#define __CR_INIT                                                           \
-    __cr_init_check__ :;                                                    \
-    void* __cr_async_check__ = &&__cr_init_check__;                         \
-    do {                                                                    \
-        if ((__cr_handle__->data[__cr_handle__->runDepth].ptr) != 0)        \
-            goto*(void*)(__cr_handle__->data[__cr_handle__->runDepth].ptr); \
+struct __sch_chan;
+extern void __cortn_internal_chan_xfer(__async__, struct __sch_chan* chan,
+                                       uint8_t send, void* data,
+                                       uint32_t timeout_ms, uint8_t* ok);
+extern void __cortn_internal_chan_select(__async__,
+                                         struct __sch_chan* const* chans,
+                                         uint8_t num, uint32_t timeout_ms,
+                                         int16_t* index);
+
+#define __CR_INIT                                   \
+    __cr_init_check__ :;                            \
+    void* __cr_async_check__ = &&__cr_init_check__; \
+    do {                                            \
+        if ((__cr_handle__->data->ptr) != 0)        \
+            goto*(void*)(__cr_handle__->data->ptr); \
     } while (0);
 
 #define __CR_INIT_LOCAL_BEGIN struct __cr_local {
@@ -64,28 +91,28 @@ extern void __cortn_internal_await_msg(__async__, void** msgPtr);
 
 #define __CR_LOCAL(var) (__cr_local_hd__->var)
 
-#define __CR_YIELD()                                                      \
-    do {                                                                  \
-        __label__ l;                                                      \
-        (__cr_handle__->data[__cr_handle__->runDepth].ptr) = (long) && l; \
-        return;                                                           \
-    l:;                                                                   \
-        (__cr_handle__->data[__cr_handle__->runDepth].ptr) = 0;           \
-        __cr_async_check__ = __cr_async_check__;                          \
+#define __CR_YIELD()                              \
+    do {                                          \
+        __label__ l;                              \
+        (__cr_handle__->data->ptr) = (long) && l; \
+        return;                                   \
+    l:;                                           \
+        (__cr_handle__->data->ptr) = 0;           \
+        __cr_async_check__ = __cr_async_check__;  \
     } while (0)
 
-#define __CR_AWAIT(func_cmd, args...)                                     \
-    do {                                                                  \
-        __label__ l;                                                      \
-        (__cr_handle__->data[__cr_handle__->runDepth].ptr) = (long) && l; \
-    l:;                                                                   \
-        if (__cortn_internal_await_enter()) {                             \
-            func_cmd(__cr_handle__, ##args);                              \
-            if (!__cortn_internal_await_return())                         \
-                return;                                                   \
-            (__cr_handle__->data[__cr_handle__->runDepth].ptr) = 0;       \
-        }                                                                 \
-        __cr_async_check__ = __cr_async_check__;                          \
+#define __CR_AWAIT(func_cmd, args...)             \
+    do {                                          \
+        __label__ l;                              \
+        (__cr_handle__->data->ptr) = (long) && l; \
+    l:;                                           \
+        if (__cortn_internal_await_enter()) {     \
+            func_cmd(__cr_handle__, ##args);      \
+            if (!__cortn_internal_await_return()) \
+                return;                           \
+            (__cr_handle__->data->ptr) = 0;       \
+        }                                         \
+        __cr_async_check__ = __cr_async_check__;  \
     } while (0)
 
 #define __CR_DELAY_US(us)                          \
@@ -108,7 +135,6 @@ extern void __cortn_internal_await_msg(__async__, void** msgPtr);
 #define __CR_ACQUIRE_MUTEX(mutex_name)                 \
     do {                                               \
         if (!__cortn_internal_acq_mutex(mutex_name)) { \
-            __cr_handle__->state = _CR_STATE_CRING;    \
             __CR_YIELD();                              \
         }                                              \
     } while (0)
@@ -2,10 +2,11 @@
 
 #include "scheduler_internal.h"
 #if SCH_CFG_ENABLE_EVENT
-typedef struct {            // 事件结构
-    ID_NAME_VAR(name);      // 事件名
-    sch_event_func_t task;  // 事件回调函数指针
-    uint8_t enable;         // 是否使能
+typedef struct __sch_event {  // 事件结构
+    sch_index_node_t node;    // 名称索引节点
+    ID_NAME_VAR(name);        // 事件名
+    sch_event_func_t task;    // 事件回调函数指针
+    uint8_t enable;           // 是否使能
 #if SCH_CFG_DEBUG_REPORT
     uint64_t max_cost;     // 事件最大执行时间(Tick)
     uint64_t total_cost;   // 事件总执行时间(Tick)
@@ -17,172 +18,332 @@ typedef struct {            // 事件结构
 #endif
 } scheduler_event_t;
 
-typedef struct {            // 事件触发结构
-    sch_event_func_t task;  // 事件回调函数指针
-    sch_event_arg_t arg;    // 事件参数
-    uint8_t allocated;      // 动态分配的参数内存
+#if (SCH_CFG_EVENT_QUEUE_SIZE & (SCH_CFG_EVENT_QUEUE_SIZE - 1)) != 0
+#error "SCH_CFG_EVENT_QUEUE_SIZE must be a power of 2"
+#endif
+#define EVENT_QUEUE_MASK (SCH_CFG_EVENT_QUEUE_SIZE - 1)
+
+typedef struct {               // 事件触发结构(触发队列槽)
+    mod_atomic_size_t turn;    // 槽轮次: 等于轮次基址为空闲, +1为已提交
+    sch_event_func_t task;     // 事件回调函数指针
+    sch_event_arg_t arg;       // 事件参数
+    uint8_t allocated;         // 动态分配的参数内存
+    scheduler_event_t* event;  // 源事件指针, 事件被删除后为NULL
 #if SCH_CFG_DEBUG_REPORT
-    uint64_t trigger_time;     // 触发时间(Tick)
-    scheduler_event_t* event;  // 源事件指针
+    uint64_t trigger_time;  // 触发时间(Tick)
+#endif
+#if SCH_CFG_EVENT_INLINE_ARG_SIZE > 0
+    union {  // 内联参数存储区
+        uint8_t buf[SCH_CFG_EVENT_INLINE_ARG_SIZE];
+        uint64_t _align;
+    } inline_arg;
 #endif
 } scheduler_triggered_event_t;
 
+// 全部事件(scheduler_event_t*), 事件本体单独分配以保证句柄稳定
 static ulist_t eventlist = {.data = NULL,
                             .cap = 0,
                             .num = 0,
                             .elfree = NULL,
-                            .isize = sizeof(scheduler_event_t),
+                            .isize = sizeof(scheduler_event_t*),
                             .opt = ULIST_OPT_CLEAR_DIRTY_REGION};
 
-static ulist_t triggered_eventlist = {
-    .data = NULL,
-    .cap = 0,
-    .num = 0,
-    .elfree = NULL,
-    .isize = sizeof(scheduler_triggered_event_t),
-    .opt = ULIST_OPT_NO_SHRINK};
+static sch_index_t eventindex = {.buckets = NULL, .size = 0, .num = 0};
+
+// 事件触发队列: 预分配的多生产者单消费者环形队列
+// 生产者(任意上下文, 含中断)通过CAS抢占写位置, 填充后以release提交槽
+// (未启用MOD_CFG_ENABLE_ATOMIC时抢占至提交期间关中断, 见TRIGGER_LOCK)
+// 消费者(event_runner)按序批量取出, 处理完毕后将槽释放至下一轮次
+// 槽轮次以(位置 & ~掩码)表示, 全零初始化即为合法空队列
+static scheduler_triggered_event_t trigger_queue[SCH_CFG_EVENT_QUEUE_SIZE];
+static mod_atomic_size_t trigger_head;   // 生产者写位置
+static mod_atomic_value_t trigger_tail;  // 消费者读位置
+
+#if MOD_CFG_ENABLE_ATOMIC
+#define TRIGGER_LOCK() ((void)0)
+#define TRIGGER_UNLOCK() ((void)0)
+#else
+// 无原子操作时CAS为普通读写, 中断中的触发可能与被打断的触发抢到同一个槽,
+// 因此从抢占到提交期间关中断(可嵌套)
+#define TRIGGER_LOCK()                   \
+    uint32_t _primask = __get_PRIMASK(); \
+    __disable_irq()
+#define TRIGGER_UNLOCK() __set_PRIMASK(_primask)
+#endif
 
-_INLINE void event_runner(void) {
-    static uint64_t last_event_us = 0;
-    if (!triggered_eventlist.num) {
-        if (triggered_eventlist.cap &&
-            get_sys_us() - last_event_us >
-                10000000) {  // 10s无事件触发，释放内存
-            ulist_mem_shrink(&triggered_eventlist, 1);
+/**
+ * @brief 抢占一个空闲的触发槽
+ * @retval 触发槽指针, 队列已满返回NULL
+ */
+static scheduler_triggered_event_t* trigger_reserve(void) {
+    mod_atomic_value_t pos =
+        MOD_ATOMIC_LOAD(trigger_head, MOD_ATOMIC_ORDER_RELAXED);
+    for (;;) {
+        scheduler_triggered_event_t* slot =
+            &trigger_queue[pos & EVENT_QUEUE_MASK];
+        mod_atomic_value_t turn =
+            MOD_ATOMIC_LOAD(slot->turn, MOD_ATOMIC_ORDER_ACQUIRE);
+        mod_atomic_value_t lap = pos & ~(mod_atomic_value_t)EVENT_QUEUE_MASK;
+        if (turn == lap) {
+            if (MOD_ATOMIC_CAS(trigger_head, pos, pos + 1,
+                               MOD_ATOMIC_ORDER_RELAXED))
+                return slot;  // 失败时pos已被更新为最新值
+        } else if (turn + SCH_CFG_EVENT_QUEUE_SIZE - lap <= 1) {
+            return NULL;  // 槽仍被上一轮次占用, 队列已满
+        } else {
+            pos = MOD_ATOMIC_LOAD(trigger_head, MOD_ATOMIC_ORDER_RELAXED);
         }
-        return;
     }
-    uint16_t cnt = 0;
-    ulist_foreach(&triggered_eventlist, scheduler_triggered_event_t,
-                  triggered) {
+}
+
+/**
+ * @brief 提交已填充的触发槽
+ */
+_STATIC_INLINE void trigger_commit(scheduler_triggered_event_t* slot) {
+    mod_atomic_value_t turn =
+        MOD_ATOMIC_LOAD(slot->turn, MOD_ATOMIC_ORDER_RELAXED);
+    MOD_ATOMIC_STORE(slot->turn, turn + 1, MOD_ATOMIC_ORDER_RELEASE);
+    scheduler_wakeup();
+}
+
+_INLINE uint64_t event_runner(void) {
+    mod_atomic_value_t pos = trigger_tail;
+    // 只处理本轮开始前已触发的事件, 避免回调中反复触发导致饿死其他模块
+    mod_atomic_value_t end =
+        MOD_ATOMIC_LOAD(trigger_head, MOD_ATOMIC_ORDER_ACQUIRE);
+    while (pos != end) {
+        scheduler_triggered_event_t* triggered =
+            &trigger_queue[pos & EVENT_QUEUE_MASK];
+        mod_atomic_value_t lap = pos & ~(mod_atomic_value_t)EVENT_QUEUE_MASK;
+        if (MOD_ATOMIC_LOAD(triggered->turn, MOD_ATOMIC_ORDER_ACQUIRE) !=
+            lap + 1)
+            break;                       // 槽已被抢占但尚未提交, 下轮再处理
+        if (triggered->event != NULL) {  // 事件已删除则丢弃
+            SCH_TRACE(EVENT_BEGIN, triggered->event, 0);
 #if !SCH_CFG_DEBUG_REPORT
-        triggered->task(triggered->arg);
+            triggered->task(triggered->arg);
 #else
-        scheduler_event_t* event = triggered->event;
-        uint64_t now = get_sys_tick();
-        uint64_t _late = now - triggered->trigger_time;
-        triggered->task(triggered->arg);
-        now = get_sys_tick() - now;
-        if (event->max_cost < now)
-            event->max_cost = now;
-        event->total_cost += now;
-        if (event->max_lat < _late)
-            event->max_lat = _late;
-        event->total_lat += _late;
-        event->run_cnt++;
+            uint64_t now = get_sys_tick();
+            uint64_t _late = now - triggered->trigger_time;
+            triggered->task(triggered->arg);
+            now = get_sys_tick() - now;
+            // 回调中可能删除了事件本身, 重新读取
+            scheduler_event_t* event = triggered->event;
+            if (event != NULL) {
+                if (event->max_cost < now)
+                    event->max_cost = now;
+                event->total_cost += now;
+                if (event->max_lat < _late)
+                    event->max_lat = _late;
+                event->total_lat += _late;
+                event->run_cnt++;
+            }
 #endif  // !SCH_CFG_DEBUG_REPORT
+            SCH_TRACE(EVENT_END, triggered->event, 0);
+        }
         if (triggered->allocated)
             m_free(triggered->arg.ptr);
-        cnt++;
+        // 释放槽至下一轮次
+        MOD_ATOMIC_STORE(triggered->turn, lap + SCH_CFG_EVENT_QUEUE_SIZE,
+                         MOD_ATOMIC_ORDER_RELEASE);
+        pos++;
     }
-    ulist_delete_multi(&triggered_eventlist, 0, cnt);
-    last_event_us = get_sys_us();
+    trigger_tail = pos;
+    // 队列中仍有事件(回调中触发或尚未提交)时不休眠
+    if (pos != MOD_ATOMIC_LOAD(trigger_head, MOD_ATOMIC_ORDER_RELAXED))
+        return 0;
+    return UINT64_MAX;
 }
 
-uint8_t sch_event_create(const char* name, sch_event_func_t callback,
-                         uint8_t enable) {
+static scheduler_event_t* find_event(const char* name) {
+    sch_index_node_t* node = sch_index_find(&eventindex, name);
+    if (node == NULL)
+        return NULL;
+    return SCH_INDEX_ENTRY(node, scheduler_event_t, node);
+}
+
+sch_event_handle_t sch_event_create_h(const char* name,
+                                      sch_event_func_t callback,
+                                      uint8_t enable) {
     if (!name || !callback)
-        return 0;
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
-        if (fast_strcmp(event->name, name))
-            return 0;
+        return NULL;
+    if (find_event(name) != NULL)
+        return NULL;
+    scheduler_event_t* event = m_alloc(sizeof(scheduler_event_t));
+    if (event == NULL)
+        return NULL;
+    memset(event, 0, sizeof(scheduler_event_t));
+    event->task = callback;
+    event->enable = enable;
+    ID_NAME_SET(event->name, name);
+    if (!sch_index_add(&eventindex, &event->node, event->name)) {
+        m_free(event);
+        return NULL;
+    }
+    if (!ulist_append_copy(&eventlist, &event)) {
+        sch_index_remove(&eventindex, &event->node);
+        m_free(event);
+        return NULL;
     }
-    scheduler_event_t event = {
-        .task = callback,
-        .enable = enable,
-    };
-    ID_NAME_SET(event.name, name);
-    return ulist_append_copy(&eventlist, &event);
+    return event;
 }
 
-__STATIC_INLINE scheduler_event_t* find_event(const char* name) {
-    if (eventlist.num == 0)
-        return NULL;
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
-        if (fast_strcmp(event->name, name)) {
-            return event;
+uint8_t sch_event_create(const char* name, sch_event_func_t callback,
+                         uint8_t enable) {
+    return sch_event_create_h(name, callback, enable) != NULL;
+}
+
+sch_event_handle_t sch_event_get_handle(const char* name) {
+    return find_event(name);
+}
+
+uint8_t sch_event_delete_h(sch_event_handle_t event) {
+    if (event == NULL)
+        return 0;
+    // 作废队列中已提交但尚未处理的触发(包括正在执行回调的槽),
+    // 已提交的槽只有消费者(调度器线程)才会释放, 可以安全修改
+    mod_atomic_value_t head =
+        MOD_ATOMIC_LOAD(trigger_head, MOD_ATOMIC_ORDER_ACQUIRE);
+    for (mod_atomic_value_t pos = trigger_tail; pos != head; pos++) {
+        scheduler_triggered_event_t* triggered =
+            &trigger_queue[pos & EVENT_QUEUE_MASK];
+        mod_atomic_value_t lap = pos & ~(mod_atomic_value_t)EVENT_QUEUE_MASK;
+        if (MOD_ATOMIC_LOAD(triggered->turn, MOD_ATOMIC_ORDER_ACQUIRE) ==
+                lap + 1 &&
+            triggered->event == event)
+            triggered->event = NULL;
+    }
+    sch_index_remove(&eventindex, &event->node);
+    ulist_foreach(&eventlist, scheduler_event_t*, pevent) {
+        if (*pevent == event) {
+            ulist_remove(&eventlist, pevent);
+            break;
         }
     }
-    return NULL;
+    m_free(event);
+    return 1;
 }
 
 uint8_t sch_event_delete(const char* name) {
-    scheduler_event_t* event = find_event(name);
+    return sch_event_delete_h(find_event(name));
+}
+
+uint8_t sch_event_set_enabled_h(sch_event_handle_t event, uint8_t enable) {
     if (event == NULL)
         return 0;
-    ulist_remove(&eventlist, event);
+    if (enable == 0xff)
+        event->enable = !event->enable;
+    else
+        event->enable = enable;
     return 1;
 }
 
 uint8_t sch_event_set_enabled(const char* name, uint8_t enable) {
-    scheduler_event_t* event = find_event(name);
-    if (event == NULL)
-        return 0;
-    event->enable = enable;
-    return 1;
+    return sch_event_set_enabled_h(find_event(name), enable);
 }
 
-uint8_t sch_event_trigger(const char* name, uint8_t arg_type, void* arg_ptr,
-                          size_t arg_size) {
-    scheduler_event_t* event = find_event(name);
+uint8_t sch_event_trigger_h(sch_event_handle_t event, uint8_t arg_type,
+                            void* arg_ptr, size_t arg_size) {
     if (event == NULL)
         return 0;
     if (!event->enable)
         return 0;
-    scheduler_triggered_event_t triggered = {.task = event->task,
-                                             .arg =
-                                                 {
-                                                     .type = arg_type,
-                                                     .ptr = arg_ptr,
-                                                     .size = arg_size,
-                                                 },
-                                             .allocated = 0};
+    TRIGGER_LOCK();
+    scheduler_triggered_event_t* triggered = trigger_reserve();
+    if (triggered == NULL) {
+        TRIGGER_UNLOCK();
+        return 0;
+    }
+    triggered->task = event->task;
+    triggered->arg.type = arg_type;
+    triggered->arg.ptr = arg_ptr;
+    triggered->arg.size = arg_size;
+    triggered->allocated = 0;
 #if SCH_CFG_DEBUG_REPORT
-    triggered.trigger_time = get_sys_tick();
-    triggered.event = event;
+    triggered->trigger_time = get_sys_tick();
     event->trigger_cnt++;
 #endif
-    return ulist_append_copy(&triggered_eventlist, &triggered);
+    triggered->event = event;
+    SCH_TRACE(EVENT_TRIGGER, event, 0);
+    trigger_commit(triggered);
+    TRIGGER_UNLOCK();
     return 1;
 }
 
-uint8_t sch_event_trigger_ex(const char* name, uint8_t arg_type,
-                             const void* arg_ptr, size_t arg_size) {
-    scheduler_event_t* event = find_event(name);
+uint8_t sch_event_trigger(const char* name, uint8_t arg_type, void* arg_ptr,
+                          size_t arg_size) {
+    return sch_event_trigger_h(find_event(name), arg_type, arg_ptr, arg_size);
+}
+
+uint8_t sch_event_trigger_ex_h(sch_event_handle_t event, uint8_t arg_type,
+                               const void* arg_ptr, size_t arg_size) {
     if (event == NULL)
         return 0;
     if (!event->enable)
         return 0;
-    void* args = m_alloc(arg_size);
-    if (args == NULL)
+    void* args = NULL;
+#if SCH_CFG_EVENT_INLINE_ARG_SIZE > 0
+    if (arg_size > SCH_CFG_EVENT_INLINE_ARG_SIZE)
+#endif
+    {
+        args = m_alloc(arg_size);
+        if (args == NULL)
+            return 0;
+        memcpy(args, arg_ptr, arg_size);
+    }
+    TRIGGER_LOCK();
+    scheduler_triggered_event_t* triggered = trigger_reserve();
+    if (triggered == NULL) {
+        TRIGGER_UNLOCK();
+        if (args != NULL)
+            m_free(args);
         return 0;
-    memcpy(args, arg_ptr, arg_size);
-    scheduler_triggered_event_t triggered = {
-        .task = event->task,
-        .arg = {.type = arg_type, .ptr = args, .size = arg_size},
-        .allocated = 1};
+    }
+#if SCH_CFG_EVENT_INLINE_ARG_SIZE > 0
+    if (args == NULL) {  // 小参数直接拷贝至触发槽
+        memcpy(triggered->inline_arg.buf, arg_ptr, arg_size);
+        args = triggered->inline_arg.buf;
+        triggered->allocated = 0;
+    } else
+#endif
+    {
+        triggered->allocated = 1;
+    }
+    triggered->task = event->task;
+    triggered->arg.type = arg_type;
+    triggered->arg.ptr = args;
+    triggered->arg.size = arg_size;
 #if SCH_CFG_DEBUG_REPORT
-    triggered.trigger_time = get_sys_tick();
-    triggered.event = event;
+    triggered->trigger_time = get_sys_tick();
     event->trigger_cnt++;
 #endif
-    uint8_t ret = ulist_append_copy(&triggered_eventlist, &triggered);
-    if (!ret)
-        m_free(args);
-    return ret;
+    triggered->event = event;
+    SCH_TRACE(EVENT_TRIGGER, event, 0);
+    trigger_commit(triggered);
+    TRIGGER_UNLOCK();
+    return 1;
+}
+
+uint8_t sch_event_trigger_ex(const char* name, uint8_t arg_type,
+                             const void* arg_ptr, size_t arg_size) {
+    return sch_event_trigger_ex_h(find_event(name), arg_type, arg_ptr,
+                                  arg_size);
 }
 
 uint8_t sch_event_get_exist(const char* name) {
     return find_event(name) == NULL ? 0 : 1;
 }
 
-uint8_t sch_event_get_enabled(const char* name) {
-    scheduler_event_t* event = find_event(name);
+uint8_t sch_event_get_enabled_h(sch_event_handle_t event) {
     if (event == NULL)
         return 0;
     return event->enable;
 }
 
+uint8_t sch_event_get_enabled(const char* name) {
+    return sch_event_get_enabled_h(find_event(name));
+}
+
 uint16_t sch_event_get_num(void) {
     return eventlist.num;
 }
@@ -205,7 +366,8 @@ void sch_event_add_debug(TT tt, uint64_t period, uint64_t* other) {
         for (int i = 0; i < sizeof(head2) / sizeof(char*); i++)
             TT_GridLine_AddItem(line, TT_Str(al, f1, f2, head2[i]));
         int i = 0;
-        ulist_foreach(&eventlist, scheduler_event_t, event) {
+        ulist_foreach(&eventlist, scheduler_event_t*, pevent) {
+            scheduler_event_t* event = *pevent;
             if (i >= SCH_CFG_DEBUG_MAXLINE) {
                 TT_AddString(
                     tt,
@@ -278,7 +440,8 @@ void sch_event_add_debug(TT tt, uint64_t period, uint64_t* other) {
 }
 
 void sch_event_finish_debug(uint8_t first_print, uint64_t offset) {
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
+    ulist_foreach(&eventlist, scheduler_event_t*, pevent) {
+        scheduler_event_t* event = *pevent;
         event->max_cost = 0;
         event->total_cost = 0;
         event->run_cnt = 0;
@@ -289,6 +452,14 @@ void sch_event_finish_debug(uint8_t first_print, uint64_t offset) {
 }
 #endif  // SCH_CFG_DEBUG_REPORT
 
+#if SCH_CFG_TRACE
+void sch_event_trace_names(sch_trace_write_t write) {
+    ulist_foreach(&eventlist, scheduler_event_t*, pevent) {
+        sch_trace_name(write, 2, *pevent, (*pevent)->name);
+    }
+}
+#endif  // SCH_CFG_TRACE
+
 #if SCH_CFG_ENABLE_TERMINAL
 void event_cmd_func(EmbeddedCli* cli, char* args, void* context) {
     size_t argc = embeddedCliGetTokenCount(args);
@@ -300,12 +471,13 @@ void event_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         PRINTLN(T_FMT(T_BOLD, T_GREEN) "events list:" T_FMT(T_RESET, T_GREEN));
         uint16_t max_len = 0;
         uint16_t temp;
-        ulist_foreach(&eventlist, scheduler_event_t, event) {
-            temp = strlen(event->name);
+        ulist_foreach(&eventlist, scheduler_event_t*, pevent) {
+            temp = strlen((*pevent)->name);
             if (temp > max_len)
                 max_len = temp;
         }
-        ulist_foreach(&eventlist, scheduler_event_t, event) {
+        ulist_foreach(&eventlist, scheduler_event_t*, pevent) {
+            scheduler_event_t* event = *pevent;
             PRINTLN("  %-*s | entry:%p en:%d", max_len, event->name,
                     event->task, event->enable);
         }
@@ -317,13 +489,7 @@ void event_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         return;
     }
     const char* name = embeddedCliGetToken(args, 2);
-    scheduler_event_t* p = NULL;
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
-        if (fast_strcmp(event->name, name)) {
-            p = event;
-            break;
-        }
-    }
+    scheduler_event_t* p = find_event(name);
     if (p == NULL) {
         PRINTLN(T_FMT(T_BOLD, T_RED) "event: %s not found" T_RST, name);
         return;
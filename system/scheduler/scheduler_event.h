@@ -15,6 +15,8 @@ typedef struct {
 // 事件回调函数指针类型
 typedef void (*sch_event_func_t)(sch_event_arg_t arg);
 
+typedef struct __sch_event* sch_event_handle_t;  // 事件句柄类型
+
 /**
  * @brief 创建一个事件
  * @param  name             事件名
@@ -27,9 +29,10 @@ extern uint8_t sch_event_create(const char* name, sch_event_func_t callback,
                                 uint8_t enable);
 
 /**
- * @brief 删除一个事件
+ * @brief 删除一个事件, 队列中尚未执行的触发一并丢弃
  * @param  name             事件名
  * @retval uint8_t          是否成功
+ * @note 可在事件自身的回调中调用, 不可与该事件的触发并发
  */
 extern uint8_t sch_event_delete(const char* name);
 
@@ -51,9 +54,11 @@ extern uint8_t sch_event_get_enabled(const char* name);
 /**
  * @brief 触发一个事件, 并传递参数
  * @param  name             事件名
- * @retval uint8_t          是否成功(事件不存在或禁用)
+ * @retval uint8_t          是否成功(事件不存在或禁用, 或触发队列已满)
  * @warning 事件回调是异步执行的, 需注意回调参数的生命周期
  * @note 对于短生命周期的参数, 可以考虑使用sch_event_trigger_ex
+ * @note 不分配内存, 可在中断中调用; 未启用MOD_CFG_ENABLE_ATOMIC时
+ *       以短暂关中断代替无锁操作
  */
 extern uint8_t sch_event_trigger(const char* name, uint8_t arg_type,
                                  void* arg_ptr, size_t arg_size);
@@ -64,7 +69,9 @@ extern uint8_t sch_event_trigger(const char* name, uint8_t arg_type,
  * @param  arg_type         参数类型
  * @param  arg_ptr          参数指针
  * @param  arg_size         参数大小
- * @retval uint8_t          是否成功(事件不存在或禁用, 或alloc失败)
+ * @retval uint8_t          是否成功(事件不存在或禁用, 或alloc失败/队列已满)
+ * @note 参数不超过SCH_CFG_EVENT_INLINE_ARG_SIZE时直接拷贝至触发队列,
+ *       不分配内存, 可在中断中调用
  */
 extern uint8_t sch_event_trigger_ex(const char* name, uint8_t arg_type,
                                     const void* arg_ptr, size_t arg_size);
@@ -80,6 +87,36 @@ extern uint16_t sch_event_get_num(void);
  * @retval uint8_t             事件是否存在
  */
 extern uint8_t sch_event_get_exist(const char* name);
+
+/*********************句柄接口**********************/
+// 句柄接口跳过名称查找, 适合高频触发场景
+// 句柄在事件删除前始终有效, 删除后不可再使用
+
+/**
+ * @brief 创建一个事件并返回句柄
+ * @param  参数同sch_event_create
+ * @retval sch_event_handle_t 事件句柄, 失败(或事件名重复)返回NULL
+ */
+extern sch_event_handle_t sch_event_create_h(const char* name,
+                                             sch_event_func_t callback,
+                                             uint8_t enable);
+
+/**
+ * @brief 按事件名获取事件句柄
+ * @param  name             事件名
+ * @retval sch_event_handle_t 事件句柄, 未找到返回NULL
+ */
+extern sch_event_handle_t sch_event_get_handle(const char* name);
+
+extern uint8_t sch_event_delete_h(sch_event_handle_t event);
+extern uint8_t sch_event_set_enabled_h(sch_event_handle_t event,
+                                       uint8_t enable);
+extern uint8_t sch_event_get_enabled_h(sch_event_handle_t event);
+extern uint8_t sch_event_trigger_h(sch_event_handle_t event, uint8_t arg_type,
+                                   void* arg_ptr, size_t arg_size);
+extern uint8_t sch_event_trigger_ex_h(sch_event_handle_t event,
+                                      uint8_t arg_type, const void* arg_ptr,
+                                      size_t arg_size);
 #endif  // SCH_CFG_ENABLE_EVENT
 #ifdef __cplusplus
 }
@@ -62,6 +62,17 @@ _STATIC_INLINE float tick_to_us(uint64_t tick) {
     return temp * (float)tick;
 }
 
+/**
+ * @brief 转换时钟为us(向上取整), 用于计算休眠时间, 保证唤醒时已经到期
+ * @param  tick            时钟
+ * @retval uint64_t        us
+ */
+_STATIC_INLINE uint64_t tick_to_us_ceil(uint64_t tick) {
+    if (tick > UINT64_MAX / 1000000)
+        return (uint64_t)tick_to_us(tick) + 1;
+    return (tick * 1000000 + get_sys_freq() - 1) / get_sys_freq();
+}
+
 /**
  * @brief 转换us为时钟
  * @param  us              us
@@ -102,15 +113,68 @@ _STATIC_INLINE uint8_t fast_strcmp(const char* str1, const char* str2) {
 
 #if SCH_CFG_STATIC_NAME
 #define ID_NAME_VAR(name) char name[SCH_CFG_STATIC_NAME_LEN]
-#define ID_NAME_SET(name, str) strncpy(name, str, SCH_CFG_STATIC_NAME_LEN)
+#define ID_NAME_SET(name, str)                          \
+    do {                                                \
+        strncpy(name, str, SCH_CFG_STATIC_NAME_LEN - 1); \
+        name[SCH_CFG_STATIC_NAME_LEN - 1] = '\0';       \
+    } while (0)
+#define ID_NAME_MAX_LEN (SCH_CFG_STATIC_NAME_LEN - 1)
 #else
 #define ID_NAME_VAR(name) const char* name
 #define ID_NAME_SET(name, str) name = str
+#define ID_NAME_MAX_LEN (SIZE_MAX)
 #endif
 
+typedef struct sch_index_node {  // 名称索引节点(嵌入对象结构体)
+    struct sch_index_node* next;  // 同一哈希桶内的下一个节点
+    const char* key;              // 对象名(指向对象内的名称)
+    uint32_t hash;                // 对象名哈希值
+} sch_index_node_t;
+
+typedef struct {                  // 名称哈希索引
+    sch_index_node_t** buckets;  // 哈希桶数组
+    uint16_t size;               // 哈希桶数量(2的幂)
+    uint16_t num;                // 节点数量
+} sch_index_t;
+
+/**
+ * @brief 由索引节点获取对象指针
+ * @param  node             索引节点指针
+ * @param  type             对象类型
+ * @param  member           节点在对象中的成员名
+ */
+#define SCH_INDEX_ENTRY(node, type, member) \
+    ((type*)((uint8_t*)(node) - offsetof(type, member)))
+
+/**
+ * @brief 向索引添加节点
+ * @param  index            索引
+ * @param  node             节点(需保证对象地址不变)
+ * @param  key              对象名(需与对象生命周期一致)
+ * @retval uint8_t          是否成功
+ */
+extern uint8_t sch_index_add(sch_index_t* index, sch_index_node_t* node,
+                             const char* key);
+
+/**
+ * @brief 从索引移除节点
+ * @param  index            索引
+ * @param  node             节点
+ */
+extern void sch_index_remove(sch_index_t* index, sch_index_node_t* node);
+
+/**
+ * @brief 按名称查找节点
+ * @param  index            索引
+ * @param  key              对象名
+ * @retval sch_index_node_t* 节点指针, 未找到返回NULL
+ */
+extern sch_index_node_t* sch_index_find(const sch_index_t* index,
+                                        const char* key);
+
 //////// 子模块的运行函数 ////////
-extern void event_runner(void);
-extern void soft_int_runner(void);
+extern uint64_t event_runner(void);
+extern uint64_t soft_int_runner(void);
 extern uint64_t task_runner(void);
 extern uint64_t cortn_runner(void);
 extern uint64_t runlater_runner(void);
@@ -127,12 +191,40 @@ extern void sch_event_finish_debug(uint8_t first_print, uint64_t offset);
 extern void sch_cortn_finish_debug(uint8_t first_print, uint64_t offset);
 #endif
 
+#if SCH_CFG_TRACE
+/**
+ * @brief 写入一条追踪记录(可在中断中调用)
+ * @param  type             记录类型(sch_trace_type_t)
+ * @param  obj              对象句柄
+ * @param  arg              附加参数(低24位有效)
+ */
+extern void sch_trace_record(uint8_t type, const void* obj, uint32_t arg);
+/**
+ * @brief 导出一条对象名表项
+ * @param  kind             对象类别(1:任务 2:事件 3:协程, 0:名表结束)
+ */
+extern void sch_trace_name(sch_trace_write_t write, uint8_t kind,
+                           const void* obj, const char* name);
+//////// 子模块导出对象名表的函数 ////////
+extern void sch_task_trace_names(sch_trace_write_t write);
+extern void sch_event_trace_names(sch_trace_write_t write);
+extern void sch_cortn_trace_names(sch_trace_write_t write);
+#define SCH_TRACE(type, obj, arg) \
+    sch_trace_record(SCH_TRACE_##type, (const void*)(obj), (arg))
+// 将附加参数截断到24位
+#define SCH_TRACE_ARG(x) \
+    ((x) > 0xFFFFFF ? (uint32_t)0xFFFFFF : (uint32_t)(x))
+#else
+#define SCH_TRACE(type, obj, arg) ((void)0)
+#endif
+
 #if SCH_CFG_ENABLE_TERMINAL
 //////// 子模块的命令行回调函数 ////////
 extern void task_cmd_func(EmbeddedCli* cli, char* args, void* context);
 extern void event_cmd_func(EmbeddedCli* cli, char* args, void* context);
 extern void cortn_cmd_func(EmbeddedCli* cli, char* args, void* context);
 extern void softint_cmd_func(EmbeddedCli* cli, char* args, void* context);
+extern void trace_cmd_func(EmbeddedCli* cli, char* args, void* context);
 #endif
 
 #ifdef __cplusplus
@@ -16,8 +16,10 @@ typedef struct {         // 延时调用任务结构
     void* task;          // 任务函数指针
     uint64_t runTimeUs;  // 执行时间(us)
     cl_arg_t* args;      // 参数区
+    uint32_t seq;        // 添加序号(同一时刻按添加顺序执行)
 } scheduler_runlater_t;
 
+// 按执行时间排序的小顶堆
 static ulist_t clist = {.data = NULL,
                         .cap = 0,
                         .num = 0,
@@ -25,6 +27,107 @@ static ulist_t clist = {.data = NULL,
                         .isize = sizeof(scheduler_runlater_t),
                         .opt = ULIST_OPT_NO_SHRINK};
 
+static uint32_t cl_seq = 0;
+
+#if SCH_CFG_CALLLATER_ARG_POOL > 0
+typedef union __cl_arg_block {  // 参数区内存块
+    cl_arg_t args[SCH_CFG_CALLLATER_MAX_ARG];
+    union __cl_arg_block* next;  // 空闲链表
+} cl_arg_block_t;
+
+static cl_arg_block_t arg_pool[SCH_CFG_CALLLATER_ARG_POOL];
+static cl_arg_block_t* arg_pool_free = NULL;
+static uint8_t arg_pool_inited = 0;
+#endif
+
+/**
+ * @brief 分配参数区
+ * @note 参数区固定为最大参数数量的大小, 因为调用时总是展开全部参数
+ */
+static cl_arg_t* arg_alloc(void) {
+#if SCH_CFG_CALLLATER_ARG_POOL > 0
+    if (!arg_pool_inited) {
+        for (uint16_t i = 0; i < SCH_CFG_CALLLATER_ARG_POOL - 1; i++)
+            arg_pool[i].next = &arg_pool[i + 1];
+        arg_pool[SCH_CFG_CALLLATER_ARG_POOL - 1].next = NULL;
+        arg_pool_free = &arg_pool[0];
+        arg_pool_inited = 1;
+    }
+    if (arg_pool_free != NULL) {
+        cl_arg_block_t* block = arg_pool_free;
+        arg_pool_free = block->next;
+        return block->args;
+    }
+#endif
+    // 内存池耗尽, 从堆中分配
+    return (cl_arg_t*)m_alloc(SCH_CFG_CALLLATER_MAX_ARG * sizeof(cl_arg_t));
+}
+
+static void arg_free(cl_arg_t* args) {
+    if (args == NULL)
+        return;
+#if SCH_CFG_CALLLATER_ARG_POOL > 0
+    if ((uint8_t*)args >= (uint8_t*)&arg_pool[0] &&
+        (uint8_t*)args < (uint8_t*)&arg_pool[SCH_CFG_CALLLATER_ARG_POOL]) {
+        cl_arg_block_t* block = (cl_arg_block_t*)args;
+        block->next = arg_pool_free;
+        arg_pool_free = block;
+        return;
+    }
+#endif
+    m_free((void*)args);
+}
+
+_STATIC_INLINE uint8_t cl_before(const scheduler_runlater_t* a,
+                                 const scheduler_runlater_t* b) {
+    if (a->runTimeUs != b->runTimeUs)
+        return a->runTimeUs < b->runTimeUs;
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+static void cl_sift_up(mod_size_t idx) {
+    scheduler_runlater_t* heap = (scheduler_runlater_t*)clist.data;
+    scheduler_runlater_t item = heap[idx];
+    while (idx > 0) {
+        mod_size_t parent = (idx - 1) >> 1;
+        if (!cl_before(&item, &heap[parent]))
+            break;
+        heap[idx] = heap[parent];
+        idx = parent;
+    }
+    heap[idx] = item;
+}
+
+static void cl_sift_down(mod_size_t idx) {
+    scheduler_runlater_t* heap = (scheduler_runlater_t*)clist.data;
+    scheduler_runlater_t item = heap[idx];
+    mod_size_t num = clist.num;
+    for (;;) {
+        mod_size_t child = (idx << 1) + 1;
+        if (child >= num)
+            break;
+        if (child + 1 < num && cl_before(&heap[child + 1], &heap[child]))
+            child++;
+        if (!cl_before(&heap[child], &item))
+            break;
+        heap[idx] = heap[child];
+        idx = child;
+    }
+    heap[idx] = item;
+}
+
+/**
+ * @brief 取出堆顶(最早到期)的延时调用
+ */
+static void cl_pop(scheduler_runlater_t* out) {
+    scheduler_runlater_t* heap = (scheduler_runlater_t*)clist.data;
+    *out = heap[0];
+    heap[0] = heap[clist.num - 1];
+    ulist_delete(&clist, -1);
+    if (clist.num > 1)
+        cl_sift_down(0);
+}
+
 _INLINE uint64_t runlater_runner(void) {
     static uint64_t last_active_us = 0;
     if (!clist.num) {
@@ -34,28 +137,35 @@ _INLINE uint64_t runlater_runner(void) {
         }
         return UINT64_MAX;
     }
-    uint64_t sleep_us = UINT64_MAX;
     uint64_t now = get_sys_us();
     last_active_us = now;
-    ulist_foreach(&clist, scheduler_runlater_t, callLater_p) {
-        if (now >= callLater_p->runTimeUs) {
-            if (callLater_p->args != NULL) {
-                ((cl_func_arg_t)callLater_p->task)(
+    // 本轮只执行开始前已添加的到期任务, 回调中新添加的任务留到下一轮
+    uint32_t seq_end = cl_seq;
+    scheduler_runlater_t callLater;
+    while (clist.num) {
+        scheduler_runlater_t* top = (scheduler_runlater_t*)clist.data;
+        if (top->runTimeUs > now || (int32_t)(top->seq - seq_end) >= 0)
+            break;
+        cl_pop(&callLater);  // 先出堆, 回调中可安全地添加或取消任务
+        SCH_TRACE(RUNLATER_BEGIN, callLater.task,
+                  SCH_TRACE_ARG(now - callLater.runTimeUs));
+        if (callLater.args != NULL) {
+            cl_arg_t* args = callLater.args;
+            ((cl_func_arg_t)callLater.task)(
 #define ARG_TYPE 2
 #include "scheduler_runlater_arg.h"
-                    EXPAND_ARGS_X(SCH_CFG_CALLLATER_MAX_ARG));
-                m_free((void*)callLater_p->args);
-            } else {
-                ((cl_func_noarg_t)callLater_p->task)();
-            }
-            ulist_remove(&clist, callLater_p);
-            return 0;  // 有任务被执行，不确定
-        }
-        if (callLater_p->runTimeUs - now < sleep_us) {
-            sleep_us = callLater_p->runTimeUs - now;
+                EXPAND_ARGS_X(SCH_CFG_CALLLATER_MAX_ARG));
+            arg_free(args);
+        } else {
+            ((cl_func_noarg_t)callLater.task)();
         }
+        SCH_TRACE(RUNLATER_END, callLater.task, 0);
     }
-    return sleep_us;
+    if (!clist.num)
+        return UINT64_MAX;
+    now = get_sys_us();
+    uint64_t next = ((scheduler_runlater_t*)clist.data)->runTimeUs;
+    return next > now ? next - now : 0;
 }
 
 uint8_t __sch_runlater(void* func_addr, uint64_t delay_us, uint8_t argc,
@@ -66,17 +176,17 @@ uint8_t __sch_runlater(void* func_addr, uint64_t delay_us, uint8_t argc,
     uint32_t temp4_2;
     scheduler_runlater_t task = {
         .task = func_addr, .runTimeUs = get_sys_us() + delay_us, .args = NULL};
+    if (argc > SCH_CFG_CALLLATER_MAX_ARG)
+        return 0;  // 参数过多
     if (argc) {
         uint8_t arg_index = 0;
         size_t arg_size_sum = 0;
         for (uint8_t i = 0; i < argc; i++) {
             arg_size_sum += sizeof(cl_arg_t) * (arg_size[i] > 4 ? 2 : 1);
         }
-        if (argc > SCH_CFG_CALLLATER_MAX_ARG)
-            return 0;  // 参数过多
         if (arg_size_sum > SCH_CFG_CALLLATER_MAX_ARG * sizeof(cl_arg_t))
             return 0;  // 参数过大
-        task.args = (cl_arg_t*)m_alloc(arg_size_sum);
+        task.args = arg_alloc();
         if (task.args == NULL)
             return 0;  // 内存分配失败
         for (uint8_t i = 0; i < argc; i++) {
@@ -100,24 +210,34 @@ uint8_t __sch_runlater(void* func_addr, uint64_t delay_us, uint8_t argc,
                     task.args[arg_index++] = (cl_arg_t)temp4_2;
                     break;
                 default:
+                    arg_free(task.args);
                     return 0;  // 不支持的参数长度
             }
         }
     }
-    uint8_t ret = ulist_append_copy(&clist, &task);
-    if (!ret) {
-        m_free((void*)task.args);
+    task.seq = cl_seq++;
+    if (!ulist_append_copy(&clist, &task)) {
+        arg_free(task.args);
+        return 0;
     }
-    return ret;
+    cl_sift_up(clist.num - 1);
+    return 1;
 }
 
 void __sch_runlater_cancel(void* func_addr) {
-    ulist_foreach(&clist, scheduler_runlater_t, callLater_p) {
-        if (callLater_p->task == func_addr) {
-            ulist_remove(&clist, callLater_p);
-            callLater_p--;
-            callLater_p_end--;
+    scheduler_runlater_t* heap = (scheduler_runlater_t*)clist.data;
+    mod_size_t num = 0;
+    for (mod_size_t i = 0; i < clist.num; i++) {  // 原地过滤
+        if (heap[i].task == func_addr) {
+            arg_free(heap[i].args);
+        } else {
+            heap[num++] = heap[i];
         }
     }
+    if (num == clist.num)
+        return;
+    ulist_delete_multi(&clist, num, clist.num - num);
+    for (mod_size_t i = clist.num >> 1; i > 0; i--)  // 重建堆
+        cl_sift_down(i - 1);
 }
 #endif  // SCH_CFG_ENABLE_CALLLATER
@@ -7,7 +7,7 @@
 #if ARG_TYPE == 1
 #define ARG_LIST_X(n) cl_arg_t
 #elif ARG_TYPE == 2
-#define ARG_LIST_X(n) callLater_p->args[n]
+#define ARG_LIST_X(n) args[n]
 #endif
 #undef ARG_TYPE
 
@@ -11,6 +11,8 @@ _INLINE void sch_softint_trigger(uint8_t main_channel, uint8_t sub_channel) {
     // if (main_channel > 7 || sub_channel > 7) return;
     imm |= 1 << main_channel;
     ism[main_channel] |= 1 << sub_channel;
+    SCH_TRACE(SOFTINT_TRIGGER, NULL, main_channel << 8 | sub_channel);
+    scheduler_wakeup();
 }
 
 __weak void scheduler_softint_handler(uint8_t main_channel,
@@ -18,7 +20,7 @@ __weak void scheduler_softint_handler(uint8_t main_channel,
     LOG_DEBUG_LIMIT(100, "soft_int %d:%d", main_channel, sub_channel_mask);
 }
 
-_INLINE void soft_int_runner(void) {
+_INLINE uint64_t soft_int_runner(void) {
     if (imm) {
         uint8_t _ism;
         for (uint8_t i = 0; i < 8; i++) {
@@ -26,10 +28,13 @@ _INLINE void soft_int_runner(void) {
                 _ism = ism[i];
                 ism[i] = 0;
                 imm &= ~(1 << i);
+                SCH_TRACE(SOFTINT_BEGIN, NULL, i << 8 | _ism);
                 scheduler_softint_handler(i, _ism);
+                SCH_TRACE(SOFTINT_END, NULL, i << 8 | _ism);
             }
         }
     }
+    return imm ? 0 : UINT64_MAX;  // 处理期间有新的软中断触发
 }
 
 #if SCH_CFG_ENABLE_TERMINAL
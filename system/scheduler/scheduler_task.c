@@ -2,14 +2,17 @@
 
 #include "scheduler_internal.h"
 #if SCH_CFG_ENABLE_TASK
-typedef struct {           // 用户任务结构
-    ID_NAME_VAR(name);     // 任务名
+typedef struct __sch_task {  // 用户任务结构
+    sch_index_node_t node;   // 名称索引节点
+    ID_NAME_VAR(name);       // 任务名
     sch_task_func_t task;  // 任务函数指针
     uint64_t period;       // 任务调度周期(Tick)
     uint64_t pendTime;     // 下次执行时间(Tick)
     uint8_t enable;        // 是否使能
     uint8_t priority;      // 优先级
     void* args;            // 任务参数
+    ulist_t* heap;         // 所在的调度堆(NULL: 未入队)
+    mod_size_t heap_idx;   // 在调度堆中的位置
 #if SCH_CFG_DEBUG_REPORT
     uint64_t max_cost;    // 任务最大执行时间(Tick)
     uint64_t total_cost;  // 任务总执行时间(Tick)
@@ -21,63 +24,158 @@ typedef struct {           // 用户任务结构
 #endif
 } scheduler_task_t;
 
+// 全部任务(scheduler_task_t*), 任务本体单独分配以保证指针稳定
 static ulist_t tasklist = {.data = NULL,
                            .cap = 0,
                            .num = 0,
                            .elfree = NULL,
-                           .isize = sizeof(scheduler_task_t),
+                           .isize = sizeof(scheduler_task_t*),
                            .opt = ULIST_OPT_CLEAR_DIRTY_REGION};
 
-static scheduler_task_t* pending_task = NULL;
+// 定时堆: 未到期的使能任务, 按下次执行时间排序的小顶堆
+static ulist_t timer_heap = {
+    .data = NULL,
+    .cap = 0,
+    .num = 0,
+    .elfree = NULL,
+    .isize = sizeof(scheduler_task_t*),
+    .opt = ULIST_OPT_NO_SHRINK | ULIST_OPT_NO_AUTO_FREE};
+
+// 就绪堆: 已到期的任务, 按优先级排序(同优先级先到期者在前)
+static ulist_t ready_heap = {
+    .data = NULL,
+    .cap = 0,
+    .num = 0,
+    .elfree = NULL,
+    .isize = sizeof(scheduler_task_t*),
+    .opt = ULIST_OPT_NO_SHRINK | ULIST_OPT_NO_AUTO_FREE};
+
+static sch_index_t taskindex = {.buckets = NULL, .size = 0, .num = 0};
+
+static scheduler_task_t* running_task = NULL;
 
-static int taskcmp(const void* a, const void* b) {
-    int priority1 = ((scheduler_task_t*)a)->priority;
-    int priority2 = ((scheduler_task_t*)b)->priority;
 #if SCH_CFG_PRI_ORDER_ASC
-    return priority2 - priority1;  // 高优先级在前
+#define PRI_HIGHER(p1, p2) ((p1) > (p2))  // 高优先级在前
 #else
-    return priority1 - priority2;  // 低优先级在前
+#define PRI_HIGHER(p1, p2) ((p1) < (p2))  // 低优先级在前
 #endif
+
+#define HEAP_ARR(heap) ((scheduler_task_t**)(heap)->data)
+#define HEAP_TOP(heap) (HEAP_ARR(heap)[0])
+
+/**
+ * @brief 堆内排序规则
+ * @retval uint8_t          a是否应排在b之前
+ */
+_STATIC_INLINE uint8_t task_before(const ulist_t* heap,
+                                   const scheduler_task_t* a,
+                                   const scheduler_task_t* b) {
+    if (heap == &ready_heap) {
+        if (a->priority != b->priority)
+            return PRI_HIGHER(a->priority, b->priority);
+        return a->pendTime < b->pendTime;
+    }
+    if (a->pendTime != b->pendTime)
+        return a->pendTime < b->pendTime;
+    return PRI_HIGHER(a->priority, b->priority);
 }
 
-static scheduler_task_t* find_task(const char* name) {
-    ulist_foreach(&tasklist, scheduler_task_t, task) {
-        if (fast_strcmp(task->name, name))
-            return task;
+_STATIC_INLINE void heap_place(ulist_t* heap, mod_size_t idx,
+                               scheduler_task_t* task) {
+    HEAP_ARR(heap)[idx] = task;
+    task->heap_idx = idx;
+}
+
+static void heap_sift_up(ulist_t* heap, mod_size_t idx) {
+    scheduler_task_t* task = HEAP_ARR(heap)[idx];
+    while (idx) {
+        mod_size_t parent = (idx - 1) >> 1;
+        if (!task_before(heap, task, HEAP_ARR(heap)[parent]))
+            break;
+        heap_place(heap, idx, HEAP_ARR(heap)[parent]);
+        idx = parent;
+    }
+    heap_place(heap, idx, task);
+}
+
+static void heap_sift_down(ulist_t* heap, mod_size_t idx) {
+    scheduler_task_t* task = HEAP_ARR(heap)[idx];
+    mod_size_t child;
+    while ((child = (idx << 1) + 1) < heap->num) {
+        if (child + 1 < heap->num &&
+            task_before(heap, HEAP_ARR(heap)[child + 1],
+                        HEAP_ARR(heap)[child]))
+            child++;
+        if (!task_before(heap, HEAP_ARR(heap)[child], task))
+            break;
+        heap_place(heap, idx, HEAP_ARR(heap)[child]);
+        idx = child;
     }
-    return NULL;
+    heap_place(heap, idx, task);
+}
+
+static uint8_t heap_push(ulist_t* heap, scheduler_task_t* task) {
+    if (ulist_append(heap) == NULL)
+        return 0;
+    task->heap = heap;
+    heap_place(heap, heap->num - 1, task);
+    heap_sift_up(heap, heap->num - 1);
+    return 1;
 }
 
-static void resort_task(void) {
-    if (tasklist.num <= 1)
+static void heap_remove(scheduler_task_t* task) {
+    ulist_t* heap = task->heap;
+    if (heap == NULL)
         return;
-    ulist_sort(&tasklist, taskcmp, SLICE_START, SLICE_END);
+    mod_size_t idx = task->heap_idx;
+    scheduler_task_t* last = HEAP_ARR(heap)[heap->num - 1];
+    ulist_delete(heap, -1);
+    task->heap = NULL;
+    if (idx < heap->num) {  // 用末尾元素填补空位
+        heap_place(heap, idx, last);
+        heap_sift_up(heap, idx);
+        heap_sift_down(heap, last->heap_idx);
+    }
 }
 
-static inline scheduler_task_t* get_next_task(void) {
-    if (!tasklist.num)
-        return NULL;
-    uint64_t now = get_sys_tick();
-    scheduler_task_t* next = NULL;
-    ulist_foreach(&tasklist, scheduler_task_t, task) {
-        if (!task->enable)
-            continue;  // 跳过禁用任务
-        if (now >= task->pendTime)
-            return task;  // 高优先级在前
-        if (next == NULL || task->pendTime < next->pendTime)
-            next = task;
+/**
+ * @brief 将任务(重新)放入定时堆, 禁用的任务仅出队
+ */
+static uint8_t requeue_task(scheduler_task_t* task) {
+    heap_remove(task);
+    if (!task->enable)
+        return 1;
+    if (!heap_push(&timer_heap, task)) {
+        LOG_ERROR("task %s requeue failed", task->name);
+        task->enable = 0;
+        return 0;
     }
-    return next;
+    return 1;
+}
+
+static scheduler_task_t* find_task(const char* name) {
+    sch_index_node_t* node = sch_index_find(&taskindex, name);
+    if (node == NULL)
+        return NULL;
+    return SCH_INDEX_ENTRY(node, scheduler_task_t, node);
 }
 
 _INLINE uint64_t task_runner(void) {
-    if (!pending_task)
+    if (!timer_heap.num && !ready_heap.num)
         return UINT64_MAX;
     uint64_t now = get_sys_tick();
-    if (now < pending_task->pendTime) {
-        return tick_to_us(pending_task->pendTime - now);
+    while (timer_heap.num && now >= HEAP_TOP(&timer_heap)->pendTime) {
+        scheduler_task_t* due = HEAP_TOP(&timer_heap);  // 到期任务转入就绪堆
+        heap_remove(due);
+        if (!heap_push(&ready_heap, due)) {
+            LOG_ERROR("task %s enqueue failed", due->name);
+            due->enable = 0;
+        }
     }
-    scheduler_task_t* task = pending_task;
+    if (!ready_heap.num)
+        return tick_to_us_ceil(HEAP_TOP(&timer_heap)->pendTime - now);
+    scheduler_task_t* task = HEAP_TOP(&ready_heap);
+    heap_remove(task);
     uint64_t latency = now - task->pendTime;
     if (latency <= us_to_tick(SCH_CFG_COMP_RANGE_US)) {
         task->pendTime += task->period;
@@ -87,119 +185,177 @@ _INLINE uint64_t task_runner(void) {
         task->unsync = 1;
 #endif
     }
+    requeue_task(task);  // 先入队, 任务函数内可安全修改/删除自身
+    running_task = task;
+    SCH_TRACE(TASK_BEGIN, task, SCH_TRACE_ARG(tick_to_us(latency)));
 #if SCH_CFG_DEBUG_REPORT
     uint64_t _sch_debug_task_tick = get_sys_tick();
     task->task(task->args);
     _sch_debug_task_tick = get_sys_tick() - _sch_debug_task_tick;
-    if (task->max_cost < _sch_debug_task_tick)
-        task->max_cost = _sch_debug_task_tick;
-    if (latency > task->max_lat)
-        task->max_lat = latency;
-    task->total_cost += _sch_debug_task_tick;
-    task->total_lat += latency;
-    task->run_cnt++;
+    if (running_task == task) {  // 任务未在执行中删除自身
+        if (task->max_cost < _sch_debug_task_tick)
+            task->max_cost = _sch_debug_task_tick;
+        if (latency > task->max_lat)
+            task->max_lat = latency;
+        task->total_cost += _sch_debug_task_tick;
+        task->total_lat += latency;
+        task->run_cnt++;
+    }
 #else
     task->task(task->args);
 #endif  // SCH_CFG_DEBUG_REPORT
-    pending_task = get_next_task();
+    SCH_TRACE(TASK_END, task, 0);
+    running_task = NULL;
     return 0;
 }
 
+sch_task_handle_t sch_task_create_h(const char* name, sch_task_func_t func,
+                                    float freq_hz, uint8_t enable,
+                                    uint8_t priority, void* args) {
+    if (name == NULL || func == NULL || find_task(name) != NULL)
+        return NULL;
+    scheduler_task_t* task = m_alloc(sizeof(scheduler_task_t));
+    if (task == NULL)
+        return NULL;
+    memset(task, 0, sizeof(scheduler_task_t));
+    task->task = func;
+    task->enable = enable;
+    task->priority = priority;
+    task->period = (double)get_sys_freq() / (double)freq_hz;
+    task->pendTime = get_sys_tick();
+    task->args = args;
+    ID_NAME_SET(task->name, name);
+    if (!task->period)
+        task->period = 1;
+    if (!sch_index_add(&taskindex, &task->node, task->name)) {
+        m_free(task);
+        return NULL;
+    }
+    if (!ulist_append_copy(&tasklist, &task)) {
+        sch_index_remove(&taskindex, &task->node);
+        m_free(task);
+        return NULL;
+    }
+    if (!requeue_task(task)) {
+        sch_index_remove(&taskindex, &task->node);
+        ulist_delete(&tasklist, -1);
+        m_free(task);
+        return NULL;
+    }
+    return task;
+}
+
 uint8_t sch_task_create(const char* name, sch_task_func_t func, float freq_hz,
                         uint8_t enable, uint8_t priority, void* args) {
-    scheduler_task_t task = {
-        .task = func,
-        .enable = enable,
-        .priority = priority,
-        .period = (double)get_sys_freq() / (double)freq_hz,
-        .pendTime = get_sys_tick(),
-        .args = args,
-    };
-    ID_NAME_SET(task.name, name);
-    if (!task.period)
-        task.period = 1;
-    if (!ulist_append_copy(&tasklist, &task))
+    return sch_task_create_h(name, func, freq_hz, enable, priority, args) !=
+           NULL;
+}
+
+sch_task_handle_t sch_task_get_handle(const char* name) {
+    return find_task(name);
+}
+
+uint8_t sch_task_delete_h(sch_task_handle_t task) {
+    if (task == NULL)
         return 0;
-    resort_task();
-    pending_task = get_next_task();
+    heap_remove(task);
+    sch_index_remove(&taskindex, &task->node);
+    ulist_foreach(&tasklist, scheduler_task_t*, ptask) {
+        if (*ptask == task) {
+            ulist_remove(&tasklist, ptask);
+            break;
+        }
+    }
+    if (running_task == task)
+        running_task = NULL;
+    m_free(task);
     return 1;
 }
 
 uint8_t sch_task_delete(const char* name) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
-        return 0;
-    ulist_remove(&tasklist, p);
-    pending_task = get_next_task();
-    return 1;
+    return sch_task_delete_h(find_task(name));
 }
 
 uint8_t sch_task_get_exist(const char* name) {
     return find_task(name) != NULL;
 }
 
+uint8_t sch_task_get_enabled_h(sch_task_handle_t task) {
+    if (task == NULL)
+        return 0;
+    return task->enable;
+}
+
 uint8_t sch_task_get_enabled(const char* name) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+    return sch_task_get_enabled_h(find_task(name));
+}
+
+uint8_t sch_task_set_priority_h(sch_task_handle_t task, uint8_t priority) {
+    if (task == NULL)
         return 0;
-    return p->enable;
+    task->priority = priority;
+    return requeue_task(task);
 }
 
 uint8_t sch_task_set_priority(const char* name, uint8_t priority) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+    return sch_task_set_priority_h(find_task(name), priority);
+}
+
+uint8_t sch_task_set_args_h(sch_task_handle_t task, void* args) {
+    if (task == NULL)
         return 0;
-    p->priority = priority;
-    resort_task();
-    pending_task = get_next_task();
+    task->args = args;
     return 1;
 }
 
 uint8_t sch_task_set_args(const char* name, void* args) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
-        return 0;
-    p->args = args;
-    return 1;
+    return sch_task_set_args_h(find_task(name), args);
 }
 
-uint8_t sch_task_delay(const char* name, uint64_t delay_us, uint8_t from_now) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+uint8_t sch_task_delay_h(sch_task_handle_t task, uint64_t delay_us,
+                         uint8_t from_now) {
+    if (task == NULL)
         return 0;
     if (from_now)
-        p->pendTime = us_to_tick(delay_us) + get_sys_tick();
+        task->pendTime = us_to_tick(delay_us) + get_sys_tick();
     else
-        p->pendTime += us_to_tick(delay_us);
-    pending_task = get_next_task();
-    return 1;
+        task->pendTime += us_to_tick(delay_us);
+    return requeue_task(task);
+}
+
+uint8_t sch_task_delay(const char* name, uint64_t delay_us, uint8_t from_now) {
+    return sch_task_delay_h(find_task(name), delay_us, from_now);
 }
 
 uint16_t sch_task_get_num(void) {
     return tasklist.num;
 }
 
+uint8_t sch_task_set_enabled_h(sch_task_handle_t task, uint8_t enable) {
+    if (task == NULL)
+        return 0;
+    task->enable = enable;
+    if (task->enable)
+        task->pendTime = get_sys_tick();
+    return requeue_task(task);
+}
+
 uint8_t sch_task_set_enabled(const char* name, uint8_t enable) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+    return sch_task_set_enabled_h(find_task(name), enable);
+}
+
+uint8_t sch_task_set_freq_h(sch_task_handle_t task, float freq_hz) {
+    if (task == NULL)
         return 0;
-    p->enable = enable;
-    if (p->enable)
-        p->pendTime = get_sys_tick();
-    pending_task = get_next_task();
-    return 1;
+    task->period = (double)get_sys_freq() / (double)freq_hz;
+    if (!task->period)
+        task->period = 1;
+    task->pendTime = get_sys_tick();
+    return requeue_task(task);
 }
 
 uint8_t sch_task_set_freq(const char* name, float freq_hz) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
-        return 0;
-    p->period = (double)get_sys_freq() / (double)freq_hz;
-    if (!p->period)
-        p->period = 1;
-    p->pendTime = get_sys_tick();
-    pending_task = get_next_task();
-    return 1;
+    return sch_task_set_freq_h(find_task(name), freq_hz);
 }
 
 #if SCH_CFG_DEBUG_REPORT
@@ -220,7 +376,8 @@ void sch_task_add_debug(TT tt, uint64_t period, uint64_t* other) {
         for (int i = 0; i < sizeof(head1) / sizeof(char*); i++)
             TT_GridLine_AddItem(line, TT_Str(al, f1, f2, head1[i]));
         int i = 0;
-        ulist_foreach(&tasklist, scheduler_task_t, task) {
+        ulist_foreach(&tasklist, scheduler_task_t*, ptask) {
+            scheduler_task_t* task = *ptask;
             if (i >= SCH_CFG_DEBUG_MAXLINE) {
                 TT_AddString(
                     tt,
@@ -284,7 +441,8 @@ void sch_task_add_debug(TT tt, uint64_t period, uint64_t* other) {
 }
 
 void sch_task_finish_debug(uint8_t first_print, uint64_t offset) {
-    ulist_foreach(&tasklist, scheduler_task_t, task) {
+    ulist_foreach(&tasklist, scheduler_task_t*, ptask) {
+        scheduler_task_t* task = *ptask;
         if (first_print)
             task->pendTime = get_sys_tick();
         else
@@ -295,11 +453,19 @@ void sch_task_finish_debug(uint8_t first_print, uint64_t offset) {
         task->max_lat = 0;
         task->total_lat = 0;
         task->unsync = 0;
+        requeue_task(task);
     }
-    pending_task = get_next_task();
 }
 #endif  // SCH_CFG_DEBUG_REPORT
 
+#if SCH_CFG_TRACE
+void sch_task_trace_names(sch_trace_write_t write) {
+    ulist_foreach(&tasklist, scheduler_task_t*, ptask) {
+        sch_trace_name(write, 1, *ptask, (*ptask)->name);
+    }
+}
+#endif  // SCH_CFG_TRACE
+
 #if SCH_CFG_ENABLE_TERMINAL
 void task_cmd_func(EmbeddedCli* cli, char* args, void* context) {
     size_t argc = embeddedCliGetTokenCount(args);
@@ -311,12 +477,13 @@ void task_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         PRINTLN(T_FMT(T_BOLD, T_GREEN) "tasks list:" T_FMT(T_RESET, T_GREEN));
         uint16_t max_len = 0;
         uint16_t temp;
-        ulist_foreach(&tasklist, scheduler_task_t, task) {
-            temp = strlen(task->name);
+        ulist_foreach(&tasklist, scheduler_task_t*, ptask) {
+            temp = strlen((*ptask)->name);
             if (temp > max_len)
                 max_len = temp;
         }
-        ulist_foreach(&tasklist, scheduler_task_t, task) {
+        ulist_foreach(&tasklist, scheduler_task_t*, ptask) {
+            scheduler_task_t* task = *ptask;
             PRINTLN("  %-*s | entry:%p pri:%d en:%d freq:%.1f", max_len,
                     task->name, task->task, task->priority, task->enable,
                     (float)get_sys_freq() / task->period);
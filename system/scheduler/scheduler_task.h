@@ -7,6 +7,7 @@ extern "C" {
 #include "scheduler.h"
 
 typedef void (*sch_task_func_t)(void* args);  // 任务函数指针类型
+typedef struct __sch_task* sch_task_handle_t;  // 任务句柄类型
 
 #if SCH_CFG_ENABLE_TASK
 
@@ -92,6 +93,37 @@ extern uint8_t sch_task_delay(const char* name, uint64_t delay_us,
  */
 extern uint16_t sch_task_get_num(void);
 
+/*********************句柄接口**********************/
+// 句柄接口跳过名称查找, 适合高频调用场景
+// 句柄在任务删除前始终有效, 删除后不可再使用
+
+/**
+ * @brief 创建一个调度任务并返回句柄
+ * @param  参数同sch_task_create
+ * @retval sch_task_handle_t 任务句柄, 失败(或任务名重复)返回NULL
+ */
+extern sch_task_handle_t sch_task_create_h(const char* name,
+                                           sch_task_func_t func, float freq_hz,
+                                           uint8_t enable, uint8_t priority,
+                                           void* args);
+
+/**
+ * @brief 按任务名获取任务句柄
+ * @param  name             任务名
+ * @retval sch_task_handle_t 任务句柄, 未找到返回NULL
+ */
+extern sch_task_handle_t sch_task_get_handle(const char* name);
+
+extern uint8_t sch_task_delete_h(sch_task_handle_t task);
+extern uint8_t sch_task_set_enabled_h(sch_task_handle_t task, uint8_t enable);
+extern uint8_t sch_task_get_enabled_h(sch_task_handle_t task);
+extern uint8_t sch_task_set_freq_h(sch_task_handle_t task, float freq_hz);
+extern uint8_t sch_task_set_priority_h(sch_task_handle_t task,
+                                       uint8_t priority);
+extern uint8_t sch_task_set_args_h(sch_task_handle_t task, void* args);
+extern uint8_t sch_task_delay_h(sch_task_handle_t task, uint64_t delay_us,
+                                uint8_t from_now);
+
 #endif  // SCH_CFG_ENABLE_TASK
 
 #ifdef __cplusplus
@@ -0,0 +1,141 @@
+#include "scheduler_trace.h"
+
+#include "scheduler_internal.h"
+
+#if SCH_CFG_TRACE
+
+#if (SCH_CFG_TRACE_SIZE & (SCH_CFG_TRACE_SIZE - 1)) != 0
+#error "SCH_CFG_TRACE_SIZE must be a power of 2"
+#endif
+#define TRACE_MASK (SCH_CFG_TRACE_SIZE - 1)
+#define TRACE_VERSION 1
+
+typedef struct {         // 导出文件头
+    char magic[4];       // "SCHT"
+    uint8_t version;     // 格式版本
+    uint8_t ptr_size;    // 指针大小(字节)
+    uint16_t rec_size;   // 单条记录大小(字节)
+    uint32_t rec_num;    // 记录数
+    uint32_t lost;       // 被覆盖的记录数
+    uint64_t freq;       // 时间戳频率(Hz)
+} sch_trace_header_t;
+
+// 追踪环形缓冲区: 写满后覆盖最旧的记录, 记录位置由原子自增抢占(可在中断中记录)
+static sch_trace_rec_t trace_ring[SCH_CFG_TRACE_SIZE];
+static mod_atomic_size_t trace_head;  // 已写入的记录总数
+static __IO uint8_t trace_enabled = 1;
+
+void sch_trace_record(uint8_t type, const void* obj, uint32_t arg) {
+    if (!trace_enabled)
+        return;
+    mod_atomic_value_t pos =
+        MOD_ATOMIC_FETCH_ADD(trace_head, 1, MOD_ATOMIC_ORDER_RELAXED);
+    sch_trace_rec_t* rec = &trace_ring[pos & TRACE_MASK];
+    rec->tick = get_sys_tick();
+    rec->obj = obj;
+    rec->info = type | (arg << 8);
+}
+
+void sch_trace_set_enabled(uint8_t enable) {
+    if (enable == 0xff)
+        trace_enabled = !trace_enabled;
+    else
+        trace_enabled = enable;
+}
+
+void sch_trace_clear(void) {
+    MOD_ATOMIC_STORE(trace_head, 0, MOD_ATOMIC_ORDER_RELAXED);
+}
+
+void sch_trace_name(sch_trace_write_t write, uint8_t kind, const void* obj,
+                    const char* name) {
+    uint8_t len = strlen(name) > 255 ? 255 : strlen(name);
+    write(&obj, sizeof(obj));
+    write(&kind, 1);
+    write(&len, 1);
+    write(name, len);
+}
+
+uint32_t sch_trace_dump(sch_trace_write_t write) {
+    uint8_t enabled = trace_enabled;
+    trace_enabled = 0;
+    mod_atomic_value_t head =
+        MOD_ATOMIC_LOAD(trace_head, MOD_ATOMIC_ORDER_ACQUIRE);
+    uint32_t num = head > SCH_CFG_TRACE_SIZE ? SCH_CFG_TRACE_SIZE : head;
+    sch_trace_header_t hdr = {
+        .magic = {'S', 'C', 'H', 'T'},
+        .version = TRACE_VERSION,
+        .ptr_size = sizeof(void*),
+        .rec_size = sizeof(sch_trace_rec_t),
+        .rec_num = num,
+        .lost = head - num,
+        .freq = get_sys_freq(),
+    };
+    write(&hdr, sizeof(hdr));
+    for (mod_atomic_value_t i = head - num; i != head; i++) {
+        write(&trace_ring[i & TRACE_MASK], sizeof(sch_trace_rec_t));
+    }
+#if SCH_CFG_ENABLE_TASK
+    sch_task_trace_names(write);
+#endif
+#if SCH_CFG_ENABLE_EVENT
+    sch_event_trace_names(write);
+#endif
+#if SCH_CFG_ENABLE_COROUTINE
+    sch_cortn_trace_names(write);
+#endif
+    sch_trace_name(write, 0, NULL, "");  // 名表结束
+    trace_enabled = enabled;
+    return num;
+}
+
+#if SCH_CFG_ENABLE_TERMINAL
+static uint8_t hex_line[32];
+static uint8_t hex_len = 0;
+
+static void hex_flush(void) {
+    if (!hex_len)
+        return;
+    PRINT("TRACE:");
+    for (uint8_t i = 0; i < hex_len; i++) {
+        PRINT("%02X", hex_line[i]);
+    }
+    PRINTLN("");
+    hex_len = 0;
+}
+
+static void hex_write(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    while (len--) {
+        hex_line[hex_len++] = *p++;
+        if (hex_len == sizeof(hex_line))
+            hex_flush();
+    }
+}
+
+void trace_cmd_func(EmbeddedCli* cli, char* args, void* context) {
+    size_t argc = embeddedCliGetTokenCount(args);
+    if (!argc) {
+        embeddedCliPrintCurrentHelp(cli);
+        return;
+    }
+    if (embeddedCliCheckToken(args, "-s", 1)) {
+        sch_trace_set_enabled(1);
+        PRINTLN(T_FMT(T_BOLD, T_GREEN) "trace started" T_RST);
+    } else if (embeddedCliCheckToken(args, "-p", 1)) {
+        sch_trace_set_enabled(0);
+        PRINTLN(T_FMT(T_BOLD, T_GREEN) "trace paused" T_RST);
+    } else if (embeddedCliCheckToken(args, "-c", 1)) {
+        sch_trace_clear();
+        PRINTLN(T_FMT(T_BOLD, T_GREEN) "trace cleared" T_RST);
+    } else if (embeddedCliCheckToken(args, "-d", 1)) {
+        uint32_t num = sch_trace_dump(hex_write);
+        hex_flush();
+        PRINTLN(T_FMT(T_BOLD, T_GREEN) "Total %d records" T_RST, num);
+    } else {
+        PRINTLN(T_FMT(T_BOLD, T_RED) "unknown option" T_RST);
+    }
+}
+#endif  // SCH_CFG_ENABLE_TERMINAL
+
+#endif  // SCH_CFG_TRACE
@@ -0,0 +1,66 @@
+#ifndef _SCHEDULER_TRACE_H
+#define _SCHEDULER_TRACE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scheduler.h"
+
+#if SCH_CFG_TRACE
+
+typedef enum {                  // 追踪记录类型
+    SCH_TRACE_TASK_BEGIN = 1,   // 任务开始执行(参数: 调度延迟us)
+    SCH_TRACE_TASK_END,         // 任务执行结束
+    SCH_TRACE_EVENT_TRIGGER,    // 事件触发(可能在中断中)
+    SCH_TRACE_EVENT_BEGIN,      // 事件回调开始
+    SCH_TRACE_EVENT_END,        // 事件回调结束
+    SCH_TRACE_CORTN_BEGIN,      // 协程开始运行
+    SCH_TRACE_CORTN_END,        // 协程让出
+    SCH_TRACE_RUNLATER_BEGIN,   // 延时调用开始(对象为函数地址, 参数: 延迟us)
+    SCH_TRACE_RUNLATER_END,     // 延时调用结束
+    SCH_TRACE_SOFTINT_TRIGGER,  // 软中断触发(参数: 主通道<<8|子通道)
+    SCH_TRACE_SOFTINT_BEGIN,    // 软中断处理开始(参数: 主通道<<8|子通道掩码)
+    SCH_TRACE_SOFTINT_END,      // 软中断处理结束
+    SCH_TRACE_IDLE_BEGIN,       // 进入空闲休眠(参数: 请求休眠us)
+    SCH_TRACE_IDLE_END,         // 空闲休眠结束
+} sch_trace_type_t;
+
+typedef struct {      // 追踪记录
+    uint64_t tick;    // 时间戳(系统时钟)
+    const void* obj;  // 对象句柄
+    uint32_t info;    // 低8位为类型, 高24位为附加参数
+} sch_trace_rec_t;
+
+/**
+ * @brief 追踪数据输出函数
+ * @param  data             数据指针
+ * @param  len              数据长度
+ */
+typedef void (*sch_trace_write_t)(const void* data, size_t len);
+
+/**
+ * @brief 设置追踪记录使能
+ * @param  enable           0:暂停 1:开始 0xff:切换
+ */
+extern void sch_trace_set_enabled(uint8_t enable);
+
+/**
+ * @brief 清空追踪缓冲区
+ */
+extern void sch_trace_clear(void);
+
+/**
+ * @brief 导出追踪数据(二进制), 由sch_trace2chrome.py转换为Chrome追踪格式
+ * @param  write            数据输出函数
+ * @retval uint32_t         导出的记录数
+ * @note 格式: 文件头 + 记录(旧->新) + 对象名表(以类型0结束)
+ * @note 导出期间暂停记录
+ */
+extern uint32_t sch_trace_dump(sch_trace_write_t write);
+
+#endif  // SCH_CFG_TRACE
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // _SCHEDULER_TRACE_H
@@ -0,0 +1,429 @@
+/**
+ * @file tlsf.c
+ * @brief 两级分离适配(TLSF)内存分配器, 分配/释放为O(1)且耗时有界
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-14
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "tlsf.h"
+
+#include <string.h>
+
+#ifndef TLSF_CFG_SL_INDEX_LOG2
+#define TLSF_CFG_SL_INDEX_LOG2 4
+#endif
+#ifndef TLSF_CFG_FL_INDEX_MAX
+#define TLSF_CFG_FL_INDEX_MAX 20
+#endif
+
+/*
+ * 块布局: [prev_phys | size | payload ...]
+ * prev_phys仅在上一块空闲时有效, 与上一块负载的最后一个字重叠;
+ * 空闲块的负载前两个字存放空闲链表指针, 因此已用块只有size一个字的开销
+ */
+
+#if UINTPTR_MAX > 0xFFFFFFFF
+#define ALIGN_LOG2 3
+#else
+#define ALIGN_LOG2 2
+#endif
+#define ALIGN_SIZE (1 << ALIGN_LOG2)
+
+#define SL_INDEX_COUNT (1 << TLSF_CFG_SL_INDEX_LOG2)
+#define FL_INDEX_SHIFT (TLSF_CFG_SL_INDEX_LOG2 + ALIGN_LOG2)
+#define FL_INDEX_COUNT (TLSF_CFG_FL_INDEX_MAX - FL_INDEX_SHIFT + 1)
+#define SMALL_BLOCK_SIZE (1 << FL_INDEX_SHIFT)
+
+#if TLSF_CFG_SL_INDEX_LOG2 > 5 || FL_INDEX_COUNT > 32 || FL_INDEX_COUNT < 1
+#error "TLSF_CFG_SL_INDEX_LOG2 / TLSF_CFG_FL_INDEX_MAX out of range"
+#endif
+
+typedef struct tlsf_block {
+    struct tlsf_block* prev_phys;  // 物理上的前一块(仅前一块空闲时有效)
+    size_t size;                   // 负载大小, 低2位为标志
+    struct tlsf_block* next_free;  // 空闲链表后继(仅空闲时有效)
+    struct tlsf_block* prev_free;  // 空闲链表前驱(仅空闲时有效)
+} block_t;
+
+#define BLOCK_FREE_BIT ((size_t)1)       // 本块空闲
+#define BLOCK_PREV_FREE_BIT ((size_t)2)  // 物理上的前一块空闲
+#define BLOCK_OVERHEAD (sizeof(size_t))  // 已用块的开销
+#define BLOCK_START_OFFSET (offsetof(block_t, size) + sizeof(size_t))
+#define BLOCK_SIZE_MIN (sizeof(block_t) - sizeof(block_t*))
+#define BLOCK_SIZE_MAX ((size_t)1 << TLSF_CFG_FL_INDEX_MAX)
+
+static struct {
+    uint32_t fl_bitmap;                               // 一级位图
+    uint32_t sl_bitmap[FL_INDEX_COUNT];               // 二级位图
+    block_t* blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];  // 空闲链表
+    size_t total;                                     // 可用总大小
+    size_t avail;                                     // 剩余大小
+    size_t min_avail;                                 // 剩余大小历史最小值
+    size_t alloc_count;                               // 成功分配次数
+    size_t free_count;                                // 释放次数
+} heap;
+
+#if defined(__GNUC__) || defined(__clang__)
+static inline int tlsf_ffs(uint32_t word) {  // 最低置位, 0返回-1
+    return word ? __builtin_ctz(word) : -1;
+}
+static inline int tlsf_fls(size_t size) {  // 最高置位, 0返回-1
+#if UINTPTR_MAX > 0xFFFFFFFF
+    return size ? 63 - __builtin_clzll(size) : -1;
+#else
+    return size ? 31 - __builtin_clz(size) : -1;
+#endif
+}
+#else
+static inline int tlsf_fls(size_t size) {
+    int bit = -1;
+    while (size) {
+        size >>= 1;
+        bit++;
+    }
+    return bit;
+}
+static inline int tlsf_ffs(uint32_t word) {
+    return tlsf_fls(word & (~word + 1));
+}
+#endif
+
+/******************************* 块操作 *******************************/
+
+static inline size_t block_size(const block_t* block) {
+    return block->size & ~(BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT);
+}
+
+static inline void block_set_size(block_t* block, size_t size) {
+    block->size = size | (block->size & (BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT));
+}
+
+static inline uint8_t block_is_free(const block_t* block) {
+    return (block->size & BLOCK_FREE_BIT) != 0;
+}
+
+static inline uint8_t block_is_prev_free(const block_t* block) {
+    return (block->size & BLOCK_PREV_FREE_BIT) != 0;
+}
+
+static inline void* block_to_ptr(const block_t* block) {
+    return (uint8_t*)block + BLOCK_START_OFFSET;
+}
+
+static inline block_t* block_from_ptr(const void* ptr) {
+    return (block_t*)((uint8_t*)ptr - BLOCK_START_OFFSET);
+}
+
+static inline block_t* block_next(const block_t* block) {
+    return (block_t*)((uint8_t*)block_to_ptr(block) + block_size(block) -
+                      BLOCK_OVERHEAD);
+}
+
+static inline block_t* block_link_next(block_t* block) {
+    block_t* next = block_next(block);
+    next->prev_phys = block;
+    return next;
+}
+
+static inline void block_mark_as_free(block_t* block) {
+    block_t* next = block_link_next(block);
+    next->size |= BLOCK_PREV_FREE_BIT;
+    block->size |= BLOCK_FREE_BIT;
+}
+
+static inline void block_mark_as_used(block_t* block) {
+    block_t* next = block_next(block);
+    next->size &= ~BLOCK_PREV_FREE_BIT;
+    block->size &= ~BLOCK_FREE_BIT;
+}
+
+static inline size_t align_up(size_t x) {
+    return (x + (ALIGN_SIZE - 1)) & ~(size_t)(ALIGN_SIZE - 1);
+}
+
+static inline size_t align_down(size_t x) {
+    return x & ~(size_t)(ALIGN_SIZE - 1);
+}
+
+/**
+ * @brief 将请求大小调整为对齐后的块大小, 超出上限返回0
+ */
+static inline size_t adjust_request_size(size_t size) {
+    if (size == 0 || size >= BLOCK_SIZE_MAX)
+        return 0;
+    size_t aligned = align_up(size);
+    return aligned < BLOCK_SIZE_MIN ? BLOCK_SIZE_MIN : aligned;
+}
+
+/******************************* 索引映射 *******************************/
+
+static inline void mapping_insert(size_t size, int* fli, int* sli) {
+    if (size < SMALL_BLOCK_SIZE) {
+        *fli = 0;
+        *sli = (int)(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+    } else {
+        int fl = tlsf_fls(size);
+        *sli = (int)(size >> (fl - TLSF_CFG_SL_INDEX_LOG2)) ^ SL_INDEX_COUNT;
+        *fli = fl - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+/**
+ * @brief 查找用的映射: 向上取整到下一档, 保证该档内任一块都足够大
+ */
+static inline void mapping_search(size_t size, int* fli, int* sli) {
+    if (size >= SMALL_BLOCK_SIZE)
+        size += ((size_t)1 << (tlsf_fls(size) - TLSF_CFG_SL_INDEX_LOG2)) - 1;
+    mapping_insert(size, fli, sli);
+}
+
+static block_t* search_suitable_block(int* fli, int* sli) {
+    int fl = *fli;
+    uint32_t sl_map = heap.sl_bitmap[fl] & (~0U << *sli);
+    if (!sl_map) {  // 本级没有, 找更高的一级
+        uint32_t fl_map = fl + 1 < 32 ? heap.fl_bitmap & (~0U << (fl + 1)) : 0;
+        if (!fl_map)
+            return NULL;
+        fl = tlsf_ffs(fl_map);
+        *fli = fl;
+        sl_map = heap.sl_bitmap[fl];
+    }
+    *sli = tlsf_ffs(sl_map);
+    return heap.blocks[fl][*sli];
+}
+
+/******************************* 空闲链表 *******************************/
+
+static void remove_free_block(block_t* block, int fl, int sl) {
+    block_t* prev = block->prev_free;
+    block_t* next = block->next_free;
+    if (next)
+        next->prev_free = prev;
+    if (prev) {
+        prev->next_free = next;
+    } else {  // 链表头
+        heap.blocks[fl][sl] = next;
+        if (!next) {
+            heap.sl_bitmap[fl] &= ~(1U << sl);
+            if (!heap.sl_bitmap[fl])
+                heap.fl_bitmap &= ~(1U << fl);
+        }
+    }
+}
+
+static void insert_free_block(block_t* block, int fl, int sl) {
+    block_t* head = heap.blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head)
+        head->prev_free = block;
+    heap.blocks[fl][sl] = block;
+    heap.fl_bitmap |= 1U << fl;
+    heap.sl_bitmap[fl] |= 1U << sl;
+}
+
+static inline void block_remove(block_t* block) {
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(block, fl, sl);
+}
+
+static inline void block_insert(block_t* block) {
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    insert_free_block(block, fl, sl);
+}
+
+/******************************* 分割/合并 *******************************/
+
+static inline uint8_t block_can_split(const block_t* block, size_t size) {
+    return block_size(block) >= sizeof(block_t) + size;
+}
+
+/**
+ * @brief 将块分割为size大小的前半部分和空闲的后半部分
+ */
+static block_t* block_split(block_t* block, size_t size) {
+    block_t* remaining =
+        (block_t*)((uint8_t*)block_to_ptr(block) + size - BLOCK_OVERHEAD);
+    size_t remain_size = block_size(block) - (size + BLOCK_OVERHEAD);
+    remaining->size = remain_size;
+    block_set_size(block, size);
+    block_mark_as_free(remaining);
+    return remaining;
+}
+
+/**
+ * @brief 将next并入物理上相邻的前一块prev
+ */
+static block_t* block_absorb(block_t* prev, block_t* next) {
+    prev->size += block_size(next) + BLOCK_OVERHEAD;
+    block_link_next(prev);
+    return prev;
+}
+
+static block_t* block_merge_prev(block_t* block) {
+    if (block_is_prev_free(block)) {
+        block_t* prev = block->prev_phys;
+        block_remove(prev);
+        block = block_absorb(prev, block);
+    }
+    return block;
+}
+
+static block_t* block_merge_next(block_t* block) {
+    block_t* next = block_next(block);
+    if (block_is_free(next)) {
+        block_remove(next);
+        block = block_absorb(block, next);
+    }
+    return block;
+}
+
+/**
+ * @brief 从空闲块上切下多余部分放回空闲链表
+ */
+static void block_trim_free(block_t* block, size_t size) {
+    if (block_can_split(block, size)) {
+        block_t* remaining = block_split(block, size);
+        block_link_next(block);
+        remaining->size |= BLOCK_PREV_FREE_BIT;
+        block_insert(remaining);
+    }
+}
+
+/**
+ * @brief 从已用块上切下多余部分, 与后一块合并后放回空闲链表
+ */
+static void block_trim_used(block_t* block, size_t size) {
+    if (block_can_split(block, size)) {
+        block_t* remaining = block_split(block, size);
+        remaining->size &= ~BLOCK_PREV_FREE_BIT;
+        remaining = block_merge_next(remaining);
+        block_insert(remaining);
+    }
+}
+
+static inline void update_min_avail(void) {
+    if (heap.avail < heap.min_avail)
+        heap.min_avail = heap.avail;
+}
+
+/******************************* 接口 *******************************/
+
+uint8_t tlsf_heap_init(void* mem, size_t size) {
+    uint8_t* start = (uint8_t*)align_up((size_t)(uintptr_t)mem);
+    if (size < (size_t)(start - (uint8_t*)mem) + 2 * BLOCK_OVERHEAD)
+        return 0;
+    size_t pool_bytes =
+        align_down(size - (start - (uint8_t*)mem) - 2 * BLOCK_OVERHEAD);
+    if (pool_bytes < BLOCK_SIZE_MIN || pool_bytes >= BLOCK_SIZE_MAX)
+        return 0;
+    memset(&heap, 0, sizeof(heap));
+    // 首块头部的prev_phys位于内存区之外, 因首块前一块永不空闲而不会被访问
+    block_t* block = (block_t*)(start - BLOCK_OVERHEAD);
+    block->size = pool_bytes | BLOCK_FREE_BIT;
+    block_insert(block);
+    // 尾部哨兵: 大小为0的已用块, 阻止向后合并越界
+    block_t* sentinel = block_link_next(block);
+    sentinel->size = BLOCK_PREV_FREE_BIT;
+    heap.total = pool_bytes;
+    heap.avail = pool_bytes;
+    heap.min_avail = pool_bytes;
+    return 1;
+}
+
+void* tlsf_malloc(size_t size) {
+    size_t adjust = adjust_request_size(size);
+    if (!adjust)
+        return NULL;
+    int fl, sl;
+    mapping_search(adjust, &fl, &sl);
+    if (fl >= FL_INDEX_COUNT)
+        return NULL;
+    block_t* block = search_suitable_block(&fl, &sl);
+    if (!block)
+        return NULL;
+    remove_free_block(block, fl, sl);
+    block_trim_free(block, adjust);
+    block_mark_as_used(block);
+    heap.avail -= block_size(block) + BLOCK_OVERHEAD;
+    heap.alloc_count++;
+    update_min_avail();
+    return block_to_ptr(block);
+}
+
+void tlsf_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    block_t* block = block_from_ptr(ptr);
+    heap.avail += block_size(block) + BLOCK_OVERHEAD;
+    heap.free_count++;
+    block_mark_as_free(block);
+    block = block_merge_prev(block);
+    block = block_merge_next(block);
+    block_insert(block);
+}
+
+void* tlsf_realloc(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return tlsf_malloc(size);
+    if (size == 0) {
+        tlsf_free(ptr);
+        return NULL;
+    }
+    size_t adjust = adjust_request_size(size);
+    if (!adjust)
+        return NULL;
+    block_t* block = block_from_ptr(ptr);
+    block_t* next = block_next(block);
+    size_t cur_size = block_size(block);
+    size_t combined = cur_size + block_size(next) + BLOCK_OVERHEAD;
+    if (adjust > cur_size && (!block_is_free(next) || adjust > combined)) {
+        void* new_ptr = tlsf_malloc(size);  // 无法原地扩展
+        if (new_ptr) {
+            memcpy(new_ptr, ptr, cur_size < size ? cur_size : size);
+            tlsf_free(ptr);
+        }
+        return new_ptr;
+    }
+    heap.avail += cur_size;
+    if (adjust > cur_size) {  // 并入后一空闲块
+        block_merge_next(block);
+        block_mark_as_used(block);
+    }
+    block_trim_used(block, adjust);
+    heap.avail -= block_size(block);
+    update_min_avail();
+    return ptr;
+}
+
+size_t tlsf_block_size(void* ptr) {
+    return ptr ? block_size(block_from_ptr(ptr)) : 0;
+}
+
+void tlsf_get_stats(tlsf_stats_t* stats) {
+    if (stats == NULL)
+        return;
+    stats->total_size = heap.total;
+    stats->avail_size = heap.avail;
+    stats->minimum_ever_avail = heap.min_avail;
+    stats->alloc_count = heap.alloc_count;
+    stats->free_count = heap.free_count;
+    stats->largest_free = 0;
+    stats->free_blocks = 0;
+    for (int fl = 0; fl < FL_INDEX_COUNT; fl++) {
+        if (!(heap.fl_bitmap & (1U << fl)))
+            continue;
+        for (int sl = 0; sl < SL_INDEX_COUNT; sl++) {
+            for (block_t* b = heap.blocks[fl][sl]; b; b = b->next_free) {
+                stats->free_blocks++;
+                if (block_size(b) > stats->largest_free)
+                    stats->largest_free = block_size(b);
+            }
+        }
+    }
+}
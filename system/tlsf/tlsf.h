@@ -0,0 +1,78 @@
+/**
+ * @file tlsf.h
+ * @brief 两级分离适配(TLSF)内存分配器, 分配/释放为O(1)且耗时有界
+ * @author Ellu (ellu.grif@gmail.com)
+ * @version 1.0
+ * @date 2024-06-14
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __TLSF_H
+#define __TLSF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "modules.h"
+
+typedef struct {                // 堆统计
+    size_t total_size;          // 可用总大小(字节)
+    size_t avail_size;          // 剩余大小(字节)
+    size_t minimum_ever_avail;  // 剩余大小历史最小值(字节)
+    size_t largest_free;        // 最大空闲块(字节)
+    size_t free_blocks;         // 空闲块数量
+    size_t alloc_count;         // 累计成功分配次数
+    size_t free_count;          // 累计释放次数
+} tlsf_stats_t;
+
+/**
+ * @brief 初始化堆
+ * @param  mem              堆内存起始地址
+ * @param  size             堆内存大小(字节)
+ * @retval uint8_t          是否成功, 内存过小或超出TLSF_CFG_FL_INDEX_MAX时失败
+ * @note 只能初始化一次
+ */
+extern uint8_t tlsf_heap_init(void* mem, size_t size);
+
+/**
+ * @brief 分配内存
+ * @param  size             请求大小
+ * @retval void*            内存指针, 失败(或size为0)返回NULL
+ */
+extern void* tlsf_malloc(size_t size);
+
+/**
+ * @brief 释放内存
+ * @param  ptr              内存指针(可为NULL)
+ */
+extern void tlsf_free(void* ptr);
+
+/**
+ * @brief 重新分配内存, 优先原地扩展/收缩
+ * @param  ptr              原内存指针(可为NULL)
+ * @param  size             新大小, 为0时释放并返回NULL
+ * @retval void*            新内存指针, 失败返回NULL(原内存保持不变)
+ */
+extern void* tlsf_realloc(void* ptr, size_t size);
+
+/**
+ * @brief 获取已分配内存块的可用大小
+ * @param  ptr              内存指针
+ * @retval size_t           可用大小(不小于申请大小)
+ */
+extern size_t tlsf_block_size(void* ptr);
+
+/**
+ * @brief 获取堆统计
+ * @param  stats            统计数据输出
+ * @note largest_free和free_blocks需要遍历空闲链表, 耗时与空闲块数量相关
+ */
+extern void tlsf_get_stats(tlsf_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __TLSF_H
@@ -0,0 +1,12 @@
+DALLOC_SRCS := $(ROOT)/system/dalloc/dalloc.c
+
+# 同一测试与基准分别以同步整理(改造前)与增量整理编译
+TESTS += dalloc_stress dalloc_stress_incr
+dalloc_stress_SRCS := dalloc/dalloc_stress.c $(DALLOC_SRCS)
+dalloc_stress_incr_SRCS := $(dalloc_stress_SRCS)
+dalloc_stress_incr_CFLAGS := -DDALLOC_CFG_INCREMENTAL_DEFRAG=1
+
+BENCHES += dalloc_lat_bench dalloc_lat_bench_incr
+dalloc_lat_bench_SRCS := dalloc/dalloc_lat_bench.c $(DALLOC_SRCS)
+dalloc_lat_bench_incr_SRCS := $(dalloc_lat_bench_SRCS)
+dalloc_lat_bench_incr_CFLAGS := -DDALLOC_CFG_INCREMENTAL_DEFRAG=1
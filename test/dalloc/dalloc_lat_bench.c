@@ -0,0 +1,106 @@
+/**
+ * @file dalloc_lat_bench.c
+ * @brief dalloc延迟: 64KiB堆, 24个1~4000字节的槽位, 200k次随机操作的
+ *        dalloc/dfree(及增量整理每步)耗时分位数, 以及最坏情况:
+ *        堆满时释放最底部的块
+ * @note 同步整理(改造前)与增量整理(DALLOC_CFG_INCREMENTAL_DEFRAG)各编译一份;
+ *       增量模式下每次操作后执行一步整理(DALLOC_CFG_DEFRAG_STEP_BYTES)
+ */
+
+#include "dalloc.h"
+
+#define HEAP_SIZE 65536
+#define SLOTS 24
+#define ROUNDS 200000
+#define WORST_ROUNDS 2000
+#define STEPS_MAX (1 << 20)
+
+static uint8_t heap_mem[HEAP_SIZE];
+static dl_heap_t heap;
+static uint8_t* slots[SLOTS];
+static uint32_t lat_alloc[ROUNDS], lat_free[ROUNDS], lat_step[STEPS_MAX];
+static unsigned seed = 12345;
+
+static unsigned rnd(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char* name, uint32_t* lat, int n) {
+    if (n == 0)
+        return;
+    qsort(lat, n, sizeof(lat[0]), cmp_u32);
+    printf("%-7s n %6d: p50 %6u ns, p99.9 %6u ns, max %6u ns\n", name, n,
+           lat[n / 2], lat[(int)(n * 0.999)], lat[n - 1]);
+}
+
+static uint32_t timed_free(int i) {
+    uint64_t t = host_ns();
+    dfree(&heap, (void**)&slots[i], USING_PTR_ADDRESS);
+    return host_ns() - t;
+}
+
+static void defrag(int* nstep) {
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+    if (heap.pending_size == 0 || *nstep == STEPS_MAX)
+        return;
+    uint64_t t = host_ns();
+    dalloc_defrag_step(&heap, DALLOC_CFG_DEFRAG_STEP_BYTES);
+    lat_step[(*nstep)++] = host_ns() - t;
+#endif
+}
+
+static void bench_random(void) {
+    int na = 0, nf = 0, ns = 0;
+    heap_init(&heap, heap_mem, HEAP_SIZE);
+    for (int round = 0; round < ROUNDS; round++) {
+        int i = rnd() % SLOTS;
+        if (slots[i] == NULL) {
+            uint32_t size = 1 + rnd() % 4000;
+            uint64_t t = host_ns();
+            dalloc(&heap, size, (void**)&slots[i]);
+            lat_alloc[na++] = host_ns() - t;
+        } else {
+            lat_free[nf++] = timed_free(i);
+        }
+        defrag(&ns);
+    }
+    report("dalloc", lat_alloc, na);
+    report("dfree", lat_free, nf);
+    report("step", lat_step, ns);
+    for (int i = 0; i < SLOTS; i++)
+        if (slots[i] != NULL)
+            dfree(&heap, (void**)&slots[i], USING_PTR_ADDRESS);
+}
+
+// 堆几乎占满时释放最底部的块, 同步整理需要移动其余全部块
+static void bench_worst(void) {
+    uint32_t size = HEAP_SIZE / SLOTS - 16;
+    int ns = 0;
+    heap_init(&heap, heap_mem, HEAP_SIZE);
+    for (int i = 0; i < SLOTS; i++) dalloc(&heap, size, (void**)&slots[i]);
+    for (int round = 0; round < WORST_ROUNDS; round++) {
+        int bottom = round % SLOTS;  // 释放后重新分配到顶部, 下一个成为最底部
+        lat_free[round] = timed_free(bottom);
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+        while (heap.pending_size && ns < STEPS_MAX) defrag(&ns);
+#endif
+        dalloc(&heap, size, (void**)&slots[bottom]);
+    }
+    report("worst", lat_free, WORST_ROUNDS);
+    report("step", lat_step, ns);
+}
+
+int main(void) {
+    printf("%s defrag, random:\n",
+           DALLOC_CFG_INCREMENTAL_DEFRAG ? "incremental" : "sync");
+    bench_random();
+    printf("free the bottom block of a full heap:\n");
+    bench_worst();
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file dalloc_stress.c
+ * @brief dalloc随机分配/释放/重新分配与碎片整理压力测试, 对比影子内容
+ * @note 64KiB堆, 24个普通槽位(指针变量在静态区)与4个内部槽位
+ *       (指针变量位于另一个dalloc块中, 该块随整理移动);
+ *       每次操作及每步整理后校验所有块的内容与指针
+ */
+
+#include "dalloc.h"
+#include "minctest.h"
+
+#define HEAP_SIZE 65536
+#define SLOTS 24
+#define INNER 4
+#define ROUNDS 200000
+
+typedef struct {  // 指针变量位于堆中的槽位
+    uint8_t* ptr[INNER];
+} table_t;
+
+static uint8_t heap_mem[HEAP_SIZE];
+static dl_heap_t heap;
+static uint8_t* slots[SLOTS];
+static table_t* table;
+static uint8_t* filler;
+static uint32_t sizes[SLOTS + INNER];
+static uint8_t tags[SLOTS + INNER];
+static uint8_t shadow[SLOTS + INNER][4000];
+static unsigned seed = 12345;
+static long bad;
+
+static unsigned rnd(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static uint8_t** var(int i) {
+    return i < SLOTS ? &slots[i] : &table->ptr[i - SLOTS];
+}
+
+static void fill(int i) {
+    uint8_t* p = *var(i);
+    for (uint32_t k = 0; k < sizes[i]; k++) {
+        shadow[i][k] = (uint8_t)(tags[i] + k * 7);
+        p[k] = shadow[i][k];
+    }
+}
+
+static void check_all(void) {
+    for (int i = 0; i < SLOTS + INNER; i++) {
+        uint8_t* p = *var(i);
+        if ((p == NULL) != (sizes[i] == 0)) {
+            bad++;
+            continue;
+        }
+        if (p == NULL)
+            continue;
+        if (p < heap_mem || p + sizes[i] > heap_mem + HEAP_SIZE ||
+            memcmp(p, shadow[i], sizes[i]) != 0)
+            bad++;
+    }
+}
+
+static void test_random(void) {
+    heap_init(&heap, heap_mem, HEAP_SIZE);
+    // 表之前的块释放后, 表(及其中的指针变量)随整理下移
+    dalloc(&heap, 1000, (void**)&filler);
+    dalloc(&heap, sizeof(table_t), (void**)&table);
+    lassert(table != NULL);
+    memset(table, 0, sizeof(table_t));
+    dfree(&heap, (void**)&filler, USING_PTR_ADDRESS);
+    long reallocs = 0;
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+    long steps = 0;
+#endif
+    for (long round = 0; round < ROUNDS && !bad; round++) {
+        int i = rnd() % (SLOTS + INNER);
+        unsigned r = rnd();
+        uint32_t size = 1 + r % ((r >> 20) % 8 ? 400 : 4000);  // 多数为小块
+        if (*var(i) == NULL) {
+            dalloc(&heap, size, (void**)var(i));
+            if (*var(i) == NULL) {
+                bad++;
+                break;
+            }
+            sizes[i] = size;
+            tags[i] = (uint8_t)r;
+            fill(i);
+        } else if (r % 4 == 0) {
+            if (!drealloc(&heap, size, (void**)var(i))) {
+                bad++;
+                break;
+            }
+            uint32_t keep = size < sizes[i] ? size : sizes[i];
+            if (memcmp(*var(i), shadow[i], keep) != 0)
+                bad++;
+            sizes[i] = size;
+            fill(i);
+            reallocs++;
+        } else {
+            dfree(&heap, (void**)var(i), USING_PTR_ADDRESS);
+            if (*var(i) != NULL)
+                bad++;
+            sizes[i] = 0;
+        }
+        check_all();
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+        // 随机推进若干步, 每步后校验
+        for (int s = rnd() % 3; s > 0; s--) {
+            if (!dalloc_defrag_step(&heap, 1 + rnd() % 512))
+                break;
+            steps++;
+            check_all();
+        }
+#endif
+    }
+    lequal((int)bad, 0);
+    lassert(reallocs > 0);
+#if DALLOC_CFG_INCREMENTAL_DEFRAG
+    lassert(steps > 0);
+    while (dalloc_defrag_step(&heap, 64)) check_all();
+#endif
+    // 整理完成后堆紧凑: 已用空间等于存活块(按4字节对齐)之和
+    uint32_t live = (sizeof(table_t) + 3) & ~3u;
+    for (int i = 0; i < SLOTS + INNER; i++) live += (sizes[i] + 3) & ~3u;
+    lequal((int)heap.offset, (int)live);
+    check_all();
+    lequal((int)bad, 0);
+}
+
+int main(void) {
+    lrun("random dalloc/drealloc/dfree with shadow content", test_random);
+    lresults();
+    return _lfails != 0;
+}
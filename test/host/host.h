@@ -0,0 +1,36 @@
+/**
+ * @file host.h
+ * @brief 主机测试平台头文件(MOD_CFG_PLATFORM_HEADER)
+ */
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#define __weak __attribute__((weak))
+#define __IO volatile
+#define __STATIC_INLINE static inline
+#define ENABLE 1
+#define DISABLE 0
+
+// 关中断(CMSIS接口): 单核上关中断即独占CPU, 主机上以全局互斥锁模拟,
+// 用于MOD_CFG_ENABLE_ATOMIC=0时的临界区
+extern uint32_t __get_PRIMASK(void);
+extern void __set_PRIMASK(uint32_t primask);
+extern void __disable_irq(void);
+extern void __enable_irq(void);
+
+extern bool host_fake_time;   // true: m_tick()返回host_now_us
+extern uint64_t host_now_us;  // 模拟时钟(us)
+
+// 单调时钟(ns), 用于基准计时
+static inline uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+#endif  // __HOST_H__
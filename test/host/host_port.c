@@ -0,0 +1,57 @@
+/**
+ * @file host_port.c
+ * @brief 主机测试平台的时基, 延时与关中断模拟
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "modules.h"
+
+bool host_fake_time = false;
+uint64_t host_now_us = 1;
+
+void mod_custom_tick_init(void) {}
+
+m_time_t mod_custom_tick_get(void) {
+    if (host_fake_time)
+        return host_now_us;
+    return host_ns() / 1000;
+}
+
+void mod_custom_delay_us(m_time_t us) {
+    if (host_fake_time)
+        host_now_us += us;
+    else
+        usleep(us);
+}
+
+void mod_custom_delay_ms(m_time_t ms) { mod_custom_delay_us(ms * 1000); }
+
+void mod_custom_delay_s(m_time_t s) { mod_custom_delay_us(s * 1000000); }
+
+static pthread_mutex_t irq_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint32_t primask;  // 本线程是否持有irq_lock
+
+uint32_t __get_PRIMASK(void) { return primask; }
+
+void __disable_irq(void) {
+    if (primask)
+        return;
+    pthread_mutex_lock(&irq_lock);
+    primask = 1;
+}
+
+void __enable_irq(void) {
+    if (!primask)
+        return;
+    primask = 0;
+    pthread_mutex_unlock(&irq_lock);
+}
+
+void __set_PRIMASK(uint32_t value) {
+    if (value)
+        __disable_irq();
+    else
+        __enable_irq();
+}
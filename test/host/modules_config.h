@@ -0,0 +1,116 @@
+/**
+ * @file modules_config.h
+ * @brief 主机(Linux/gcc)测试与基准使用的模块配置, 代替menuconfig生成的文件
+ * @note 各测试通过-D覆盖带#ifndef的选项
+ */
+
+#ifndef __MODULES_CONFIG_H__
+#define __MODULES_CONFIG_H__
+
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_CPU_CM4 1
+#define MOD_CFG_USE_OS_NONE 1
+#define MOD_CFG_PLATFORM_HEADER "host.h"
+
+/* 时基: 微秒, 由host_port.c提供, 可切换为模拟时钟 */
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+
+/* 堆: 默认使用libc, 堆相关测试自行选择后端 */
+#if !MOD_CFG_HEAP_MATHOD_HEAP4 && !MOD_CFG_HEAP_MATHOD_LWMEM && \
+    !MOD_CFG_HEAP_MATHOD_TLSF && !MOD_CFG_HEAP_MATHOD_CUSTOM
+#define MOD_CFG_HEAP_MATHOD_STDLIB 1
+#endif
+#ifndef MOD_CFG_ENABLE_ATOMIC
+#define MOD_CFG_ENABLE_ATOMIC 1
+#endif
+
+/* mslab, 由-DMOD_CFG_HEAP_SLAB=1启用 */
+#define MSLAB_CFG_POOL_SIZE 8192
+#define MSLAB_CFG_PAGE_SIZE 512
+#define MSLAB_CFG_MAX_SIZE 256
+
+/* log */
+#define LOG_CFG_ENABLE 1
+#define LOG_CFG_ENABLE_TIMESTAMP 0
+#define LOG_CFG_ENABLE_COLOR 0
+#define LOG_CFG_ENABLE_MODULE_NAME 1
+#define LOG_CFG_LEVEL_USE_INFO 1
+#define LOG_CFG_R_COLOR T_BLUE
+#define LOG_CFG_D_COLOR T_CYAN
+#define LOG_CFG_I_COLOR T_GREEN
+#define LOG_CFG_P_COLOR T_LGREEN
+#define LOG_CFG_W_COLOR T_YELLOW
+#define LOG_CFG_E_COLOR T_RED
+#define LOG_CFG_F_COLOR T_MAGENTA
+#define LOG_CFG_A_COLOR T_RED
+#define LOG_CFG_T_COLOR T_YELLOW
+#define LOG_CFG_R_STR "TRACE"
+#define LOG_CFG_D_STR "DEBUG"
+#define LOG_CFG_I_STR "INFO"
+#define LOG_CFG_P_STR "PASS"
+#define LOG_CFG_W_STR "WARN"
+#define LOG_CFG_E_STR "ERROR"
+#define LOG_CFG_F_STR "FATAL"
+#define LOG_CFG_A_STR "ASSERT"
+#define LOG_CFG_T_STR "TIMEIT"
+#define LOG_CFG_PRINTF printf
+#define LOG_CFG_TIMESTAMP_FMT "%.3fs"
+#define LOG_CFG_TIMESTAMP_FUNC ((float)((uint64_t)m_time_ms()) / 1000)
+#define LOG_CFG_PREFIX ""
+#define LOG_CFG_SUFFIX ""
+#define LOG_CFG_NEWLINE "\n"
+#define LOG_CFG_INFO_PREFIX "["
+#define LOG_CFG_INFO_SUFFIX "]"
+#define LOG_CFG_INFO_SEPERATOR ""
+#define LOG_CFG_MSG_SEPERATOR " "
+
+/* scheduler */
+#define SCH_CFG_ENABLE_TASK 1
+#define SCH_CFG_COMP_RANGE_US 1000
+#define SCH_CFG_PRI_ORDER_ASC 1
+#define SCH_CFG_ENABLE_EVENT 1
+#ifndef SCH_CFG_EVENT_QUEUE_SIZE
+#define SCH_CFG_EVENT_QUEUE_SIZE 32
+#endif
+#define SCH_CFG_EVENT_INLINE_ARG_SIZE 16
+#define SCH_CFG_ENABLE_COROUTINE 1
+#define SCH_CFG_CORTN_ARENA_SIZE 256
+#define SCH_CFG_ENABLE_CALLLATER 1
+#define SCH_CFG_CALLLATER_MAX_ARG 12
+#define SCH_CFG_CALLLATER_ARG_POOL 16
+#define SCH_CFG_ENABLE_SOFTINT 1
+#ifndef SCH_CFG_TICKLESS
+#define SCH_CFG_TICKLESS 0
+#endif
+#define SCH_CFG_TICKLESS_MAX_SLEEP_US 1000000
+#ifndef SCH_CFG_DEBUG_REPORT
+#define SCH_CFG_DEBUG_REPORT 0
+#endif
+#define SCH_CFG_DEBUG_PERIOD 5
+#define SCH_CFG_DEBUG_MAXLINE 10
+#define SCH_CFG_STATIC_NAME 1
+#define SCH_CFG_STATIC_NAME_LEN 16
+
+/* TinyFrame, 校验类型由-DTF_CKSUM_TYPE_*=1选择, 默认CRC16 */
+#define TF_ID_BYTES 1
+#define TF_LEN_BYTES 2
+#define TF_TYPE_BYTES 1
+#define TF_USE_SOF_BYTE 1
+#define TF_SOF_BYTE 0x01
+#if !TF_CKSUM_TYPE_NONE && !TF_CKSUM_TYPE_XOR && !TF_CKSUM_TYPE_CRC8 && \
+    !TF_CKSUM_TYPE_CRC32
+#define TF_CKSUM_TYPE_CRC16 1
+#endif
+#define TF_TICKS_TYPE uint16_t
+#define TF_COUNT_TYPE uint8_t
+#define TF_MAX_PAYLOAD_RX 1024
+#define TF_SENDBUF_LEN 128
+#define TF_MAX_ID_LST 10
+#define TF_MAX_TYPE_LST 10
+#define TF_MAX_GEN_LST 10
+#define TF_PARSER_TIMEOUT_TICKS 10
+
+#endif  // __MODULES_CONFIG_H__
@@ -0,0 +1,77 @@
+/**
+ * @file kl_tick_bench.c
+ * @brief klite时钟处理基准: 不同睡眠线程数下每次kl_sched_timing的开销
+ * @note 直接包含sched.c, 以桩函数替代移植层; N个线程处于10~1010 tick的
+ *       超时等待, 到期后立即重新等待, 统计1M次时钟处理
+ */
+
+#include "../../system/klite/kernel/sched.c"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UNIT "cyc"
+#define stamp() __rdtsc()
+#else
+#define UNIT "ns"
+#define stamp() host_ns()
+#endif
+
+#define TICKS 1000000
+
+void kl_port_context_switch(void) { kl_sched_tcb_now = kl_sched_tcb_next; }
+
+void kl_port_sys_idle(kl_tick_t time) {}
+
+static uint32_t seed = 1;
+
+static uint32_t xorshift(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static void bench(int n) {
+    struct kl_thread_list wait_list = {NULL, NULL};
+    struct kl_thread* threads = calloc(n + 1, sizeof(*threads));
+    for (int i = 0; i <= n; i++) {
+        threads[i].prio = 1;
+        threads[i].node_sched.tcb = &threads[i];
+        threads[i].node_wait.tcb = &threads[i];
+    }
+    kl_sched_init();
+    kl_sched_tcb_now = &threads[n];  // 最后一个作为当前运行的线程
+    kl_sched_tcb_next = &threads[n];
+    for (int i = 0; i < n; i++)
+        kl_sched_tcb_timed_wait(&threads[i], &wait_list,
+                                10 + xorshift() % 1000);
+    uint64_t total = 0, max = 0;
+    long woken = 0;
+    for (long k = 0; k < TICKS; k++) {
+        uint64_t cost = stamp();
+        kl_sched_timing();
+        cost = stamp() - cost;
+        total += cost;
+        if (cost > max)
+            max = cost;
+        struct kl_thread_node* node;
+        while ((node = m_list_ready[1].head) != NULL) {
+            struct kl_thread* thread = node->tcb;
+            remove_list_sched(thread);
+            woken++;
+            kl_sched_tcb_timed_wait(thread, &wait_list,
+                                    10 + xorshift() % 1000);
+        }
+    }
+    printf("threads %4d: avg %5.0f " UNIT ", max %6llu " UNIT ", woken %ld\n",
+           n, (double)total / TICKS, (unsigned long long)max, woken);
+    free(threads);
+}
+
+int main(void) {
+    bench(8);
+    bench(32);
+    bench(128);
+    bench(512);
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file kl_timer_test.c
+ * @brief klite软件定时器时间轮测试: 随机启动/停止/推进, 与参考模型逐次对比
+ * @note 直接包含timer.c, 以桩函数替代内核; 时钟从接近计数上限处开始,
+ *       运行中多次回绕. 参考模型按剩余时间逐个计算到期时刻, 每次推进后
+ *       将时间轮实际触发的(时刻, 定时器)排序后与模型比较
+ */
+
+#include "../../system/klite/ipc/timer.c"
+#include "minctest.h"
+
+#define TIMERS 300
+#define STEPS 100000
+#define EVENTS_MAX (1 << 20)
+
+kl_thread_t kl_sched_tcb_now;
+static kl_tick_t tick;  // 内核时钟, 可以领先于时间轮
+
+kl_tick_t kl_kernel_tick(void) { return tick; }
+void* kl_heap_alloc(kl_size_t size) { return malloc(size); }
+void kl_heap_free(void* mem) { free(mem); }
+bool kl_mutex_lock(kl_mutex_t mutex, kl_tick_t timeout) { return true; }
+void kl_mutex_unlock(kl_mutex_t mutex) {}
+void kl_cond_signal(kl_cond_t cond) {}
+bool kl_cond_wait_complete(kl_cond_t cond, kl_tick_t timeout) { return true; }
+void kl_thread_delete(kl_thread_t thread) {}
+
+kl_thread_t kl_thread_create(void (*entry)(void*), void* arg,
+                             kl_size_t stack_size, uint32_t prio) {
+    static struct kl_thread dummy;
+    return &dummy;
+}
+
+typedef struct {
+    kl_timer_task_t task;
+    int id;
+    long fired;  // 本次启动以来触发次数
+    long limit;  // 周期定时器触发limit次后在处理函数中停止自身, 0为不限
+    // 参考模型
+    bool active;
+    bool loop;
+    kl_tick_t reload;
+    kl_tick_t expire;
+    long model_fired;
+} ref_t;
+
+typedef struct {
+    kl_tick_t offset;  // 相对本次推进起点的时刻
+    int id;
+} event_t;
+
+static struct kl_timer* timer;
+static ref_t refs[TIMERS];
+static event_t got[EVENTS_MAX], want[EVENTS_MAX];
+static int ngot, nwant;
+static kl_tick_t base;  // 本次推进的起点
+static long errs, overflow;
+static uint32_t seed = 1;
+
+static uint32_t xorshift(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static void handler(void* arg) {
+    ref_t* ref = arg;
+    if (ngot < EVENTS_MAX) {
+        got[ngot].offset = timer->now - base;
+        got[ngot].id = ref->id;
+        ngot++;
+    } else {
+        overflow++;
+    }
+    ref->fired++;
+    if (ref->limit && ref->fired == ref->limit)
+        kl_timer_stop_task(ref->task);
+}
+
+static int event_cmp(const void* a, const void* b) {
+    const event_t* x = a;
+    const event_t* y = b;
+    if (x->offset != y->offset)
+        return x->offset < y->offset ? -1 : 1;
+    return x->id - y->id;
+}
+
+// 模型: 时间轮从timer->now推进到tick, 逐个定时器计算期间的到期时刻
+static void model_advance(kl_tick_t span) {
+    nwant = 0;
+    for (int i = 0; i < TIMERS; i++) {
+        ref_t* ref = &refs[i];
+        while (ref->active && (kl_tick_t)(ref->expire - base) <= span) {
+            if (nwant < EVENTS_MAX) {
+                want[nwant].offset = ref->expire - base;
+                want[nwant].id = i;
+                nwant++;
+            }
+            ref->model_fired++;
+            if (!ref->loop || (ref->limit && ref->model_fired == ref->limit))
+                ref->active = false;
+            else
+                ref->expire += ref->reload;
+        }
+    }
+}
+
+static void advance(kl_tick_t d) {
+    tick += d;
+    base = timer->now;
+    ngot = 0;
+    model_advance(tick - base);
+    kl_timer_process(timer, tick);
+    if (timer->now != tick)
+        errs++;
+    qsort(got, ngot, sizeof(event_t), event_cmp);
+    qsort(want, nwant, sizeof(event_t), event_cmp);
+    if (ngot != nwant || memcmp(got, want, ngot * sizeof(event_t)) != 0)
+        errs++;
+    // 服务线程的睡眠时间不能越过最早的到期时刻
+    kl_tick_t next = wheel_next(timer), earliest = KL_WAIT_FOREVER;
+    for (int i = 0; i < TIMERS; i++) {
+        kl_tick_t left = refs[i].expire - timer->now;
+        if (refs[i].active && left < earliest)
+            earliest = left;
+    }
+    if (earliest == KL_WAIT_FOREVER ? next != KL_WAIT_FOREVER
+                                    : next == 0 || next > earliest)
+        errs++;
+}
+
+static kl_tick_t random_timeout(bool loop) {
+    uint32_t r = xorshift() % 100;
+    if (loop)  // 周期定时器不取太短的周期, 控制每次推进的触发数
+        return 100 + xorshift() % 5000;
+    if (r < 25)
+        return 1 + xorshift() % 64;
+    if (r < 60)
+        return 1 + xorshift() % 4096;
+    if (r < 90)
+        return 1 + xorshift() % (1 << 20);
+    return 1 + xorshift() % (1 << 25);  // 默认配置下超出时间轮范围
+}
+
+static kl_tick_t random_step(void) {
+    uint32_t r = xorshift() % 100;
+    if (r < 50)
+        return 1 + xorshift() % 64;
+    if (r < 90)
+        return 1 + xorshift() % 5000;
+    return 1 + xorshift() % 65536;
+}
+
+static void start(ref_t* ref) {
+    bool loop = xorshift() % 2;
+    kl_tick_t timeout = random_timeout(loop);
+    ref->fired = 0;
+    ref->limit = loop && xorshift() % 2 ? 1 + xorshift() % 20 : 0;
+    kl_timer_start_task(ref->task, timeout, loop);
+    ref->active = true;
+    ref->loop = loop;
+    ref->reload = timeout;
+    ref->expire = tick + timeout;
+    ref->model_fired = 0;
+}
+
+static void stop(ref_t* ref) {
+    kl_timer_stop_task(ref->task);
+    ref->active = false;
+}
+
+static void test_wheel(void) {
+    tick = (kl_tick_t)0 - ((kl_tick_t)1 << 26);  // 约6700万tick后回绕
+    timer = kl_timer_create(0, 0);
+    lassert(timer != NULL);
+    for (int i = 0; i < TIMERS; i++) {
+        refs[i].id = i;
+        refs[i].task = kl_timer_attach_task(timer, handler, &refs[i]);
+    }
+    kl_tick_t start_tick = tick;
+    long wraps = 0, fired = 0, beyond = 0;
+    for (long s = 0; s < STEPS; s++) {
+        ref_t* ref = &refs[xorshift() % TIMERS];
+        uint32_t op = xorshift() % 100;
+        if (op < 40) {
+            start(ref);
+            if (ref->reload >= WHEEL_RANGE)
+                beyond++;
+        } else if (op < 52) {
+            stop(ref);
+        } else if (op < 53) {  // 分离后重新附加
+            kl_timer_detach_task(ref->task);
+            ref->task = kl_timer_attach_task(timer, handler, ref);
+            ref->active = false;
+        } else if (op < 58) {
+            tick += 1 + xorshift() % 50;  // 内核时钟领先, 时间轮尚未处理
+        } else {
+            kl_tick_t before = tick;
+            advance(random_step());
+            wraps += tick < before;
+            fired += ngot;
+        }
+    }
+    for (int i = 0; i < TIMERS; i++) {
+        if (refs[i].loop)
+            stop(&refs[i]);
+    }
+    advance((kl_tick_t)1 << 26);  // 剩余的一次性定时器全部到期
+    fired += ngot;
+    for (int i = 0; i < TIMERS; i++) lassert(!refs[i].active);
+    lassert(wheel_next(timer) == KL_WAIT_FOREVER);
+    printf("\tfired %ld, wraps %ld, beyond range %ld, elapsed %llu ticks\n",
+           fired, wraps, beyond,
+           (unsigned long long)(kl_tick_t)(tick - start_tick));
+    lequal((int)errs, 0);
+    lequal((int)overflow, 0);
+    lassert(wraps > 0);
+    lassert(fired > 0);
+    kl_timer_delete(timer);
+}
+
+int main(void) {
+    lrun("wheel vs model", test_wheel);
+    lresults();
+    return _lfails != 0;
+}
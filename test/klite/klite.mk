@@ -0,0 +1,26 @@
+# kl_blist以__b_list_t访问kl_thread_list(类型双关), 需关闭严格别名优化
+KLITE_CFLAGS := -fno-strict-aliasing -DKLITE_CFG_FREQ=1000 \
+	-DKLITE_CFG_MAX_PRIO=7 -DKLITE_CFG_WAIT_LIST_ORDER_BY_PRIO=0 \
+	-DKLITE_CFG_MLFQ=0 -DKLITE_CFG_ROUND_ROBIN_SLICE=0 \
+	-DKLITE_CFG_64BIT_TICK=0 -DKLITE_CFG_STACKOF_DETECT_ON_TICK_INC=0 \
+	-DKLITE_CFG_STACKOF_DETECT_ON_TASK_SWITCH=0
+
+BENCHES += kl_tick_bench
+kl_tick_bench_SRCS := klite/kl_tick_bench.c
+kl_tick_bench_CFLAGS := $(KLITE_CFLAGS)
+
+# 时间轮与参考模型对比: 默认配置, 64位tick, 16/128槽
+TESTS += kl_timer_test kl_timer_test_tick64 kl_timer_test_bits4 \
+	kl_timer_test_bits7
+kl_timer_test_SRCS := klite/kl_timer_test.c
+kl_timer_test_CFLAGS := $(KLITE_CFLAGS) -DKLITE_CFG_IPC_TIMER=1 \
+	-DKLITE_CFG_IPC_MUTEX=1 -DKLITE_CFG_IPC_COND=1
+kl_timer_test_tick64_SRCS := $(kl_timer_test_SRCS)
+kl_timer_test_tick64_CFLAGS := $(kl_timer_test_CFLAGS) -UKLITE_CFG_64BIT_TICK \
+	-DKLITE_CFG_64BIT_TICK=1
+kl_timer_test_bits4_SRCS := $(kl_timer_test_SRCS)
+kl_timer_test_bits4_CFLAGS := $(kl_timer_test_CFLAGS) \
+	-DKLITE_CFG_TIMER_WHEEL_BITS=4
+kl_timer_test_bits7_SRCS := $(kl_timer_test_SRCS)
+kl_timer_test_bits7_CFLAGS := $(kl_timer_test_CFLAGS) \
+	-DKLITE_CFG_TIMER_WHEEL_BITS=7
@@ -0,0 +1,17 @@
+LFIFO_SRCS := $(ROOT)/datastruct/lfifo/lfifo.c
+
+TESTS += lfifo_mp_stress
+lfifo_mp_stress_SRCS := lfifo/lfifo_mp_stress.c $(LFIFO_SRCS)
+lfifo_mp_stress_CFLAGS := -DLFIFO_CFG_POW2=1 -DLFIFO_CFG_MP=1
+
+# 同一测试分别以原模式与LFIFO_CFG_POW2编译
+TESTS += lfifo_stream lfifo_stream_pow2
+lfifo_stream_SRCS := lfifo/lfifo_stream.c $(LFIFO_SRCS)
+lfifo_stream_pow2_SRCS := $(lfifo_stream_SRCS)
+lfifo_stream_pow2_CFLAGS := -DLFIFO_CFG_POW2=1
+
+BENCHES += lfifo_bench lfifo_bench_pow2
+lfifo_bench_SRCS := lfifo/lfifo_bench.c $(LFIFO_SRCS) \
+	$(ROOT)/datastruct/lwrb/lwrb.c $(ROOT)/datastruct/lfbb/lfbb.c
+lfifo_bench_pow2_SRCS := $(lfifo_bench_SRCS)
+lfifo_bench_pow2_CFLAGS := -DLFIFO_CFG_POW2=1
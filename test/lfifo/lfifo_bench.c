@@ -0,0 +1,102 @@
+/**
+ * @file lfifo_bench.c
+ * @brief 环形缓冲区吞吐量: lfifo与lwrb/lfbb, 单线程, 4KiB缓冲区
+ * @note 每轮写入半个缓冲区后全部读出; 1字节/次使用各自的单字节接口
+ *       (lfifo为WriteByte/ReadByte, lfbb为预留+释放), 64字节/次为块拷贝.
+ *       lfifo的模式(原模式/LFIFO_CFG_POW2)由编译选项决定
+ */
+
+#include <string.h>
+
+#include "lfbb.h"
+#include "lfifo.h"
+#include "lwrb.h"
+
+#define BUF_SIZE 4096
+#define TOTAL (64u * 1024 * 1024)  // 每项传输的字节数
+
+static uint8_t lwrb_mem[BUF_SIZE + 1];  // lwrb保留一个字节区分满/空
+static uint8_t lfbb_mem[BUF_SIZE];
+static uint8_t src[64], dst[64];
+static volatile uint32_t sink;  // 防止读出被优化掉
+
+static double mbps(uint64_t ns) { return TOTAL / (ns * 1e-3); }
+
+static double bench_lfifo(uint32_t chunk) {
+    lfifo_t fifo;
+    LFifo_Init(&fifo, BUF_SIZE);
+    uint32_t per_round = BUF_SIZE / 2 / chunk;
+    uint64_t start = host_ns();
+    for (uint32_t done = 0; done < TOTAL; done += per_round * chunk) {
+        if (chunk == 1) {
+            for (uint32_t i = 0; i < per_round; i++)
+                LFifo_WriteByte(&fifo, (uint8_t)i);
+            for (uint32_t i = 0; i < per_round; i++)
+                sink += LFifo_ReadByte(&fifo);
+        } else {
+            for (uint32_t i = 0; i < per_round; i++)
+                LFifo_Write(&fifo, src, chunk);
+            for (uint32_t i = 0; i < per_round; i++)
+                sink += LFifo_Read(&fifo, dst, chunk);
+        }
+    }
+    uint64_t ns = host_ns() - start;
+    LFifo_Destory(&fifo);
+    return mbps(ns);
+}
+
+static double bench_lwrb(uint32_t chunk) {
+    lwrb_t rb;
+    lwrb_init(&rb, lwrb_mem, sizeof(lwrb_mem));
+    uint32_t per_round = BUF_SIZE / 2 / chunk;
+    uint64_t start = host_ns();
+    for (uint32_t done = 0; done < TOTAL; done += per_round * chunk) {
+        for (uint32_t i = 0; i < per_round; i++) lwrb_write(&rb, src, chunk);
+        for (uint32_t i = 0; i < per_round; i++)
+            sink += lwrb_read(&rb, dst, chunk);
+    }
+    return mbps(host_ns() - start);
+}
+
+static double bench_lfbb(uint32_t chunk) {
+    LFBB_Inst_Type bb;
+    LFBB_Init(&bb, lfbb_mem, sizeof(lfbb_mem));
+    uint32_t per_round = BUF_SIZE / 2 / chunk;
+    uint64_t start = host_ns();
+    for (uint32_t done = 0; done < TOTAL; done += per_round * chunk) {
+        for (uint32_t i = 0; i < per_round; i++) {
+            uint8_t* p = LFBB_WriteAcquire(&bb, chunk);
+            if (p == NULL)
+                continue;
+            memcpy(p, src, chunk);
+            LFBB_WriteRelease(&bb, chunk);
+        }
+        for (uint32_t i = 0; i < per_round; i++) {
+            size_t avail;
+            uint8_t* p = LFBB_ReadAcquire(&bb, &avail);
+            if (p == NULL)
+                continue;
+            if (avail > chunk)
+                avail = chunk;
+            memcpy(dst, p, avail);
+            LFBB_ReadRelease(&bb, avail);
+            sink += avail;
+        }
+    }
+    return mbps(host_ns() - start);
+}
+
+int main(void) {
+    const char* mode = LFIFO_CFG_POW2 ? "pow2" : "legacy";
+    static const uint32_t chunks[] = {1, 64};
+    for (int k = 0; k < 2; k++) {
+        uint32_t chunk = chunks[k];
+        double a = bench_lfifo(chunk);
+        double b = bench_lwrb(chunk);
+        double c = bench_lfbb(chunk);
+        printf("%2u byte/op: lfifo(%s) %6.0f MB/s, lwrb %6.0f MB/s, "
+               "lfbb %6.0f MB/s\n",
+               chunk, mode, a, b, c);
+    }
+    return 0;
+}
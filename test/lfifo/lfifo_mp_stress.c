@@ -0,0 +1,136 @@
+/**
+ * @file lfifo_mp_stress.c
+ * @brief lfifo多生产者/多消费者压力测试(LFIFO_CFG_MP): 4个生产者, 3个消费者
+ * @note 每条记录12字节(生产者/序号/校验), 缓冲区4KiB, 共8M条记录,
+ *       读写指针的24位位置与8位计数均多次回绕, 记录跨越缓冲区末尾;
+ *       检查每条记录恰好被读出一次, 同一消费者读到的同一生产者的记录有序,
+ *       以及结束后读写指针一致
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "lfifo.h"
+#include "minctest.h"
+
+#define PRODUCERS 4
+#define CONSUMERS 3
+#define PER_PRODUCER 2000000
+#define FIFO_SIZE 4096
+
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+    uint32_t check;
+} rec_t;
+
+static lfifo_t fifo;
+static atomic_uchar seen[PRODUCERS][PER_PRODUCER];
+static atomic_long received, dup_err, data_err, order_err;
+static atomic_int producers_done;
+
+static uint32_t rec_check(uint32_t producer, uint32_t seq) {
+    return (producer * 0x9E3779B9u) ^ seq ^ 0xA5A5A5A5u;
+}
+
+// 预留必须全部满足, 偶数号生产者整条拷贝, 奇数号分两段拷贝
+static void* producer(void* arg) {
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    for (uint32_t seq = 0; seq < PER_PRODUCER; seq++) {
+        rec_t r = {id, seq, rec_check(id, seq)};
+        mod_size_t pos;
+        while (LFifo_ReserveWrite(&fifo, sizeof(r), &pos) == 0) sched_yield();
+        if (seq % 16 == id)  // 单核上模拟预留后被抢占, 其他生产者继续提交
+            sched_yield();
+        if (id % 2 == 0) {
+            LFifo_CopyToReserved(&fifo, pos, (uint8_t*)&r, sizeof(r));
+        } else {
+            LFifo_CopyToReserved(&fifo, pos, (uint8_t*)&r, 4);
+            LFifo_CopyToReserved(&fifo, pos + 4, (uint8_t*)&r + 4,
+                                 sizeof(r) - 4);
+        }
+        LFifo_CommitWrite(&fifo);
+    }
+    atomic_fetch_add(&producers_done, 1);
+    return NULL;
+}
+
+static void consume(rec_t* r, uint32_t* last) {
+    if (r->producer >= PRODUCERS || r->seq >= PER_PRODUCER ||
+        r->check != rec_check(r->producer, r->seq)) {
+        atomic_fetch_add(&data_err, 1);
+        return;
+    }
+    if (atomic_fetch_add(&seen[r->producer][r->seq], 1) != 0)
+        atomic_fetch_add(&dup_err, 1);
+    if (last[r->producer] != UINT32_MAX && r->seq <= last[r->producer])
+        atomic_fetch_add(&order_err, 1);
+    last[r->producer] = r->seq;
+    atomic_fetch_add(&received, 1);
+}
+
+// 0号消费者用LFifo_Read, 其余从预留区域拷贝
+static void* consumer(void* arg) {
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    uint32_t last[PRODUCERS], yields = 0;
+    memset(last, 0xFF, sizeof(last));
+    for (;;) {
+        rec_t r;
+        mod_size_t pos, n;
+        if (id == 0) {
+            n = LFifo_Read(&fifo, (uint8_t*)&r, sizeof(r));
+        } else {
+            n = LFifo_ReserveRead(&fifo, sizeof(r), &pos);
+            if (n && ++yields % 16 == 0)  // 模拟预留后被抢占
+                sched_yield();
+            if (n == sizeof(r))
+                LFifo_CopyFromReserved(&fifo, pos, (uint8_t*)&r, n);
+            if (n)
+                LFifo_CommitRead(&fifo);
+        }
+        if (n == sizeof(r)) {
+            consume(&r, last);
+            continue;
+        }
+        if (n != 0) {  // 写指针只在记录边界发布, 不应读到半条记录
+            atomic_fetch_add(&data_err, 1);
+            continue;
+        }
+        if (atomic_load(&producers_done) == PRODUCERS &&
+            LFifo_IsEmpty(&fifo))
+            break;
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void test_mpmc(void) {
+    pthread_t p[PRODUCERS], c[CONSUMERS];
+    lequal(LFifo_Init(&fifo, FIFO_SIZE), 0);
+    lequal((int)LFifo_GetSize(&fifo), FIFO_SIZE);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_create(&c[i], NULL, consumer, (void*)(uintptr_t)i);
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_create(&p[i], NULL, producer, (void*)(uintptr_t)i);
+    for (int i = 0; i < PRODUCERS; i++) pthread_join(p[i], NULL);
+    for (int i = 0; i < CONSUMERS; i++) pthread_join(c[i], NULL);
+    long missing = 0;
+    for (int i = 0; i < PRODUCERS; i++)
+        for (int k = 0; k < PER_PRODUCER; k++) missing += !seen[i][k];
+    lequal((int)atomic_load(&data_err), 0);
+    lequal((int)atomic_load(&dup_err), 0);
+    lequal((int)atomic_load(&order_err), 0);
+    lequal((int)missing, 0);
+    lequal((int)atomic_load(&received), PRODUCERS * PER_PRODUCER);
+    lassert(LFifo_IsEmpty(&fifo));
+    lequal((int)LFifo_GetUsed(&fifo), 0);
+    LFifo_Destory(&fifo);
+}
+
+int main(void) {
+    lrun("4 producers / 3 consumers, 8M records", test_mpmc);
+    lresults();
+    return _lfails != 0;
+}
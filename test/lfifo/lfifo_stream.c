@@ -0,0 +1,171 @@
+/**
+ * @file lfifo_stream.c
+ * @brief lfifo单生产者/单消费者流测试: 两个线程经1KiB缓冲区传输50MB
+ * @note 生产者混合使用WriteByte/Write/AcquireLinearWrite, 消费者混合使用
+ *       ReadByte/Read/AcquireLinearRead/Peek, 流中每个字节由其位置决定;
+ *       LFIFO_CFG_POW2模式下读写指针从2^32之前开始, 传输中途回绕
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "lfifo.h"
+#include "minctest.h"
+
+#define FIFO_SIZE 1024
+#define STREAM_LEN (50u * 1024 * 1024)
+#define BLOCK_MAX 300
+#define STALL_MAX 100000  // 连续无进展的次数, 超过视为状态错误(如满被当作空)
+
+static lfifo_t fifo;
+static atomic_long data_err, size_err, stall_err;
+static atomic_int stop;
+
+static uint8_t stream_byte(uint32_t k) {
+    return (uint8_t)(k ^ (k >> 8) ^ (k >> 16) * 7);
+}
+
+static uint32_t rnd(uint32_t* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+// 无进展时让出CPU, 长时间无进展则记录错误并结束两个线程
+static bool stall_check(uint32_t* stall) {
+    if (++*stall < STALL_MAX) {
+        sched_yield();
+        return true;
+    }
+    atomic_fetch_add(&stall_err, 1);
+    atomic_store(&stop, 1);
+    return false;
+}
+
+static void* producer(void* arg) {
+    uint32_t seed = 1, k = 0, stall = 0;
+    uint8_t block[BLOCK_MAX];
+    while (k < STREAM_LEN && !atomic_load(&stop)) {
+        uint32_t r = rnd(&seed);
+        uint32_t want = 1 + r % BLOCK_MAX;
+        if (want > STREAM_LEN - k)
+            want = STREAM_LEN - k;
+        mod_size_t n = 0;
+        switch (r >> 16 & 3) {
+            case 0:
+                if (LFifo_WriteByte(&fifo, stream_byte(k)) == 0)
+                    n = 1;
+                break;
+            case 1:
+            case 2:
+                for (uint32_t i = 0; i < want; i++)
+                    block[i] = stream_byte(k + i);
+                n = LFifo_Write(&fifo, block, want);
+                break;
+            case 3: {
+                mod_size_t len;
+                uint8_t* p = LFifo_AcquireLinearWrite(&fifo, &len);
+                if (p == NULL || len == 0)
+                    break;
+                if (len > LFifo_GetSize(&fifo))
+                    atomic_fetch_add(&size_err, 1);
+                n = len < want ? len : want;
+                for (uint32_t i = 0; i < n; i++) p[i] = stream_byte(k + i);
+                LFifo_ReleaseLinearWrite(&fifo, n);
+                break;
+            }
+        }
+        if (LFifo_GetUsed(&fifo) > LFifo_GetSize(&fifo))
+            atomic_fetch_add(&size_err, 1);
+        k += n;
+        if (n)
+            stall = 0;
+        else if (!stall_check(&stall))
+            break;
+    }
+    return NULL;
+}
+
+static void check(const uint8_t* data, uint32_t k, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        if (data[i] != stream_byte(k + i)) {
+            atomic_fetch_add(&data_err, 1);
+            return;
+        }
+}
+
+static void* consumer(void* arg) {
+    uint32_t seed = 2, k = 0, stall = 0;
+    uint8_t block[BLOCK_MAX];
+    while (k < STREAM_LEN && !atomic_load(&stop)) {
+        uint32_t r = rnd(&seed);
+        uint32_t want = 1 + r % BLOCK_MAX;
+        mod_size_t n = 0;
+        switch (r >> 16 & 3) {
+            case 0: {
+                int c = LFifo_ReadByte(&fifo);
+                if (c >= 0) {
+                    block[0] = c;
+                    n = 1;
+                    check(block, k, 1);
+                }
+                break;
+            }
+            case 1:
+                n = LFifo_Read(&fifo, block, want);
+                check(block, k, n);
+                break;
+            case 2: {
+                mod_size_t len;
+                uint8_t* p = LFifo_AcquireLinearRead(&fifo, &len);
+                if (p == NULL || len == 0)
+                    break;
+                n = len < want ? len : want;
+                check(p, k, n);
+                LFifo_ReleaseLinearRead(&fifo, n);
+                break;
+            }
+            case 3: {  // 偏移查看后丢弃
+                mod_size_t skip = r % 8;
+                mod_size_t got = LFifo_Peek(&fifo, skip, block, want);
+                if (got)
+                    check(block, k + skip, got);
+                n = LFifo_Read(&fifo, NULL, skip + got);
+                break;
+            }
+        }
+        k += n;
+        if (n)
+            stall = 0;
+        else if (!stall_check(&stall))
+            break;
+    }
+    return NULL;
+}
+
+static void test_stream(void) {
+    pthread_t p, c;
+    lequal(LFifo_Init(&fifo, FIFO_SIZE), 0);
+#if LFIFO_CFG_POW2
+    // 指针自由递增, 从回绕点之前开始
+    fifo.wr = fifo.rd = fifo.rd_cache = fifo.wr_cache = UINT32_MAX - 4096;
+#endif
+    pthread_create(&c, NULL, consumer, NULL);
+    pthread_create(&p, NULL, producer, NULL);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+    lequal((int)atomic_load(&data_err), 0);
+    lequal((int)atomic_load(&size_err), 0);
+    lequal((int)atomic_load(&stall_err), 0);
+    lassert(LFifo_IsEmpty(&fifo));
+#if LFIFO_CFG_POW2
+    lassert(fifo.wr < STREAM_LEN);  // 已回绕
+#endif
+    LFifo_Destory(&fifo);
+}
+
+int main(void) {
+    lrun("two-thread 50MB stream, mixed byte/block/linear/peek", test_stream);
+    lresults();
+    return _lfails != 0;
+}
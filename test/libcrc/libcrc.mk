@@ -0,0 +1,33 @@
+LIBCRC_SRCS := $(ROOT)/algorithm/libcrc/crcLib.c
+LIBCRC_ENGINES := bit nibble table const slice8
+LIBCRC_bit_CFLAGS := -DLIBCRC_CFG_ENGINE_BIT=1
+LIBCRC_nibble_CFLAGS := -DLIBCRC_CFG_ENGINE_NIBBLE=1
+LIBCRC_table_CFLAGS := -DLIBCRC_CFG_ENGINE_TABLE=1
+LIBCRC_const_CFLAGS := -DLIBCRC_CFG_ENGINE_TABLE=1 -DLIBCRC_CFG_CONST_TABLE=1
+LIBCRC_slice8_CFLAGS := -DLIBCRC_CFG_ENGINE_SLICE8=1
+
+# 每种引擎各一个测试与基准
+define LIBCRC_PROG
+TESTS += libcrc_test_$(1)
+libcrc_test_$(1)_SRCS := libcrc/libcrc_test.c $$(LIBCRC_SRCS)
+libcrc_test_$(1)_CFLAGS := $$(LIBCRC_$(1)_CFLAGS)
+BENCHES += libcrc_bench_$(1)
+libcrc_bench_$(1)_SRCS := libcrc/libcrc_bench.c $$(LIBCRC_SRCS)
+libcrc_bench_$(1)_CFLAGS := $$(LIBCRC_$(1)_CFLAGS)
+endef
+$(foreach e,$(LIBCRC_ENGINES),$(eval $(call LIBCRC_PROG,$(e))))
+
+# 使用libcrc的模块, 分别以字节常量表/逐位/slice-by-8引擎及
+# TinyFrame的CRC16/CRC8/CRC32校验编译
+CRC_MODULES_SRCS := libcrc/libcrc_modules_test.c $(LIBCRC_SRCS) \
+	$(ROOT)/communication/TinyFrame/TinyFrame.c \
+	$(ROOT)/communication/lwpkt/lwpkt.c $(ROOT)/datastruct/lwrb/lwrb.c \
+	$(ROOT)/storage/easyflash/src/ef_utils.c
+TESTS += libcrc_modules_test libcrc_modules_test_bit libcrc_modules_test_slice8
+libcrc_modules_test_SRCS := $(CRC_MODULES_SRCS)
+libcrc_modules_test_CFLAGS := $(LIBCRC_const_CFLAGS) -DTF_CKSUM_TYPE_CRC16=1
+libcrc_modules_test_bit_SRCS := $(CRC_MODULES_SRCS)
+libcrc_modules_test_bit_CFLAGS := $(LIBCRC_bit_CFLAGS) -DTF_CKSUM_TYPE_CRC8=1
+libcrc_modules_test_slice8_SRCS := $(CRC_MODULES_SRCS)
+libcrc_modules_test_slice8_CFLAGS := $(LIBCRC_slice8_CFLAGS) \
+	-DTF_CKSUM_TYPE_CRC32=1
@@ -0,0 +1,134 @@
+/**
+ * @file libcrc_modules_test.c
+ * @brief 经libcrc计算校验的模块(modbus/TinyFrame/lwpkt/easyflash)的已知向量测试
+ * @note 期望值取自各协议的标准校验(CRC-16/MODBUS, CRC-16/ARC, CRC-8/MAXIM,
+ *       CRC-32)并经独立的逐位实现核对; 同一测试以不同引擎与TinyFrame
+ *       校验类型编译多份, 输出应完全一致
+ */
+
+#include "macro.h"  // u8/u32, 目标平台由厂商头文件提供
+
+// 直接包含以测试静态的GenCRC16/CheckCRC16
+#include "../../communication/modbus/modbus.c"
+
+// 各模块头文件都定义了自己的LOG_MODULE
+#undef LOG_MODULE
+#include "TinyFrame.h"
+#undef LOG_MODULE
+#include "easyflash.h"
+#undef LOG_MODULE
+#include "lwpkt.h"
+#include "minctest.h"
+
+static const char vector[] = "123456789";
+
+static void test_libcrc_models(void) {
+    // 各模块使用的模型
+    lequal((int)crc_calc(&crc16_modbus_model, vector, 9), 0x4B37);
+    lequal((int)crc_calc(&crc16_ibm_model, vector, 9), 0xBB3D);
+    lequal((int)crc_calc(&crc8_maxim_model, vector, 9), 0xA1);
+    lassert(crc_calc(&crc32_model, vector, 9) == 0xCBF43926u);
+}
+
+static void test_modbus(void) {
+    // 读保持寄存器: 从机1, 起始0, 数量10
+    static const uint8_t expect[] = {0x01, 0x03, 0x00, 0x00,
+                                     0x00, 0x0A, 0xC5, 0xCD};
+    uint8_t frame[16] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+    lequal((int)GenCRC16(frame, 6), 8);
+    lassert(memcmp(frame, expect, sizeof(expect)) == 0);
+    lequal(CheckCRC16(frame, 8, 8), CRC16_FULL_OK);
+    // 帧后跟随两个多余字节时前缀校验通过
+    frame[8] = 0x12;
+    frame[9] = 0x34;
+    lequal(CheckCRC16(frame, 10, 8), CRC16_PREFIX_OK);
+    frame[7] ^= 0x01;
+    lequal(CheckCRC16(frame, 8, 8), 0);
+}
+
+static uint8_t tf_out[64];
+static uint32_t tf_out_len;
+static int tf_received;
+
+void TF_WriteImpl(TinyFrame* tf, const uint8_t* buff, uint32_t len) {
+    memcpy(tf_out + tf_out_len, buff, len);
+    tf_out_len += len;
+}
+
+static TF_Result tf_listener(TinyFrame* tf, TF_Msg* msg) {
+    if (msg->len == 9 && memcmp(msg->data, vector, 9) == 0)
+        tf_received++;
+    return TF_STAY;
+}
+
+static void test_tinyframe(void) {
+    // SOF 01, ID 80(主机), LEN 0009, TYPE 22, 头校验, 数据, 数据校验(大端)
+    static const uint8_t expect[] = {
+        0x01, 0x80, 0x00, 0x09, 0x22,
+#if TF_CKSUM_TYPE == TF_CKSUM_CRC8
+        0x39, '1',  '2',  '3',  '4',  '5', '6', '7', '8', '9', 0xA1,
+#elif TF_CKSUM_TYPE == TF_CKSUM_CRC16
+        0x49, 0x92, '1',  '2',  '3',  '4', '5', '6', '7', '8', '9',
+        0xBB, 0x3D,
+#else
+        0x12, 0xB9, 0x92, 0x3B, '1',  '2', '3', '4', '5', '6', '7',
+        '8',  '9',  0xCB, 0xF4, 0x39, 0x26,
+#endif
+    };
+    TinyFrame tx, rx;
+    lassert(TF_InitStatic(&tx, TF_MASTER));
+    lassert(TF_InitStatic(&rx, TF_SLAVE));
+    lassert(TF_AddGenericListener(&rx, tf_listener));
+    lassert(TF_SendSimple(&tx, 0x22, (const uint8_t*)vector, 9));
+    lequal((int)tf_out_len, (int)sizeof(expect));
+    lassert(memcmp(tf_out, expect, sizeof(expect)) == 0);
+    TF_Accept(&rx, tf_out, tf_out_len);
+    lequal(tf_received, 1);
+    // 数据校验错误的帧被丢弃
+    tf_out[tf_out_len - 1] ^= 0x01;
+    TF_Accept(&rx, tf_out, tf_out_len);
+    lequal(tf_received, 1);
+}
+
+static void test_lwpkt(void) {
+    // START AA, FROM 12, TO 34, CMD 85, LEN 09, 数据, CRC-8/MAXIM, STOP 55
+    static const uint8_t expect[] = {0xAA, 0x12, 0x34, 0x85, 0x09, '1',
+                                     '2',  '3',  '4',  '5',  '6',  '7',
+                                     '8',  '9',  0x83, 0x55};
+    static uint8_t tx_data[64], rx_data[64];
+    uint8_t frame[sizeof(expect)];
+    lwrb_t tx_rb, rx_rb;
+    lwpkt_t tx, rx;
+    lwrb_init(&tx_rb, tx_data, sizeof(tx_data));
+    lwrb_init(&rx_rb, rx_data, sizeof(rx_data));
+    lwpkt_init(&tx, &tx_rb, NULL);
+    lwpkt_init(&rx, NULL, &rx_rb);
+    lwpkt_set_addr(&tx, 0x12);
+    lwpkt_set_addr(&rx, 0x34);
+    lequal(lwpkt_write(&tx, 0x34, 0x85, vector, 9), lwpktOK);
+    lequal((int)lwrb_read(&tx_rb, frame, sizeof(frame)), (int)sizeof(expect));
+    lassert(memcmp(frame, expect, sizeof(expect)) == 0);
+    lwrb_write(&rx_rb, frame, sizeof(frame));
+    lequal(lwpkt_read(&rx), lwpktVALID);
+    lequal((int)lwpkt_get_data_len(&rx), 9);
+    frame[sizeof(frame) - 2] ^= 0x01;
+    lwrb_write(&rx_rb, frame, sizeof(frame));
+    lequal(lwpkt_read(&rx), lwpktERRCRC);
+}
+
+static void test_easyflash(void) {
+    lassert(ef_calc_crc32(0, vector, 9) == 0xCBF43926u);
+    // 分段累计与一次计算相同
+    lassert(ef_calc_crc32(ef_calc_crc32(0, vector, 4), vector + 4, 5) ==
+            0xCBF43926u);
+}
+
+int main(void) {
+    lrun("libcrc models", test_libcrc_models);
+    lrun("modbus", test_modbus);
+    lrun("TinyFrame", test_tinyframe);
+    lrun("lwpkt", test_lwpkt);
+    lrun("easyflash", test_easyflash);
+    lresults();
+    return _lfails != 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file libcrc_test.c
+ * @brief libcrc功能测试: 21个模型的校验值, 与逐位参考实现逐字节对比,
+ *        分段计算与接续计算
+ * @note 每种引擎(LIBCRC_CFG_ENGINE_*)各编译一个测试程序
+ */
+
+#include <string.h>
+
+#include "crcLib.h"
+#include "minctest.h"
+
+#define MODEL(name) {#name, &name##_model}
+
+static const struct {
+    const char* name;
+    const crc_model_t* model;
+} models[] = {
+    MODEL(crc4_itu), MODEL(crc5_epc), MODEL(crc5_itu), MODEL(crc5_usb),
+    MODEL(crc6_itu), MODEL(crc7_mmc), MODEL(crc8), MODEL(crc8_itu),
+    MODEL(crc8_rohc), MODEL(crc8_maxim), MODEL(crc16_ibm), MODEL(crc16_maxim),
+    MODEL(crc16_usb), MODEL(crc16_modbus), MODEL(crc16_ccitt),
+    MODEL(crc16_ccitt_false), MODEL(crc16_x25), MODEL(crc16_xmodem),
+    MODEL(crc16_dnp), MODEL(crc32), MODEL(crc32_mpeg_2),
+};
+#define MODEL_NUM (sizeof(models) / sizeof(models[0]))
+
+static uint8_t buf[1 << 20];
+
+static uint32_t reflect(uint32_t value, uint8_t width) {
+    uint32_t out = 0;
+    for (uint8_t i = 0; i < width; i++) {
+        out = (out << 1) | (value & 1);
+        value >>= 1;
+    }
+    return out;
+}
+
+// 按Rocksoft模型逐位计算, 作为各引擎的参考
+static uint32_t crc_ref(const crc_model_t* m, const uint8_t* data,
+                        uint32_t length) {
+    uint64_t top = 1ull << (m->width - 1), mask = (top << 1) - 1;
+    uint64_t reg = m->init;
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t byte = m->refin ? reflect(data[i], 8) : data[i];
+        for (int bit = 7; bit >= 0; bit--) {
+            bool feedback = !!(reg & top) ^ ((byte >> bit) & 1);
+            reg = (reg << 1) & mask;
+            if (feedback)
+                reg ^= m->poly;
+        }
+    }
+    if (m->refout)
+        reg = reflect(reg, m->width);
+    return (reg ^ m->xorout) & mask;
+}
+
+static void test_check_value(void) {
+    for (size_t k = 0; k < MODEL_NUM; k++) {
+        if (!crc_model_verify(models[k].model))
+            printf("\t%s: check value mismatch\n", models[k].name);
+        lassert(crc_model_verify(models[k].model));
+    }
+}
+
+static void test_reference(void) {
+    long bad = 0;
+    for (size_t k = 0; k < MODEL_NUM; k++) {
+        const crc_model_t* m = models[k].model;
+        // 起始偏移0~4覆盖slice-by-8的非对齐头部
+        for (uint32_t len = 0; len < 600; len += 7) {
+            const uint8_t* p = buf + len % 5;
+            uint32_t crc = crc_calc(m, p, len);
+            if (crc != crc_ref(m, p, len)) {
+                printf("\t%s: len %u mismatch\n", models[k].name, len);
+                bad++;
+                break;
+            }
+            crc_ctx_t ctx;
+            crc_init(&ctx, m);
+            crc_update(&ctx, p, len / 3);
+            crc_update(&ctx, p + len / 3, len - len / 3);
+            if (crc_final(&ctx) != crc)
+                bad++;
+            if (crc_continue(m, crc_calc(m, p, len / 3), p + len / 3,
+                             len - len / 3) != crc)
+                bad++;
+        }
+    }
+    lequal((int)bad, 0);
+}
+
+static void test_wrappers(void) {
+    const uint8_t* p = buf + 3;
+    lequal(crc16_modbus(p, 1000), crc_calc(&crc16_modbus_model, p, 1000));
+    lequal(crc8_maxim(p, 1000), crc_calc(&crc8_maxim_model, p, 1000));
+    lassert(crc32(p, 1000) == crc_calc(&crc32_model, p, 1000));
+    // 超过64KiB的长度
+    crc_ctx_t ctx;
+    crc_init(&ctx, &crc32_model);
+    for (int i = 0; i < 16; i++) crc_update(&ctx, buf + i * 65536, 65536);
+    lassert(crc_final(&ctx) == crc32(buf, sizeof(buf)));
+    lassert(crc32(buf, sizeof(buf)) ==
+            crc_ref(&crc32_model, buf, sizeof(buf)));
+}
+
+int main(void) {
+    unsigned seed = 1;
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = seed >> 16;
+    }
+    lrun("check value", test_check_value);
+    lrun("reference", test_reference);
+    lrun("wrappers", test_wrappers);
+    lresults();
+    return _lfails != 0;
+}
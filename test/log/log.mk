@@ -0,0 +1,11 @@
+# 延迟日志: 以本测试程序自身作为ELF, 经log_decode.py解码后与printf比较
+TESTS += log_roundtrip log_roundtrip_noatomic
+log_roundtrip_SRCS := log/log_roundtrip.c $(ROOT)/debug/log/log_deferred.c
+# 描述符地址需与ELF中一致, 不使用PIE
+log_roundtrip_CFLAGS := -DLOG_CFG_ENABLE_DEFERRED=1 -fno-pie \
+	-DLOG_DECODE_PY='"$(abspath $(ROOT))/debug/log/log_decode.py"'
+log_roundtrip_LDLIBS := -no-pie
+log_roundtrip_noatomic_SRCS := $(log_roundtrip_SRCS)
+log_roundtrip_noatomic_CFLAGS := $(log_roundtrip_CFLAGS) \
+	-DMOD_CFG_ENABLE_ATOMIC=0
+log_roundtrip_noatomic_LDLIBS := $(log_roundtrip_LDLIBS)
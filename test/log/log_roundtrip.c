@@ -0,0 +1,165 @@
+/**
+ * @file log_roundtrip.c
+ * @brief 延迟日志往返测试: 30种格式经log_deferred记录, drain输出二进制流,
+ *        由log_decode.py以本程序的ELF解码, 结果应与snprintf完全一致
+ * @note 另有多线程并发写入与缓冲区满时的丢失计数检查
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "minctest.h"
+
+#define MAX_CASES 40
+
+static char expect[MAX_CASES][128];
+static int ncase;
+static FILE* stream;
+
+// 同一组参数分别交给snprintf与延迟日志
+#define CASE(fmt, args...)                                         \
+    do {                                                           \
+        snprintf(expect[ncase++], sizeof(expect[0]), fmt, ##args); \
+        LOG_INFO(fmt, ##args);                                     \
+    } while (0)
+
+static void write_stream(const void* data, uint32_t len) {
+    fwrite(data, 1, len, stream);
+}
+
+// 解码stream, 逐行读入out, 返回行数
+static int decode(const char* path, char out[][160], int max) {
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "python3 %s %s --elf /proc/%d/exe",
+             LOG_DECODE_PY, path, (int)getpid());
+    FILE* p = popen(cmd, "r");
+    if (p == NULL)
+        return -1;
+    int n = 0;
+    while (n < max && fgets(out[n], sizeof(out[0]), p)) {
+        out[n][strcspn(out[n], "\n")] = '\0';
+        n++;
+    }
+    pclose(p);
+    return n;
+}
+
+// 解码结果为"[INFO] [时间戳] 消息", 比较消息部分
+static const char* message(const char* line) {
+    const char* p = strstr(line, "s] ");
+    return p ? p + 3 : line;
+}
+
+static void test_formats(void) {
+    char path[] = "/tmp/log_roundtripXXXXXX";
+    int fd = mkstemp(path);
+    lassert(fd >= 0);
+    stream = fdopen(fd, "wb");
+    int x = 0;
+    ncase = 0;
+    CASE("int %d %i", -12345, 678);
+    CASE("unsigned %u", -1);
+    CASE("hex %x %X", 0xdeadbeef, 0xabcdef);
+    CASE("octal %o", 511);
+    CASE("char %c%c", 'o', 'k');
+    CASE("width [%5d] [%-5d] [%05d]", 42, 42, -42);
+    CASE("sign [%+d] [% d]", 7, 7);
+    CASE("alt %#x %#o %#x %#o [%#6o]", 255, 8, 0, 0, 9);
+    CASE("long %ld %lu", -1234567890123L, 4000000000UL);
+    CASE("long long %lld %llx", -9000000000000LL, 0x123456789abcULL);
+    CASE("short %hd %hu", (short)-2, (unsigned short)65535);
+    CASE("byte %hhd %hhu", (signed char)-3, (unsigned char)200);
+    CASE("size %zu %zd", (size_t)123456789, (ssize_t)-5);
+    CASE("max %jd", (intmax_t)-77);
+    CASE("float %f", 3.14159);
+    CASE("prec %.2f [%8.3f]", 2.71828, -1.5);
+    CASE("exp %e %E", 12345.678, 0.000123);
+    CASE("exp width [%12.3e]", -6.02e23);
+    CASE("general %g %G", 0.0001234, 1e20);
+    CASE("general %g", 100000.0);
+    CASE("hexfloat %a %A %a %a", 1.5, -0.375, 1.0, 0.1);
+    CASE("string %s", "hello");
+    CASE("string [%.3s] [%8s] [%-8s]", "abcdef", "ab", "cd");
+    CASE("star [%*d] [%-*d]", 6, 12, 4, 3);
+    CASE("star prec %.*f", 3, 1.23456);
+    CASE("pointer %p", (void*)&x);
+    CASE("percent 100%% %d%%", 50);
+    CASE("mixed %s=%d (%.1f%%) %c", "load", 3, 87.5, '!');
+    CASE("many %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8);
+    CASE("no args");
+    lequal(ncase, 30);
+    lequal((int)log_deferred_drain(write_stream, 0), ncase);
+    fclose(stream);
+    static char out[MAX_CASES][160];
+    int n = decode(path, out, MAX_CASES);
+    unlink(path);
+    lequal(n, ncase);
+    for (int i = 0; i < n && i < ncase; i++)
+        lsequal(message(out[i]), expect[i]);
+}
+
+#define THREADS 4
+#define PER_THREAD 20000
+
+static long seen[THREADS];
+static long bad, lost;
+static atomic_int finished;
+
+static void count_stream(const void* data, uint32_t len) {
+    const uint8_t* rec = data;
+    if (rec[2] & 0x02) {  // 丢失计数记录
+        uint32_t n;
+        memcpy(&n, rec + 3, sizeof(n));
+        lost += n;
+        return;
+    }
+    // 负载: 描述符地址/时间戳/线程号/序号/校验
+    int32_t arg[3];
+    if (rec[1] != sizeof(void*) + 4 + sizeof(arg)) {
+        bad++;
+        return;
+    }
+    memcpy(arg, rec + 3 + sizeof(void*) + 4, sizeof(arg));
+    if (arg[0] < 0 || arg[0] >= THREADS || arg[2] != (arg[0] ^ arg[1]))
+        bad++;
+    else
+        seen[arg[0]]++;
+}
+
+static void* writer(void* p) {
+    int id = (int)(intptr_t)p;
+    for (int i = 0; i < PER_THREAD; i++) {
+        LOG_INFO("t%d %d %d", id, i, id ^ i);
+        if (i % 64 == 0)
+            sched_yield();
+    }
+    atomic_fetch_add(&finished, 1);
+    return NULL;
+}
+
+static void test_concurrent(void) {
+    pthread_t t[THREADS];
+    for (int i = 0; i < THREADS; i++)
+        pthread_create(&t[i], NULL, writer, (void*)(intptr_t)i);
+    while (atomic_load(&finished) < THREADS) {
+        log_deferred_drain(count_stream, 0);
+        sched_yield();
+    }
+    for (int i = 0; i < THREADS; i++) pthread_join(t[i], NULL);
+    log_deferred_drain(count_stream, 0);
+    log_deferred_drain(count_stream, 0);  // 缓冲区清空后报告丢失数
+    long total = 0;
+    for (int i = 0; i < THREADS; i++) total += seen[i];
+    lequal((int)bad, 0);
+    lequal((int)(total + lost), THREADS * PER_THREAD);
+    lassert(total > 0);
+}
+
+int main(void) {
+    lrun("30 formats printf == log_decode.py", test_formats);
+    lrun("concurrent writers, records + lost", test_concurrent);
+    lresults();
+    return _lfails != 0;
+}
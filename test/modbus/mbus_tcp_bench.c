@@ -0,0 +1,295 @@
+/**
+ * @file mbus_tcp_bench.c
+ * @brief mbus TCP吞吐量: 客户端线程经本机TCP连接访问服务器线程,
+ *        服务器直接应答或作为网关经管道转发到3个RTU从机(从机线程)
+ * @note 每个读事务的全部寄存器值都经过校验; 无参数时运行默认组合, 每组1s,
+ *       也可指定单个组合:
+ *       mbus_tcp_bench [寄存器数] [在途数] [网关] [下游在途数] [秒]
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "mbus.h"
+
+#define NR 3  // RTU从机个数, 地址1~3
+
+typedef struct {
+    int regs, inflight, gateway, down_inflight;
+} bench_cfg_t;
+
+static bench_cfg_t cfg;
+static atomic_int stop;
+static int cli_fd, srv_fd;        // TCP连接的客户端/服务器端
+static int down_fd[2], up_fd[2];  // RTU总线: 网关->从机, 从机->网关
+static mbus_t C, S, D, R[NR];
+static lfifo_t crx, srx, drx, rrx[NR];
+static mbus_regblock_t s_map, r_map[NR];
+static mbus_gw_slot_t slots[8];
+static uint16_t regs[NR][200];
+static uint16_t dst[64][MBUS_READ_MAX];
+static long done_ok, done_bad, done_ex, done_tmo;
+static unsigned next_req;
+
+static void write_all(int fd, const uint8_t* d, uint32_t len) {
+    while (len) {
+        ssize_t r = write(fd, d, len);
+        if (r > 0) {
+            d += r;
+            len -= r;
+        }
+    }
+}
+
+static void fd_to_fifo(int fd, lfifo_t* fifo, lfifo_t* others, int n) {
+    mod_size_t len;
+    uint8_t* p = LFifo_AcquireLinearWrite(fifo, &len);
+    if (p == NULL)
+        return;
+    ssize_t r = read(fd, p, len);
+    if (r <= 0)
+        return;
+    for (int i = 0; i < n; i++) LFifo_Write(&others[i], p, r);
+    LFifo_ReleaseLinearWrite(fifo, r);
+}
+
+static void client_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(cli_fd, d, len);
+}
+
+static void server_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(srv_fd, d, len);
+}
+
+static void down_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(down_fd[1], d, len);
+}
+
+static void rtu_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(up_fd[1], d, len);
+}
+
+// 寄存器值 = 从机序号 * 1000 + 地址
+static void read_cb(mbus_t* bus, const mbus_xfer_t* xfer, int result) {
+    if (result > 0) {
+        done_ex++;
+        return;
+    }
+    if (result == MBUS_ERR_TIMEOUT) {
+        done_tmo++;
+        return;
+    }
+    uint16_t base = cfg.gateway ? (xfer->unit - 1) * 1000 : 0;
+    for (uint16_t i = 0; result == MBUS_OK && i < xfer->count; i++)
+        if (xfer->data[i] != base + xfer->addr + i)
+            result = MBUS_ERR_FRAME;
+    if (result == MBUS_OK)
+        done_ok++;
+    else
+        done_bad++;
+}
+
+static void submit(void) {
+    while (mbus_pending(&C) < cfg.inflight) {
+        unsigned k = next_req++;
+        uint8_t unit = cfg.gateway ? 1 + k % NR : 1;
+        if (mbus_read_regs(&C, unit, k % 50, cfg.regs, dst[k % 64], read_cb,
+                           NULL) < 0) {
+            done_bad++;
+            return;
+        }
+    }
+}
+
+static void* client_thread(void* arg) {
+    struct pollfd pfd = {cli_fd, POLLIN, 0};
+    submit();
+    while (!atomic_load(&stop)) {
+        if (poll(&pfd, 1, 1) > 0)
+            fd_to_fifo(cli_fd, &crx, NULL, 0);
+        mbus_poll(&C);
+        submit();
+    }
+    return NULL;
+}
+
+static void* server_thread(void* arg) {
+    struct pollfd pfd[2] = {{srv_fd, POLLIN, 0}, {up_fd[0], POLLIN, 0}};
+    while (!atomic_load(&stop)) {
+        if (poll(pfd, cfg.gateway ? 2 : 1, 1) > 0) {
+            if (pfd[0].revents)
+                fd_to_fifo(srv_fd, &srx, NULL, 0);
+            if (cfg.gateway && pfd[1].revents)
+                fd_to_fifo(up_fd[0], &drx, NULL, 0);
+        }
+        mbus_poll(&S);
+        if (cfg.gateway)
+            mbus_poll(&D);
+    }
+    return NULL;
+}
+
+static void* rtu_thread(void* arg) {
+    struct pollfd pfd = {down_fd[0], POLLIN, 0};
+    while (!atomic_load(&stop)) {
+        if (poll(&pfd, 1, 1) > 0)
+            fd_to_fifo(down_fd[0], &rrx[0], &rrx[1], NR - 1);
+        for (int i = 0; i < NR; i++) mbus_poll(&R[i]);
+    }
+    return NULL;
+}
+
+static int tcp_pair(int* c, int* s) {
+    int one = 1;
+    int l = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in sa = {.sin_family = AF_INET};
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t sl = sizeof(sa);
+    if (bind(l, (struct sockaddr*)&sa, sizeof(sa)) != 0 || listen(l, 1) != 0)
+        return -1;
+    getsockname(l, (struct sockaddr*)&sa, &sl);
+    *c = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(*c, (struct sockaddr*)&sa, sizeof(sa)) != 0)
+        return -1;
+    *s = accept(l, NULL, NULL);
+    close(l);
+    setsockopt(*c, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(*s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return *s < 0 ? -1 : 0;
+}
+
+static void setup(void) {
+    mbus_cfg_t c = {0};
+    c.mode = MBUS_TCP;
+    c.role = MBUS_MASTER;
+    c.max_inflight = cfg.inflight;
+    c.timeout = 200;
+    c.rx = &crx;
+    c.send = client_send;
+    LFifo_Init(&crx, 2048);
+    mbus_init(&C, &c);
+    c = (mbus_cfg_t){0};
+    c.mode = MBUS_TCP;
+    c.role = MBUS_SLAVE;
+    c.unit = cfg.gateway ? 0xFF : 1;
+    c.rx = &srx;
+    c.send = server_send;
+    LFifo_Init(&srx, 2048);
+    mbus_init(&S, &c);
+    s_map = (mbus_regblock_t){0, 200, regs[0], MBUS_REG_HOLDING};
+    mbus_set_regmap(&S, &s_map, 1, NULL);
+    if (!cfg.gateway)
+        return;
+    c = (mbus_cfg_t){0};
+    c.mode = MBUS_RTU;
+    c.role = MBUS_MASTER;
+    c.max_inflight = cfg.down_inflight;
+    c.baud = 115200;
+    c.timeout = 50;
+    c.rx = &drx;
+    c.send = down_send;
+    LFifo_Init(&drx, 1024);
+    mbus_init(&D, &c);
+    mbus_set_gateway(&S, &D, slots, 8);
+    for (int i = 0; i < NR; i++) {
+        c = (mbus_cfg_t){0};
+        c.mode = MBUS_RTU;
+        c.role = MBUS_SLAVE;
+        c.unit = i + 1;
+        c.baud = 115200;
+        c.rx = &rrx[i];
+        c.send = rtu_send;
+        LFifo_Init(&rrx[i], 1024);
+        mbus_init(&R[i], &c);
+        r_map[i] = (mbus_regblock_t){0, 200, regs[i], MBUS_REG_HOLDING};
+        mbus_set_regmap(&R[i], &r_map[i], 1, NULL);
+    }
+}
+
+static void teardown(void) {
+    LFifo_Destory(&crx);
+    LFifo_Destory(&srx);
+    if (!cfg.gateway)
+        return;
+    LFifo_Destory(&drx);
+    for (int i = 0; i < NR; i++) LFifo_Destory(&rrx[i]);
+}
+
+static int run(double seconds) {
+    if (tcp_pair(&cli_fd, &srv_fd) != 0 || pipe(down_fd) != 0 ||
+        pipe(up_fd) != 0) {
+        printf("socket/pipe failed\n");
+        return 1;
+    }
+    setup();
+    done_ok = done_bad = done_ex = done_tmo = next_req = 0;
+    atomic_store(&stop, 0);
+    pthread_t tc, ts, tr;
+    pthread_create(&ts, NULL, server_thread, NULL);
+    if (cfg.gateway)
+        pthread_create(&tr, NULL, rtu_thread, NULL);
+    uint64_t start = host_ns();
+    pthread_create(&tc, NULL, client_thread, NULL);
+    usleep(seconds * 1e6);
+    atomic_store(&stop, 1);
+    double dt = (host_ns() - start) * 1e-9;
+    pthread_join(tc, NULL);
+    pthread_join(ts, NULL);
+    if (cfg.gateway)
+        pthread_join(tr, NULL);
+    if (cfg.gateway)
+        printf("tcp gw->rtu regs %3d inflight %d/%d: ", cfg.regs, cfg.inflight,
+               cfg.down_inflight);
+    else
+        printf("tcp direct  regs %3d inflight %d  : ", cfg.regs, cfg.inflight);
+    printf("%8.0f tps (bad %ld, exception %ld, timeout %ld)\n", done_ok / dt,
+           done_bad, done_ex, done_tmo);
+    teardown();
+    close(cli_fd);
+    close(srv_fd);
+    for (int i = 0; i < 2; i++) {
+        close(down_fd[i]);
+        close(up_fd[i]);
+    }
+    return done_bad != 0;
+}
+
+int main(int argc, char** argv) {
+    static const bench_cfg_t defaults[] = {
+        {10, 1, 0, 1},  {10, 8, 0, 1}, {125, 1, 0, 1}, {125, 8, 0, 1},
+        {10, 1, 1, 1},  {10, 8, 1, 1}, {10, 8, 1, 4},  {125, 8, 1, 4},
+    };
+    for (int u = 0; u < NR; u++)
+        for (int i = 0; i < 200; i++) regs[u][i] = u * 1000 + i;
+    if (argc < 2) {
+        int ret = 0;
+        for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+            cfg = defaults[i];
+            ret |= run(1);
+        }
+        return ret;
+    }
+    cfg = (bench_cfg_t){atoi(argv[1]), 1, 0, 1};
+    if (argc > 2)
+        cfg.inflight = atoi(argv[2]);
+    if (argc > 3)
+        cfg.gateway = atoi(argv[3]);
+    if (argc > 4)
+        cfg.down_inflight = atoi(argv[4]);
+    if (cfg.regs < 1 || cfg.regs > MBUS_READ_MAX || cfg.inflight < 1 ||
+        cfg.inflight > MBUS_CFG_QUEUE_LEN || cfg.down_inflight < 1 ||
+        cfg.down_inflight > MBUS_CFG_QUEUE_LEN) {
+        printf("usage: %s <regs> [inflight] [gateway] [down inflight] [s]\n",
+               argv[0]);
+        return 1;
+    }
+    return run(argc > 5 ? atof(argv[5]) : 2);
+}
@@ -0,0 +1,408 @@
+/**
+ * @file mbus_tcp_test.c
+ * @brief mbus TCP回环测试: 客户端与服务器经本机TCP连接互连, 服务器作为网关
+ *        经管道转发到2个RTU从机, 使用模拟时钟
+ * @note 单线程轮询各连接, 每步推进1ms; 测试一端可由测试代码直接读写原始字节,
+ *       用于检查MBAP封装和构造事务标识不符的响应
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "mbus.h"
+#include "minctest.h"
+
+#define GW_UNIT 0xFF  // 网关本机地址
+#define NR 2          // RTU从机个数, 地址5/6
+
+typedef struct {
+    int result, done;
+} job_t;
+
+static int cli_fd, srv_fd;        // TCP连接的客户端/服务器端
+static int down_fd[2], up_fd[2];  // RTU总线: 网关->从机, 从机->网关
+static mbus_t C, S, D, R[NR];
+static lfifo_t crx, srx, drx, rrx[NR];
+static mbus_regblock_t gw_map, r_map[NR];
+static mbus_gw_slot_t slots[2];
+static uint16_t gw_regs[10], r_regs[NR][100];
+static job_t jobs[8];
+static bool raw_client, raw_server;  // 该端由测试直接读写
+static int chunk;                    // 每步每个连接最多读取的字节数, 0不限
+
+static void write_all(int fd, const uint8_t* d, uint32_t len) {
+    while (len) {
+        ssize_t r = write(fd, d, len);
+        if (r > 0) {
+            d += r;
+            len -= r;
+        }
+    }
+}
+
+static bool readable(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) > 0;
+}
+
+// 读取已到达的数据, RTU总线上的数据同时复制给其他从机
+static void fd_to_fifo(int fd, lfifo_t* fifo, lfifo_t* others, int n) {
+    uint8_t buf[512];
+    while (readable(fd)) {
+        mod_size_t len = LFifo_GetFree(fifo);
+        if (len > sizeof(buf))
+            len = sizeof(buf);
+        if (chunk && len > (mod_size_t)chunk)
+            len = chunk;
+        ssize_t r = read(fd, buf, len);
+        if (r <= 0)
+            return;
+        LFifo_Write(fifo, buf, r);
+        for (int i = 0; i < n; i++) LFifo_Write(&others[i], buf, r);
+        if (chunk)
+            return;
+    }
+}
+
+static void client_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(cli_fd, d, len);
+}
+
+static void server_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(srv_fd, d, len);
+}
+
+static void down_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(down_fd[1], d, len);
+}
+
+static void rtu_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(up_fd[1], d, len);
+}
+
+static void step(void) {
+    if (!raw_client)
+        fd_to_fifo(cli_fd, &crx, NULL, 0);
+    if (!raw_server)
+        fd_to_fifo(srv_fd, &srx, NULL, 0);
+    fd_to_fifo(down_fd[0], &rrx[0], &rrx[1], NR - 1);
+    fd_to_fifo(up_fd[0], &drx, NULL, 0);
+    mbus_poll(&C);
+    mbus_poll(&S);
+    mbus_poll(&D);
+    for (int i = 0; i < NR; i++) mbus_poll(&R[i]);
+    host_now_us += 1000;
+}
+
+static void run(int ms) {
+    while (ms--) step();
+}
+
+// 运行直到客户端没有未完成的事务
+static void run_idle(void) {
+    for (int ms = 0; ms < 1000 && mbus_pending(&C); ms++) step();
+    run(5);
+}
+
+static void job_cb(mbus_t* bus, const mbus_xfer_t* xfer, int result) {
+    job_t* j = xfer->arg;
+    j->result = result;
+    j->done = 1;
+}
+
+// 读取测试直接持有的一端已到达的数据
+static int raw_recv(int fd, uint8_t* buf, int max) {
+    int n = 0;
+    while (n < max && readable(fd)) {
+        ssize_t r = read(fd, buf + n, max - n);
+        if (r <= 0)
+            break;
+        n += r;
+    }
+    return n;
+}
+
+static void tcp_pair(int* c, int* s) {
+    int one = 1;
+    int l = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in sa = {.sin_family = AF_INET};
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t sl = sizeof(sa);
+    lassert(bind(l, (struct sockaddr*)&sa, sizeof(sa)) == 0);
+    lassert(listen(l, 1) == 0);
+    getsockname(l, (struct sockaddr*)&sa, &sl);
+    *c = socket(AF_INET, SOCK_STREAM, 0);
+    lassert(connect(*c, (struct sockaddr*)&sa, sizeof(sa)) == 0);
+    *s = accept(l, NULL, NULL);
+    lassert(*s >= 0);
+    close(l);
+    setsockopt(*c, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(*s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+static void setup(bool gateway) {
+    uint8_t junk[512];
+    raw_recv(cli_fd, junk, sizeof(junk));
+    raw_recv(srv_fd, junk, sizeof(junk));
+    raw_recv(down_fd[0], junk, sizeof(junk));
+    raw_recv(up_fd[0], junk, sizeof(junk));
+    raw_client = raw_server = false;
+    memset(jobs, 0, sizeof(jobs));
+    for (int i = 0; i < 10; i++) gw_regs[i] = 0xA00 + i;
+    mbus_cfg_t cfg = {0};
+    cfg.mode = MBUS_TCP;
+    cfg.role = MBUS_MASTER;
+    cfg.max_inflight = 8;
+    cfg.timeout = 300;
+    cfg.rx = &crx;
+    cfg.send = client_send;
+    LFifo_Clear(&crx);
+    mbus_init(&C, &cfg);
+    cfg = (mbus_cfg_t){0};
+    cfg.mode = MBUS_TCP;
+    cfg.role = MBUS_SLAVE;
+    cfg.unit = GW_UNIT;
+    cfg.rx = &srx;
+    cfg.send = server_send;
+    LFifo_Clear(&srx);
+    mbus_init(&S, &cfg);
+    gw_map = (mbus_regblock_t){0, 10, gw_regs, MBUS_REG_HOLDING};
+    mbus_set_regmap(&S, &gw_map, 1, NULL);
+    cfg = (mbus_cfg_t){0};
+    cfg.mode = MBUS_RTU;
+    cfg.role = MBUS_MASTER;
+    cfg.baud = 115200;
+    cfg.timeout = 50;  // 小于客户端的超时
+    cfg.rx = &drx;
+    cfg.send = down_send;
+    LFifo_Clear(&drx);
+    mbus_init(&D, &cfg);
+    if (gateway)
+        mbus_set_gateway(&S, &D, slots, 2);
+    for (int i = 0; i < NR; i++) {
+        for (int k = 0; k < 100; k++) r_regs[i][k] = 0x100 * (i + 1) + k;
+        cfg = (mbus_cfg_t){0};
+        cfg.mode = MBUS_RTU;
+        cfg.role = MBUS_SLAVE;
+        cfg.unit = 5 + i;
+        cfg.baud = 115200;
+        cfg.rx = &rrx[i];
+        cfg.send = rtu_send;
+        LFifo_Clear(&rrx[i]);
+        mbus_init(&R[i], &cfg);
+        r_map[i] = (mbus_regblock_t){0, 100, r_regs[i], MBUS_REG_HOLDING};
+        mbus_set_regmap(&R[i], &r_map[i], 1, NULL);
+    }
+}
+
+// 检查客户端一端收到的原始应答
+static void expect_reply(const uint8_t* rsp, int len) {
+    uint8_t buf[300];
+    int n = raw_recv(cli_fd, buf, sizeof(buf));
+    lequal(n, len);
+    lassert(n == len && memcmp(buf, rsp, len) == 0);
+}
+
+static void test_mbap_framing(void) {
+    setup(false);
+    raw_client = true;
+    // 读保持寄存器2~4, 事务标识0x002A原样返回, 长度 = 地址 + PDU
+    static const uint8_t req[] = {0x00, 0x2A, 0x00, 0x00, 0x00, 0x06,
+                                  0xFF, 0x03, 0x00, 0x02, 0x00, 0x03};
+    static const uint8_t rsp[] = {0x00, 0x2A, 0x00, 0x00, 0x00, 0x09,
+                                  0xFF, 0x03, 0x06, 0x0A, 0x02, 0x0A,
+                                  0x03, 0x0A, 0x04};
+    write_all(cli_fd, req, sizeof(req));
+    run(2);
+    expect_reply(rsp, sizeof(rsp));
+    // 逐字节送达
+    for (size_t i = 0; i < sizeof(req); i++) {
+        write_all(cli_fd, req + i, 1);
+        step();
+    }
+    run(2);
+    expect_reply(rsp, sizeof(rsp));
+    // 一次写入两帧: 写单个寄存器后读回; TCP没有广播, 地址0同样应答
+    static const uint8_t req2[] = {
+        0x12, 0x34, 0x00, 0x00, 0x00, 0x06, 0x00, 0x06, 0x00, 0x01, 0xBE, 0xEF,
+        0x12, 0x35, 0x00, 0x00, 0x00, 0x06, 0x00, 0x03, 0x00, 0x01, 0x00, 0x01};
+    static const uint8_t rsp2[] = {
+        0x12, 0x34, 0x00, 0x00, 0x00, 0x06, 0x00, 0x06, 0x00, 0x01,
+        0xBE, 0xEF, 0x12, 0x35, 0x00, 0x00, 0x00, 0x05, 0x00, 0x03,
+        0x02, 0xBE, 0xEF};
+    write_all(cli_fd, req2, sizeof(req2));
+    run(2);
+    expect_reply(rsp2, sizeof(rsp2));
+    lequal(gw_regs[1], 0xBEEF);
+    // 协议标识非0的帧被逐字节丢弃, 其后的帧仍能正确分帧; 异常应答
+    static const uint8_t req3[] = {
+        0x00, 0x07, 0x00, 0x01, 0x00, 0x06, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x08, 0x00, 0x00, 0x00, 0x06, 0xFF, 0x03, 0x00, 0x20, 0x00, 0x01};
+    static const uint8_t rsp3[] = {0x00, 0x08, 0x00, 0x00, 0x00,
+                                   0x03, 0xFF, 0x83, 0x02};
+    write_all(cli_fd, req3, sizeof(req3));
+    run(2);
+    expect_reply(rsp3, sizeof(rsp3));
+    lassert(S.stat.rx_errors > 0);
+    lequal((int)S.stat.rx_frames, 5);
+    lequal((int)LFifo_GetUsed(&srx), 0);
+}
+
+static void test_tid_mismatch(void) {
+    uint8_t buf[64];
+    uint16_t d[2] = {0};
+    setup(false);
+    raw_server = true;
+    int tid = mbus_read_regs(&C, 1, 0, 2, d, job_cb, &jobs[0]);
+    lassert(tid >= 0);
+    run(1);
+    uint8_t req[] = {tid >> 8, tid & 0xFF, 0x00, 0x00, 0x00, 0x06,
+                     0x01,     0x03,       0x00, 0x00, 0x00, 0x02};
+    lequal(raw_recv(srv_fd, buf, sizeof(buf)), (int)sizeof(req));
+    lassert(memcmp(buf, req, sizeof(req)) == 0);
+    // 事务标识不符的响应被忽略
+    uint8_t rsp[] = {(tid + 1) >> 8, (tid + 1) & 0xFF, 0x00, 0x00, 0x00, 0x07,
+                     0x01,           0x03,             0x04, 0x12, 0x34, 0x56,
+                     0x78};
+    write_all(srv_fd, rsp, sizeof(rsp));
+    run(2);
+    lequal(jobs[0].done, 0);
+    lequal((int)C.stat.rx_frames, 1);
+    lequal((int)mbus_pending(&C), 1);
+    rsp[0] = tid >> 8;
+    rsp[1] = tid & 0xFF;
+    write_all(srv_fd, rsp, sizeof(rsp));
+    run(2);
+    lequal(jobs[0].done, 1);
+    lequal(jobs[0].result, MBUS_OK);
+    lequal(d[0], 0x1234);
+    lequal(d[1], 0x5678);
+    // 两个在途事务乱序应答, 按事务标识分别写回
+    uint16_t a = 0, b = 0;
+    int ta = mbus_read_regs(&C, 1, 0, 1, &a, job_cb, &jobs[1]);
+    int tb = mbus_read_regs(&C, 1, 1, 1, &b, job_cb, &jobs[2]);
+    run(1);
+    lequal(raw_recv(srv_fd, buf, sizeof(buf)), 24);
+    uint8_t r1[] = {tb >> 8, tb & 0xFF, 0, 0, 0, 5, 1, 3, 2, 0xBB, 0xBB,
+                    ta >> 8, ta & 0xFF, 0, 0, 0, 5, 1, 3, 2, 0xAA, 0xAA};
+    write_all(srv_fd, r1, sizeof(r1));
+    run(2);
+    lequal(jobs[1].result, MBUS_OK);
+    lequal(jobs[2].result, MBUS_OK);
+    lequal(a, 0xAAAA);
+    lequal(b, 0xBBBB);
+    // 只收到事务标识不符的响应, 事务超时
+    int tc = mbus_read_regs(&C, 1, 0, 1, &a, job_cb, &jobs[3]);
+    run(1);
+    raw_recv(srv_fd, buf, sizeof(buf));
+    uint8_t r2[] = {(tc + 7) >> 8, (tc + 7) & 0xFF, 0, 0, 0, 5, 1, 3, 2, 0, 0};
+    write_all(srv_fd, r2, sizeof(r2));
+    run_idle();
+    lequal(jobs[3].result, MBUS_ERR_TIMEOUT);
+    lequal((int)C.stat.timeouts, 1);
+    lequal(a, 0xAAAA);
+}
+
+static void gateway_cases(void) {
+    uint16_t d[10] = {0};
+    setup(true);
+    // 网关本机地址
+    mbus_read_regs(&C, GW_UNIT, 2, 3, d, job_cb, &jobs[0]);
+    run_idle();
+    lequal(jobs[0].result, MBUS_OK);
+    lequal(d[0], 0xA02);
+    lequal(d[2], 0xA04);
+    lequal((int)D.stat.tx_frames, 0);
+    // 转发到RTU从机
+    mbus_read_regs(&C, 5, 90, 10, d, job_cb, &jobs[0]);
+    run_idle();
+    lequal(jobs[0].result, MBUS_OK);
+    lequal(d[0], 0x15A);
+    lequal(d[9], 0x163);
+    uint16_t w[3] = {1, 2, 3};
+    mbus_write_regs(&C, 6, 10, 3, w, job_cb, &jobs[0]);
+    mbus_read_regs(&C, 6, 9, 5, d, job_cb, &jobs[1]);
+    run_idle();
+    lequal(jobs[0].result, MBUS_OK);
+    lequal(jobs[1].result, MBUS_OK);
+    lequal(r_regs[1][11], 2);
+    lequal(d[0], 0x209);
+    lequal(d[3], 3);
+    lequal(d[4], 0x20D);
+    // 下游异常原样返回, 下游未应答返回0x0B
+    mbus_read_regs(&C, 5, 99, 5, d, job_cb, &jobs[0]);
+    mbus_read_regs(&C, 9, 0, 1, d, job_cb, &jobs[1]);
+    run_idle();
+    lequal(jobs[0].result, MBUS_EX_ILLEGAL_ADDRESS);
+    lequal(jobs[1].result, MBUS_EX_GATEWAY_TARGET);
+    lequal((int)D.stat.timeouts, 1);
+    // 2个转发槽, 同时到达4个请求: 2个成功, 2个返回0x0A;
+    // 分段送达时后面的请求到达前可能已有转发完成
+    memset(jobs, 0, sizeof(jobs));
+    for (int i = 0; i < 4; i++)
+        mbus_read_regs(&C, 5, i, 1, d + i, job_cb, &jobs[i]);
+    run_idle();
+    int ok = 0, path = 0;
+    for (int i = 0; i < 4; i++) {
+        ok += jobs[i].result == MBUS_OK;
+        path += jobs[i].result == MBUS_EX_GATEWAY_PATH;
+    }
+    lequal(ok + path, 4);
+    lassert(path > 0);
+    if (chunk == 0)
+        lequal(path, 2);
+    // 透传: 无法推算长度的功能码, 下游以帧间隔分帧
+    uint8_t pdu[MBUS_PDU_MAX] = {0x41, 0x00, 0x00, 0x00, 0x01};
+    mbus_request(&C, 5, pdu, 5, job_cb, &jobs[0]);
+    run_idle();
+    lequal(jobs[0].result, MBUS_EX_ILLEGAL_FUNCTION);
+    lequal(pdu[0], 0xC1);
+    lequal(pdu[1], MBUS_EX_ILLEGAL_FUNCTION);
+    uint8_t pdu2[MBUS_PDU_MAX] = {0x03, 0x00, 0x05, 0x00, 0x02};
+    mbus_request(&C, 6, pdu2, 5, job_cb, &jobs[0]);
+    run_idle();
+    lequal(jobs[0].result, MBUS_OK);
+    static const uint8_t expect[] = {0x03, 0x04, 0x02, 0x05, 0x02, 0x06};
+    lassert(memcmp(pdu2, expect, sizeof(expect)) == 0);
+    // 地址0经网关在RTU总线上广播: 从机执行, 不应答, 客户端超时
+    mbus_write_reg(&C, 0, 20, 77, job_cb, &jobs[0]);
+    run_idle();
+    lequal(jobs[0].result, MBUS_ERR_TIMEOUT);
+    lequal(r_regs[0][20], 77);
+    lequal(r_regs[1][20], 77);
+    lequal((int)C.stat.rx_errors, 0);
+    lequal((int)S.stat.rx_errors, 0);
+    lequal((int)D.stat.rx_errors, 0);
+}
+
+static void test_gateway(void) {
+    chunk = 0;
+    gateway_cases();
+}
+
+static void test_gateway_chunked(void) {
+    chunk = 3;
+    gateway_cases();
+    chunk = 0;
+}
+
+int main(void) {
+    host_fake_time = true;
+    tcp_pair(&cli_fd, &srv_fd);
+    lassert(pipe(down_fd) == 0 && pipe(up_fd) == 0);
+    LFifo_Init(&crx, 512);
+    LFifo_Init(&srx, 512);
+    LFifo_Init(&drx, 512);
+    for (int i = 0; i < NR; i++) LFifo_Init(&rrx[i], 512);
+    lrun("mbap framing", test_mbap_framing);
+    lrun("transaction id mismatch", test_tid_mismatch);
+    lrun("gateway tcp<->rtu", test_gateway);
+    lrun("gateway tcp<->rtu, 3-byte reads", test_gateway_chunked);
+    lresults();
+    return _lfails != 0;
+}
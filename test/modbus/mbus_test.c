@@ -0,0 +1,450 @@
+/**
+ * @file mbus_test.c
+ * @brief mbus主从回环测试: 1个主机与3个从机经内存"总线"互连, 使用模拟时钟
+ * @note 随机读写与影子模型对比(RTU/ASCII, 在途1/4, 整帧/分段送达),
+ *       干扰与错帧, CRC/LRC错误, 跨越FIFO边界的帧与超长字节数字段,
+ *       超时/异常/广播/队列满
+ */
+
+#include <string.h>
+
+#include "mbus.h"
+#include "minctest.h"
+
+#define NS 3       // 从机个数
+#define NJOBS 8    // 每轮最多提交的事务数
+#define WIRE 4096  // 总线上尚未送达的数据
+
+typedef struct {
+    int op, unit, addr, count;
+    uint16_t buf[130];
+    int result, done;
+} job_t;
+
+static mbus_t M, S[NS];
+static lfifo_t mrx, srx[NS];
+static mbus_regblock_t map[NS][3];
+static uint16_t hold[NS][200], inp[NS][50], model[NS][200];
+static job_t jobs[NJOBS];
+
+// 主机->从机与从机->主机两个方向的总线数据, 由pump按块送达
+static uint8_t mwire[WIRE], swire[WIRE];
+static int mwire_n, swire_n;
+static int chunk;      // 0: 整块送达, >0: 每次随机送达1~chunk字节
+static int noise;      // 在帧之间插入干扰, 或翻转帧中的一位
+static int drop_next;  // 丢弃从机接下来的若干个应答
+static int corrupted;  // 被翻转的帧数
+
+static uint32_t rnd_state = 1;
+
+static uint32_t rnd(void) {
+    rnd_state = rnd_state * 1103515245u + 12345u;
+    return rnd_state >> 8;
+}
+
+// 返回true表示该帧已被破坏(已写入总线)
+static bool wire_noise(uint8_t* wire, int* n, const uint8_t* d, uint32_t len) {
+    if (!noise)
+        return false;
+    uint32_t r = rnd() % 16;
+    if (r < 4) {  // 帧之间的干扰字节
+        for (uint32_t k = 1 + rnd() % 6; k; k--) wire[(*n)++] = rnd();
+    } else if (r == 15) {  // 翻转帧中的一位
+        uint32_t pos = rnd() % len;
+        memcpy(wire + *n, d, len);
+        wire[*n + pos] ^= 1 << (rnd() % 8);
+        *n += len;
+        corrupted++;
+        return true;
+    }
+    return false;
+}
+
+static void master_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    if (wire_noise(mwire, &mwire_n, d, len))
+        return;
+    memcpy(mwire + mwire_n, d, len);
+    mwire_n += len;
+}
+
+static void slave_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    if (drop_next) {
+        drop_next--;
+        return;
+    }
+    if (wire_noise(swire, &swire_n, d, len))
+        return;
+    memcpy(swire + swire_n, d, len);
+    swire_n += len;
+}
+
+// 从总线数据头部取出一块, 返回块长度
+static int wire_take(uint8_t* wire, int* n, uint8_t* out) {
+    int len = chunk ? 1 + (int)(rnd() % chunk) : *n;
+    if (len > *n)
+        len = *n;
+    memcpy(out, wire, len);
+    memmove(wire, wire + len, *n - len);
+    *n -= len;
+    return len;
+}
+
+// 送达总线上的全部数据并推进模拟时钟, 直到主机没有未完成的事务
+static void pump(void) {
+    uint8_t buf[WIRE];
+    for (int iter = 0; iter < 100; iter++) {
+        while (mwire_n) {
+            int len = wire_take(mwire, &mwire_n, buf);
+            for (int i = 0; i < NS; i++) {
+                lequal((int)LFifo_Write(&srx[i], buf, len), len);
+                mbus_poll(&S[i]);
+            }
+        }
+        while (swire_n) {
+            int len = wire_take(swire, &swire_n, buf);
+            lequal((int)LFifo_Write(&mrx, buf, len), len);
+            mbus_poll(&M);
+        }
+        for (int i = 0; i < NS; i++) mbus_poll(&S[i]);
+        mbus_poll(&M);
+        if (mwire_n || swire_n)
+            continue;
+        // 刚好超过帧间隔, 丢弃残帧, 检查超时
+        host_now_us += M.mode == MBUS_ASCII ? 1100000 : 3000;
+        for (int i = 0; i < NS; i++) mbus_poll(&S[i]);
+        mbus_poll(&M);
+        if (!mwire_n && !swire_n && !mbus_pending(&M))
+            return;
+    }
+}
+
+static void job_cb(mbus_t* bus, const mbus_xfer_t* xfer, int result) {
+    job_t* j = xfer->arg;
+    j->result = result;
+    j->done = 1;
+}
+
+static void setup(mbus_mode_t mode, uint8_t inflight, mod_size_t fifo_size) {
+    mwire_n = swire_n = drop_next = 0;
+    mbus_cfg_t cfg = {0};
+    cfg.mode = mode;
+    cfg.role = MBUS_MASTER;
+    cfg.max_inflight = inflight;
+    cfg.baud = 115200;
+    cfg.rx = &mrx;
+    cfg.send = master_send;
+    LFifo_Destory(&mrx);
+    LFifo_Init(&mrx, fifo_size);
+    mbus_init(&M, &cfg);
+    for (int i = 0; i < NS; i++) {
+        cfg.role = MBUS_SLAVE;
+        cfg.unit = i + 1;
+        cfg.rx = &srx[i];
+        cfg.send = slave_send;
+        LFifo_Destory(&srx[i]);
+        LFifo_Init(&srx[i], fifo_size);
+        mbus_init(&S[i], &cfg);
+        for (int k = 0; k < 200; k++) model[i][k] = rnd();
+        for (int k = 0; k < 100; k++) hold[i][k] = model[i][k];
+        // 100~199为大端块, 数组中按线上字节序保存
+        for (int k = 100; k < 200; k++)
+            hold[i][k] = __builtin_bswap16(model[i][k]);
+        for (int k = 0; k < 50; k++) inp[i][k] = 1000 * i + k;
+        map[i][0] = (mbus_regblock_t){0, 100, hold[i], MBUS_REG_HOLDING};
+        map[i][1] = (mbus_regblock_t){100, 100, hold[i] + 100,
+                                      MBUS_REG_HOLDING | MBUS_REG_BE};
+        map[i][2] = (mbus_regblock_t){0, 50, inp[i], MBUS_REG_INPUT};
+        mbus_set_regmap(&S[i], map[i], 3, NULL);
+    }
+}
+
+static uint16_t slave_reg(int i, int addr) {
+    return addr < 100 ? hold[i][addr] : __builtin_bswap16(hold[i][addr]);
+}
+
+static int submit(job_t* j) {
+    memset(j, 0, sizeof(*j));
+    j->unit = 1 + rnd() % NS;
+    j->op = rnd() % 4;
+    j->count = 1 + rnd() % 100;
+    j->addr = rnd() % (101 - j->count);
+    j->addr += (rnd() % 2) * 100;
+    if (rnd() % 20 == 0) {  // 跨越两个寄存器块, 应返回非法地址
+        j->addr = 95 + rnd() % 5;
+        j->count = 10;
+    }
+    switch (j->op) {
+        case 0:
+            return mbus_read_regs(&M, j->unit, j->addr, j->count, j->buf,
+                                  job_cb, j);
+        case 1:
+            j->addr %= 50;
+            if (j->addr + j->count > 50)
+                j->count = 50 - j->addr;
+            return mbus_read_input_regs(&M, j->unit, j->addr, j->count,
+                                        j->buf, job_cb, j);
+        case 2:
+            for (int k = 0; k < j->count; k++) j->buf[k] = rnd();
+            return mbus_write_regs(&M, j->unit, j->addr, j->count, j->buf,
+                                   job_cb, j);
+        default:
+            j->count = 1;
+            j->buf[0] = rnd();
+            return mbus_write_reg(&M, j->unit, j->addr, j->buf[0], job_cb, j);
+    }
+}
+
+// 检查一个已完成的事务并更新影子模型, 返回错误数
+static int check_job(job_t* j) {
+    int u = j->unit - 1;
+    if (!j->done)
+        return 1;
+    if (j->op != 1 && j->addr < 100 && j->addr + j->count > 100)
+        return j->result != MBUS_EX_ILLEGAL_ADDRESS &&
+               !(noise && j->result == MBUS_ERR_TIMEOUT);
+    if (j->result != MBUS_OK)
+        return !noise;
+    if (j->op >= 2)
+        for (int k = 0; k < j->count; k++) model[u][j->addr + k] = j->buf[k];
+    if (j->op == 0)
+        return memcmp(j->buf, model[u] + j->addr, j->count * 2) != 0;
+    if (j->op == 1)
+        return memcmp(j->buf, inp[u] + j->addr, j->count * 2) != 0;
+    return 0;
+}
+
+// 随机读写rounds轮, 返回错误数; 有干扰时失败的写可能已被从机执行,
+// 同一从机之后的结果不再检查, 每轮结束后以从机存储重新同步模型
+static int random_ops(int rounds, uint8_t inflight) {
+    int errs = 0;
+    for (int r = 0; r < rounds; r++) {
+        int n = 1 + rnd() % (inflight * 2);
+        if (n > NJOBS)
+            n = NJOBS;
+        for (int q = 0; q < n; q++) errs += submit(&jobs[q]) < 0;
+        pump();
+        bool failed[NS + 1] = {0};
+        for (int q = 0; q < n; q++) {
+            if (noise && failed[jobs[q].unit])
+                continue;
+            if (jobs[q].done && jobs[q].result < 0)
+                failed[jobs[q].unit] = true;
+            errs += check_job(&jobs[q]);
+        }
+        for (int i = 0; i < NS; i++) {
+            for (int k = 0; k < 200; k++) {
+                if (slave_reg(i, k) != model[i][k]) {
+                    errs += !noise;
+                    model[i][k] = slave_reg(i, k);
+                }
+            }
+        }
+    }
+    return errs;
+}
+
+static void test_rtu_roundtrip(void) {
+    setup(MBUS_RTU, 1, 512);
+    uint16_t src[4] = {0x1111, 0x2222, 0x3333, 0x4444}, dst[4] = {0};
+    lassert(mbus_write_regs(&M, 2, 10, 4, src, job_cb, &jobs[0]) >= 0);
+    lassert(mbus_write_reg(&M, 2, 150, 0xBEEF, job_cb, &jobs[1]) >= 0);
+    lassert(mbus_read_regs(&M, 2, 10, 4, dst, job_cb, &jobs[2]) >= 0);
+    pump();
+    for (int q = 0; q < 3; q++) lequal(jobs[q].result, MBUS_OK);
+    lassert(memcmp(dst, src, sizeof(src)) == 0);
+    lequal(hold[1][10], 0x1111);
+    lequal(hold[1][150], 0xEFBE);  // 大端块按线上字节序保存
+    lassert(mbus_read_input_regs(&M, 3, 5, 2, dst, job_cb, &jobs[0]) >= 0);
+    pump();
+    lequal(jobs[0].result, MBUS_OK);
+    lequal(dst[0], 2005);
+    lequal(dst[1], 2006);
+    lequal((int)M.stat.rx_errors, 0);
+    lequal((int)M.stat.tx_frames, 4);
+    lequal((int)M.stat.rx_frames, 4);
+}
+
+static void test_random(void) {
+    static const mod_size_t sizes[] = {300, 512, 1024};
+    for (int mode = MBUS_RTU; mode <= MBUS_ASCII; mode++) {
+        for (int inflight = 1; inflight <= 4; inflight += 3) {
+            for (chunk = 0; chunk <= 7; chunk += 7) {
+                setup(mode, inflight,
+                      mode == MBUS_ASCII ? 2048 : sizes[rnd() % 3]);
+                lequal(random_ops(300, inflight), 0);
+                lequal((int)M.stat.rx_errors, 0);
+                lequal((int)M.stat.timeouts, 0);
+            }
+        }
+    }
+    chunk = 0;
+}
+
+static void test_noise(void) {
+    noise = 1;
+    chunk = 5;
+    for (int mode = MBUS_RTU; mode <= MBUS_ASCII; mode++) {
+        corrupted = 0;
+        setup(mode, 4, 2048);
+        lequal(random_ops(300, 4), 0);
+        lassert(corrupted > 0);
+        lassert(M.stat.rx_frames > 500);
+    }
+    noise = 0;
+    chunk = 0;
+}
+
+// 捕获主机发出的一帧请求
+static int capture_request(uint8_t* frame) {
+    lassert(mbus_write_reg(&M, 1, 7, 0x5A5A, job_cb, &jobs[0]) >= 0);
+    int len = mwire_n;
+    memcpy(frame, mwire, len);
+    mwire_n = 0;
+    return len;
+}
+
+static void test_crc_error(void) {
+    uint8_t frame[32];
+    setup(MBUS_RTU, 1, 512);
+    int len = capture_request(frame);
+    lequal(len, 8);
+    frame[len - 1] ^= 0x01;
+    LFifo_Write(&srx[0], frame, len);
+    mbus_poll(&S[0]);
+    host_now_us += 3000;  // 剩余字节在静默后逐个丢弃
+    mbus_poll(&S[0]);
+    lequal((int)S[0].stat.rx_frames, 0);
+    lassert(S[0].stat.rx_errors > 0);
+    lequal(swire_n, 0);
+    lequal((int)LFifo_GetUsed(&srx[0]), 0);
+    lequal(hold[0][7], model[0][7]);
+}
+
+static void test_lrc_error(void) {
+    uint8_t frame[64];
+    setup(MBUS_ASCII, 1, 512);
+    int len = capture_request(frame);
+    lequal(len, 17);  // ':' + 7字节HEX + CRLF
+    lequal(frame[0], ':');
+    frame[len - 3] = frame[len - 3] == '0' ? '1' : '0';  // LRC的低位字符
+    LFifo_Write(&srx[0], frame, len);
+    mbus_poll(&S[0]);
+    lequal((int)S[0].stat.rx_frames, 0);
+    lequal((int)S[0].stat.rx_errors, 1);
+    lequal(swire_n, 0);
+    lequal((int)LFifo_GetUsed(&srx[0]), 0);
+    // 非HEX字符
+    frame[len - 3] = 'G';
+    LFifo_Write(&srx[0], frame, len);
+    mbus_poll(&S[0]);
+    lequal((int)S[0].stat.rx_errors, 2);
+    lequal(hold[0][7], model[0][7]);
+}
+
+// 将FIFO的读写位置推进到offset, 之后写入的帧从该处开始
+static void fifo_seek(lfifo_t* fifo, mod_size_t offset) {
+    uint8_t pad[64] = {0};
+    LFifo_Clear(fifo);
+    while (offset) {
+        mod_size_t n = offset < sizeof(pad) ? offset : sizeof(pad);
+        LFifo_Write(fifo, pad, n);
+        LFifo_Read(fifo, NULL, n);
+        offset -= n;
+    }
+}
+
+// 字节数字段为0xFF的帧头推算出的长度超过MBUS_ADU_MAX, 必须按错误帧头丢弃,
+// 不能在跨越FIFO边界时按该长度复制到rxbuf
+static void check_oversize(mbus_t* bus, lfifo_t* fifo, const uint8_t* hdr,
+                           int hdr_len, int total) {
+    uint8_t frame[300];
+    memset(frame, 0xFF, sizeof(frame));
+    memcpy(frame, hdr, hdr_len);
+    fifo_seek(fifo, 1000);
+    memset(bus->txbuf, 0xA5, sizeof(bus->txbuf));
+    uint32_t errors = bus->stat.rx_errors, frames = bus->stat.rx_frames;
+    lequal((int)LFifo_Write(fifo, frame, total), total);
+    mbus_poll(bus);
+    lassert(bus->stat.rx_errors > errors);
+    host_now_us += 3000;
+    mbus_poll(bus);
+    lequal((int)LFifo_GetUsed(fifo), 0);
+    lequal((int)bus->stat.rx_frames, (int)frames);
+    bool intact = true;
+    for (size_t i = 0; i < sizeof(bus->txbuf); i++)
+        intact = intact && bus->txbuf[i] == 0xA5;
+    lassert(intact);
+}
+
+static void test_wrapped_frame(void) {
+    setup(MBUS_RTU, 1, 1024);
+    // 从机: 写多个寄存器请求, 9 + 0xFF = 264字节
+    static const uint8_t req[] = {0x01, 0x10, 0x00, 0x00, 0x00, 0x7F, 0xFF};
+    check_oversize(&S[0], &srx[0], req, sizeof(req), 264);
+    lequal(swire_n, 0);
+    // 之后的正常帧同样跨越边界, 仍能正确处理
+    uint16_t src[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    lassert(mbus_write_regs(&M, 1, 20, 8, src, job_cb, &jobs[0]) >= 0);
+    fifo_seek(&srx[0], 1010);
+    pump();
+    lequal(jobs[0].result, MBUS_OK);
+    lassert(memcmp(hold[0] + 20, src, sizeof(src)) == 0);
+    lequal((int)S[0].stat.rx_frames, 1);
+    // 主机: 读保持寄存器响应, 5 + 0xFF = 260字节
+    static const uint8_t rsp[] = {0x01, 0x03, 0xFF};
+    check_oversize(&M, &mrx, rsp, sizeof(rsp), 260);
+    uint16_t dst[8] = {0};
+    lassert(mbus_read_regs(&M, 1, 20, 8, dst, job_cb, &jobs[0]) >= 0);
+    pump();
+    lequal(jobs[0].result, MBUS_OK);
+    lassert(memcmp(dst, src, sizeof(src)) == 0);
+}
+
+static void test_timeout(void) {
+    setup(MBUS_RTU, 1, 512);
+    drop_next = 1;
+    lassert(mbus_read_regs(&M, 1, 0, 4, jobs[0].buf, job_cb, &jobs[0]) >= 0);
+    lassert(mbus_read_regs(&M, 2, 0, 4, jobs[1].buf, job_cb, &jobs[1]) >= 0);
+    pump();
+    lequal(jobs[0].result, MBUS_ERR_TIMEOUT);
+    lequal(jobs[1].result, MBUS_OK);
+    lequal((int)M.stat.timeouts, 1);
+}
+
+static void test_exception_broadcast_busy(void) {
+    setup(MBUS_RTU, 1, 512);
+    memset(jobs, 0, sizeof(jobs));
+    lassert(mbus_read_regs(&M, 1, 500, 4, jobs[0].buf, job_cb, &jobs[0]) >= 0);
+    pump();
+    lequal(jobs[0].result, MBUS_EX_ILLEGAL_ADDRESS);
+    // 广播: 所有从机执行, 不应答, 发送后即完成
+    memset(jobs, 0, sizeof(jobs));
+    lassert(mbus_write_reg(&M, MBUS_BROADCAST, 3, 0x1234, job_cb, &jobs[0]) >=
+            0);
+    pump();
+    lequal(jobs[0].done, 1);
+    lequal(jobs[0].result, MBUS_OK);
+    for (int i = 0; i < NS; i++) lequal(hold[i][3], 0x1234);
+    lequal(swire_n, 0);
+    // 队列满
+    for (int i = 0; i < MBUS_CFG_QUEUE_LEN; i++)
+        lassert(mbus_read_regs(&M, 1, 0, 1, jobs[0].buf, NULL, NULL) >= 0);
+    lequal(mbus_read_regs(&M, 1, 0, 1, jobs[0].buf, NULL, NULL),
+           MBUS_ERR_BUSY);
+    pump();
+    lequal((int)mbus_pending(&M), 0);
+}
+
+int main(void) {
+    host_fake_time = true;
+    lrun("rtu round-trip", test_rtu_roundtrip);
+    lrun("random ops", test_random);
+    lrun("noise", test_noise);
+    lrun("rtu crc error", test_crc_error);
+    lrun("ascii lrc error", test_lrc_error);
+    lrun("wrapped oversize frame", test_wrapped_frame);
+    lrun("timeout", test_timeout);
+    lrun("exception/broadcast/busy", test_exception_broadcast_busy);
+    lresults();
+    return _lfails != 0;
+}
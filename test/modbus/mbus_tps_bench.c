@@ -0,0 +1,229 @@
+/**
+ * @file mbus_tps_bench.c
+ * @brief mbus经pty/管道互连的吞吐量: 主机线程与从机线程, 每秒完成的读事务数
+ * @note 无参数时运行默认组合, 每组1s; 也可指定单个组合:
+ *       mbus_tps_bench <pty|pipe> [寄存器数] [在途数] [从机数] [ascii] [秒]
+ *       多从机时所有从机共享同一条"总线"(同一个接收流)
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <pty.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "mbus.h"
+
+#define MAX_SLAVES 3
+
+typedef struct {
+    const char* transport;
+    int regs, inflight, slaves, ascii;
+} bench_cfg_t;
+
+static bench_cfg_t cfg;
+static int m_rd, m_wr, s_rd, s_wr;
+static atomic_int stop;
+static mbus_t M, S[MAX_SLAVES];
+static lfifo_t mrx, srx[MAX_SLAVES];
+static mbus_regblock_t map[MAX_SLAVES];
+static uint16_t regs[MAX_SLAVES][200];
+static uint16_t dst[MBUS_CFG_QUEUE_LEN][MBUS_READ_MAX];
+static long done_ok, done_err;
+static int next_unit;
+
+static void write_all(int fd, const uint8_t* d, uint32_t len) {
+    while (len) {
+        ssize_t r = write(fd, d, len);
+        if (r > 0) {
+            d += r;
+            len -= r;
+        }
+    }
+}
+
+static void master_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(m_wr, d, len);
+}
+
+static void slave_send(mbus_t* bus, const uint8_t* d, uint32_t len) {
+    write_all(s_wr, d, len);
+}
+
+// 直接读入FIFO的连续可写区域, 再复制给共享总线的其他从机
+static void fd_to_fifo(int fd, lfifo_t* fifo, lfifo_t* others, int n) {
+    mod_size_t len;
+    uint8_t* p = LFifo_AcquireLinearWrite(fifo, &len);
+    if (p == NULL)
+        return;
+    ssize_t r = read(fd, p, len);
+    if (r <= 0)
+        return;
+    for (int i = 0; i < n; i++) LFifo_Write(&others[i], p, r);
+    LFifo_ReleaseLinearWrite(fifo, r);
+}
+
+static void* slave_thread(void* arg) {
+    struct pollfd pfd = {s_rd, POLLIN, 0};
+    while (!atomic_load(&stop)) {
+        if (poll(&pfd, 1, 1) > 0)
+            fd_to_fifo(s_rd, &srx[0], &srx[1], cfg.slaves - 1);
+        for (int i = 0; i < cfg.slaves; i++) mbus_poll(&S[i]);
+    }
+    return NULL;
+}
+
+static void read_cb(mbus_t* bus, const mbus_xfer_t* xfer, int result) {
+    if (result == MBUS_OK && xfer->data[0] == 0x1234)
+        done_ok++;
+    else
+        done_err++;
+}
+
+static void submit(void) {
+    while (mbus_pending(&M) < cfg.inflight) {
+        int unit = 1 + next_unit++ % cfg.slaves;
+        mbus_read_regs(&M, unit, 0, cfg.regs,
+                       dst[next_unit % MBUS_CFG_QUEUE_LEN], read_cb, NULL);
+    }
+}
+
+static void* master_thread(void* arg) {
+    struct pollfd pfd = {m_rd, POLLIN, 0};
+    submit();
+    while (!atomic_load(&stop)) {
+        if (poll(&pfd, 1, 1) > 0)
+            fd_to_fifo(m_rd, &mrx, NULL, 0);
+        mbus_poll(&M);
+        submit();
+    }
+    return NULL;
+}
+
+static void make_raw(int fd) {
+    struct termios t;
+    tcgetattr(fd, &t);
+    cfmakeraw(&t);
+    tcsetattr(fd, TCSANOW, &t);
+}
+
+static int open_transport(void) {
+    if (strcmp(cfg.transport, "pty") == 0) {
+        int master, slave;
+        if (openpty(&master, &slave, NULL, NULL, NULL) != 0)
+            return -1;
+        make_raw(master);
+        make_raw(slave);
+        m_rd = m_wr = master;
+        s_rd = s_wr = slave;
+        return 0;
+    }
+    int down[2], up[2];
+    if (pipe(down) != 0 || pipe(up) != 0)
+        return -1;
+    m_wr = down[1];
+    s_rd = down[0];
+    s_wr = up[1];
+    m_rd = up[0];
+    return 0;
+}
+
+static void close_transport(void) {
+    close(m_rd);
+    close(s_rd);
+    if (m_wr != m_rd)
+        close(m_wr);
+    if (s_wr != s_rd)
+        close(s_wr);
+}
+
+static void setup(void) {
+    mbus_cfg_t c = {0};
+    c.mode = cfg.ascii ? MBUS_ASCII : MBUS_RTU;
+    c.baud = 115200;
+    c.max_inflight = cfg.inflight;
+    c.role = MBUS_MASTER;
+    c.rx = &mrx;
+    c.send = master_send;
+    LFifo_Init(&mrx, 1024);
+    mbus_init(&M, &c);
+    for (int i = 0; i < cfg.slaves; i++) {
+        regs[i][0] = 0x1234;
+        c.role = MBUS_SLAVE;
+        c.unit = i + 1;
+        c.rx = &srx[i];
+        c.send = slave_send;
+        LFifo_Init(&srx[i], 1024);
+        mbus_init(&S[i], &c);
+        map[i] = (mbus_regblock_t){0, 200, regs[i], MBUS_REG_HOLDING};
+        mbus_set_regmap(&S[i], &map[i], 1, NULL);
+    }
+}
+
+static void teardown(void) {
+    LFifo_Destory(&mrx);
+    for (int i = 0; i < cfg.slaves; i++) LFifo_Destory(&srx[i]);
+}
+
+static int run(double seconds) {
+    if (open_transport() != 0) {
+        printf("%s: open failed\n", cfg.transport);
+        return 1;
+    }
+    setup();
+    done_ok = done_err = next_unit = 0;
+    atomic_store(&stop, 0);
+    pthread_t ts, tm;
+    pthread_create(&ts, NULL, slave_thread, NULL);
+    uint64_t start = host_ns();
+    pthread_create(&tm, NULL, master_thread, NULL);
+    usleep(seconds * 1e6);
+    atomic_store(&stop, 1);
+    double dt = (host_ns() - start) * 1e-9;
+    pthread_join(tm, NULL);
+    pthread_join(ts, NULL);
+    printf("%-4s %-5s regs %3d inflight %d slaves %d: %8.0f tps (err %ld)\n",
+           cfg.transport, cfg.ascii ? "ASCII" : "RTU", cfg.regs, cfg.inflight,
+           cfg.slaves, done_ok / dt, done_err);
+    teardown();
+    close_transport();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    static const bench_cfg_t defaults[] = {
+        {"pty", 10, 1, 1, 0},   {"pty", 10, 4, 3, 0},
+        {"pty", 125, 1, 1, 0},  {"pty", 10, 1, 1, 1},
+        {"pipe", 10, 1, 1, 0},  {"pipe", 10, 4, 3, 0},
+        {"pipe", 125, 1, 1, 0}, {"pipe", 10, 1, 1, 1},
+    };
+    if (argc < 2) {
+        int ret = 0;
+        for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+            cfg = defaults[i];
+            ret |= run(1);
+        }
+        return ret;
+    }
+    cfg = (bench_cfg_t){argv[1], 10, 1, 1, 0};
+    if (argc > 2)
+        cfg.regs = atoi(argv[2]);
+    if (argc > 3)
+        cfg.inflight = atoi(argv[3]);
+    if (argc > 4)
+        cfg.slaves = atoi(argv[4]);
+    if (argc > 5)
+        cfg.ascii = atoi(argv[5]);
+    if (cfg.regs < 1 || cfg.regs > MBUS_READ_MAX || cfg.inflight < 1 ||
+        cfg.inflight > MBUS_CFG_QUEUE_LEN || cfg.slaves < 1 ||
+        cfg.slaves > MAX_SLAVES) {
+        printf("usage: %s <pty|pipe> [regs] [inflight] [slaves] [ascii] [s]\n",
+               argv[0]);
+        return 1;
+    }
+    return run(argc > 6 ? atof(argv[6]) : 2);
+}
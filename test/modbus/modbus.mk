@@ -0,0 +1,12 @@
+MBUS_SRCS := $(ROOT)/communication/modbus/mbus.c \
+	$(ROOT)/datastruct/lfifo/lfifo.c $(LIBCRC_SRCS)
+
+TESTS += mbus_test mbus_tcp_test
+mbus_test_SRCS := modbus/mbus_test.c $(MBUS_SRCS)
+mbus_tcp_test_SRCS := modbus/mbus_tcp_test.c $(MBUS_SRCS)
+
+BENCHES += mbus_bench mbus_tps_bench mbus_tcp_bench
+mbus_bench_SRCS := modbus/mbus_bench.c $(MBUS_SRCS)
+mbus_tps_bench_SRCS := modbus/mbus_tps_bench.c $(MBUS_SRCS)
+mbus_tps_bench_LDLIBS := -lutil
+mbus_tcp_bench_SRCS := modbus/mbus_tcp_bench.c $(MBUS_SRCS)
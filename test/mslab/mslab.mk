@@ -0,0 +1,21 @@
+MSLAB_SRCS := $(ROOT)/system/mslab/mslab.c
+HEAP4_SRCS := $(ROOT)/system/heap4/heap4.c
+
+TESTS += mslab_stress
+mslab_stress_SRCS := mslab/mslab_stress.c $(MSLAB_SRCS)
+mslab_stress_CFLAGS := -DMOD_CFG_HEAP_SLAB=1
+
+# 分配序列由工具程序记录, 两个回放基准分别不带/带mslab
+TOOLS += mslab_trace_rec
+mslab_trace_rec_SRCS := mslab/mslab_trace_rec.c $(SCH_SRCS)
+mslab_trace_rec_CFLAGS := -DMOD_CFG_HEAP_MATHOD_CUSTOM=1
+
+BENCHES += mslab_replay_heap4 mslab_replay_slab
+mslab_replay_heap4_SRCS := mslab/mslab_replay.c $(HEAP4_SRCS)
+mslab_replay_heap4_CFLAGS := -DMOD_CFG_HEAP_MATHOD_HEAP4=1
+mslab_replay_slab_SRCS := mslab/mslab_replay.c $(HEAP4_SRCS) $(MSLAB_SRCS)
+mslab_replay_slab_CFLAGS := -DMOD_CFG_HEAP_MATHOD_HEAP4=1 -DMOD_CFG_HEAP_SLAB=1
+
+$(BUILD)/mslab_trace.txt: $(BUILD)/mslab_trace_rec
+	$< > $@
+bench: $(BUILD)/mslab_trace.txt
@@ -0,0 +1,117 @@
+/**
+ * @file mslab_replay.c
+ * @brief 在heap4上回放mslab_trace_rec记录的分配序列, 对比开启mslab前后
+ *        的耗时与空闲链表碎片
+ * @note 重新分配按"分配+拷贝+释放"回放, 两种配置一致; 共回放20遍,
+ *       碎片统计取第一遍每64次操作的采样
+ */
+
+#include <string.h>
+
+#include "heap4.h"
+#include "modules.h"
+
+#define HEAP_SIZE (64 * 1024)
+#define MAX_EVENTS 40000
+#define MAX_IDS 20000
+#define REPEAT 20
+
+#if MOD_CFG_HEAP_SLAB
+#define CONFIG_NAME "heap4 + mslab"
+#else
+#define CONFIG_NAME "heap4"
+#endif
+
+typedef struct {
+    char op;
+    long id;
+    size_t size;
+} trace_event_t;
+
+static uint8_t heap[HEAP_SIZE] __attribute__((aligned(8)));
+static trace_event_t events[MAX_EVENTS];
+static int event_num;
+static void* ptrs[MAX_IDS];
+static size_t sizes[MAX_IDS];
+
+static int load_trace(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL)
+        return 0;
+    char op;
+    long id;
+    while (event_num < MAX_EVENTS && fscanf(f, " %c %ld", &op, &id) == 2) {
+        size_t size = 0;
+        if (op != 'f' && fscanf(f, "%zu", &size) != 1)
+            break;
+        if (id <= 0 || id >= MAX_IDS)
+            continue;
+        events[event_num++] = (trace_event_t){op, id, size};
+    }
+    fclose(f);
+    return event_num;
+}
+
+static void replay(trace_event_t* e, long* fails) {
+    void* ptr;
+    switch (e->op) {
+        case 'a':
+            ptrs[e->id] = m_alloc(e->size);
+            sizes[e->id] = e->size;
+            if (ptrs[e->id] == NULL)
+                (*fails)++;
+            break;
+        case 'f':
+            m_free(ptrs[e->id]);
+            ptrs[e->id] = NULL;
+            break;
+        default:
+            ptr = m_alloc(e->size);
+            if (ptr == NULL) {
+                (*fails)++;
+                break;
+            }
+            memcpy(ptr, ptrs[e->id],
+                   sizes[e->id] < e->size ? sizes[e->id] : e->size);
+            m_free(ptrs[e->id]);
+            ptrs[e->id] = ptr;
+            sizes[e->id] = e->size;
+            break;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "build/mslab_trace.txt";
+    if (!load_trace(path)) {
+        printf("trace %s not found, run: make -C test bench\n", path);
+        return 1;
+    }
+    prvHeapInit(heap, sizeof(heap));
+    long fails = 0, blocks_sum = 0, samples = 0, blocks_max = 0;
+    uint64_t ns = 0;
+    for (int rep = 0; rep < REPEAT; rep++) {
+        uint64_t start = host_ns();
+        for (int i = 0; i < event_num; i++) {
+            replay(&events[i], &fails);
+            if (rep == 0 && i % 64 == 0) {
+                HeapStats_t stats;
+                vPortGetHeapStats(&stats);
+                blocks_sum += stats.xNumberOfFreeBlocks;
+                samples++;
+                if ((long)stats.xNumberOfFreeBlocks > blocks_max)
+                    blocks_max = stats.xNumberOfFreeBlocks;
+            }
+        }
+        ns += host_ns() - start;
+        for (int i = 0; i < MAX_IDS; i++) {
+            m_free(ptrs[i]);
+            ptrs[i] = NULL;
+        }
+    }
+    printf(CONFIG_NAME ": %d ops, %.1f ns/op, free blocks avg %.1f / max %ld, "
+           "fails %ld\n",
+           event_num,
+           (double)ns / ((uint64_t)event_num * REPEAT),
+           (double)blocks_sum / samples, blocks_max, fails);
+    return 0;
+}
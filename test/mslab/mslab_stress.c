@@ -0,0 +1,91 @@
+/**
+ * @file mslab_stress.c
+ * @brief mslab随机分配/释放/重新分配压力测试(后端libc)
+ * @note 每个块按其编号填充, 释放及重新分配前后校验内容;
+ *       结束时所有页应归还内存池
+ */
+
+#include <string.h>
+
+#include "minctest.h"
+#include "modules.h"
+
+#define SLOTS 4000
+#define ROUNDS 2000000
+
+static void* ptrs[SLOTS];
+static size_t sizes[SLOTS];
+static unsigned seed = 12345;
+
+static unsigned rnd(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static int check(int i, size_t size) {
+    for (size_t k = 0; k < size; k++)
+        if (((uint8_t*)ptrs[i])[k] != (uint8_t)i)
+            return 0;
+    return 1;
+}
+
+static void test_random(void) {
+    long bad = 0;
+    for (long round = 0; round < ROUNDS; round++) {
+        int i = rnd() % SLOTS;
+        unsigned r = rnd();
+        size_t size = (r % 10 < 8) ? r % 300 : r % 2000;  // 多数为小块
+        if (ptrs[i] == NULL) {
+            ptrs[i] = m_alloc(size);
+            sizes[i] = size;
+            if (ptrs[i] == NULL && size)
+                bad++;
+            if (ptrs[i] != NULL)
+                memset(ptrs[i], (uint8_t)i, size);
+        } else if (r % 3 == 0) {
+            if (!check(i, sizes[i]))
+                bad++;
+            void* ptr = m_realloc(ptrs[i], size);
+            if (size == 0) {
+                m_free(ptr);
+                ptrs[i] = NULL;
+                continue;
+            }
+            if (ptr == NULL) {
+                bad++;
+                continue;
+            }
+            ptrs[i] = ptr;
+            if (!check(i, size < sizes[i] ? size : sizes[i]))
+                bad++;
+            sizes[i] = size;
+            memset(ptr, (uint8_t)i, size);
+        } else {
+            if (!check(i, sizes[i]))
+                bad++;
+            m_free(ptrs[i]);
+            ptrs[i] = NULL;
+        }
+    }
+    lequal((int)bad, 0);
+    for (int i = 0; i < SLOTS; i++) {
+        m_free(ptrs[i]);
+        ptrs[i] = NULL;
+    }
+    mslab_pool_stat_t pool;
+    mslab_get_pool_stat(&pool);
+    lassert(pool.total_pages > 0);
+    lequal(pool.free_pages + mslab_get_class_num() >= pool.total_pages, 1);
+    for (uint8_t c = 0; c < mslab_get_class_num(); c++) {
+        mslab_class_stat_t stat;
+        lassert(mslab_get_class_stat(c, &stat));
+        lequal((int)stat.used, 0);
+        lassert(stat.pages <= 1);  // 每个级别最多保留一个空页
+    }
+}
+
+int main(void) {
+    lrun("random alloc/free/realloc", test_random);
+    lresults();
+    return _lfails != 0;
+}
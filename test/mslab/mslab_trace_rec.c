@@ -0,0 +1,120 @@
+/**
+ * @file mslab_trace_rec.c
+ * @brief 记录真实模块的内存分配序列, 输出到标准输出供mslab_replay回放
+ * @note 负载: 协程(含子协程)、通道、带20~60字节参数的事件、udict、ulist;
+ *       每行一条记录: "a id size"分配, "f id"释放, "r id size"重新分配
+ */
+
+#include "scheduler.h"
+#include "udict.h"
+#include "ulist.h"
+
+#define ITERATIONS 20000
+
+typedef struct {
+    long id;
+    size_t size;
+} block_hdr_t;
+
+static long next_id = 1;
+
+void mod_custom_heap_init(void* ptr, size_t size) {}
+
+void* mod_custom_heap_alloc(size_t size) {
+    block_hdr_t* hdr = malloc(sizeof(block_hdr_t) + size);
+    hdr->id = next_id++;
+    hdr->size = size;
+    printf("a %ld %zu\n", hdr->id, size);
+    return hdr + 1;
+}
+
+void mod_custom_heap_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    block_hdr_t* hdr = (block_hdr_t*)ptr - 1;
+    printf("f %ld\n", hdr->id);
+    free(hdr);
+}
+
+void* mod_custom_heap_realloc(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return mod_custom_heap_alloc(size);
+    block_hdr_t* hdr = (block_hdr_t*)ptr - 1;
+    hdr = realloc(hdr, sizeof(block_hdr_t) + size);
+    hdr->size = size;
+    printf("r %ld %zu\n", hdr->id, size);
+    return hdr + 1;
+}
+
+static void event_cb(sch_event_arg_t arg) {}
+
+static void child(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int i;
+    char buf[40];
+    CR_INIT_LOCAL_END
+    for (CR_LOCAL(i) = 0; CR_LOCAL(i) < 3; CR_LOCAL(i)++) CR_DELAY(1);
+}
+
+static void worker(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int i;
+    CR_INIT_LOCAL_END
+    for (CR_LOCAL(i) = 0; CR_LOCAL(i) < 5; CR_LOCAL(i)++) {
+        CR_AWAIT(child, NULL);
+        CR_YIELD();
+    }
+}
+
+int main(void) {
+    host_fake_time = true;
+    UDICT dict = udict_new();
+    ULIST lists[16];
+    for (int i = 0; i < 16; i++)
+        lists[i] = ulist_new(4 + (i % 4) * 4, 0, 0, NULL);
+    char key[32];
+    char payload[64] = {0};
+    for (int i = 0; i < 8; i++) {
+        snprintf(key, sizeof(key), "e%d", i);
+        sch_event_create(key, event_cb, 1);
+    }
+    unsigned seed = 1;
+    for (int it = 0; it < ITERATIONS; it++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+        switch (r % 8) {
+            case 0:
+                snprintf(key, sizeof(key), "k%u", r % 200);
+                udict_set_copy(dict, key, payload, 8 + r % 40);
+                break;
+            case 1:
+                snprintf(key, sizeof(key), "k%u", r % 200);
+                udict_del(dict, key);
+                break;
+            case 2:
+                ulist_append_copy(lists[r % 16], payload);
+                break;
+            case 3:
+                if (lists[r % 16]->num)
+                    ulist_delete(lists[r % 16], -1);
+                break;
+            case 4:
+                snprintf(key, sizeof(key), "e%u", r % 8);
+                sch_event_trigger_ex(key, 1, payload, 20 + r % 40);
+                break;
+            case 5:
+                snprintf(key, sizeof(key), "w%u", r % 64);
+                sch_cortn_run(key, worker, NULL);
+                break;
+            case 6:
+                m_free(m_alloc(16 + r % 100));
+                break;
+            case 7:
+                sch_chan_delete(sch_chan_create(4 + r % 12, 4));
+                break;
+        }
+        scheduler_run(0);
+        host_now_us += 300;
+    }
+    return 0;
+}
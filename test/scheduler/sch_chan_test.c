@@ -0,0 +1,295 @@
+/**
+ * @file sch_chan_test.c
+ * @brief 协程通道测试: 流水线背压, 超时, 多路等待, 唤醒转交, 阻塞时停止/删除
+ * @note 使用模拟时钟; 在ASan下运行可发现停止阻塞协程后残留的等待登记
+ */
+
+#include "minctest.h"
+#include "scheduler.h"
+#include "scheduler_coroutine.h"
+
+#define PIPE_ITEMS 1000
+#define PIPE_CAP 4
+
+// 运行调度器max_us(模拟时间), until_idle时协程全部结束即返回
+// 空闲时推进模拟时钟, 每轮最多100us, 保证超时判定的精度
+static void run_for(uint64_t max_us, uint8_t until_idle) {
+    uint64_t end = host_now_us + max_us;
+    while (host_now_us < end) {
+        if (until_idle && !sch_cortn_get_num())
+            return;
+        uint64_t sleep = scheduler_run(0);
+        host_now_us += sleep == 0 ? 1 : sleep < 100 ? sleep : 100;
+    }
+}
+
+/*********************流水线**********************/
+
+static sch_chan_t pipe_chan;
+static int pipe_err, pipe_recv, pipe_max, pipe_full;
+
+static void pipe_producer(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int i;
+    uint8_t ok;
+    CR_INIT_LOCAL_END
+
+    for (CR_LOCAL(i) = 1; CR_LOCAL(i) <= PIPE_ITEMS; CR_LOCAL(i)++) {
+        CR_CHAN_SEND(pipe_chan, &CR_LOCAL(i), SCH_CHAN_FOREVER, CR_LOCAL(ok));
+        if (!CR_LOCAL(ok))
+            pipe_err++;
+        int count = sch_chan_get_count(pipe_chan);
+        if (count > pipe_max)
+            pipe_max = count;
+        if (count == PIPE_CAP)
+            pipe_full++;
+        if (CR_LOCAL(i) % 7 == 0)
+            CR_YIELD();
+    }
+}
+
+static void pipe_consumer(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int n;
+    int v;
+    uint8_t ok;
+    CR_INIT_LOCAL_END
+
+    for (CR_LOCAL(n) = 0; CR_LOCAL(n) < PIPE_ITEMS; CR_LOCAL(n)++) {
+        CR_CHAN_RECV(pipe_chan, &CR_LOCAL(v), SCH_CHAN_FOREVER, CR_LOCAL(ok));
+        if (!CR_LOCAL(ok) || CR_LOCAL(v) != CR_LOCAL(n) + 1)
+            pipe_err++;
+        pipe_recv++;
+        if (CR_LOCAL(n) % 13 == 0)
+            CR_DELAY_US(50);  // 让缓冲区填满, 生产者阻塞
+    }
+}
+
+static void test_pipeline(void) {
+    pipe_chan = CR_CHAN_CREATE(int, PIPE_CAP);
+    lassert(pipe_chan != NULL);
+    lassert(sch_cortn_run("consumer", pipe_consumer, NULL));
+    lassert(sch_cortn_run("producer", pipe_producer, NULL));
+    run_for(1000000, 1);
+    lequal(sch_cortn_get_num(), 0);
+    lequal(pipe_recv, PIPE_ITEMS);
+    lequal(pipe_err, 0);
+    lequal(pipe_max, PIPE_CAP);
+    lassert(pipe_full > 0);
+    lequal((int)sch_chan_get_count(pipe_chan), 0);
+    lassert(sch_chan_delete(pipe_chan));
+}
+
+/*********************超时**********************/
+
+static sch_chan_t tmo_chan;
+static uint8_t tmo_ok[3];
+static uint64_t tmo_elapsed[3];
+static int tmo_value;
+
+static void tmo_receiver(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    uint64_t start;
+    int v;
+    uint8_t ok;
+    CR_INIT_LOCAL_END
+
+    CR_LOCAL(start) = host_now_us;  // 超时0: 只尝试一次
+    CR_CHAN_RECV(tmo_chan, &CR_LOCAL(v), 0, CR_LOCAL(ok));
+    tmo_ok[0] = CR_LOCAL(ok);
+    tmo_elapsed[0] = host_now_us - CR_LOCAL(start);
+
+    CR_LOCAL(start) = host_now_us;  // 10ms内无数据
+    CR_CHAN_RECV(tmo_chan, &CR_LOCAL(v), 10, CR_LOCAL(ok));
+    tmo_ok[1] = CR_LOCAL(ok);
+    tmo_elapsed[1] = host_now_us - CR_LOCAL(start);
+
+    CR_LOCAL(start) = host_now_us;  // 期限内到达的数据提前唤醒
+    CR_CHAN_RECV(tmo_chan, &CR_LOCAL(v), 10, CR_LOCAL(ok));
+    tmo_ok[2] = CR_LOCAL(ok);
+    tmo_elapsed[2] = host_now_us - CR_LOCAL(start);
+    tmo_value = CR_LOCAL(v);
+}
+
+static void tmo_sender(__async__, void* args) {
+    CR_INIT
+    CR_DELAY(13);  // 第二次接收超时后3ms
+    sch_chan_try_send(tmo_chan, &(int){77});
+}
+
+static void test_timeout(void) {
+    tmo_chan = CR_CHAN_CREATE(int, 1);
+    lassert(sch_cortn_run("tmo_recv", tmo_receiver, NULL));
+    lassert(sch_cortn_run("tmo_send", tmo_sender, NULL));
+    run_for(1000000, 1);
+    lequal(sch_cortn_get_num(), 0);
+    lequal(tmo_ok[0], 0);
+    lequal((int)tmo_elapsed[0], 0);
+    lequal(tmo_ok[1], 0);
+    lassert(tmo_elapsed[1] >= 10000 && tmo_elapsed[1] <= 10100);
+    lequal(tmo_ok[2], 1);
+    lequal(tmo_value, 77);
+    lassert(tmo_elapsed[2] >= 2900 && tmo_elapsed[2] <= 3100);
+    lassert(sch_chan_delete(tmo_chan));
+}
+
+/*********************多路等待**********************/
+
+static sch_chan_t sel_chans[2];
+static int16_t sel_index[3];
+static int sel_value[2];
+static uint64_t sel_elapsed;
+
+static void sel_waiter(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int n;
+    int16_t index;
+    uint64_t start;
+    CR_INIT_LOCAL_END
+
+    for (CR_LOCAL(n) = 0; CR_LOCAL(n) < 2; CR_LOCAL(n)++) {
+        CR_CHAN_SELECT(sel_chans, 2, SCH_CHAN_FOREVER, CR_LOCAL(index));
+        sel_index[CR_LOCAL(n)] = CR_LOCAL(index);
+        if (CR_LOCAL(index) >= 0)
+            sch_chan_try_recv(sel_chans[CR_LOCAL(index)],
+                              &sel_value[CR_LOCAL(n)]);
+    }
+    CR_LOCAL(start) = host_now_us;
+    CR_CHAN_SELECT(sel_chans, 2, 5, CR_LOCAL(index));
+    sel_index[2] = CR_LOCAL(index);
+    sel_elapsed = host_now_us - CR_LOCAL(start);
+}
+
+static void sel_sender(__async__, void* args) {
+    CR_INIT
+    CR_DELAY(1);
+    sch_chan_try_send(sel_chans[1], &(int){11});
+    CR_DELAY(1);
+    sch_chan_try_send(sel_chans[0], &(int){22});
+}
+
+static void test_select(void) {
+    sel_chans[0] = CR_CHAN_CREATE(int, 2);
+    sel_chans[1] = CR_CHAN_CREATE(int, 2);
+    lassert(sch_cortn_run("sel_wait", sel_waiter, NULL));
+    lassert(sch_cortn_run("sel_send", sel_sender, NULL));
+    run_for(1000000, 1);
+    lequal(sch_cortn_get_num(), 0);
+    lequal(sel_index[0], 1);
+    lequal(sel_value[0], 11);
+    lequal(sel_index[1], 0);
+    lequal(sel_value[1], 22);
+    lequal(sel_index[2], -1);
+    lassert(sel_elapsed >= 5000 && sel_elapsed <= 5100);
+    lassert(sch_chan_delete(sel_chans[0]));
+    lassert(sch_chan_delete(sel_chans[1]));
+}
+
+/*********************唤醒转交**********************/
+
+static sch_chan_t wake_chan;
+static int wake_got[3];
+
+static void wake_receiver(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int v;
+    uint8_t ok;
+    CR_INIT_LOCAL_END
+
+    CR_CHAN_RECV(wake_chan, &CR_LOCAL(v), SCH_CHAN_FOREVER, CR_LOCAL(ok));
+    if (CR_LOCAL(ok))
+        wake_got[(uintptr_t)args] = CR_LOCAL(v);
+}
+
+static void test_wake_handoff(void) {
+    wake_chan = CR_CHAN_CREATE(int, 2);
+    sch_cortn_handle_t r0 = sch_cortn_run_h("wake0", wake_receiver, (void*)0);
+    sch_cortn_handle_t r1 = sch_cortn_run_h("wake1", wake_receiver, (void*)1);
+    sch_cortn_handle_t r2 = sch_cortn_run_h("wake2", wake_receiver, (void*)2);
+    lassert(r0 != NULL && r1 != NULL && r2 != NULL);
+    run_for(1000, 0);  // 三者按顺序登记在等待列表中
+    lequal(sch_cortn_get_num(), 3);
+    // 唤醒落在r0上, r0运行前被停止, 唤醒应转交给r1
+    lassert(sch_chan_try_send(wake_chan, &(int){5}));
+    lassert(sch_cortn_stop_h(r0));
+    run_for(1000, 0);
+    lequal(wake_got[0], 0);
+    lequal(wake_got[1], 5);
+    lequal(sch_cortn_get_num(), 1);
+    lequal((int)sch_chan_get_count(wake_chan), 0);
+    // 任务上下文中连续发送两次, 只剩r2等待, 多出的一个留在通道中
+    lassert(sch_chan_try_send(wake_chan, &(int){6}));
+    lassert(sch_chan_try_send(wake_chan, &(int){7}));
+    run_for(1000, 0);
+    lequal(wake_got[2], 6);
+    lequal(sch_cortn_get_num(), 0);
+    lequal((int)sch_chan_get_count(wake_chan), 1);
+    lassert(sch_chan_delete(wake_chan));
+}
+
+/*********************阻塞时停止/删除**********************/
+
+static sch_chan_t blk_chan;
+static int blk_done;
+
+static void blk_receiver(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int v;
+    uint8_t ok;
+    CR_INIT_LOCAL_END
+
+    CR_CHAN_RECV(blk_chan, &CR_LOCAL(v), (uint32_t)(uintptr_t)args,
+                 CR_LOCAL(ok));
+    blk_done++;
+}
+
+static void blk_sender(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int v;
+    uint8_t ok;
+    CR_INIT_LOCAL_END
+
+    CR_LOCAL(v) = 1;
+    CR_CHAN_SEND(blk_chan, &CR_LOCAL(v), SCH_CHAN_FOREVER, CR_LOCAL(ok));
+    CR_CHAN_SEND(blk_chan, &CR_LOCAL(v), 1000, CR_LOCAL(ok));
+    blk_done++;
+}
+
+static void test_stop_blocked(void) {
+    blk_chan = CR_CHAN_CREATE(int, 1);
+    sch_cortn_handle_t r0 =
+        sch_cortn_run_h("blk_r0", blk_receiver, (void*)SCH_CHAN_FOREVER);
+    sch_cortn_handle_t r1 =
+        sch_cortn_run_h("blk_r1", blk_receiver, (void*)(uintptr_t)1000);
+    run_for(1000, 0);  // 两个接收者阻塞(一个永久, 一个带超时)
+    lequal(sch_cortn_get_num(), 2);
+    lequal(sch_chan_delete(blk_chan), 0);  // 仍有等待者, 拒绝删除
+    lassert(sch_cortn_stop_h(r0));
+    lassert(sch_cortn_stop_h(r1));
+    lequal(sch_cortn_get_num(), 0);
+
+    // 发送者在满通道上阻塞: 第一次发送填满通道, 第二次带超时等待
+    sch_cortn_handle_t s0 = sch_cortn_run_h("blk_s0", blk_sender, NULL);
+    lassert(s0 != NULL);
+    run_for(1000, 0);
+    lequal(sch_cortn_get_num(), 1);
+    lequal((int)sch_chan_get_count(blk_chan), 1);
+    lequal(sch_chan_delete(blk_chan), 0);
+    lassert(sch_cortn_stop_h(s0));
+
+    lassert(sch_chan_delete(blk_chan));  // 登记已全部注销
+    run_for(2000000, 0);             // 越过全部超时期限, 不应再唤醒
+    lequal(blk_done, 0);
+    lequal(sch_cortn_get_num(), 0);
+}
+
+int main(void) {
+    host_fake_time = true;
+    lrun("pipeline", test_pipeline);
+    lrun("timeout", test_timeout);
+    lrun("select", test_select);
+    lrun("wake handoff", test_wake_handoff);
+    lrun("stop blocked", test_stop_blocked);
+    lresults();
+    return _lfails != 0;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file sch_cortn_arena_test.c
+ * @brief 协程帧内存区测试: 深度7的二叉等待树, 跨块停止/释放, 块的栈式复用
+ * @note 自定义堆统计分配次数与存活块数; 每层局部变量带校验值,
+ *       帧内存重叠或回退错误会破坏校验值
+ */
+
+#include <string.h>
+
+#include "minctest.h"
+#include "scheduler.h"
+#include "scheduler_coroutine.h"
+
+#define TREE_DEPTH 7
+#define TREE_NODES ((1 << TREE_DEPTH) - 1)
+#define TREE_PASSES 2000
+#define DEEP_LEVELS 21
+#define SMALL_ARENA 64
+
+static long allocs, live;
+
+void mod_custom_heap_init(void* ptr, size_t size) {}
+
+void* mod_custom_heap_alloc(size_t size) {
+    allocs++;
+    live++;
+    return malloc(size);
+}
+
+void mod_custom_heap_free(void* ptr) {
+    if (ptr != NULL)
+        live--;
+    free(ptr);
+}
+
+void* mod_custom_heap_realloc(void* ptr, size_t size) {
+    if (ptr == NULL) {
+        live++;
+    } else if (size == 0) {
+        live--;
+    }
+    allocs++;
+    return realloc(ptr, size);
+}
+
+static void run_passes(int n) {
+    for (int i = 0; i < n; i++) {
+        scheduler_run(0);
+        host_now_us += 100;
+    }
+}
+
+static uint32_t tag_of(int depth, uint32_t id) {
+    return 0x5A5A0000u ^ (uint32_t)depth << 24 ^ id;
+}
+
+/*********************二叉等待树**********************/
+
+static long tree_nodes, tree_errs;
+
+static void tree(__async__, int depth, uint32_t id) {
+    CR_INIT_LOCAL_BEGIN
+    int depth;
+    uint32_t id;
+    uint32_t tag;
+    CR_INIT_LOCAL_END
+
+    CR_LOCAL(depth) = depth;
+    CR_LOCAL(id) = id;
+    CR_LOCAL(tag) = tag_of(depth, id);
+    tree_nodes++;
+    if (CR_LOCAL(depth) == 1) {
+        CR_YIELD();  // 叶子在最深处挂起一次
+    } else {
+        CR_AWAIT(tree, CR_LOCAL(depth) - 1, CR_LOCAL(id) * 2);
+        if (CR_LOCAL(tag) != tag_of(CR_LOCAL(depth), CR_LOCAL(id)))
+            tree_errs++;
+        CR_AWAIT(tree, CR_LOCAL(depth) - 1, CR_LOCAL(id) * 2 + 1);
+    }
+    if (CR_LOCAL(tag) != tag_of(CR_LOCAL(depth), CR_LOCAL(id)))
+        tree_errs++;
+}
+
+static sch_cortn_handle_t tree_hd;
+static long tree_passes, tree_used_errs, tree_allocs;
+static size_t tree_base, tree_cap;
+
+static void tree_root(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int pass;
+    CR_INIT_LOCAL_END
+
+    for (CR_LOCAL(pass) = 0; CR_LOCAL(pass) < TREE_PASSES; CR_LOCAL(pass)++) {
+        CR_AWAIT(tree, TREE_DEPTH, 1);
+        sch_cortn_arena_stat_t stat;
+        sch_cortn_get_arena_stat_h(tree_hd, &stat);
+        if (CR_LOCAL(pass) == 0) {  // 首轮之后块已齐备, 不应再分配
+            tree_base = stat.used;
+            tree_cap = stat.cap;
+            tree_allocs = allocs;
+        } else if (stat.used != tree_base || stat.cap != tree_cap ||
+                   stat.depth != 0) {
+            tree_used_errs++;
+        }
+        tree_passes++;
+    }
+    tree_allocs = allocs - tree_allocs;
+}
+
+static void test_await_tree(void) {
+    tree_hd = sch_cortn_run_h("tree", tree_root, NULL);
+    lassert(tree_hd != NULL);
+    uint64_t start = host_ns();
+    while (sch_cortn_get_num()) run_passes(1);
+    uint64_t ns = host_ns() - start;
+    lequal((int)tree_passes, TREE_PASSES);
+    lequal((int)tree_nodes, TREE_NODES * TREE_PASSES);
+    lequal((int)tree_errs, 0);
+    lequal((int)tree_used_errs, 0);
+    lequal((int)tree_allocs, 0);
+    lassert(tree_cap > SCH_CFG_CORTN_ARENA_SIZE);  // 确实跨越了多个块
+    printf("\tarena cap %zu, %.0f ns/await\n", tree_cap,
+           (double)ns / ((double)TREE_NODES * TREE_PASSES));
+}
+
+/*********************跨块停止/栈式复用**********************/
+
+typedef struct {
+    int depth;          // 当前递归层数
+    int target;         // 目标深度
+    long descents;      // 已完成的下潜次数
+    long errs;          // 校验值错误
+    long park;          // 到达目标深度后挂起, 非0时一直挂起等待停止
+    long chunk_allocs;  // 首次下潜之后新分配的次数
+} deep_ctl_t;
+
+static deep_ctl_t deep;
+
+static void dive(__async__, int level) {
+    CR_INIT_LOCAL_BEGIN
+    int level;
+    uint32_t tag;
+    uint8_t pad[40];  // 使每层占用较多空间, 小内存区下每一两层就要换块
+    CR_INIT_LOCAL_END
+
+    CR_LOCAL(level) = level;
+    CR_LOCAL(tag) = tag_of(level, 0xD1);
+    memset(CR_LOCAL(pad), level, sizeof(CR_LOCAL(pad)));
+    deep.depth = CR_LOCAL(level);
+    if (CR_LOCAL(level) < deep.target) {
+        CR_AWAIT(dive, CR_LOCAL(level) + 1);
+    } else {
+        do {
+            CR_YIELD();
+        } while (deep.park);
+    }
+    if (CR_LOCAL(tag) != tag_of(CR_LOCAL(level), 0xD1))
+        deep.errs++;
+    for (size_t i = 0; i < sizeof(CR_LOCAL(pad)); i++) {
+        if (CR_LOCAL(pad)[i] != (uint8_t)CR_LOCAL(level)) {
+            deep.errs++;
+            break;
+        }
+    }
+    deep.depth = CR_LOCAL(level) - 1;
+}
+
+static void dive_root(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    long before;
+    CR_INIT_LOCAL_END
+
+    while (1) {
+        CR_LOCAL(before) = allocs;
+        CR_AWAIT(dive, 1);
+        if (deep.descents)
+            deep.chunk_allocs += allocs - CR_LOCAL(before);
+        deep.descents++;
+        CR_YIELD();
+    }
+}
+
+static void test_deep_stop(void) {
+    long live0 = live;
+    memset(&deep, 0, sizeof(deep));
+    deep.target = DEEP_LEVELS;
+    sch_cortn_handle_t hd =
+        sch_cortn_run_ex_h("deep", dive_root, NULL, SMALL_ARENA);
+    lassert(hd != NULL);
+
+    // 反复下潜到21层再返回: 首次之后全部复用保留的块
+    run_passes(200);
+    sch_cortn_arena_stat_t stat;
+    lassert(sch_cortn_get_arena_stat_h(hd, &stat));
+    lassert(deep.descents > 10);
+    lequal((int)deep.chunk_allocs, 0);
+    lequal((int)deep.errs, 0);
+    lassert(stat.cap > SMALL_ARENA * 8);
+    size_t cap = stat.cap;
+
+    // 浅层下潜只用到前面的块, 回退后更深的块仍保留
+    deep.target = 3;
+    run_passes(50);
+    lassert(sch_cortn_get_arena_stat_h(hd, &stat));
+    lequal((int)stat.cap, (int)cap);
+    lassert(stat.peak <= cap);
+    lequal((int)deep.chunk_allocs, 0);
+
+    // 挂起在21层(跨越多个块)时停止, 全部块随之释放
+    deep.target = DEEP_LEVELS;
+    deep.park = 1;
+    for (int i = 0; i < 100 && deep.depth != DEEP_LEVELS; i++) run_passes(1);
+    lequal(deep.depth, DEEP_LEVELS);
+    lassert(sch_cortn_get_arena_stat_h(hd, &stat));
+    lequal(stat.depth, DEEP_LEVELS);
+    lassert(stat.used > SMALL_ARENA * 8);
+    lassert(sch_cortn_stop_h(hd));
+    lequal(sch_cortn_get_num(), 0);
+    lequal((int)(live - live0), 0);
+    lequal((int)deep.errs, 0);
+}
+
+/*********************超出块大小的局部变量**********************/
+
+static long big_errs, big_runs;
+
+static void big_frame(__async__, int fill) {
+    CR_INIT_LOCAL_BEGIN
+    uint8_t buf[SCH_CFG_CORTN_ARENA_SIZE * 2];
+    CR_INIT_LOCAL_END
+
+    memset(CR_LOCAL(buf), fill, sizeof(CR_LOCAL(buf)));
+    CR_YIELD();
+    for (size_t i = 0; i < sizeof(CR_LOCAL(buf)); i++) {
+        if (CR_LOCAL(buf)[i] != (uint8_t)fill) {
+            big_errs++;
+            break;
+        }
+    }
+}
+
+static void big_root(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    int i;
+    CR_INIT_LOCAL_END
+
+    for (CR_LOCAL(i) = 0; CR_LOCAL(i) < 10; CR_LOCAL(i)++) {
+        CR_AWAIT(big_frame, CR_LOCAL(i) + 1);
+        big_runs++;
+    }
+}
+
+static void test_big_local(void) {
+    long live0 = live;
+    lassert(sch_cortn_run("big", big_root, NULL));
+    run_passes(100);
+    lequal(sch_cortn_get_num(), 0);
+    lequal((int)big_runs, 10);
+    lequal((int)big_errs, 0);
+    lequal((int)(live - live0), 0);
+}
+
+int main(void) {
+    host_fake_time = true;
+    lrun("await tree", test_await_tree);
+    lrun("deep stop", test_deep_stop);
+    lrun("big local", test_big_local);
+    lresults();
+    return _lfails != 0;
+}
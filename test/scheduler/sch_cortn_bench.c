@@ -0,0 +1,133 @@
+/**
+ * @file sch_cortn_bench.c
+ * @brief 协程调度基准: 大量协程多数在睡眠时每轮调度的开销, 与改造前的扫描对比
+ * @note 使用模拟时钟, 每轮调度后时钟前进100us; scan列为改造前cortn_runner
+ *       逻辑的副本(每轮遍历全部协程, 检查就绪/睡眠到期), 协程体以普通函数代替,
+ *       不含协程切换, 只是改造前开销的下限; queue列为完整的scheduler_run
+ */
+
+#include "scheduler.h"
+#include "scheduler_coroutine.h"
+
+#define PASSES 200000
+#define STEP_US 100
+
+typedef struct scan_cortn {  // 改造前的协程结构(只保留调度用到的字段)
+    void (*task)(struct scan_cortn* cortn, uint64_t now);
+    uint8_t state;
+    uint64_t sleepUntil;
+    uint32_t period;  // 0表示忙协程(每次调度都yield)
+} scan_cortn_t;
+
+static long count;
+
+static void scan_body(scan_cortn_t* cortn, uint64_t now) {
+    count++;
+    if (cortn->period) {
+        cortn->sleepUntil = now + cortn->period;
+        cortn->state = _CR_STATE_SLEEPING;
+    }
+}
+
+static uint64_t scan_runner(scan_cortn_t** list, int n) {
+    uint64_t sleep_us = UINT64_MAX;
+    uint64_t now = host_now_us;
+    for (int i = 0; i < n; i++) {
+        scan_cortn_t* cortn = list[i];
+        if (cortn->state == _CR_STATE_READY) {
+            cortn->state = _CR_STATE_RUNNING;
+            cortn->sleepUntil = 0;
+        } else if (cortn->state == _CR_STATE_AWAITING) {
+            continue;
+        }
+        if (cortn->state == _CR_STATE_RUNNING ||
+            (cortn->state == _CR_STATE_SLEEPING && now >= cortn->sleepUntil)) {
+            cortn->sleepUntil = 0;
+            cortn->task(cortn, now);
+        }
+        if (cortn->sleepUntil < now) {
+            sleep_us = 0;
+        } else if (cortn->sleepUntil - now < sleep_us) {
+            sleep_us = cortn->sleepUntil - now;
+        }
+    }
+    return sleep_us;
+}
+
+// 睡眠协程的周期在[base, 2*base)内均匀分布, 前busy个为忙协程
+static uint32_t period_of(int i, int n, int busy, uint32_t base) {
+    if (i < busy)
+        return 0;
+    return base + (uint32_t)((uint64_t)(i - busy) * base / (n - busy));
+}
+
+static double bench_scan(int n, int busy, uint32_t base, long* runs) {
+    static scan_cortn_t* list[1000];  // 与改造前相同, 协程本体单独分配
+    for (int i = 0; i < n; i++) {
+        list[i] = calloc(1, sizeof(scan_cortn_t));
+        list[i]->task = scan_body;
+        list[i]->state = _CR_STATE_READY;
+        list[i]->period = period_of(i, n, busy, base);
+    }
+    count = 0;
+    uint64_t start = host_ns();
+    for (int i = 0; i < PASSES; i++) {
+        scan_runner(list, n);
+        host_now_us += STEP_US;
+    }
+    double ns = (double)(host_ns() - start) / PASSES;
+    *runs = count;
+    for (int i = 0; i < n; i++) free(list[i]);
+    return ns;
+}
+
+static void cortn_fn(__async__, void* args) {
+    CR_INIT;
+    while (1) {
+        count++;
+        if (args)
+            CR_DELAY_US((uint32_t)(uintptr_t)args);
+        else
+            CR_YIELD();
+    }
+}
+
+static double bench_queue(int n, int busy, uint32_t base, long* runs) {
+    static sch_cortn_handle_t cortns[1000];
+    char name[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(name, sizeof(name), "c%d", i);
+        cortns[i] = sch_cortn_run_h(
+            name, cortn_fn, (void*)(uintptr_t)period_of(i, n, busy, base));
+    }
+    count = 0;
+    uint64_t start = host_ns();
+    for (int i = 0; i < PASSES; i++) {
+        scheduler_run(0);
+        host_now_us += STEP_US;
+    }
+    double ns = (double)(host_ns() - start) / PASSES;
+    *runs = count;
+    for (int i = 0; i < n; i++) sch_cortn_stop_h(cortns[i]);
+    scheduler_run(0);  // 回收已停止的协程
+    return ns;
+}
+
+static void bench(int n, int busy, uint32_t base) {
+    long scan_runs, queue_runs;
+    double scan = bench_scan(n, busy, base, &scan_runs);
+    double queue = bench_queue(n, busy, base, &queue_runs);
+    printf("cortns %3d, busy %d, sleep %3u-%3u ms: scan %5.0f ns/pass, "
+           "queue %5.0f ns/pass (runs %ld/%ld)\n",
+           n, busy, base / 1000, base * 2 / 1000, scan, queue, scan_runs,
+           queue_runs);
+}
+
+int main(void) {
+    host_fake_time = true;
+    bench(500, 5, 1000);
+    bench(500, 0, 1000);
+    bench(50, 5, 1000);
+    bench(500, 5, 100000);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file sch_event_stress.c
+ * @brief 事件触发队列压力测试: 多线程并发触发, 调度器线程消费
+ * @note 检查每次成功的触发恰好执行一次且同一生产者内保持顺序,
+ *       以及删除事件后队列中尚未执行的触发被丢弃
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "minctest.h"
+#include "scheduler.h"
+
+#define PRODUCERS 4
+#define PER_PRODUCER 200000
+
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+    uint32_t check;
+} msg_t;
+
+static sch_event_handle_t event;
+static long sent[PRODUCERS], full[PRODUCERS];
+static long received[PRODUCERS];
+static uint32_t last_seq[PRODUCERS];
+static long order_err, data_err;
+static atomic_int done;
+
+static void stress_cb(sch_event_arg_t arg) {
+    if (arg.size != sizeof(msg_t)) {
+        data_err++;
+        return;
+    }
+    msg_t* m = arg.ptr;
+    if (m->producer >= PRODUCERS ||
+        m->check != (m->producer ^ m->seq ^ 0xA5A5A5A5u)) {
+        data_err++;
+        return;
+    }
+    if (received[m->producer] && m->seq <= last_seq[m->producer]) order_err++;
+    last_seq[m->producer] = m->seq;
+    received[m->producer]++;
+}
+
+static void* producer(void* arg) {
+    uint32_t p = (uint32_t)(uintptr_t)arg;
+    for (uint32_t i = 1; i <= PER_PRODUCER; i++) {
+        msg_t m = {p, i, p ^ i ^ 0xA5A5A5A5u};
+        while (!sch_event_trigger_ex_h(event, 1, &m, sizeof(m))) {
+            full[p]++;
+            sched_yield();
+        }
+        sent[p]++;
+    }
+    atomic_fetch_add(&done, 1);
+    return NULL;
+}
+
+static void test_concurrent_trigger(void) {
+    pthread_t th[PRODUCERS];
+    event = sch_event_create_h("stress", stress_cb, 1);
+    lassert(event != NULL);
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_create(&th[i], NULL, producer, (void*)(uintptr_t)i);
+    while (atomic_load(&done) < PRODUCERS) {
+        if (scheduler_run(0))
+            sched_yield();  // 队列已空, 让出CPU给生产者(单核主机上尤为重要)
+    }
+    for (int i = 0; i < PRODUCERS; i++) pthread_join(th[i], NULL);
+    scheduler_run(0);
+    long total_full = 0;
+    for (int i = 0; i < PRODUCERS; i++) {
+        lequal((int)sent[i], PER_PRODUCER);
+        lequal((int)received[i], (int)sent[i]);
+        total_full += full[i];
+    }
+    lequal((int)order_err, 0);
+    lequal((int)data_err, 0);
+    printf("\tqueue full retries: %ld\n", total_full);
+    lassert(sch_event_delete_h(event));
+}
+
+static int pending_calls;
+
+static void pending_cb(sch_event_arg_t arg) { pending_calls++; }
+
+static void test_delete_pending(void) {
+    uint8_t buf[SCH_CFG_EVENT_INLINE_ARG_SIZE + 8] = {0};
+    sch_event_handle_t other = sch_event_create_h("other", pending_cb, 1);
+    event = sch_event_create_h("victim", pending_cb, 1);
+    // 内联参数与堆参数交替, 删除时两者都要正确释放
+    for (int i = 0; i < 8; i++) {
+        size_t size = i & 1 ? sizeof(buf) : 4;
+        lassert(sch_event_trigger_ex_h(event, 0, buf, size));
+        lassert(sch_event_trigger_h(other, 0, NULL, 0));
+    }
+    lassert(sch_event_delete_h(event));
+    // 同名事件复用同一块内存时也不能收到旧的触发
+    event = sch_event_create_h("victim", pending_cb, 1);
+    scheduler_run(0);
+    lequal(pending_calls, 8);
+    lassert(sch_event_delete_h(event));
+    lassert(sch_event_delete_h(other));
+}
+
+static int self_calls;
+
+static void self_delete_cb(sch_event_arg_t arg) {
+    self_calls++;
+    sch_event_delete_h(event);
+}
+
+static void test_delete_in_callback(void) {
+    event = sch_event_create_h("self", self_delete_cb, 1);
+    for (int i = 0; i < 4; i++)
+        lassert(sch_event_trigger_h(event, 0, NULL, 0));
+    scheduler_run(0);
+    lequal(self_calls, 1);
+    lequal(sch_event_get_num(), 0);
+}
+
+int main(void) {
+    lrun("concurrent trigger", test_concurrent_trigger);
+    lrun("delete with pending triggers", test_delete_pending);
+    lrun("delete in callback", test_delete_in_callback);
+    lresults();
+    return _lfails != 0;
+}
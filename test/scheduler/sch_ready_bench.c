@@ -0,0 +1,111 @@
+/**
+ * @file sch_ready_bench.c
+ * @brief 任务就绪队列基准: 不同任务数下每次调度的开销, 与改造前的线性扫描对比
+ * @note 使用模拟时钟, 空闲时间直接跳过; scan列为改造前get_next_task/
+ *       task_runner逻辑的副本(按优先级排序的ulist, 每次执行后扫描全部任务),
+ *       只包含任务部分, heap列为完整的scheduler_run
+ */
+
+#include "scheduler.h"
+#include "ulist.h"
+
+#define DISPATCHES 2000000
+
+typedef struct {  // 改造前的任务结构(不含调试统计)
+    sch_task_func_t task;
+    uint64_t period;
+    uint64_t pendTime;
+    uint8_t enable;
+    uint8_t priority;
+    void* args;
+} scan_task_t;
+
+static long count;
+
+static void task_fn(void* args) { count++; }
+
+static int scan_taskcmp(const void* a, const void* b) {
+    return ((scan_task_t*)b)->priority - ((scan_task_t*)a)->priority;
+}
+
+static scan_task_t* scan_get_next(ULIST tasklist, uint64_t now) {
+    scan_task_t* next = NULL;
+    ulist_foreach(tasklist, scan_task_t, task) {
+        if (!task->enable)
+            continue;
+        if (now >= task->pendTime)
+            return task;  // 高优先级在前
+        if (next == NULL || task->pendTime < next->pendTime)
+            next = task;
+    }
+    return next;
+}
+
+static double bench_scan(int n) {
+    ULIST tasklist = ulist_new(sizeof(scan_task_t), 0, 0, NULL);
+    for (int i = 0; i < n; i++) {
+        scan_task_t task = {
+            .task = task_fn,
+            .period = 1000000 / (10 + i % 50),
+            .pendTime = host_now_us,
+            .enable = 1,
+            .priority = i % 7,
+        };
+        ulist_append_copy(tasklist, &task);
+        ulist_sort(tasklist, scan_taskcmp, SLICE_START, SLICE_END);
+    }
+    count = 0;
+    scan_task_t* pending = scan_get_next(tasklist, host_now_us);
+    uint64_t start = host_ns();
+    while (count < DISPATCHES) {
+        uint64_t now = host_now_us;
+        if (now < pending->pendTime) {
+            host_now_us = pending->pendTime;
+            continue;
+        }
+        if (now - pending->pendTime <= SCH_CFG_COMP_RANGE_US)
+            pending->pendTime += pending->period;
+        else
+            pending->pendTime = now + pending->period;
+        pending->task(pending->args);
+        pending = scan_get_next(tasklist, now);
+    }
+    double ns = (double)(host_ns() - start) / count;
+    ulist_free(tasklist);
+    return ns;
+}
+
+static double bench_heap(int n) {
+    static sch_task_handle_t tasks[1000];
+    char name[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(name, sizeof(name), "t%d", i);
+        tasks[i] = sch_task_create_h(name, task_fn, 10 + i % 50, 1, i % 7,
+                                     NULL);
+    }
+    count = 0;
+    uint64_t start = host_ns();
+    while (count < DISPATCHES) {
+        uint64_t sleep = scheduler_run(0);
+        if (sleep)
+            host_now_us += sleep;
+    }
+    double ns = (double)(host_ns() - start) / count;
+    for (int i = 0; i < n; i++) sch_task_delete_h(tasks[i]);
+    return ns;
+}
+
+static void bench(int n) {
+    double scan = bench_scan(n);
+    double heap = bench_heap(n);
+    printf("tasks %5d: scan %6.0f ns/dispatch, heap %6.0f ns/dispatch\n", n,
+           scan, heap);
+}
+
+int main(void) {
+    host_fake_time = true;
+    bench(10);
+    bench(100);
+    bench(1000);
+    return 0;
+}
@@ -0,0 +1,23 @@
+BENCHES += sch_ready_bench
+sch_ready_bench_SRCS := scheduler/sch_ready_bench.c $(SCH_SRCS)
+
+TESTS += sch_event_stress sch_event_stress_report
+sch_event_stress_SRCS := scheduler/sch_event_stress.c $(SCH_SRCS)
+# 同一测试在调试报告开启时再跑一遍(回调前后会访问事件统计字段)
+sch_event_stress_report_SRCS := $(sch_event_stress_SRCS) \
+	$(ROOT)/utility/term_table/term_table.c
+sch_event_stress_report_CFLAGS := -DSCH_CFG_DEBUG_REPORT=1
+# 无原子操作时触发队列以关中断保护(主机上以互斥锁模拟)
+TESTS += sch_event_stress_noatomic
+sch_event_stress_noatomic_SRCS := $(sch_event_stress_SRCS)
+sch_event_stress_noatomic_CFLAGS := -DMOD_CFG_ENABLE_ATOMIC=0
+
+BENCHES += sch_cortn_bench
+sch_cortn_bench_SRCS := scheduler/sch_cortn_bench.c $(SCH_SRCS)
+
+TESTS += sch_chan_test
+sch_chan_test_SRCS := scheduler/sch_chan_test.c $(SCH_SRCS)
+
+TESTS += sch_cortn_arena_test
+sch_cortn_arena_test_SRCS := scheduler/sch_cortn_arena_test.c $(SCH_SRCS)
+sch_cortn_arena_test_CFLAGS := -DMOD_CFG_HEAP_MATHOD_CUSTOM=1
@@ -0,0 +1,22 @@
+TLSF_SRCS := $(ROOT)/system/tlsf/tlsf.c
+
+TESTS += tlsf_stress
+tlsf_stress_SRCS := tlsf/tlsf_stress.c $(TLSF_SRCS)
+
+# 同一延迟基准分别链接heap4/lwmem/tlsf/klite内置堆
+BENCHES += tlsf_lat_heap4 tlsf_lat_lwmem tlsf_lat_tlsf tlsf_lat_klite \
+	tlsf_lat_klite_first
+tlsf_lat_heap4_SRCS := tlsf/tlsf_lat_bench.c $(ROOT)/system/heap4/heap4.c
+tlsf_lat_heap4_CFLAGS := -DLAT_HEAP4=1
+tlsf_lat_lwmem_SRCS := tlsf/tlsf_lat_bench.c $(ROOT)/system/lwmem/lwmem.c
+tlsf_lat_lwmem_CFLAGS := -DLAT_LWMEM=1
+tlsf_lat_tlsf_SRCS := tlsf/tlsf_lat_bench.c $(TLSF_SRCS)
+# klite内置堆把指针转为kl_size_t, 64位主机上需加宽
+TLSF_LAT_KLITE_CFLAGS := $(KLITE_CFLAGS) -DLAT_KLITE=1 \
+	-DKLITE_CFG_HEAP_USE_BUILTIN=1 -DKLITE_CFG_64BIT_SIZE=1 \
+	-DKLITE_CFG_HEAP_ALIGN_BYTE=8 -DKLITE_CFG_HEAP_STORAGE_PREV_NODE=1
+tlsf_lat_klite_SRCS := tlsf/tlsf_lat_bench.c $(ROOT)/system/klite/heap/builtin.c
+tlsf_lat_klite_CFLAGS := $(TLSF_LAT_KLITE_CFLAGS) -DKLITE_CFG_HEAP_USE_BESTFIT=1
+tlsf_lat_klite_first_SRCS := $(tlsf_lat_klite_SRCS)
+tlsf_lat_klite_first_CFLAGS := $(TLSF_LAT_KLITE_CFLAGS) \
+	-DKLITE_CFG_HEAP_USE_BESTFIT=0
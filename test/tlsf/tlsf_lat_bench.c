@@ -0,0 +1,117 @@
+/**
+ * @file tlsf_lat_bench.c
+ * @brief 分配器延迟基准: 随机请求下malloc/free耗时的分位数
+ * @note 256KiB堆, 1500个槽位, 8B~4KiB随机请求, 共1M次操作;
+ *       编译时以LAT_HEAP4/LAT_LWMEM/LAT_KLITE选择对比对象, 默认tlsf.
+ *       主机上max受调度抢占影响, 以p99.9/p99.99为准
+ */
+
+#include <string.h>
+
+#include "modules.h"
+
+#define HEAP_SIZE (256 * 1024)
+#define SLOTS 1500
+#define OPS 1000000
+
+static uint8_t heap[HEAP_SIZE] __attribute__((aligned(8)));
+
+#if LAT_HEAP4
+#include "heap4.h"
+#define NAME "heap4"
+#define heap_init() prvHeapInit(heap, HEAP_SIZE)
+#define heap_alloc(size) pvPortMalloc(size)
+#define heap_free(ptr) vPortFree(ptr)
+#elif LAT_LWMEM
+#include "lwmem.h"
+static lwmem_region_t regions[] = {{heap, HEAP_SIZE}, {NULL, 0}};
+#define NAME "lwmem"
+#define heap_init() lwmem_assignmem(regions)
+#define heap_alloc(size) lwmem_malloc(size)
+#define heap_free(ptr) lwmem_free(ptr)
+#elif LAT_KLITE
+#include "kl_priv.h"
+// 单线程运行, 堆锁永不竞争, 调度相关函数以空桩代替
+kl_thread_t kl_sched_tcb_now;
+void kl_port_enter_critical(void) {}
+void kl_port_leave_critical(void) {}
+void kl_sched_tcb_wait(kl_thread_t tcb, struct kl_thread_list* list) {}
+void kl_sched_switch(void) {}
+void kl_sched_preempt(const bool round_robin) {}
+kl_thread_t kl_sched_tcb_wake_from(struct kl_thread_list* list) { return NULL; }
+void* kl_heap_alloc_fault_hook(kl_size_t size) { return NULL; }
+#if KLITE_CFG_HEAP_USE_BESTFIT
+#define NAME "klite(best)"
+#else
+#define NAME "klite(first)"
+#endif
+#define heap_init() kl_heap_init(heap, HEAP_SIZE)
+#define heap_alloc(size) kl_heap_alloc(size)
+#define heap_free(ptr) kl_heap_free(ptr)
+#else
+#include "tlsf.h"
+#define NAME "tlsf"
+#define heap_init() tlsf_heap_init(heap, HEAP_SIZE)
+#define heap_alloc(size) tlsf_malloc(size)
+#define heap_free(ptr) tlsf_free(ptr)
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UNIT "cyc"
+#define stamp() __rdtsc()
+#else
+#define UNIT "ns"
+#define stamp() host_ns()
+#endif
+
+static void* ptrs[SLOTS];
+static uint32_t alloc_lat[OPS], free_lat[OPS];
+static unsigned seed = 7;
+
+static unsigned rnd(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void report(const char* what, uint32_t* lat, long n) {
+    qsort(lat, n, sizeof(uint32_t), cmp_u32);
+    printf("  %s p50 %5u  p99 %5u  p99.9 %6u  p99.99 %7u  max %8u " UNIT "\n",
+           what, lat[n / 2], lat[n * 99 / 100], lat[n * 999 / 1000],
+           lat[n * 9999 / 10000], lat[n - 1]);
+}
+
+int main(void) {
+    heap_init();
+    long allocs = 0, frees = 0, fails = 0;
+    for (long op = 0; op < OPS; op++) {
+        int i = rnd() % SLOTS;
+        unsigned r = rnd();
+        if (ptrs[i] == NULL) {
+            // 3/4小块, 3/16中块, 1/16大块
+            size_t size = (r % 16 < 12)   ? 8 + r % 120
+                          : (r % 16 < 15) ? 128 + r % 900
+                                          : 1024 + r % 3000;
+            uint64_t start = stamp();
+            ptrs[i] = heap_alloc(size);
+            alloc_lat[allocs++] = stamp() - start;
+            if (ptrs[i] == NULL)
+                fails++;
+        } else {
+            uint64_t start = stamp();
+            heap_free(ptrs[i]);
+            free_lat[frees++] = stamp() - start;
+            ptrs[i] = NULL;
+        }
+    }
+    printf("%s: %ld allocs (%ld failed), %ld frees\n", NAME, allocs, fails,
+           frees);
+    report("malloc", alloc_lat, allocs);
+    report("free  ", free_lat, frees);
+    return 0;
+}
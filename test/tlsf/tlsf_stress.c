@@ -0,0 +1,85 @@
+/**
+ * @file tlsf_stress.c
+ * @brief tlsf随机分配/释放/重新分配压力测试
+ * @note 堆起始地址故意不对齐, 请求0~60KiB; 每个块按其编号填充并在
+ *       释放及重新分配前后校验; 全部释放后堆应合并为一个空闲块
+ */
+
+#include <string.h>
+
+#include "minctest.h"
+#include "tlsf.h"
+
+#define SLOTS 3000
+#define ROUNDS 3000000
+
+static uint8_t heap[1 << 19];
+static void* ptrs[SLOTS];
+static size_t sizes[SLOTS];
+static unsigned seed = 12345;
+
+static unsigned rnd(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static int check(int i, size_t size) {
+    for (size_t k = 0; k < size; k++)
+        if (((uint8_t*)ptrs[i])[k] != (uint8_t)i)
+            return 0;
+    return 1;
+}
+
+static void test_random(void) {
+    long bad = 0;
+    lassert(tlsf_heap_init(heap + 3, sizeof(heap) - 3));
+    for (long round = 0; round < ROUNDS; round++) {
+        int i = rnd() % SLOTS;
+        unsigned r = rnd();
+        size_t size = (r % 10 < 7)   ? r % 300
+                      : (r % 10 < 9) ? r % 4000
+                                     : r % 60000;
+        if (ptrs[i] == NULL) {
+            ptrs[i] = tlsf_malloc(size);
+            sizes[i] = size;
+            if (ptrs[i] == NULL)
+                continue;  // 堆满
+            if ((uintptr_t)ptrs[i] & (sizeof(void*) - 1))
+                bad++;
+            memset(ptrs[i], (uint8_t)i, size);
+        } else if (r % 3 == 0) {
+            if (!check(i, sizes[i]))
+                bad++;
+            void* ptr = tlsf_realloc(ptrs[i], size);
+            if (size == 0) {
+                ptrs[i] = NULL;
+                continue;
+            }
+            if (ptr == NULL)
+                continue;  // 失败时原内存仍有效
+            ptrs[i] = ptr;
+            if (!check(i, size < sizes[i] ? size : sizes[i]))
+                bad++;
+            sizes[i] = size;
+            memset(ptr, (uint8_t)i, size);
+        } else {
+            if (!check(i, sizes[i]))
+                bad++;
+            tlsf_free(ptrs[i]);
+            ptrs[i] = NULL;
+        }
+    }
+    lequal((int)bad, 0);
+    for (int i = 0; i < SLOTS; i++) tlsf_free(ptrs[i]);
+    tlsf_stats_t stats;
+    tlsf_get_stats(&stats);
+    lequal((int)stats.free_blocks, 1);
+    lequal((int)stats.avail_size, (int)stats.total_size);
+    lequal((int)stats.largest_free, (int)stats.total_size);
+}
+
+int main(void) {
+    lrun("random malloc/realloc/free", test_random);
+    lresults();
+    return _lfails != 0;
+}
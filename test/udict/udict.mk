@@ -0,0 +1,10 @@
+TESTS += udict_flat_test
+udict_flat_test_SRCS := udict/udict_flat_test.c $(UDICT_SRCS)
+udict_flat_test_CFLAGS := -DUDICT_CFG_FLAT=1 -DMOD_CFG_HEAP_MATHOD_CUSTOM=1
+
+# 同一基准分别使用uthash/开放寻址后端
+BENCHES += udict_bench_uthash udict_bench_flat
+udict_bench_uthash_SRCS := udict/udict_bench.c $(UDICT_SRCS)
+udict_bench_uthash_CFLAGS := -DMOD_CFG_HEAP_MATHOD_CUSTOM=1
+udict_bench_flat_SRCS := udict/udict_bench.c $(UDICT_SRCS)
+udict_bench_flat_CFLAGS := -DUDICT_CFG_FLAT=1 -DMOD_CFG_HEAP_MATHOD_CUSTOM=1
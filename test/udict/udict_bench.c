@@ -0,0 +1,85 @@
+/**
+ * @file udict_bench.c
+ * @brief udict内存占用与查找基准: 4000个配置项式的键, 4字节值
+ * @note 自定义堆按heap4的方式计量(8字节对齐加8字节块头);
+ *       分别以UDICT_CFG_FLAT=0/1编译对比uthash与开放寻址后端
+ */
+
+#include <string.h>
+
+#include "udict.h"
+
+#define K 4000
+#define REPEAT 50
+
+#if UDICT_CFG_FLAT
+#define CONFIG_NAME "flat"
+#else
+#define CONFIG_NAME "uthash"
+#endif
+
+static size_t live, allocs;
+static char keys[K][32];
+
+void mod_custom_heap_init(void* ptr, size_t size) {}
+
+void* mod_custom_heap_alloc(size_t size) {
+    size_t* hdr = malloc(size + 2 * sizeof(size_t));
+    hdr[0] = size;
+    live += ((size + 7) & ~(size_t)7) + 8;
+    allocs++;
+    return hdr + 2;
+}
+
+void mod_custom_heap_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    size_t* hdr = (size_t*)ptr - 2;
+    live -= ((hdr[0] + 7) & ~(size_t)7) + 8;
+    free(hdr);
+}
+
+void* mod_custom_heap_realloc(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return mod_custom_heap_alloc(size);
+    size_t old = ((size_t*)ptr)[-2];
+    void* new_ptr = mod_custom_heap_alloc(size);
+    memcpy(new_ptr, ptr, old < size ? old : size);
+    mod_custom_heap_free(ptr);
+    return new_ptr;
+}
+
+int main(void) {
+    volatile long sum = 0;
+    char miss[32];
+    for (int i = 0; i < K; i++)
+        snprintf(keys[i], sizeof(keys[i]), "cfg.module%d.param%d", i % 37, i);
+    UDICT dict = udict_new();
+    uint64_t start = host_ns();
+    for (int i = 0; i < K; i++) udict_set_copy(dict, keys[i], &i, sizeof(i));
+    uint64_t t_insert = host_ns() - start;
+    size_t mem = live, mem_allocs = allocs;
+    start = host_ns();
+    for (int rep = 0; rep < REPEAT; rep++)
+        for (int i = 0; i < K; i++)
+            sum += *(int*)udict_get(dict, keys[(i * 7919) % K]);
+    uint64_t t_hit = host_ns() - start;
+    start = host_ns();
+    for (int rep = 0; rep < REPEAT; rep++)
+        for (int i = 0; i < K; i++) {
+            memcpy(miss, keys[i], sizeof(miss));
+            miss[0] = 'x';
+            sum += udict_get(dict, miss) != NULL;
+        }
+    uint64_t t_miss = host_ns() - start;
+    start = host_ns();
+    for (int i = 0; i < K; i++) udict_del(dict, keys[i]);
+    uint64_t t_del = host_ns() - start;
+    udict_free(dict);
+    printf(CONFIG_NAME ": %.1f B/key (%zu allocs), insert %.1f ns, "
+           "hit %.1f ns, miss %.1f ns, del %.1f ns\n",
+           (double)mem / K, mem_allocs, (double)t_insert / K,
+           (double)t_hit / K / REPEAT, (double)t_miss / K / REPEAT,
+           (double)t_del / K);
+    return 0;
+}
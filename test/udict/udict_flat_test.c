@@ -0,0 +1,123 @@
+/**
+ * @file udict_flat_test.c
+ * @brief udict开放寻址后端与影子模型对比的随机测试
+ * @note 400k次随机set/set_copy/set_alloc/get/del, 之后检查长度、迭代、
+ *       拷贝, 释放后自定义堆上不应有残留
+ */
+
+#include <string.h>
+
+#include "minctest.h"
+#include "udict.h"
+
+#define K 4000
+#define ROUNDS 400000
+
+enum { VAL_PTR, VAL_COPY, VAL_ALLOC };
+
+static size_t live;
+static char keys[K][32];
+static int present[K], vals[K], kinds[K];
+
+void mod_custom_heap_init(void* ptr, size_t size) {}
+
+void* mod_custom_heap_alloc(size_t size) {
+    size_t* hdr = malloc(size + 2 * sizeof(size_t));
+    hdr[0] = size;
+    live += size;
+    return hdr + 2;
+}
+
+void mod_custom_heap_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    size_t* hdr = (size_t*)ptr - 2;
+    live -= hdr[0];
+    free(hdr);
+}
+
+void* mod_custom_heap_realloc(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return mod_custom_heap_alloc(size);
+    size_t old = ((size_t*)ptr)[-2];
+    void* new_ptr = mod_custom_heap_alloc(size);
+    memcpy(new_ptr, ptr, old < size ? old : size);
+    mod_custom_heap_free(ptr);
+    return new_ptr;
+}
+
+static int check_value(int i, void* v) {
+    switch (kinds[i]) {
+        case VAL_PTR:
+            return v == (void*)(uintptr_t)(i * 7 + 1);
+        case VAL_COPY:
+            return *(int*)v == vals[i];
+        default:
+            return ((uint8_t*)v)[39] == (uint8_t)i;
+    }
+}
+
+static void test_shadow(void) {
+    long bad = 0;
+    unsigned seed = 3;
+    for (int i = 0; i < K; i++)
+        snprintf(keys[i], sizeof(keys[i]), "cfg.module%d.param%d", i % 37, i);
+    UDICT dict = udict_new();
+    lassert(dict != NULL);
+    for (long round = 0; round < ROUNDS; round++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+        int i = r % K;
+        void* v;
+        switch (r % 6) {
+            case 0:
+            case 1:
+                if (r & 64) {
+                    udict_set(dict, keys[i], (void*)(uintptr_t)(i * 7 + 1));
+                    kinds[i] = VAL_PTR;
+                } else {
+                    int val = r;
+                    udict_set_copy(dict, keys[i], &val, sizeof(val));
+                    kinds[i] = VAL_COPY;
+                }
+                vals[i] = r;
+                present[i] = 1;
+                break;
+            case 2:
+                v = udict_set_alloc(dict, keys[i], 40 + (r % 3) * 60);
+                memset(v, (uint8_t)i, 40);
+                kinds[i] = VAL_ALLOC;
+                present[i] = 1;
+                break;
+            case 3:
+                if (udict_del(dict, keys[i]) != present[i])
+                    bad++;
+                present[i] = 0;
+                break;
+            default:
+                v = udict_get(dict, keys[i]);
+                if ((v != NULL) != present[i] || (v && !check_value(i, v)))
+                    bad++;
+                break;
+        }
+    }
+    lequal((int)bad, 0);
+    int num = 0, iter_num = 0;
+    for (int i = 0; i < K; i++) num += present[i];
+    lequal((int)udict_len(dict), num);
+    const char* key = NULL;
+    void* v;
+    while (udict_iter(dict, &key, &v)) iter_num++;
+    lequal(iter_num, num);
+    UDICT copy = udict_copy(dict);
+    lequal((int)udict_len(copy), num);
+    udict_free(copy);
+    udict_free(dict);
+    lequal((int)live, 0);
+}
+
+int main(void) {
+    lrun("shadow model", test_shadow);
+    lresults();
+    return _lfails != 0;
+}
@@ -0,0 +1,14 @@
+TESTS += ulist_test ulist_test_intro
+ulist_test_SRCS := ulist/ulist_test.c $(ULIST_SRCS)
+# 同一测试强制ulist_sort_by_key全部走内省排序
+ulist_test_intro_SRCS := ulist/ulist_test.c $(ULIST_SRCS)
+ulist_test_intro_CFLAGS := -DULIST_SORT_RADIX_NUM=UINT32_MAX
+
+BENCHES += ulist_sort_bench ulist_sort_bench_intro
+ulist_sort_bench_SRCS := ulist/ulist_sort_bench.c $(ULIST_SRCS)
+ulist_sort_bench_intro_SRCS := ulist/ulist_sort_bench.c $(ULIST_SRCS)
+ulist_sort_bench_intro_CFLAGS := -DULIST_SORT_RADIX_NUM=UINT32_MAX
+
+BENCHES += ulist_cap_bench
+ulist_cap_bench_SRCS := ulist/ulist_cap_bench.c $(ULIST_SRCS)
+ulist_cap_bench_CFLAGS := -DMOD_CFG_HEAP_MATHOD_CUSTOM=1
@@ -0,0 +1,92 @@
+/**
+ * @file ulist_cap_bench.c
+ * @brief ulist容量策略基准: 统计4字节元素列表的分配器调用次数
+ * @note 依次为: 追加100k个元素, 在该长度附近每200次切换追加/删除共
+ *       10000次, 从尾部逐个删除全部元素; 另测8个元素的列表在容量边界
+ *       来回追加/删除1000次
+ */
+
+#include <string.h>
+
+#include "ulist.h"
+
+#define N 100000
+
+static unsigned long allocs, copied;
+
+void mod_custom_heap_init(void* ptr, size_t size) {}
+
+void* mod_custom_heap_alloc(size_t size) {
+    size_t* hdr = malloc(size + 2 * sizeof(size_t));
+    hdr[0] = size;
+    allocs++;
+    return hdr + 2;
+}
+
+void mod_custom_heap_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    allocs++;
+    free((size_t*)ptr - 2);
+}
+
+void* mod_custom_heap_realloc(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return mod_custom_heap_alloc(size);
+    size_t old = ((size_t*)ptr)[-2];
+    size_t* hdr = malloc(size + 2 * sizeof(size_t));
+    hdr[0] = size;
+    memcpy(hdr + 2, ptr, old < size ? old : size);
+    copied += old < size ? old : size;
+    allocs++;
+    free((size_t*)ptr - 2);
+    return hdr + 2;
+}
+
+static void run(const char* name, uint8_t opt, bool reserve) {
+    ULIST list = ulist_new(4, 0, opt | ULIST_OPT_NO_MUTEX, NULL);
+    allocs = copied = 0;
+    uint64_t start = host_ns();
+    if (reserve)
+        ulist_reserve(list, N);
+    for (uint32_t i = 0; i < N; i++) ulist_append_copy(list, &i);
+    double t_append = (host_ns() - start) / 1e6;
+    unsigned long a_append = allocs, c_append = copied;
+    allocs = 0;
+    for (uint32_t i = 0; i < 10000; i++) {
+        if ((i / 200) & 1)
+            ulist_delete(list, -1);
+        else
+            ulist_append_copy(list, &i);
+    }
+    unsigned long a_bounce = allocs;
+    allocs = 0;
+    start = host_ns();
+    for (uint32_t i = 0; i < N; i++) ulist_delete(list, -1);
+    double t_delete = (host_ns() - start) / 1e6;
+    printf("%-17s append: %6lu allocs %6.1f MB copied %6.2f ms | "
+           "+-200 x25: %5lu | delete all: %6lu allocs %6.2f ms\n",
+           name, a_append, c_append / 1e6, t_append, a_bounce, allocs,
+           t_delete);
+    ulist_free(list);
+}
+
+int main(void) {
+    run("default", 0, false);
+    run("GEOMETRIC_GROWTH", ULIST_OPT_GEOMETRIC_GROWTH, false);
+    run("reserve(100k)", ULIST_OPT_NO_SHRINK, true);
+    run("NO_SHRINK", ULIST_OPT_NO_SHRINK, false);
+
+    ULIST list = ulist_new(4, 0, ULIST_OPT_NO_MUTEX, NULL);
+    for (uint32_t i = 0; i < 8; i++) ulist_append_copy(list, &i);
+    allocs = 0;
+    for (uint32_t i = 0; i < 1000; i++) {
+        if (i & 1)
+            ulist_delete(list, -1);
+        else
+            ulist_append_copy(list, &i);
+    }
+    printf("8-element boundary bounce x1000: %lu allocs\n", allocs);
+    ulist_free(list);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file ulist_sort_bench.c
+ * @brief ulist查找/排序/批量删除基准: 100k个元素
+ * @note 排序对比ulist_sort(qsort)与ulist_sort_by_key, 批量删除对比逐个
+ *       ulist_delete与ulist_delete_matched; 以-DULIST_SORT_RADIX_NUM=
+ *       UINT32_MAX编译时ulist_sort_by_key全部走内省排序
+ */
+
+#include <string.h>
+
+#include "ulist.h"
+
+#define N 100000
+#define FIND_REPEAT 100
+
+#ifdef ULIST_SORT_RADIX_NUM
+#define SORT_NAME "introsort"
+#else
+#define SORT_NAME "radix"
+#endif
+
+typedef struct {
+    int32_t key;
+    float f;
+    uint16_t pad;
+    int8_t c;
+    uint8_t tag;
+} rec_t;  // 12字节
+
+static unsigned seed = 1;
+
+static unsigned rnd(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 1;
+}
+
+static int cmp_key(const void* a, const void* b) {
+    int32_t x = ((const rec_t*)a)->key, y = ((const rec_t*)b)->key;
+    return (x > y) - (x < y);
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static bool match_tag(const void* item, const void* key) {
+    return ((const rec_t*)item)->tag == *(const uint8_t*)key;
+}
+
+static double ms_since(uint64_t start) { return (host_ns() - start) / 1e6; }
+
+int main(void) {
+    volatile mod_offset_t found = 0;
+    ULIST l4 = ulist_new(4, 0, ULIST_OPT_NO_MUTEX, NULL);
+    ULIST l12 = ulist_new(sizeof(rec_t), 0, ULIST_OPT_NO_MUTEX, NULL);
+    for (uint32_t i = 0; i < N; i++) {
+        rec_t r = {i};
+        ulist_append_copy(l4, &i);
+        ulist_append_copy(l12, &r);
+    }
+
+    uint64_t start = host_ns();
+    for (int rep = 0; rep < FIND_REPEAT; rep++) {
+        uint32_t key = N - 1 - (rep & 1);
+        found += ulist_find(l4, &key);
+    }
+    printf("find last u32:        %.1f us\n",
+           ms_since(start) * 1000 / FIND_REPEAT);
+    rec_t last = {N - 1};
+    start = host_ns();
+    for (int rep = 0; rep < FIND_REPEAT; rep++)
+        found += ulist_find(l12, &last);
+    printf("find last 12 B item:  %.1f us\n",
+           ms_since(start) * 1000 / FIND_REPEAT);
+
+    uint32_t* src4 = malloc(sizeof(uint32_t) * N);
+    rec_t* src12 = malloc(sizeof(rec_t) * N);
+    for (int i = 0; i < N; i++) {
+        src4[i] = rnd();
+        src12[i] = (rec_t){(int32_t)rnd(), 0, 0, 0, rnd() % 10};
+    }
+    memcpy(l4->data, src4, sizeof(uint32_t) * N);
+    start = host_ns();
+    ulist_sort(l4, cmp_u32, SLICE_START, SLICE_END);
+    printf("sort u32:             qsort %.2f ms", ms_since(start));
+    memcpy(l4->data, src4, sizeof(uint32_t) * N);
+    start = host_ns();
+    ulist_sort_by_key(l4, ULIST_KEY_U32, 0, SLICE_START, SLICE_END);
+    printf(", " SORT_NAME " %.2f ms\n", ms_since(start));
+    memcpy(l12->data, src12, sizeof(rec_t) * N);
+    start = host_ns();
+    ulist_sort(l12, cmp_key, SLICE_START, SLICE_END);
+    printf("sort 12 B by i32 key: qsort %.2f ms", ms_since(start));
+    memcpy(l12->data, src12, sizeof(rec_t) * N);
+    start = host_ns();
+    ulist_sort_by_key(l12, ULIST_KEY_I32, 0, SLICE_START, SLICE_END);
+    printf(", " SORT_NAME " %.2f ms\n", ms_since(start));
+
+    // 删除tag==3的元素(约10%)
+    uint8_t tag = 3;
+    memcpy(l12->data, src12, sizeof(rec_t) * N);
+    mod_size_t deleted = 0;
+    start = host_ns();
+    for (mod_offset_t i = l12->num - 1; i >= 0; i--) {
+        if (((rec_t*)l12->data)[i].tag == tag) {
+            ulist_delete(l12, i);
+            deleted++;
+        }
+    }
+    printf("delete %u matched: per-element %.2f ms", (unsigned)deleted,
+           ms_since(start));
+    ulist_clear(l12);
+    memcpy(ulist_append_multi(l12, N), src12, sizeof(rec_t) * N);
+    start = host_ns();
+    deleted = ulist_delete_matched(l12, &tag, match_tag);
+    printf(", delete_matched %.2f ms\n", ms_since(start));
+
+    free(src4);
+    free(src12);
+    ulist_free(l4);
+    ulist_free(l12);
+    return 0;
+}
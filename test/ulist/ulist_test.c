@@ -0,0 +1,237 @@
+/**
+ * @file ulist_test.c
+ * @brief ulist功能测试: 按键排序、查找、批量删除、容量管理
+ * @note 按键排序与qsort结果对比, 元素不少于基数排序阈值时检查稳定性;
+ *       以-DULIST_SORT_RADIX_NUM=UINT32_MAX编译时全部走内省排序
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "minctest.h"
+#include "ulist.h"
+
+#ifdef ULIST_SORT_RADIX_NUM
+#define RADIX_NUM ULIST_SORT_RADIX_NUM
+#else
+#define RADIX_NUM 64
+#endif
+
+typedef struct {
+    int32_t key;
+    float f;
+    uint16_t pad;
+    int8_t c;
+    uint8_t tag;
+} rec_t;  // 12字节
+
+static unsigned seed = 1;
+static int freed;
+
+static unsigned rnd(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 1;
+}
+
+static int cmp_key(const void* a, const void* b) {
+    int32_t x = ((const rec_t*)a)->key, y = ((const rec_t*)b)->key;
+    return (x > y) - (x < y);
+}
+
+static bool match_tag(const void* item, const void* key) {
+    return ((const rec_t*)item)->tag == *(const uint8_t*)key;
+}
+
+static void count_free(void* ptr) { freed++; }
+
+#define SORTED(list, type, field)                           \
+    ({                                                      \
+        bool _ok = true;                                    \
+        type* _p = (type*)(list)->data;                     \
+        for (mod_size_t _i = 1; _i < (list)->num; _i++)     \
+            if (_p[_i - 1] field > _p[_i] field)            \
+                _ok = false;                                \
+        _ok;                                                \
+    })
+
+static void test_sort_by_key(void) {
+    long bad = 0;
+    for (int round = 0; round < 200; round++) {
+        int n = round < 100 ? round : 1 + rnd() % 3000;
+        ULIST list = ulist_new(sizeof(rec_t), 0, ULIST_OPT_NO_MUTEX, NULL);
+        for (int i = 0; i < n; i++) {
+            rec_t r = {(int32_t)(rnd() % (round & 1 ? 5 : 100000)) - 50000,
+                       ((float)(int)(rnd() % 2001) - 1000) / 7.f, 0,
+                       (int8_t)rnd(), (uint8_t)i};
+            ulist_append_copy(list, &r);
+        }
+        rec_t* ref = malloc(sizeof(rec_t) * (n + 1));
+        if (n)
+            memcpy(ref, list->data, sizeof(rec_t) * n);
+        qsort(ref, n, sizeof(rec_t), cmp_key);
+        ulist_sort_by_key(list, ULIST_KEY_I32, offsetof(rec_t, key),
+                          SLICE_START, SLICE_END);
+        rec_t* p = list->data;
+        for (int i = 0; i < n; i++)
+            if (p[i].key != ref[i].key)
+                bad++;
+        ulist_sort_by_key(list, ULIST_KEY_F32, offsetof(rec_t, f), SLICE_START,
+                          SLICE_END);
+        if (!SORTED(list, rec_t, .f))
+            bad++;
+        ulist_sort_by_key(list, ULIST_KEY_I8, offsetof(rec_t, c), SLICE_START,
+                          SLICE_END);
+        if (!SORTED(list, rec_t, .c))
+            bad++;
+        // 基数排序稳定: c相同的元素保持按f排好的顺序
+        if (n >= RADIX_NUM)
+            for (int i = 1; i < n; i++)
+                if (p[i - 1].c == p[i].c && p[i - 1].f > p[i].f)
+                    bad++;
+        // 部分范围[2, n-2)
+        if (n > 10) {
+            ulist_sort_by_key(list, ULIST_KEY_I32, 0, 2, -2);
+            for (int i = 3; i < n - 2; i++)
+                if (p[i - 1].key > p[i].key)
+                    bad++;
+        }
+        ulist_free(list);
+        free(ref);
+    }
+    lequal((int)bad, 0);
+
+    ULIST list = ulist_new(4, 0, ULIST_OPT_NO_MUTEX, NULL);
+    for (int i = 0; i < 5000; i++) {
+        uint32_t x = (i * 7919) % 13;  // 大量重复键
+        ulist_append_copy(list, &x);
+    }
+    ulist_sort_by_key(list, ULIST_KEY_U32, 0, SLICE_START, SLICE_END);
+    lassert(SORTED(list, uint32_t, ));
+    ulist_free(list);
+
+    list = ulist_new(8, 0, ULIST_OPT_NO_MUTEX, NULL);
+    for (int i = 0; i < 3000; i++) {
+        double x = (double)((int)(rnd() % 100000) - 50000) / 3;
+        ulist_append_copy(list, &x);
+    }
+    ulist_sort_by_key(list, ULIST_KEY_F64, 0, SLICE_START, SLICE_END);
+    lassert(SORTED(list, double, ));
+    ulist_free(list);
+}
+
+static void test_delete_matched(void) {
+    long bad = 0;
+    for (int round = 0; round < 200; round++) {
+        int n = round < 100 ? round : 1 + rnd() % 3000, keep = 0;
+        uint8_t tag = rnd() % 4;
+        ULIST list = ulist_new(sizeof(rec_t), 0, ULIST_OPT_NO_MUTEX, NULL);
+        rec_t* ref = malloc(sizeof(rec_t) * (n + 1));
+        for (int i = 0; i < n; i++) {
+            rec_t r = {i, 0, 0, 0, rnd() % 4};
+            ulist_append_copy(list, &r);
+            if (r.tag != tag)
+                ref[keep++] = r;
+        }
+        freed = 0;
+        list->elfree = count_free;
+        mod_size_t num = ulist_delete_matched(list, &tag, match_tag);
+        if ((int)num != n - keep || (int)list->num != keep ||
+            freed != n - keep)
+            bad++;
+        else if (keep && memcmp(list->data, ref, sizeof(rec_t) * keep))
+            bad++;
+        list->elfree = NULL;
+        ulist_free(list);
+        free(ref);
+    }
+    lequal((int)bad, 0);
+}
+
+static void test_find(void) {
+    uint8_t item[6];
+    ULIST list = ulist_new(6, 0, ULIST_OPT_NO_MUTEX, NULL);
+    for (int i = 0; i < 1000; i++) {
+        memset(item, 0, sizeof(item));
+        item[4] = i >> 8;
+        item[5] = i & 255;
+        ulist_append_copy(list, item);
+    }
+    item[4] = 3;
+    item[5] = 0x20;
+    lequal((int)ulist_find(list, item), 0x320);
+    item[4] = 9;
+    lequal((int)ulist_find(list, item), -1);
+    // 不在元素边界上的指针不属于列表
+    lequal((int)ulist_index(list, (uint8_t*)list->data + 7), -1);
+    lequal((int)ulist_index(list, (uint8_t*)list->data + 12), 2);
+    lassert(!ulist_remove(list, (uint8_t*)list->data + 7));
+    lequal((int)list->num, 1000);
+    ulist_free(list);
+
+    // 1/2/4/8字节元素按整数比较
+    for (int size = 1; size <= 8; size *= 2) {
+        long bad = 0;
+        uint64_t v;
+        list = ulist_new(size, 0, ULIST_OPT_NO_MUTEX, NULL);
+        for (int i = 0; i < 203; i++) {
+            v = i * 0x0101010101010101ull;
+            ulist_append_copy(list, &v);
+        }
+        for (int i = 0; i < 203; i++) {
+            v = i * 0x0101010101010101ull;
+            if (ulist_find(list, &v) != i)
+                bad++;
+        }
+        lequal((int)bad, 0);
+        v = 0xFEFEFEFEFEFEFEFEull;
+        if (size > 1)
+            lequal((int)ulist_find(list, &v), -1);
+        v = 5 * 0x0101010101010101ull;
+        lequal((int)ulist_delete_matched(list, &v, NULL), 1);
+        lequal((int)list->num, 202);
+        ulist_free(list);
+    }
+}
+
+static void test_capacity(void) {
+    static uint32_t ref[5000];
+    int n = 0;
+    long bad = 0;
+    unsigned state = 7;
+    // 随机追加/删除, 内容在扩容和缩容后保持不变
+    ULIST list = ulist_new(4, 0, ULIST_OPT_NO_MUTEX, NULL);
+    for (int round = 0; round < 200000; round++) {
+        state = state * 1103515245u + 12345u;
+        unsigned r = state >> 8;
+        if (r % 3 && n < 5000) {
+            ulist_append_copy(list, &r);
+            ref[n++] = r;
+        } else if (n) {
+            int k = r % n;
+            ulist_delete(list, k);
+            memmove(ref + k, ref + k + 1, (n - k - 1) * sizeof(uint32_t));
+            n--;
+        }
+        if (list->num != (mod_size_t)n || list->cap < list->num ||
+            (n && memcmp(list->data, ref, n * sizeof(uint32_t))))
+            bad++;
+    }
+    lequal((int)bad, 0);
+    ulist_clear(list);
+    lassert(ulist_reserve(list, 1000));
+    lassert(list->cap >= 1000);
+    for (uint32_t i = 0; i < 10; i++) ulist_append_copy(list, &i);
+    ulist_shrink_to_fit(list);
+    lequal((int)list->cap, 10);
+    lequal((int)((uint32_t*)list->data)[9], 9);
+    ulist_free(list);
+}
+
+int main(void) {
+    lrun("sort by key", test_sort_by_key);
+    lrun("delete matched", test_delete_matched);
+    lrun("find", test_find);
+    lrun("capacity", test_capacity);
+    lresults();
+    return _lfails != 0;
+}